@@ -0,0 +1,57 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARENA_DEFAULT_BLOCK_SIZE (64U * 1024U)
+#define ARENA_DEFAULT_ALIGN 16U
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t capacity;
+    size_t used;
+    _Alignas(ARENA_DEFAULT_ALIGN) unsigned char data[];
+} ArenaBlock;
+
+// Bump allocator. Blocks are kept across resets, so once a workload has warmed up it
+// never calls malloc again. Not thread-safe: use one arena per thread (arena_thread_local).
+typedef struct {
+    ArenaBlock *head;
+    ArenaBlock *current;
+    size_t block_size;
+} Arena;
+
+// Position to rewind to at the end of a scope (for example one piece decision).
+typedef struct {
+    ArenaBlock *block;
+    size_t used;
+} ArenaMark;
+
+// Fixed-size object allocator with a free list, carving objects out of an arena.
+typedef struct {
+    Arena *arena;
+    size_t object_size;
+    void *free_list;
+    size_t live;
+} Pool;
+
+void arena_init(Arena *arena, size_t block_size);
+void arena_destroy(Arena *arena);
+void *arena_alloc(Arena *arena, size_t size, size_t align);
+void arena_reset(Arena *arena);
+ArenaMark arena_mark(const Arena *arena);
+void arena_reset_to(Arena *arena, ArenaMark mark);
+size_t arena_bytes_reserved(const Arena *arena);
+
+Arena *arena_thread_local(void);
+void arena_thread_local_release(void);
+uint64_t arena_heap_allocations(void);
+uint64_t arena_heap_frees(void);
+
+void pool_init(Pool *pool, Arena *arena, size_t object_size);
+void *pool_alloc(Pool *pool);
+void pool_free(Pool *pool, void *object);
+void pool_reset(Pool *pool);
+
+#endif /* ARENA_H */
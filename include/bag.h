@@ -1,17 +1,41 @@
 #ifndef BAG_H
 #define BAG_H
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #define PIECE_BAG_MAX 16
+#define PIECE_TGM_HISTORY 4 /* pieces remembered by the TGM randomizer */
+#define PIECE_TGM_ROLLS 6   /* tries to draw a piece outside that history */
+
+// Piece sequence generators. Every kind keeps all of its state in PieceBag, seeded
+// through piece_bag_seed_kind, so a sequence can be copied, snapshotted, and replayed.
+typedef enum {
+    PIECE_RANDOMIZER_BAG7,    // shuffled bag holding each piece once (the default)
+    PIECE_RANDOMIZER_BAG14,   // shuffled bag holding each piece twice
+    PIECE_RANDOMIZER_UNIFORM, // independent uniform draws
+    PIECE_RANDOMIZER_TGM,     // reroll up to PIECE_TGM_ROLLS times to avoid the last four pieces
+    PIECE_RANDOMIZER_NES,     // one reroll when the first roll repeats the last piece
+    PIECE_RANDOMIZER_COUNT
+} PieceRandomizer;
 
 typedef struct {
+    // Bag contents (bag kinds), or the most recent pieces, newest first (TGM, NES).
     int values[PIECE_BAG_MAX];
     size_t piece_count;
-    size_t cursor;
+    size_t cursor; // next bag slot (bag kinds), or pieces drawn so far (TGM, NES)
+    uint64_t rng_state;
+    PieceRandomizer kind;
 } PieceBag;
 
 void piece_bag_init(PieceBag *bag, size_t piece_count);
+void piece_bag_seed(PieceBag *bag, size_t piece_count, uint64_t seed);
+void piece_bag_seed_kind(PieceBag *bag, PieceRandomizer kind, size_t piece_count, uint64_t seed);
 int piece_bag_next(PieceBag *bag);
+size_t piece_bag_generate(PieceBag *bag, int *pieces_out, size_t count);
+size_t piece_bag_peek(const PieceBag *bag, int *pieces_out, size_t count);
+bool piece_bag_valid(const PieceBag *bag);
+const char *piece_randomizer_name(PieceRandomizer kind);
 
 #endif /* BAG_H */
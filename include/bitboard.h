@@ -0,0 +1,42 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "piece.h"
+
+// Board backend that keeps occupancy masks beside the cell values: one 10-bit mask per
+// row (bit c = column c) for collision and line tests, and one 20-bit mask per column
+// (bit r = row r) for drop distances. Every operation gives exactly the result and cells
+// of its board.c counterpart, which stays the reference; src/board_diff.c checks that.
+
+typedef struct {
+    Board board; // cell values, laid out exactly as the reference board
+    uint16_t rows[BOARD_HEIGHT];
+    uint32_t columns[BOARD_WIDTH];
+} BitBoard;
+
+void bitboard_reset(BitBoard *board);
+void bitboard_from_board(BitBoard *board, const Board *source);
+
+bool bitboard_can_place(const BitBoard *board,
+                        const PieceShape *shape,
+                        int rotation,
+                        int test_row,
+                        int test_col);
+
+void bitboard_lock_shape(BitBoard *board,
+                         const PieceShape *shape,
+                         int rotation,
+                         int base_row,
+                         int base_col,
+                         int value);
+
+int bitboard_clear_completed_lines(BitBoard *board, int *rows_out, int max_rows);
+bool bitboard_insert_garbage(BitBoard *board, int lines, int hole_col, int value);
+bool bitboard_is_empty(const BitBoard *board);
+int bitboard_drop_distance(const BitBoard *board, const PieceShape *shape, int rotation, int row, int col);
+
+#endif /* BITBOARD_H */
@@ -28,5 +28,11 @@ void board_lock_shape(Board *board,
                       int value);
 
 int board_clear_completed_lines(Board *board, int *rows_out, int max_rows);
+bool board_insert_garbage(Board *board, int lines, int hole_col, int value);
+bool board_is_empty(const Board *board);
+int board_drop_distance(const Board *board, const PieceShape *shape, int rotation, int row, int col);
+
+bool board_try_move_piece(const Board *board, ActivePiece *piece, int drow, int dcol);
+bool board_try_rotate_piece(const Board *board, ActivePiece *piece, int direction);
 
 #endif /* BOARD_H */
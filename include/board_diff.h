@@ -0,0 +1,110 @@
+#ifndef BOARD_DIFF_H
+#define BOARD_DIFF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "dataset.h"
+#include "piece.h"
+
+// Differential testing of board backends. Every backend is driven through the same
+// BoardBackend table; the reference wraps board.c unchanged, and a candidate is accepted
+// only while it returns the same result and the same cells as the reference for every
+// operation of every stream. Streams are either random (steered by a reference board so
+// most locks land on the stack and clear lines) or derived from recorded placements in an
+// exported dataset. The first divergence is cut down to a short reproducer.
+
+#define BOARD_DIFF_MAX_THREADS 64
+#define BOARD_DIFF_NO_DIVERGENCE SIZE_MAX
+
+typedef enum {
+    BOARD_OP_RESET,
+    BOARD_OP_LOAD,          // reset, then fill the cells of boards[load] with `value`
+    BOARD_OP_CAN_PLACE,
+    BOARD_OP_DROP_DISTANCE,
+    BOARD_OP_LOCK,
+    BOARD_OP_CLEAR,         // lines cleared plus the reported row indices
+    BOARD_OP_GARBAGE,       // `lines` rows with a hole at `col`
+    BOARD_OP_IS_EMPTY,
+    BOARD_OP_KIND_COUNT
+} BoardOpKind;
+
+typedef struct {
+    uint8_t kind;
+    int8_t type;
+    int8_t rotation;
+    int8_t row;
+    int8_t col;
+    int8_t lines;
+    int16_t value;
+    uint32_t load; // BOARD_OP_LOAD: index into the stream's boards
+} BoardOp;
+
+typedef struct {
+    BoardOp *ops;
+    size_t count;
+    size_t capacity;
+    uint16_t (*boards)[BOARD_HEIGHT]; // row masks for LOAD, top row first, bit c = column c
+    size_t board_count;
+    size_t board_capacity;
+} BoardOpStream;
+
+typedef struct {
+    int value; // bool, distance, or lines cleared; 0 for operations without a result
+    int rows[BOARD_HEIGHT];
+} BoardOpResult;
+
+// One board implementation. `cells` returns the backend's cell values in reference layout,
+// or fills and returns `scratch` when it keeps them differently.
+typedef struct {
+    const char *name;
+    size_t state_size;
+    void (*reset)(void *state);
+    void (*load)(void *state, const Board *source);
+    bool (*can_place)(const void *state, const PieceShape *shape, int rotation, int row, int col);
+    void (*lock_shape)(void *state, const PieceShape *shape, int rotation, int row, int col, int value);
+    int (*clear_lines)(void *state, int *rows_out, int max_rows);
+    bool (*insert_garbage)(void *state, int lines, int hole_col, int value);
+    int (*drop_distance)(const void *state, const PieceShape *shape, int rotation, int row, int col);
+    bool (*is_empty)(const void *state);
+    const Board *(*cells)(const void *state, Board *scratch);
+} BoardBackend;
+
+typedef struct {
+    uint64_t seed;
+    int streams;           // random streams, or replay streams when `replay` is set
+    size_t ops_per_stream; // random streams only
+    size_t records_per_stream;
+    const DatasetView *replay;
+    int threads;
+} BoardDiffConfig;
+
+typedef struct {
+    uint64_t ops;              // operations checked on both backends
+    int streams;               // streams checked
+    int failing_stream;        // lowest stream that diverged, or -1
+    size_t failing_op;         // index of the first divergent op in that stream
+    BoardOpStream reproducer;  // minimized stream that still diverges (empty if none)
+} BoardDiffReport;
+
+const BoardBackend *board_backend_reference(void);
+const BoardBackend *board_backend_bitboard(void);
+
+void board_op_stream_init(BoardOpStream *stream);
+void board_op_stream_free(BoardOpStream *stream);
+int board_op_stream_append(BoardOpStream *stream, const BoardOp *op);
+int board_op_stream_add_board(BoardOpStream *stream, const uint16_t *rows, uint32_t *index_out);
+
+int board_diff_random_stream(BoardOpStream *stream, uint64_t seed, size_t count);
+int board_diff_replay_stream(BoardOpStream *stream, const DatasetView *view, uint64_t first_record, size_t count);
+void board_diff_apply(const BoardBackend *backend, void *state, const BoardOpStream *stream, const BoardOp *op,
+                      BoardOpResult *result);
+size_t board_diff_check(const BoardBackend *candidate, const BoardOpStream *stream, size_t limit);
+int board_diff_minimize(const BoardBackend *candidate, const BoardOpStream *stream, size_t divergence,
+                        BoardOpStream *out);
+int board_diff_format_op(const BoardOp *op, const BoardOpStream *stream, char *buffer, size_t capacity);
+int board_diff_run(const BoardBackend *candidate, const BoardDiffConfig *config, BoardDiffReport *report);
+
+#endif /* BOARD_DIFF_H */
@@ -0,0 +1,62 @@
+#ifndef COW_BOARD_H
+#define COW_BOARD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "arena.h"
+#include "board.h"
+#include "piece.h"
+
+#define COW_ROW_IMMORTAL -1
+
+// A board row shared between every CowBoard that has not written to it yet.
+typedef struct {
+    int refs;
+    int cells[BOARD_WIDTH];
+} CowRow;
+
+// Owns row storage for a family of boards (for example one search tree). Rows come from
+// a fixed-size Pool over an Arena, and reference counts are plain ints, so a pool and its
+// boards belong to a single thread.
+typedef struct {
+    CowRow empty_row;
+    Pool rows;
+} CowRowPool;
+
+// Board made of row pointers: cloning copies 20 pointers, locking copies only touched
+// rows, and clearing lines just shuffles pointers.
+typedef struct {
+    CowRow *rows[BOARD_HEIGHT];
+} CowBoard;
+
+void cow_pool_init(CowRowPool *pool, Arena *arena);
+size_t cow_pool_live_rows(const CowRowPool *pool);
+void cow_pool_destroy(CowRowPool *pool);
+
+void cow_board_init(CowRowPool *pool, CowBoard *board);
+int cow_board_from_board(CowRowPool *pool, CowBoard *board, const Board *source);
+void cow_board_clone(CowBoard *dest, const CowBoard *source);
+void cow_board_release(CowRowPool *pool, CowBoard *board);
+void cow_board_to_board(const CowBoard *board, Board *dest);
+
+bool cow_board_can_place(const CowBoard *board,
+                         const PieceShape *shape,
+                         int rotation,
+                         int test_row,
+                         int test_col);
+
+bool cow_board_try_move_piece(const CowBoard *board, ActivePiece *piece, int drow, int dcol);
+bool cow_board_try_rotate_piece(const CowBoard *board, ActivePiece *piece, int direction);
+
+int cow_board_lock_shape(CowRowPool *pool,
+                         CowBoard *board,
+                         const PieceShape *shape,
+                         int rotation,
+                         int base_row,
+                         int base_col,
+                         int value);
+
+int cow_board_clear_completed_lines(CowRowPool *pool, CowBoard *board, int *rows_out, int max_rows);
+
+#endif /* COW_BOARD_H */
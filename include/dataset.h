@@ -0,0 +1,114 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "board.h"
+#include "engine.h"
+
+// Training-data export: one (state, action, outcome) record per placed piece, streamed to
+// a columnar file that a loader can mmap and index without parsing.
+//
+// File layout (host byte order; every supported host is little-endian):
+//   DatasetHeader, padded to DATASET_HEADER_BYTES
+//   block_count blocks of block_bytes each; block b holds records
+//   [b * records_per_block, (b + 1) * records_per_block), stored column by column.
+//   Column c of block b starts at DATASET_HEADER_BYTES + b * block_bytes + columns[c].offset
+//   and holds records_per_block elements of columns[c].element_bytes each. Only the first
+//   record_count records are valid; the tail of the last block is zero.
+
+#define DATASET_MAGIC 0x53445454U /* "TTDS" */
+#define DATASET_VERSION 1U
+#define DATASET_HEADER_BYTES 512
+#define DATASET_RECORDS_PER_BLOCK 4096
+#define DATASET_COLUMN_ALIGN 64
+#define DATASET_COLUMN_NAME 16
+
+typedef enum {
+    DATASET_COL_BOARD = 0,   // uint16[BOARD_HEIGHT] locked-cell rows before the placement, bit c = column c
+    DATASET_COL_PIECE,       // int8 piece type being placed
+    DATASET_COL_NEXT,        // int8 next piece type
+    DATASET_COL_ROTATION,    // int8 chosen placement: rotation
+    DATASET_COL_ROW,         // int8 chosen placement: origin row
+    DATASET_COL_COL,         // int8 chosen placement: origin column
+    DATASET_COL_LINES,       // uint8 lines cleared by the placement
+    DATASET_COL_DONE,        // uint8 1 when the game ended with this placement
+    DATASET_COL_SCORE_DELTA, // int32 score gained by the placement
+    DATASET_COL_GAME,        // uint32 game index, for episode boundaries
+    DATASET_COLUMN_COUNT
+} DatasetColumn;
+
+typedef struct {
+    char name[DATASET_COLUMN_NAME];
+    uint32_t element_bytes;
+    uint32_t offset;
+} DatasetColumnInfo;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_bytes;
+    uint32_t records_per_block;
+    uint64_t block_bytes;
+    uint64_t block_count;
+    uint64_t record_count;
+    uint32_t column_count;
+    uint32_t reserved;
+    DatasetColumnInfo columns[DATASET_COLUMN_COUNT];
+} DatasetHeader;
+
+typedef struct {
+    uint16_t board[BOARD_HEIGHT];
+    int8_t piece;
+    int8_t next;
+    int8_t rotation;
+    int8_t row;
+    int8_t col;
+    uint8_t lines;
+    uint8_t done;
+    int32_t score_delta;
+    uint32_t game;
+} DatasetRecord;
+
+// Double-buffered writer: the caller fills one block in memory while a background thread
+// writes the other, so append only waits when the disk falls a whole block behind.
+typedef struct {
+    FILE *fp;
+    DatasetHeader header;
+    unsigned char *blocks[2];
+    int filling;
+    uint32_t fill;
+    int queued; // block index handed to the writer thread, or -1
+    bool stopping;
+    _Atomic bool failed; // set by the writer thread, read by appends without the lock
+    uint64_t stalls;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    pthread_cond_t drained;
+} DatasetWriter;
+
+// Read-only mapping of a finished file.
+typedef struct {
+    const unsigned char *base;
+    size_t length;
+    const DatasetHeader *header;
+} DatasetView;
+
+void dataset_header_init(DatasetHeader *header);
+void dataset_record_from_engine(DatasetRecord *record, const Engine *engine);
+
+int dataset_writer_open(DatasetWriter *writer, const char *path);
+int dataset_writer_append(DatasetWriter *writer, const DatasetRecord *record);
+int dataset_writer_close(DatasetWriter *writer);
+
+int dataset_view_open(DatasetView *view, const char *path);
+const void *dataset_view_column(const DatasetView *view, uint64_t block, DatasetColumn column);
+int dataset_view_record(const DatasetView *view, uint64_t index, DatasetRecord *record);
+void dataset_view_close(DatasetView *view);
+
+#endif /* DATASET_H */
@@ -0,0 +1,39 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "piece.h"
+
+// Board overlays for the renderer. Every layer (pieces, ghost, timed effects) is one
+// 16-bit column mask per board row, bit c = column c, so the front end composites a row
+// with a few mask tests and effects cost the same however far a piece dropped.
+
+#define OVERLAY_COLUMNS_MASK ((uint16_t)((1U << BOARD_WIDTH) - 1U))
+
+typedef enum {
+    EFFECT_LINE_FLASH, // whole cleared rows
+    EFFECT_DROP_TRAIL, // columns a hard-dropped piece fell through
+    EFFECT_COUNT
+} EffectKind;
+
+typedef struct {
+    uint16_t rows[BOARD_HEIGHT];
+    uint64_t timer_ms; // 0 when idle; the masks are cleared as it runs out
+} Effect;
+
+typedef struct {
+    Effect effects[EFFECT_COUNT];
+} Effects;
+
+void overlay_add_piece(uint16_t *rows, const ActivePiece *piece);
+
+void effects_reset(Effects *effects);
+void effects_tick(Effects *effects, uint64_t delta_ms);
+void effects_flash_rows(Effects *effects, const int *rows, int count, uint64_t duration_ms);
+void effects_drop_trail(Effects *effects, const ActivePiece *piece, int drop_distance, uint64_t duration_ms);
+uint16_t effects_row_mask(const Effects *effects, EffectKind kind, int row);
+
+#endif /* EFFECTS_H */
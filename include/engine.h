@@ -0,0 +1,169 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bag.h"
+#include "board.h"
+#include "piece.h"
+#include "score.h"
+
+#define ENGINE_GRAVITY_INTERVAL_MS 700ULL
+#define ENGINE_MIN_GRAVITY_INTERVAL_MS 120ULL
+#define ENGINE_FRAMES_PER_SECOND 60 /* "G" is rows of gravity per frame at this rate */
+#define ENGINE_GRAVITY_MAX_G 20     /* at this speed pieces drop to the stack at once */
+#define ENGINE_LOCK_DELAY_MS 500ULL
+#define ENGINE_LINES_PER_LEVEL 10
+#define ENGINE_GARBAGE_CELL 8 /* locked cell value for garbage; pieces use type + 1 */
+#define ENGINE_GARBAGE_MAX BOARD_HEIGHT
+
+typedef enum {
+    ENGINE_PHASE_IDLE,
+    ENGINE_PHASE_PLAYING,
+    ENGINE_PHASE_GAME_OVER
+} EnginePhase;
+
+// Things that happened since the last engine_take_events call, for the presentation layer.
+enum {
+    ENGINE_EVENT_LOCKED = 1u << 0,
+    ENGINE_EVENT_LINES_CLEARED = 1u << 1,
+    ENGINE_EVENT_LEVEL_UP = 1u << 2,
+    ENGINE_EVENT_HIGHSCORE = 1u << 3,
+    ENGINE_EVENT_GAME_OVER = 1u << 4,
+    ENGINE_EVENT_ATTACK = 1u << 5,
+    ENGINE_EVENT_GARBAGE = 1u << 6
+};
+
+typedef struct {
+    uint32_t flags;
+    ActivePiece locked_piece;
+    int drop_distance;
+    int cleared_count;
+    int cleared_rows[BOARD_HEIGHT];
+    int attack_lines;  // garbage to send to opponents, after cancelling incoming
+    int garbage_lines; // garbage rows pushed onto this board
+    ScoreSpin spin;    // last lock's T-spin kind
+    bool perfect_clear;
+    int combo;         // chain position after the last lock (-1: none)
+    bool back_to_back; // last lock was a chained difficult clear
+    int64_t lock_points;
+} EngineEvents;
+
+// Lock outcomes counted in EngineStats::clears; a perfect clear also counts its line kind.
+typedef enum {
+    ENGINE_CLEAR_SINGLE,
+    ENGINE_CLEAR_DOUBLE,
+    ENGINE_CLEAR_TRIPLE,
+    ENGINE_CLEAR_TETRIS,
+    ENGINE_CLEAR_TSPIN_MINI, // any mini T-spin lock, with or without lines
+    ENGINE_CLEAR_TSPIN_ZERO,
+    ENGINE_CLEAR_TSPIN_SINGLE,
+    ENGINE_CLEAR_TSPIN_DOUBLE,
+    ENGINE_CLEAR_TSPIN_TRIPLE,
+    ENGINE_CLEAR_PERFECT,
+    ENGINE_CLEAR_KIND_COUNT
+} EngineClearKind;
+
+// Per-game play analytics, accumulated as the game runs: counters only, so reading them
+// at any moment (HUD, game over, a bot evaluation) costs nothing and nothing is logged.
+typedef struct {
+    uint64_t play_ms; // time spent in the PLAYING phase (engine_tick deltas)
+    uint32_t pieces;
+    uint32_t keys;   // inputs reported through engine_count_key
+    uint32_t attack; // garbage lines produced, before cancelling incoming
+    uint32_t clears[ENGINE_CLEAR_KIND_COUNT];
+    int max_combo; // highest combo counter reached (0 for a lone clear)
+    uint64_t stack_height_sum; // tallest column after each lock
+    uint64_t holes_sum;        // covered empty cells after each lock
+} EngineStats;
+
+// Headless game state: everything needed to play one game without a terminal.
+typedef struct {
+    EnginePhase phase;
+    Board board;
+    ActivePiece active;
+    int next_piece_type;
+    PieceBag bag;
+    ScoreState score;
+    uint64_t gravity_accumulator_ms; // elapsed ms times gravity_rows, kept below gravity_interval_ms
+    bool lock_pending;
+    uint64_t lock_timer_ms;
+    int total_lines_cleared;
+    int level;
+    uint64_t gravity_interval_ms; // gravity moves the piece gravity_rows rows per interval
+    int gravity_rows;
+    int garbage_pending;
+    uint64_t garbage_rng;
+    bool last_move_rotation; // for T-spin detection at lock
+    EngineEvents events;
+    EngineStats stats;
+} Engine;
+
+// Flat copy of the gameplay state and analytics (no file paths or pending events); safe to
+// memcpy.
+typedef struct {
+    EnginePhase phase;
+    Board board;
+    ActivePiece active;
+    int next_piece_type;
+    PieceBag bag;
+    int64_t score_current;
+    int64_t score_high;
+    ScoreChain score_chain;
+    bool last_move_rotation;
+    uint64_t gravity_accumulator_ms;
+    bool lock_pending;
+    uint64_t lock_timer_ms;
+    int total_lines_cleared;
+    int level;
+    uint64_t gravity_interval_ms;
+    int gravity_rows;
+    int garbage_pending;
+    uint64_t garbage_rng;
+    EngineStats stats;
+} EngineSnapshot;
+
+void engine_init(Engine *engine, uint64_t seed);
+void engine_start(Engine *engine);
+void engine_reseed(Engine *engine, uint64_t seed);
+void engine_tick(Engine *engine, uint64_t delta_ms);
+bool engine_shift(Engine *engine, int dcol);
+bool engine_rotate(Engine *engine, int direction);
+void engine_soft_drop(Engine *engine);
+int engine_hard_drop(Engine *engine);
+uint32_t engine_take_events(Engine *engine, EngineEvents *events_out);
+void engine_receive_garbage(Engine *engine, int lines);
+void engine_set_level(Engine *engine, int level);
+int engine_attack_for_clear(int cleared);
+
+void engine_spawn_pose(int piece_type, ActivePiece *piece);
+const PieceShape *engine_active_shape(const Engine *engine);
+const PieceShape *engine_next_shape(const Engine *engine);
+int engine_ghost_row(const Engine *engine);
+void engine_gravity_for_level(int level, uint64_t *interval_ms, int *rows);
+bool engine_gravity_is_instant(const Engine *engine);
+
+void engine_count_key(Engine *engine);
+double engine_stats_pps(const EngineStats *stats);
+double engine_stats_kpp(const EngineStats *stats);
+double engine_stats_apm(const EngineStats *stats);
+double engine_stats_mean_height(const EngineStats *stats);
+double engine_stats_mean_holes(const EngineStats *stats);
+const char *engine_clear_kind_name(EngineClearKind kind);
+int engine_stats_format(const EngineStats *stats, char *buffer, size_t capacity);
+
+void engine_snapshot(const Engine *engine, EngineSnapshot *snapshot);
+void engine_restore(Engine *engine, const EngineSnapshot *snapshot);
+
+#define ENGINE_SNAPSHOT_MAGIC 0x4E535454U /* "TTSN" */
+#define ENGINE_SNAPSHOT_VERSION 4U
+#define ENGINE_SNAPSHOT_ENCODED_SIZE 1084
+
+size_t engine_snapshot_encode(const EngineSnapshot *snapshot, unsigned char *buffer, size_t capacity);
+int engine_snapshot_decode(EngineSnapshot *snapshot, const unsigned char *buffer, size_t length);
+int engine_snapshot_save(const EngineSnapshot *snapshot, const char *path);
+int engine_snapshot_load(EngineSnapshot *snapshot, const char *path);
+
+#endif /* ENGINE_H */
@@ -0,0 +1,69 @@
+#ifndef FINESSE_H
+#define FINESSE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "piece.h"
+
+// Finesse analysis: the fewest key presses that take a piece from its spawn pose to the
+// rotation and column it locked in, compared with what the player pressed. The optimal
+// paths are searched once per process over the engine's own movement rules (one-column
+// shifts, clockwise kick-free rotation) on an empty board, then looked up per piece. Only
+// placements reached by shifting, rotating, and hard dropping are judged; a soft drop
+// marks a tuck or spin whose cost the table does not model.
+
+#define FINESSE_MAX_PATH 8
+#define FINESSE_COL_MIN (-3) /* pattern-box column of a piece flush against the left wall */
+#define FINESSE_COLUMNS (BOARD_WIDTH - FINESSE_COL_MIN)
+
+typedef enum {
+    FINESSE_INPUT_LEFT,
+    FINESSE_INPUT_RIGHT,
+    FINESSE_INPUT_ROTATE,
+    FINESSE_INPUT_SOFT_DROP,
+    FINESSE_INPUT_COUNT
+} FinesseInput;
+
+typedef struct {
+    uint8_t length;
+    uint8_t inputs[FINESSE_MAX_PATH]; // FinesseInput values, in press order
+} FinessePath;
+
+// Per-game streaming state: two counters bumped per key press and one lookup per lock.
+typedef struct {
+    int inputs;        // shift and rotate presses for the current piece
+    bool soft_dropped; // the current piece was soft dropped, so it is not judged
+    int last_extra;    // presses over optimal for the last locked piece, -1 when not judged
+    uint64_t pieces;
+    uint64_t judged;
+    uint64_t faults; // judged pieces that took more presses than needed
+    uint64_t extra_inputs;
+} FinesseTracker;
+
+// Bulk totals; finesse_analyze adds to whatever is already there.
+typedef struct {
+    uint64_t pieces;
+    uint64_t judged; // pieces with known presses and a table entry
+    uint64_t faults;
+    uint64_t extra_inputs;
+    uint64_t optimal_inputs;
+    uint64_t unreachable; // placements no shift/rotate path reaches
+    uint64_t optimal_histogram[FINESSE_MAX_PATH + 1];
+} FinesseSummary;
+
+const FinessePath *finesse_path(int type, int rotation, int col);
+int finesse_optimal_inputs(int type, int rotation, int col);
+const FinessePath *finesse_best_path(const Board *board, int type);
+const char *finesse_input_name(FinesseInput input);
+
+void finesse_tracker_reset(FinesseTracker *tracker);
+void finesse_tracker_input(FinesseTracker *tracker, FinesseInput input);
+int finesse_tracker_lock(FinesseTracker *tracker, const ActivePiece *placement);
+
+void finesse_analyze(const int8_t *types, const int8_t *rotations, const int8_t *cols, const int8_t *inputs,
+                     size_t count, FinesseSummary *summary);
+
+#endif /* FINESSE_H */
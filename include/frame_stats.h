@@ -0,0 +1,49 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define FRAME_STATS_WINDOW 128
+
+typedef enum {
+    FRAME_PHASE_INPUT,
+    FRAME_PHASE_UPDATE,
+    FRAME_PHASE_DRAW,
+    FRAME_PHASE_REFRESH,
+    FRAME_PHASE_LATENCY,
+    FRAME_PHASE_COUNT
+} FramePhase;
+
+// Rolling window of the most recent samples (microseconds) for one phase.
+typedef struct {
+    uint32_t samples[FRAME_STATS_WINDOW];
+    size_t count;
+    size_t cursor;
+} FrameSampleWindow;
+
+typedef struct {
+    FrameSampleWindow windows[FRAME_PHASE_COUNT];
+} FrameStats;
+
+// Chrome trace-event JSON writer (load the output in chrome://tracing or Perfetto).
+typedef struct {
+    FILE *fp;
+    uint64_t origin_us;
+    bool wrote_event;
+} TraceWriter;
+
+uint64_t frame_stats_now_us(void);
+const char *frame_phase_name(FramePhase phase);
+void frame_stats_reset(FrameStats *stats);
+void frame_stats_record(FrameStats *stats, FramePhase phase, uint64_t duration_us);
+size_t frame_stats_sample_count(const FrameStats *stats, FramePhase phase);
+void frame_stats_percentiles(const FrameStats *stats, FramePhase phase, uint64_t *p50_out, uint64_t *p99_out);
+
+int trace_writer_open(TraceWriter *writer, const char *path, uint64_t origin_us);
+void trace_writer_span(TraceWriter *writer, const char *name, uint64_t start_us, uint64_t duration_us);
+void trace_writer_close(TraceWriter *writer);
+
+#endif /* FRAME_STATS_H */
@@ -1,8 +1,31 @@
 #ifndef GAME_H
 #define GAME_H
 
-int game_init(void);
+#include <stdbool.h>
+
+#include "perf_suite.h"
+#include "term.h"
+
+// Startup switches parsed from the command line by main.
+typedef struct {
+    bool debug_hud;
+    bool hint;
+    const char *trace_path;
+    const char *stats_path;
+    const char *session_path;
+    const char *analytics_path; // one JSON line of play analytics appended per finished game
+    const char *highscore_path; // NULL for SCORE_DEFAULT_FILE, "" to keep the high score in memory
+    const char *versus_address;
+    const char *spectate_address;
+    const char *spectate_shm;
+    const char *watch_address;
+    TermBackend backend;
+} GameOptions;
+
+void game_options_default(GameOptions *options);
+int game_init(const GameOptions *options);
 void game_loop(void);
+int game_run_script(uint64_t seed, const uint8_t *keys, size_t count, uint64_t frame_ms, PerfSessionResult *result);
 void game_shutdown(void);
 
 #endif /* GAME_H */
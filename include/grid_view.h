@@ -0,0 +1,92 @@
+#ifndef GRID_VIEW_H
+#define GRID_VIEW_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "engine.h"
+#include "term.h"
+
+// Many simulated games watched live in one terminal. Each game owns a GridSlot that its
+// simulation thread publishes snapshots into; the viewer tiles up to GRID_MAX_BOARDS of
+// them, two board rows per terminal row, and redraws a tile only when its throttle interval
+// has passed and the snapshot it reads differs from what the tile shows. The simulation
+// side never waits: it publishes only when the viewer has asked for a fresh snapshot, into
+// whichever of the slot's two buffers the viewer is not reading, and a viewer read that
+// overlaps a publish is detected by the buffer's sequence number and retried next pass.
+
+#define GRID_MIN_BOARDS 4
+#define GRID_MAX_BOARDS 64
+#define GRID_TILE_ROWS (BOARD_HEIGHT / 2)
+#define GRID_TILE_WIDTH (BOARD_WIDTH + 2)      /* board plus walls */
+#define GRID_TILE_HEIGHT (GRID_TILE_ROWS + 2)  /* label, board rows, floor */
+#define GRID_TILE_GAP 1
+#define GRID_DEFAULT_INTERVAL_MS 100
+
+// What a tile shows: locked cells with the falling piece drawn in, type + 1 per cell (0
+// empty, anything past the seven pieces is garbage), and the label fields.
+typedef struct {
+    uint8_t cells[BOARD_HEIGHT][BOARD_WIDTH];
+    uint32_t score;
+    uint32_t lines;
+    uint32_t pieces;
+    uint8_t phase;
+} GridBoard;
+
+// One game's double buffer. published holds the newest complete buffer's index in bit 0
+// and the publish count above it; sequence[b] is odd while buffer b is being written.
+typedef struct {
+    _Alignas(64) _Atomic uint32_t published;
+    _Atomic uint32_t sequence[2];
+    GridBoard boards[2];
+    _Alignas(64) _Atomic bool wanted; // set by the viewer, cleared by the next publish
+} GridSlot;
+
+// A tile as last drawn: one glyph and one piece color per terminal cell.
+typedef struct {
+    char glyphs[GRID_TILE_ROWS][BOARD_WIDTH];
+    uint8_t colors[GRID_TILE_ROWS][BOARD_WIDTH];
+} GridImage;
+
+typedef struct {
+    uint32_t generation; // publish count of the snapshot on screen, 0 before the first
+    uint64_t due_us;     // earliest time the tile redraws again
+    bool drawn;          // frame and label are on screen
+    uint32_t score;      // label as drawn
+    uint8_t phase;
+    GridImage image;
+} GridTile;
+
+typedef struct {
+    GridSlot *slots;
+    int count;
+    uint64_t interval_us;
+    bool color;
+    int screen_rows; // terminal size the layout was made for
+    int screen_cols;
+    int columns;     // tiles per row
+    int shown;       // tiles that fit on screen
+    GridTile tiles[GRID_MAX_BOARDS];
+    uint64_t tile_redraws; // tile updates that changed something on screen
+    uint64_t rows_written; // board rows sent to the terminal
+    uint64_t torn_reads;   // reads that overlapped a publish and were dropped
+} GridView;
+
+void grid_slot_init(GridSlot *slot);
+void grid_slot_publish(GridSlot *slot, const Engine *engine);
+int grid_slot_read(GridSlot *slot, uint32_t *generation, GridBoard *board);
+
+// Simulation side, once per frame: true when the viewer is waiting for a snapshot.
+static inline bool grid_slot_wanted(GridSlot *slot) {
+    return atomic_load_explicit(&slot->wanted, memory_order_relaxed);
+}
+
+void grid_board_from_engine(const Engine *engine, GridBoard *board);
+void grid_image_from_board(const GridBoard *board, GridImage *image);
+
+int grid_view_init(GridView *view, GridSlot *slots, int count, uint32_t interval_ms);
+int grid_view_draw(GridView *view, uint64_t now_us);
+
+#endif /* GRID_VIEW_H */
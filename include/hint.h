@@ -0,0 +1,95 @@
+#ifndef HINT_H
+#define HINT_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "cow_board.h"
+#include "perfect_clear.h"
+#include "piece.h"
+
+// Placement hints computed off the render thread. The game posts one request per spawned
+// piece and a worker thread posts back the best placement it found; both directions go
+// through a single-slot mailbox where a newer value replaces one the other side has not
+// taken yet, so neither thread ever waits for the other. When the request carries the
+// known piece queue, the worker first looks for a perfect clear and hints its first piece.
+
+#define HINT_DEFAULT_DEPTH 3 /* current piece, preview piece, then one unknown piece */
+#define HINT_MAX_DEPTH 4
+#define HINT_PC_NODE_BUDGET 100000 /* perfect-clear search cut-off per piece */
+
+// Stack features the evaluator weighs; tools/tetris_tune searches over their weights.
+typedef enum {
+    HINT_FEATURE_HEIGHT,          // aggregate column height
+    HINT_FEATURE_LINES,           // lines cleared on the way to this board
+    HINT_FEATURE_HOLES,           // empty cells below a column's top
+    HINT_FEATURE_BUMPINESS,       // summed height difference of neighbouring columns
+    HINT_FEATURE_MAX_HEIGHT,      // tallest column
+    HINT_FEATURE_WELLS,           // summed depth of wells (columns lower than both neighbours)
+    HINT_FEATURE_ROW_TRANSITIONS, // filled/empty changes along each row, walls counting as filled
+    HINT_FEATURE_COUNT
+} HintFeature;
+
+typedef struct {
+    double weights[HINT_FEATURE_COUNT];
+} HintWeights;
+
+extern const HintWeights hint_default_weights;
+
+typedef struct {
+    Board board;
+    int piece;
+    int next;    // preview piece, or -1
+    uint64_t id; // one per spawned piece; the result echoes it
+    int queue[PC_MAX_PIECES]; // known pieces from the current one on (pc_queue_from_engine)
+    int queue_length;         // 0 skips the perfect-clear search
+} HintRequest;
+
+typedef struct {
+    uint64_t id;
+    bool found;
+    ActivePiece placement;
+    double value;
+    bool perfect_clear; // placement starts a perfect clear with the known queue
+} HintResult;
+
+// Three buffers per mailbox: the writer fills its own buffer and exchanges it into the
+// shared slot; the reader exchanges the shared slot for its own buffer when it is fresh.
+typedef struct {
+    _Atomic unsigned shared; // buffer index, plus HINT_MAILBOX_FRESH when not yet taken
+    unsigned writer;
+    unsigned reader;
+} HintMailbox;
+
+typedef struct {
+    HintMailbox requests;
+    HintRequest request_slots[3];
+    HintMailbox results;
+    HintResult result_slots[3];
+    _Atomic uint64_t latest_id; // newest posted request, so stale searches stop early
+    _Atomic bool stopping;
+    int depth;
+    PcSolver perfect_clear;
+    bool perfect_clear_ready;
+    bool running;
+    pthread_t thread;
+    HintResult current; // game side: newest result taken so far
+} HintWorker;
+
+void hint_features(const Board *board, int cleared, double *features_out);
+double hint_evaluate_weights(const Board *board, int cleared, const HintWeights *weights);
+double hint_evaluate(const Board *board, int cleared);
+double hint_evaluate_cow_weights(const CowBoard *board, int cleared, const HintWeights *weights);
+double hint_evaluate_cow(const CowBoard *board, int cleared);
+bool hint_locks_above_board(const ActivePiece *placement);
+bool hint_search(const HintRequest *request, int depth, _Atomic uint64_t *latest_id, HintResult *result);
+
+int hint_worker_start(HintWorker *worker, int depth);
+void hint_worker_post(HintWorker *worker, const HintRequest *request);
+bool hint_worker_poll(HintWorker *worker, uint64_t id, HintResult *result);
+void hint_worker_stop(HintWorker *worker);
+
+#endif /* HINT_H */
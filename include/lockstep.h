@@ -0,0 +1,70 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "engine.h"
+#include "perf_suite.h"
+
+// Many games stepped frame by frame in lockstep. Each lane is a full Engine, but the state
+// a frame touches while a piece falls lives beside the engines in structure-of-arrays
+// form: the piece pose, lock delay, and gravity fields in parallel arrays, and each lane's
+// row masks packed so the four rows under a piece are one 64-bit load. Moves, rotations,
+// soft drops, gravity, and the lock timer then run for eight lanes per instruction with
+// AVX2 (the board windows gathered four lanes at a time), or lane by lane in the scalar
+// kernel. Anything else (hard drops, locks, 20G gravity) is handed to the lane's Engine
+// for that frame, so a lane plays exactly as perf_engine_step plays the same keys. Lanes
+// that top out or are stopped are masked out.
+
+#define LOCKSTEP_MAX_LANES 32
+#define LOCKSTEP_VECTOR_LANES 8
+#define LOCKSTEP_PAD 4 /* empty rows above and floor rows below the board, wall columns each side */
+#define LOCKSTEP_ROWS (BOARD_HEIGHT + 2 * LOCKSTEP_PAD)
+
+typedef enum {
+    LOCKSTEP_KERNEL_AUTO, // AVX2 when the CPU has it
+    LOCKSTEP_KERNEL_SCALAR,
+    LOCKSTEP_KERNEL_AVX2
+} LockstepKernel;
+
+typedef struct {
+    int lane_count;
+    int playing;           // lanes with live set
+    LockstepKernel kernel; // resolved, never AUTO
+    Engine engines[LOCKSTEP_MAX_LANES];
+    uint32_t frames[LOCKSTEP_MAX_LANES];
+    bool stopped[LOCKSTEP_MAX_LANES];
+
+    // Hot state, authoritative over the matching Engine fields until the lane is synced.
+    // Row r of a lane's padded board is rows[lane][r]; bit LOCKSTEP_PAD + c is column c,
+    // and every bit outside the ten columns is set so walls and floor collide like cells.
+    uint16_t rows[LOCKSTEP_MAX_LANES][LOCKSTEP_ROWS];
+    int32_t live[LOCKSTEP_MAX_LANES]; // -1 while the lane is playing and not stopped, else 0
+    int32_t shape[LOCKSTEP_MAX_LANES]; // piece type * 4 + rotation
+    int32_t rotation_count[LOCKSTEP_MAX_LANES];
+    int32_t row[LOCKSTEP_MAX_LANES];
+    int32_t col[LOCKSTEP_MAX_LANES];
+    int32_t last_move_rotation[LOCKSTEP_MAX_LANES];
+    int32_t lock_pending[LOCKSTEP_MAX_LANES];
+    uint32_t lock_timer_ms[LOCKSTEP_MAX_LANES];
+    uint32_t gravity_accumulator_ms[LOCKSTEP_MAX_LANES];
+    uint32_t gravity_interval_ms[LOCKSTEP_MAX_LANES];
+    uint32_t gravity_rows[LOCKSTEP_MAX_LANES];
+    uint32_t play_ms[LOCKSTEP_MAX_LANES]; // not yet added to the engine's stats
+    int32_t engine_only[LOCKSTEP_MAX_LANES]; // -1 when every frame goes to the Engine (20G, no piece)
+} LockstepBatch;
+
+bool lockstep_avx2_supported(void);
+const char *lockstep_kernel_name(LockstepKernel kernel);
+
+int lockstep_init(LockstepBatch *batch, int lane_count, LockstepKernel kernel);
+void lockstep_start(LockstepBatch *batch, int lane, uint64_t seed);
+void lockstep_set_level(LockstepBatch *batch, int lane, int level);
+int lockstep_step(LockstepBatch *batch, const uint8_t *keys, uint64_t frame_ms);
+void lockstep_stop(LockstepBatch *batch, int lane);
+const Engine *lockstep_engine(LockstepBatch *batch, int lane);
+void lockstep_result(LockstepBatch *batch, int lane, PerfSessionResult *result);
+
+#endif /* LOCKSTEP_H */
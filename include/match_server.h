@@ -0,0 +1,44 @@
+#ifndef MATCH_SERVER_H
+#define MATCH_SERVER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "versus.h"
+
+// Local versus lobby: pairs clients in arrival order into matches of a fixed size and
+// routes attacks, boards, and eliminations between the players of each match.
+
+#define MATCH_SERVER_MAX_CLIENTS 64
+
+typedef struct {
+    VersusConn conn;
+    bool in_use;
+    bool waiting;
+    int match;
+    uint8_t player;
+} MatchClient;
+
+typedef struct {
+    bool active;
+    int player_count;
+    int clients[VERSUS_MAX_PLAYERS];
+    bool alive[VERSUS_MAX_PLAYERS];
+    uint8_t next_target[VERSUS_MAX_PLAYERS];
+} Match;
+
+typedef struct {
+    int listen_fd;
+    int players_per_match;
+    uint64_t seed_state;
+    int lobby[MATCH_SERVER_MAX_CLIENTS];
+    int lobby_count;
+    MatchClient clients[MATCH_SERVER_MAX_CLIENTS];
+    Match matches[MATCH_SERVER_MAX_CLIENTS / 2];
+} MatchServer;
+
+int match_server_open(MatchServer *server, const char *address, int players_per_match, uint64_t seed);
+int match_server_poll(MatchServer *server, int timeout_ms);
+void match_server_close(MatchServer *server);
+
+#endif /* MATCH_SERVER_H */
@@ -0,0 +1,70 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define METRICS_CACHE_LINE 64
+#define METRICS_MAX_BLOCKS 64
+
+typedef enum {
+    METRIC_PIECES_LOCKED,
+    METRIC_CLEARS_SINGLE,
+    METRIC_CLEARS_DOUBLE,
+    METRIC_CLEARS_TRIPLE,
+    METRIC_CLEARS_TETRIS,
+    METRIC_COLLISION_CHECKS,
+    METRIC_ROTATIONS_FAILED,
+    METRIC_FRAMES_RENDERED,
+    METRIC_TERMINAL_BYTES,
+    METRIC_SCORE_SAVES,
+    METRIC_COUNT
+} MetricId;
+
+// One block per live thread, padded so no two threads ever write the same cache line, and
+// returned for reuse when the thread exits. Each block has a single writer, so increments
+// are a relaxed load + store; only the overflow block, shared by threads beyond
+// METRICS_MAX_BLOCKS - 1 running at once, pays for fetch_add. shared is fixed at startup.
+typedef struct {
+    _Alignas(METRICS_CACHE_LINE) _Atomic uint64_t values[METRIC_COUNT];
+    bool shared;
+} MetricsBlock;
+
+extern _Thread_local MetricsBlock *metrics_thread_block;
+
+MetricsBlock *metrics_claim_block(void);
+void metrics_snapshot(uint64_t values_out[METRIC_COUNT]);
+int metrics_write_prometheus(FILE *fp, const uint64_t values[METRIC_COUNT]);
+int metrics_write_stats_file(const char *path);
+
+static inline void metrics_add(MetricId id, uint64_t amount) {
+    MetricsBlock *block = metrics_thread_block;
+    if (block == NULL) {
+        block = metrics_claim_block();
+    }
+
+    if (block->shared) {
+        atomic_fetch_add_explicit(&block->values[id], amount, memory_order_relaxed);
+        return;
+    }
+
+    uint64_t value = atomic_load_explicit(&block->values[id], memory_order_relaxed);
+    atomic_store_explicit(&block->values[id], value + amount, memory_order_relaxed);
+}
+
+static inline void metrics_inc(MetricId id) {
+    metrics_add(id, 1);
+}
+
+// Count a line clear under the matching size bucket (4+ lines land in the tetris bucket).
+static inline void metrics_record_clear(int cleared_lines) {
+    if (cleared_lines <= 0) {
+        return;
+    }
+    int bucket = (cleared_lines > 4) ? 4 : cleared_lines;
+    metrics_inc((MetricId)(METRIC_CLEARS_SINGLE + bucket - 1));
+}
+
+#endif /* METRICS_H */
@@ -0,0 +1,98 @@
+#ifndef PERF_SUITE_H
+#define PERF_SUITE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "engine.h"
+
+// End-to-end throughput regression suite. A session is a game seed plus a recorded key
+// script, one key (or none) per frame at a fixed frame time, so replaying it always plays
+// the same game; tests/replay_corpus.h holds the checked-in sessions. tools/replay_bench
+// replays them through game.c with the null renderer, repeats the whole corpus several
+// times, and compares the per-run figures with a stored baseline: a metric regresses only
+// when the change is both larger than the tolerance and outside the 95% confidence
+// interval of the difference of the means.
+
+#define PERF_FRAME_MS 16ULL /* 60 frames per second */
+#define PERF_MAX_RUNS 64
+#define PERF_MAX_RUN_LENGTH 9999 /* longest run one script token can repeat a key */
+#define PERF_BASELINE_MAGIC "tetris-perf-baseline"
+#define PERF_BASELINE_VERSION 2
+
+// Script alphabet: '.' idle, 'L' left, 'R' right, 'D' soft drop, 'U' rotate, 'H' hard drop;
+// a decimal count in front of a key repeats it ("12." is twelve idle frames).
+typedef enum {
+    PERF_KEY_IDLE,
+    PERF_KEY_LEFT,
+    PERF_KEY_RIGHT,
+    PERF_KEY_SOFT_DROP,
+    PERF_KEY_ROTATE,
+    PERF_KEY_HARD_DROP,
+    PERF_KEY_COUNT
+} PerfKey;
+
+typedef struct {
+    uint32_t frames; // frames played, up to and including the one that topped out
+    uint32_t pieces;
+    uint32_t lines;
+    int64_t score;
+    bool topped_out;
+} PerfSessionResult;
+
+typedef enum {
+    PERF_METRIC_PIECES_PER_SEC,
+    PERF_METRIC_FRAMES_PER_SEC,
+    PERF_METRIC_ALLOCS_PER_GAME,
+    PERF_METRIC_COUNT
+} PerfMetric;
+
+// Summary of one metric over repeated runs.
+typedef struct {
+    int count;
+    double mean;
+    double stddev; // sample standard deviation, 0 for a single run
+} PerfSample;
+
+// What one pass over the corpus plays; figures measured on a different corpus are not
+// comparable.
+typedef struct {
+    int sessions;
+    uint64_t frames;
+    uint64_t pieces;
+} PerfCorpus;
+
+typedef struct {
+    PerfCorpus corpus;
+    PerfSample metrics[PERF_METRIC_COUNT];
+} PerfBaseline;
+
+typedef struct {
+    double change;   // relative change of the mean against the baseline, positive = better
+    double noise;    // relative 95% confidence half-width of the difference
+    bool regressed;
+} PerfVerdict;
+
+int perf_script_decode(const char *script, uint8_t *keys, size_t capacity);
+int perf_script_encode(const uint8_t *keys, size_t count, char *buffer, size_t capacity);
+int perf_key_term_code(PerfKey key);
+
+void perf_engine_start(Engine *engine, uint64_t seed);
+void perf_engine_step(Engine *engine, PerfKey key, uint64_t frame_ms);
+int perf_replay_engine(uint64_t seed, const uint8_t *keys, size_t count, uint64_t frame_ms,
+                       PerfSessionResult *result);
+
+const char *perf_metric_name(PerfMetric metric);
+bool perf_metric_higher_is_better(PerfMetric metric);
+void perf_sample_from_runs(const double *values, int count, PerfSample *sample);
+double perf_t_critical(double degrees_of_freedom);
+double perf_sample_interval(const PerfSample *sample);
+void perf_compare(PerfMetric metric, const PerfSample *baseline, const PerfSample *current, double tolerance,
+                  PerfVerdict *verdict);
+
+int perf_baseline_save(const PerfBaseline *baseline, const char *path);
+int perf_baseline_load(PerfBaseline *baseline, const char *path);
+bool perf_corpus_equal(const PerfCorpus *a, const PerfCorpus *b);
+
+#endif /* PERF_SUITE_H */
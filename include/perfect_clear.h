@@ -0,0 +1,47 @@
+#ifndef PERFECT_CLEAR_H
+#define PERFECT_CLEAR_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "engine.h"
+#include "piece.h"
+
+// Perfect-clear solver: finds placements for a known piece queue that empty the board.
+// Only stacks within the bottom PC_MAX_HEIGHT rows qualify; that field is searched as a
+// packed 40-bit integer (bit row * BOARD_WIDTH + col, row 0 at the bottom), with rows
+// removed as they fill. Root placements are shared out to threads that run depth-first
+// searches, and every subproblem proven unsolvable goes into one lock-free hash set so
+// no thread explores it twice. Moves follow the engine: shifts, drops, and kick-free
+// rotations from the open space above the field.
+
+#define PC_MAX_HEIGHT 4
+#define PC_MAX_PIECES 10 /* a 4-row field holds exactly ten pieces */
+#define PC_MAX_THREADS 16
+#define PC_FAILED_SLOTS_LOG2 20
+
+typedef struct {
+    int pieces;
+    ActivePiece placements[PC_MAX_PIECES]; // board coordinates at the time of each lock
+} PcSolution;
+
+typedef struct {
+    _Atomic uint64_t *failed; // open-addressed keys of failed subproblems, 0 = empty
+    size_t slot_mask;
+    uint64_t epoch;     // tags keys per solve, so the set never needs clearing between solves
+    int threads;
+    uint64_t max_nodes; // give up after this many search nodes; 0 means no limit
+    const _Atomic uint64_t *latest_id; // when set, give up once it no longer equals id
+    uint64_t id;
+    uint64_t nodes;     // nodes searched by the last solve
+} PcSolver;
+
+int pc_solver_init(PcSolver *solver, int threads, uint64_t max_nodes);
+void pc_solver_free(PcSolver *solver);
+bool pc_solve(PcSolver *solver, const Board *board, const int *queue, int count, PcSolution *solution);
+int pc_queue_from_engine(const Engine *engine, int *queue, int capacity);
+
+#endif /* PERFECT_CLEAR_H */
@@ -0,0 +1,23 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "cow_board.h"
+#include "piece.h"
+
+// Piece origins range over rows [-PERFT_ROW_OFFSET, BOARD_HEIGHT) and
+// columns [-PERFT_COL_OFFSET, BOARD_WIDTH).
+#define PERFT_ROW_OFFSET 4
+#define PERFT_COL_OFFSET 3
+#define PERFT_ROW_SPAN (BOARD_HEIGHT + PERFT_ROW_OFFSET)
+#define PERFT_COL_SPAN (BOARD_WIDTH + PERFT_COL_OFFSET)
+#define PERFT_MAX_PLACEMENTS (4 * PERFT_ROW_SPAN * PERFT_COL_SPAN)
+
+int perft_generate(const Board *board, int piece_type, ActivePiece *placements_out, int capacity);
+int perft_generate_cow(const CowBoard *board, int piece_type, ActivePiece *placements_out, int capacity);
+uint64_t perft(const Board *board, const int *pieces, int depth, bool dedupe);
+
+#endif /* PERFT_H */
@@ -0,0 +1,134 @@
+#ifndef RETRO_H
+#define RETRO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+
+// Exhaustive solver for narrow or short boards under the 7-bag. A state is the locked
+// field plus the pieces still left in the current bag; its value is the expected number of
+// lines cleared before topping out with optimal play, found by value iteration over every
+// state reachable from an empty field. Fields are bitboards of any size set up by
+// retro_geometry_init (bit row * width + col, row 0 at the bottom). Pieces spawn and move
+// in RETRO_BUFFER_ROWS open rows above the field and follow the engine's moves: shifts,
+// drops, and kick-free clockwise rotations. A lock that leaves a cell above the field
+// tops out.
+//
+// Finished values go to a table file that is mapped read-only and probed through a
+// perfect hash of the state key, so a lookup is O(1) and the table is never read into RAM.
+//
+// Table layout (host byte order; every supported host is little-endian):
+//   RetroTableHeader, padded to RETRO_TABLE_HEADER_BYTES
+//   uint32 displacements[bucket_count], padded to a multiple of 8 bytes
+//   RetroEntry entries[slot_count]; check == 0 marks an empty slot
+
+#define RETRO_MIN_WIDTH 4
+#define RETRO_BUFFER_ROWS 4
+#define RETRO_MAX_CELLS 57 /* field bits in a state key; the bag takes the top 7 */
+#define RETRO_MAX_HEIGHT 12 /* 4 wide, with the buffer rows, fills 64 bits */
+#define RETRO_PIECE_TYPES 7
+#define RETRO_FULL_BAG 0x7FU
+#define RETRO_BAGS 128
+#define RETRO_MAX_PLACEMENTS 64
+#define RETRO_MAX_THREADS 64
+#define RETRO_TABLE_MAGIC 0x54525454U /* "TTRT" */
+#define RETRO_TABLE_VERSION 1U
+#define RETRO_TABLE_HEADER_BYTES 64
+
+// Field size plus every piece pose as a cell mask: poses[type][rotation][x + 3][y + 3] for
+// the pattern box's left column x and bottom row y; 0 where the pose leaves the field and
+// buffer.
+typedef struct {
+    int width;
+    int height;
+    uint64_t row_mask;
+    uint64_t field_mask;
+    uint64_t poses[RETRO_PIECE_TYPES][4][BOARD_WIDTH + 3][RETRO_MAX_HEIGHT + RETRO_BUFFER_ROWS + 3];
+} RetroGeometry;
+
+// One distinct way to lock a piece: the field after clearing, or a topout.
+typedef struct {
+    uint64_t field;
+    int lines;
+    bool topout;
+} RetroPlacement;
+
+typedef struct {
+    int32_t next; // board index of the field after the lock, -1 on topout
+    int32_t lines;
+} RetroEdge;
+
+typedef struct {
+    double gamma;     // discount per piece; 1 counts every line until topout
+    double tolerance; // stop once no value moves by more than this in a sweep
+    int max_sweeps;   // with gamma 1, sweep k values the next k pieces
+    int threads;
+} RetroConfig;
+
+typedef struct {
+    RetroGeometry geometry;
+    uint64_t *boards; // field of each board index
+    size_t board_count;
+    size_t board_capacity;
+    uint64_t *slots; // open-addressed field + 1 per slot, 0 = empty
+    int32_t *slot_boards;
+    size_t slot_mask;
+    uint64_t *reach;     // two words per board: bags that reach it, bit = bag
+    uint32_t *edges_at;  // eight per board: edges of piece p are [edges_at[8b+p], edges_at[8b+p+1])
+    RetroEdge *edges;
+    size_t edge_count;
+    size_t edge_capacity;
+    double *values; // [board * RETRO_BAGS + bag]
+    size_t state_count;
+    int sweeps;
+    double residual; // largest change in the last sweep
+    double gamma;
+} RetroSolver;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint64_t state_count;
+    uint64_t slot_count;
+    uint64_t bucket_count;
+    uint64_t seed;
+    double gamma;
+    uint32_t sweeps;
+    uint32_t reserved;
+} RetroTableHeader;
+
+typedef struct {
+    uint32_t check; // key fingerprint, never 0 for a stored state
+    float value;
+} RetroEntry;
+
+// Read-only mapping of a finished table.
+typedef struct {
+    const unsigned char *base;
+    size_t length;
+    const RetroTableHeader *header;
+    const uint32_t *displacements;
+    const RetroEntry *entries;
+} RetroTable;
+
+int retro_geometry_init(RetroGeometry *geometry, int width, int height);
+uint64_t retro_field_from_rows(const RetroGeometry *geometry, const uint16_t *rows);
+int retro_place(const RetroGeometry *geometry, uint64_t field, int type, RetroPlacement *placements, int capacity);
+uint64_t retro_state_key(uint64_t field, unsigned bag);
+
+int retro_solver_init(RetroSolver *solver, int width, int height);
+void retro_solver_free(RetroSolver *solver);
+int retro_solver_explore(RetroSolver *solver);
+int retro_solver_iterate(RetroSolver *solver, const RetroConfig *config);
+double retro_solver_value(const RetroSolver *solver, uint64_t field, unsigned bag);
+int retro_table_write(const RetroSolver *solver, const char *path, uint64_t seed);
+
+int retro_table_open(RetroTable *table, const char *path);
+bool retro_table_lookup(const RetroTable *table, uint64_t field, unsigned bag, float *value);
+void retro_table_close(RetroTable *table);
+
+#endif /* RETRO_H */
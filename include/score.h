@@ -2,20 +2,50 @@
 #define SCORE_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#include "board.h"
 
 #define SCORE_DEFAULT_FILE "highscore.dat"
 #define SCORE_PATH_CAPACITY 512
+#define SCORE_T_PIECE 2 /* piece index of the T tetromino */
+
+typedef enum {
+    SCORE_SPIN_NONE,
+    SCORE_SPIN_MINI,
+    SCORE_SPIN_FULL,
+    SCORE_SPIN_COUNT
+} ScoreSpin;
+
+// What one lock did, as far as scoring is concerned.
+typedef struct {
+    int lines;
+    ScoreSpin spin;
+    bool perfect_clear;
+    int level;
+} ScoreLock;
+
+// Carried from lock to lock: the combo counter (-1 outside a chain) and whether the last
+// clear was a "difficult" one (tetris or spin clear) that the next one can chain from.
+typedef struct {
+    int combo;
+    bool back_to_back;
+} ScoreChain;
 
 typedef struct {
-    int current;
-    int high;
+    int64_t current;
+    int64_t high;
+    ScoreChain chain;
     char storage_path[SCORE_PATH_CAPACITY];
 } ScoreState;
 
 int score_state_init(ScoreState *state, const char *path);
 int score_state_save(const ScoreState *state);
 void score_reset_current(ScoreState *state);
-void score_add_lines(ScoreState *state, int cleared_lines);
+void score_chain_reset(ScoreChain *chain);
+ScoreSpin score_detect_tspin(const Board *board, const ActivePiece *piece, bool rotated_last);
+int64_t score_lock_points(ScoreChain *chain, const ScoreLock *lock);
+int64_t score_add_lock(ScoreState *state, const ScoreLock *lock);
 void score_add_drop(ScoreState *state, int dropped_cells);
 bool score_commit_highscore(ScoreState *state);
 
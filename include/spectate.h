@@ -0,0 +1,114 @@
+#ifndef SPECTATE_H
+#define SPECTATE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "engine.h"
+
+// Spectator fan-out. The playing process encodes what changed each tick (cells, piece
+// pose, score fields) once into a ring buffer; every viewer, over a socket or by mapping
+// the ring from shared memory, reads that same byte stream at its own pace. A keyframe
+// with the full state is written periodically so late or lagging viewers can resync.
+//
+// Record layout: kind (u8), reserved (u8), payload length (u16 LE), tick (u32 LE), payload.
+//   keyframe payload: BOARD_HEIGHT * BOARD_WIDTH cell bytes, then the fields tail
+//   delta payload:    changed cell count (u8), (cell index, value) byte pairs, fields tail
+//   fields tail:      type, rotation, row, col, active, next type, phase, level (i8/u8),
+//                     lines (u16 LE), score, high score (u32 LE)
+
+#define SPECTATE_RING_BYTES (64 * 1024)
+#define SPECTATE_KEYFRAME_TICKS 120
+#define SPECTATE_MAX_VIEWERS 64
+#define SPECTATE_RING_MAGIC 0x54505354U /* "TSPT" */
+#define SPECTATE_RECORD_HEADER 8
+#define SPECTATE_FIELDS_SIZE 18
+#define SPECTATE_MAX_RECORD (SPECTATE_RECORD_HEADER + 1 + BOARD_HEIGHT * BOARD_WIDTH * 2 + SPECTATE_FIELDS_SIZE)
+
+typedef enum {
+    SPECTATE_RECORD_KEYFRAME = 1,
+    SPECTATE_RECORD_DELTA = 2
+} SpectateRecordKind;
+
+// Everything a viewer needs to draw the game.
+typedef struct {
+    uint8_t cells[BOARD_HEIGHT][BOARD_WIDTH];
+    int8_t type;
+    int8_t rotation;
+    int8_t row;
+    int8_t col;
+    uint8_t active;
+    int8_t next_type;
+    uint8_t phase;
+    uint8_t level;
+    uint16_t lines;
+    uint32_t score;
+    uint32_t high;
+    uint32_t tick;
+} SpectateState;
+
+// Single-writer ring, also the exact layout of the shared-memory segment. Positions are
+// byte offsets into the unbounded stream; data[pos % SPECTATE_RING_BYTES] holds byte pos.
+typedef struct {
+    uint32_t magic;
+    uint32_t capacity;
+    _Atomic uint64_t write_pos;
+    _Atomic uint64_t keyframe_pos;
+    _Atomic bool closed;
+    unsigned char data[SPECTATE_RING_BYTES];
+} SpectateRing;
+
+// In-process (or shared-memory) reader; starts at the newest keyframe.
+typedef struct {
+    const SpectateRing *ring;
+    uint64_t pos;
+    bool synced;
+} SpectateReader;
+
+typedef struct {
+    int fd;
+    uint64_t pos;
+    bool at_record;
+} SpectateViewer;
+
+typedef struct {
+    SpectateRing *ring;
+    char shm_name[64];
+    int listen_fd;
+    SpectateViewer viewers[SPECTATE_MAX_VIEWERS];
+    int viewer_count;
+    SpectateState last;
+    bool have_last;
+    uint32_t tick;
+    uint32_t keyframe_tick;
+} SpectateHub;
+
+// Viewer side of either transport: "unix:PATH"/"tcp:PORT" or "shm:NAME".
+typedef struct {
+    SpectateRing *mapped;
+    SpectateReader reader;
+    int fd;
+    unsigned char in[SPECTATE_MAX_RECORD * 4];
+    size_t in_len;
+} SpectateFeed;
+
+void spectate_state_from_engine(const Engine *engine, SpectateState *state);
+void spectate_state_to_engine(const SpectateState *state, Engine *engine);
+int spectate_apply_record(const unsigned char *buffer, size_t length, SpectateState *state, size_t *consumed);
+
+int spectate_hub_open(SpectateHub *hub, const char *socket_address, const char *shm_name);
+bool spectate_hub_publish(SpectateHub *hub, const Engine *engine);
+void spectate_hub_pump(SpectateHub *hub);
+void spectate_hub_close(SpectateHub *hub);
+
+void spectate_reader_init(SpectateReader *reader, const SpectateRing *ring);
+int spectate_reader_next(SpectateReader *reader, SpectateState *state);
+
+int spectate_feed_open(SpectateFeed *feed, const char *address);
+int spectate_feed_poll(SpectateFeed *feed, SpectateState *state);
+void spectate_feed_close(SpectateFeed *feed);
+
+#endif /* SPECTATE_H */
@@ -0,0 +1,70 @@
+#ifndef TERM_H
+#define TERM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Output backends the game can draw through. ncurses is the default and the fallback
+// whenever the raw VT100 backend cannot take over the terminal. The null backend composes
+// frames off-screen like VT100 but never touches a terminal: no output, no input, a fixed
+// size; it is what headless replays (game_run_script) render through.
+typedef enum {
+    TERM_BACKEND_NCURSES,
+    TERM_BACKEND_VT100,
+    TERM_BACKEND_NULL
+} TermBackend;
+
+// Foreground colors; the values double as ncurses color-pair numbers.
+typedef enum {
+    TERM_COLOR_DEFAULT = 0,
+    TERM_COLOR_CYAN = 1,
+    TERM_COLOR_YELLOW = 2,
+    TERM_COLOR_BLUE = 3,
+    TERM_COLOR_WHITE = 4,
+    TERM_COLOR_MAGENTA = 5,
+    TERM_COLOR_GREEN = 6,
+    TERM_COLOR_RED = 7,
+    TERM_COLOR_COUNT
+} TermColor;
+
+// Drawing attribute: a TermColor in the low byte plus style flags.
+typedef uint16_t TermAttr;
+
+#define TERM_ATTR_NORMAL 0x0000U
+#define TERM_ATTR_BOLD 0x0100U
+#define TERM_ATTR_DIM 0x0200U
+#define TERM_ATTR_REVERSE 0x0400U
+#define TERM_ATTR_COLOR_MASK 0x00FFU
+#define TERM_ATTR_COLOR(attr) ((TermColor)((attr) & TERM_ATTR_COLOR_MASK))
+
+// Key codes returned by term_read_key: plain bytes for printable keys, these for the rest.
+#define TERM_KEY_NONE (-1)
+#define TERM_KEY_UP 0x101
+#define TERM_KEY_DOWN 0x102
+#define TERM_KEY_LEFT 0x103
+#define TERM_KEY_RIGHT 0x104
+#define TERM_KEY_ENTER 0x105
+
+const char *term_backend_name(TermBackend backend);
+int term_backend_parse(const char *name, TermBackend *backend_out);
+TermColor term_piece_color(int piece_type);
+
+int term_init(TermBackend requested);
+void term_shutdown(void);
+TermBackend term_backend(void);
+bool term_has_colors(void);
+
+int term_rows(void);
+int term_cols(void);
+int term_read_key(void);
+void term_nap(int ms);
+
+void term_clear(void);
+void term_box(void);
+void term_set_attr(TermAttr attr);
+void term_put(int y, int x, const char *text);
+void term_putc(int y, int x, char ch);
+void term_printf(int y, int x, const char *format, ...);
+void term_flush(void);
+
+#endif /* TERM_H */
@@ -0,0 +1,85 @@
+#ifndef TETRIS_ENV_H
+#define TETRIS_ENV_H
+
+#include <stdint.h>
+
+// Batched, headless environment exported by libtetris for external trainers. This header
+// is the library's whole ABI: it only uses fixed-width types, the environment is opaque,
+// and layouts below only ever grow by bumping TETRIS_ENV_ABI_VERSION.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define TETRIS_API __declspec(dllexport)
+#else
+#define TETRIS_API __attribute__((visibility("default")))
+#endif
+
+#define TETRIS_ENV_ABI_VERSION 1
+
+#define TETRIS_ENV_ROWS 20
+#define TETRIS_ENV_COLS 10
+#define TETRIS_ENV_FRAME_MS 16
+
+// Observation layout per environment i (all buffers are caller-owned and contiguous):
+//   planes[i][TETRIS_ENV_PLANE_COUNT][TETRIS_ENV_ROWS]  uint16 rows, bit c = column c
+//   queue[i][TETRIS_ENV_QUEUE_LEN]                      active piece, next, then preview
+//   stats[i][TETRIS_ENV_STAT_COUNT]                     int32, see TetrisEnvStat
+//   rewards[i], dones[i]                                score gained / game ended this step
+enum {
+    TETRIS_ENV_PLANE_LOCKED = 0,
+    TETRIS_ENV_PLANE_ACTIVE = 1,
+    TETRIS_ENV_PLANE_COUNT = 2
+};
+
+#define TETRIS_ENV_QUEUE_LEN 5
+
+typedef enum {
+    TETRIS_ENV_STAT_SCORE = 0,
+    TETRIS_ENV_STAT_LINES,
+    TETRIS_ENV_STAT_LEVEL,
+    TETRIS_ENV_STAT_PIECES,
+    TETRIS_ENV_STAT_ACTIVE_ROW,
+    TETRIS_ENV_STAT_ACTIVE_COL,
+    TETRIS_ENV_STAT_ACTIVE_ROTATION,
+    TETRIS_ENV_STAT_COUNT
+} TetrisEnvStat;
+
+// One action per environment per step, followed by TETRIS_ENV_FRAME_MS of game time.
+typedef enum {
+    TETRIS_ACTION_NONE = 0,
+    TETRIS_ACTION_LEFT,
+    TETRIS_ACTION_RIGHT,
+    TETRIS_ACTION_ROTATE_CW,
+    TETRIS_ACTION_ROTATE_CCW,
+    TETRIS_ACTION_SOFT_DROP,
+    TETRIS_ACTION_HARD_DROP,
+    TETRIS_ACTION_COUNT
+} TetrisAction;
+
+typedef struct {
+    uint16_t *planes;
+    int8_t *queue;
+    int32_t *stats;
+    float *rewards;
+    uint8_t *dones;
+} TetrisEnvBuffers;
+
+typedef struct TetrisEnv TetrisEnv;
+
+TETRIS_API int env_abi_version(void);
+TETRIS_API TetrisEnv *env_create(int count, const uint64_t *seeds);
+TETRIS_API void env_destroy(TetrisEnv *env);
+TETRIS_API int env_count(const TetrisEnv *env);
+TETRIS_API int env_bind_buffers(TetrisEnv *env, const TetrisEnvBuffers *buffers);
+TETRIS_API int env_set_threads(TetrisEnv *env, int threads);
+TETRIS_API int env_reset(TetrisEnv *env, const uint64_t *seeds);
+TETRIS_API int env_step(TetrisEnv *env, const int32_t *actions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TETRIS_ENV_H */
@@ -0,0 +1,46 @@
+#ifndef TUNE_H
+#define TUNE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hint.h"
+
+// Evaluation-weight tuning with a genetic algorithm. Each generation every candidate
+// weight vector plays the same seeded games (common random numbers), so candidates are
+// compared on identical piece sequences and luck cancels out of the ranking; the seeds
+// change from one generation to the next so the winner does not overfit a few sequences.
+
+#define TUNE_MAX_POPULATION 64
+#define TUNE_MAX_GAMES 1024
+#define TUNE_MAX_THREADS 64
+#define TUNE_CHECKPOINT_MAGIC 0x4E555454U /* "TTUN" */
+#define TUNE_CHECKPOINT_VERSION 1U
+
+typedef struct {
+    int games;      // games per candidate per generation, shared by all candidates
+    int max_pieces; // a game also ends after this many pieces, so good candidates finish
+    int threads;
+} TuneConfig;
+
+typedef struct {
+    uint32_t generation;
+    uint32_t population;
+    uint64_t seed;      // run seed; each generation's game seeds derive from it
+    uint64_t rng_state; // selection, crossover, and mutation
+    HintWeights candidates[TUNE_MAX_POPULATION];
+    double fitness[TUNE_MAX_POPULATION]; // mean lines cleared, once evaluated
+    HintWeights best;
+    double best_fitness;
+    uint32_t best_generation;
+} TuneState;
+
+void tune_state_init(TuneState *state, int population, uint64_t seed);
+uint64_t tune_game_seed(const TuneState *state, int game);
+int tune_play_game(const HintWeights *weights, uint64_t seed, int max_pieces);
+int tune_evaluate(TuneState *state, const TuneConfig *config);
+void tune_next_generation(TuneState *state);
+int tune_checkpoint_save(const TuneState *state, const char *path);
+int tune_checkpoint_load(TuneState *state, const char *path);
+
+#endif /* TUNE_H */
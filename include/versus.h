@@ -0,0 +1,64 @@
+#ifndef VERSUS_H
+#define VERSUS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+
+// Versus-mode wire protocol and non-blocking socket connections. Every message is a 3-byte
+// header (type, little-endian payload length) followed by a payload whose first byte is a
+// player id; boards travel as one 16-bit mask per row.
+
+#define VERSUS_PROTOCOL_VERSION 1
+#define VERSUS_MAX_PLAYERS 8
+#define VERSUS_NO_PLAYER 0xFF
+#define VERSUS_HEADER_SIZE 3
+#define VERSUS_MAX_MESSAGE (VERSUS_HEADER_SIZE + 1 + BOARD_HEIGHT * 2 + 4)
+#define VERSUS_BUFFER_SIZE 4096
+
+typedef enum {
+    VERSUS_MSG_HELLO = 1,   // client -> server: join the lobby (version)
+    VERSUS_MSG_MATCH,       // server -> client: your id, player count, shared seed
+    VERSUS_MSG_ATTACK,      // client -> server: lines sent by a clear
+    VERSUS_MSG_GARBAGE,     // server -> client: lines received, from player
+    VERSUS_MSG_BOARD,       // both ways: a player's visible board and score
+    VERSUS_MSG_TOPPED_OUT,  // both ways: a player is out
+    VERSUS_MSG_RESULT       // server -> client: match over, player is the winner
+} VersusMessageType;
+
+typedef struct {
+    VersusMessageType type;
+    uint8_t player;
+    uint8_t version;
+    uint8_t player_count;
+    uint8_t lines;
+    uint64_t seed;
+    uint16_t rows[BOARD_HEIGHT];
+    uint32_t score;
+} VersusMessage;
+
+// Buffered non-blocking stream; sends queue whatever the socket does not take at once.
+typedef struct {
+    int fd;
+    bool closed;
+    unsigned char in[VERSUS_BUFFER_SIZE];
+    size_t in_len;
+    unsigned char out[VERSUS_BUFFER_SIZE];
+    size_t out_len;
+} VersusConn;
+
+size_t versus_encode(const VersusMessage *message, unsigned char *buffer, size_t capacity);
+int versus_decode(const unsigned char *buffer, size_t length, VersusMessage *message, size_t *consumed);
+
+int versus_listen(const char *address);
+int versus_accept(int listen_fd);
+int versus_connect(const char *address);
+void versus_conn_init(VersusConn *conn, int fd);
+int versus_conn_send(VersusConn *conn, const VersusMessage *message);
+int versus_conn_flush(VersusConn *conn);
+int versus_conn_receive(VersusConn *conn, VersusMessage *message);
+void versus_conn_close(VersusConn *conn);
+
+#endif /* VERSUS_H */
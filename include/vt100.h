@@ -0,0 +1,56 @@
+#ifndef VT100_H
+#define VT100_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "term.h"
+
+// Internal flag for cells drawn from the DEC special-graphics (line drawing) set.
+#define VT100_ATTR_LINE 0x8000U
+
+typedef struct {
+    char ch;
+    TermAttr attr;
+} Vt100Cell;
+
+// Growable byte buffer reused across frames; after the first few frames it never
+// reallocates.
+typedef struct {
+    char *data;
+    size_t len;
+    size_t capacity;
+} Vt100Buffer;
+
+// Screen model for the raw backend. Drawing writes into `back`; vt100_compose diffs it
+// against `front` (what the terminal shows) and encodes only changed cells as cursor
+// moves, SGR changes, and text into `out`.
+typedef struct {
+    int rows;
+    int cols;
+    Vt100Cell *back;
+    Vt100Cell *front;
+    bool full_redraw;
+    TermAttr attr;
+    Vt100Buffer out;
+} Vt100Screen;
+
+int vt100_screen_init(Vt100Screen *screen, int rows, int cols);
+int vt100_screen_resize(Vt100Screen *screen, int rows, int cols);
+void vt100_screen_destroy(Vt100Screen *screen);
+
+void vt100_clear(Vt100Screen *screen);
+void vt100_put(Vt100Screen *screen, int y, int x, const char *text, size_t len);
+void vt100_box(Vt100Screen *screen);
+size_t vt100_compose(Vt100Screen *screen);
+
+int vt100_parse_key(const unsigned char *input, size_t len, size_t *consumed);
+
+int vt100_tty_open(void);
+void vt100_tty_close(void);
+int vt100_tty_size(int *rows, int *cols);
+bool vt100_tty_resized(void);
+int vt100_tty_write(const char *data, size_t len);
+int vt100_tty_read(unsigned char *buffer, size_t capacity);
+
+#endif /* VT100_H */
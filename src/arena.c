@@ -0,0 +1,236 @@
+#include "arena.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Arena and pool allocators for search nodes, candidate boards, and other per-decision
+// scratch memory. Everything is released wholesale by rewinding to a mark.
+
+static atomic_uint_fast64_t g_heap_allocations = 0;
+static atomic_uint_fast64_t g_heap_frees = 0;
+static _Thread_local Arena g_thread_arena;
+static _Thread_local bool g_thread_arena_ready = false;
+
+// Its destructor hands an exiting thread's arena blocks back to the heap.
+static pthread_key_t g_arena_key;
+static pthread_once_t g_arena_key_once = PTHREAD_ONCE_INIT;
+
+static ArenaBlock *block_create(size_t capacity) {
+    ArenaBlock *block = malloc(sizeof(ArenaBlock) + capacity);
+    if (block == NULL) {
+        return NULL;
+    }
+    atomic_fetch_add_explicit(&g_heap_allocations, 1U, memory_order_relaxed);
+    block->next = NULL;
+    block->capacity = capacity;
+    block->used = 0;
+    return block;
+}
+
+static size_t align_up(size_t value, size_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+void arena_init(Arena *arena, size_t block_size) {
+    if (arena == NULL) {
+        return;
+    }
+
+    arena->head = NULL;
+    arena->current = NULL;
+    arena->block_size = (block_size == 0) ? ARENA_DEFAULT_BLOCK_SIZE : block_size;
+}
+
+void arena_destroy(Arena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+
+    ArenaBlock *block = arena->head;
+    while (block != NULL) {
+        ArenaBlock *next = block->next;
+        free(block);
+        atomic_fetch_add_explicit(&g_heap_frees, 1U, memory_order_relaxed);
+        block = next;
+    }
+    arena->head = NULL;
+    arena->current = NULL;
+}
+
+// Bump-allocate from the current block, moving on to (or creating) the next one.
+// align must be a power of two no larger than ARENA_DEFAULT_ALIGN.
+void *arena_alloc(Arena *arena, size_t size, size_t align) {
+    if (arena == NULL || size == 0) {
+        return NULL;
+    }
+    if (align == 0 || align > ARENA_DEFAULT_ALIGN || (align & (align - 1)) != 0) {
+        align = ARENA_DEFAULT_ALIGN;
+    }
+
+    ArenaBlock *block = arena->current;
+    while (block != NULL) {
+        size_t offset = align_up(block->used, align);
+        if (offset + size <= block->capacity) {
+            block->used = offset + size;
+            arena->current = block;
+            return block->data + offset;
+        }
+        if (block->next == NULL || block->next->capacity < size) {
+            break;
+        }
+        block = block->next;
+        block->used = 0;
+    }
+
+    size_t capacity = (size > arena->block_size) ? size : arena->block_size;
+    ArenaBlock *fresh = block_create(capacity);
+    if (fresh == NULL) {
+        return NULL;
+    }
+
+    if (block == NULL) {
+        arena->head = fresh;
+    } else {
+        fresh->next = block->next;
+        block->next = fresh;
+    }
+    fresh->used = size;
+    arena->current = fresh;
+    return fresh->data;
+}
+
+// Release everything but keep the blocks for reuse.
+void arena_reset(Arena *arena) {
+    if (arena == NULL || arena->head == NULL) {
+        return;
+    }
+
+    arena->head->used = 0;
+    arena->current = arena->head;
+}
+
+ArenaMark arena_mark(const Arena *arena) {
+    ArenaMark mark = {NULL, 0};
+    if (arena != NULL && arena->current != NULL) {
+        mark.block = arena->current;
+        mark.used = arena->current->used;
+    }
+    return mark;
+}
+
+// Free everything allocated after the mark was taken.
+void arena_reset_to(Arena *arena, ArenaMark mark) {
+    if (arena == NULL) {
+        return;
+    }
+
+    if (mark.block == NULL) {
+        arena_reset(arena);
+        return;
+    }
+
+    mark.block->used = mark.used;
+    arena->current = mark.block;
+}
+
+size_t arena_bytes_reserved(const Arena *arena) {
+    size_t total = 0;
+    if (arena == NULL) {
+        return 0;
+    }
+    for (const ArenaBlock *block = arena->head; block != NULL; block = block->next) {
+        total += block->capacity;
+    }
+    return total;
+}
+
+static void release_thread_arena(void *arena) {
+    (void)arena;
+    arena_thread_local_release();
+}
+
+static void create_arena_key(void) {
+    pthread_key_create(&g_arena_key, release_thread_arena);
+}
+
+// Lazily created arena owned by the calling thread; its blocks are freed when the thread
+// exits.
+Arena *arena_thread_local(void) {
+    if (!g_thread_arena_ready) {
+        pthread_once(&g_arena_key_once, create_arena_key);
+        arena_init(&g_thread_arena, ARENA_DEFAULT_BLOCK_SIZE);
+        g_thread_arena_ready = true;
+        pthread_setspecific(g_arena_key, &g_thread_arena);
+    }
+    return &g_thread_arena;
+}
+
+// Return the calling thread's arena blocks to the heap now rather than at thread exit.
+void arena_thread_local_release(void) {
+    if (g_thread_arena_ready) {
+        arena_destroy(&g_thread_arena);
+        g_thread_arena_ready = false;
+        pthread_setspecific(g_arena_key, NULL);
+    }
+}
+
+// Total malloc calls made by every arena in the process (steady state should not move it).
+uint64_t arena_heap_allocations(void) {
+    return atomic_load_explicit(&g_heap_allocations, memory_order_relaxed);
+}
+
+// Blocks handed back to the heap by arena_destroy, including at thread exit.
+uint64_t arena_heap_frees(void) {
+    return atomic_load_explicit(&g_heap_frees, memory_order_relaxed);
+}
+
+void pool_init(Pool *pool, Arena *arena, size_t object_size) {
+    if (pool == NULL) {
+        return;
+    }
+
+    pool->arena = (arena != NULL) ? arena : arena_thread_local();
+    pool->object_size = align_up((object_size < sizeof(void *)) ? sizeof(void *) : object_size,
+                                 ARENA_DEFAULT_ALIGN);
+    pool->free_list = NULL;
+    pool->live = 0;
+}
+
+void *pool_alloc(Pool *pool) {
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    void *object = pool->free_list;
+    if (object != NULL) {
+        pool->free_list = *(void **)object;
+    } else {
+        object = arena_alloc(pool->arena, pool->object_size, ARENA_DEFAULT_ALIGN);
+        if (object == NULL) {
+            return NULL;
+        }
+    }
+    ++pool->live;
+    return object;
+}
+
+void pool_free(Pool *pool, void *object) {
+    if (pool == NULL || object == NULL) {
+        return;
+    }
+
+    *(void **)object = pool->free_list;
+    pool->free_list = object;
+    --pool->live;
+}
+
+// Forget every object; call together with rewinding the backing arena.
+void pool_reset(Pool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    pool->free_list = NULL;
+    pool->live = 0;
+}
@@ -2,20 +2,47 @@
 
 #include <stdlib.h>
 
-// Implements the seven-bag style randomizer used for piece order.
+// Implements the piece randomizers: seven- and fourteen-piece bags, uniform draws, and
+// the TGM and NES history rules. Each bag carries its own xorshift state so a game's
+// sequence can be seeded, snapshotted, and replayed.
 
-// Refill and shuffle the bag using Fisher-Yates so every piece appears once.
+// Piece indices from piece.c that the TGM opening history refers to.
+#define BAG_S_PIECE 5
+#define BAG_Z_PIECE 6
+
+static uint64_t bag_random(PieceBag *bag) {
+    uint64_t x = bag->rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    bag->rng_state = x;
+    return x * 2685821657736338717ULL;
+}
+
+// Uniform value in [0, bound) from the high bits by multiply-shift, which avoids a
+// division per draw; the bias is below 2^-28 for any bound the bag can hold.
+static int bag_below(PieceBag *bag, size_t bound) {
+    return (int)(((bag_random(bag) >> 32) * (uint64_t)bound) >> 32);
+}
+
+static size_t bag_slots(const PieceBag *bag) {
+    return (bag->kind == PIECE_RANDOMIZER_BAG14) ? bag->piece_count * 2 : bag->piece_count;
+}
+
+// Refill and shuffle the bag using Fisher-Yates so every piece appears once (twice for
+// the fourteen-piece bag).
 static void piece_bag_refill(PieceBag *bag) {
     if (bag == NULL || bag->piece_count == 0) {
         return;
     }
 
-    for (size_t i = 0; i < bag->piece_count; ++i) {
-        bag->values[i] = (int)i;
+    size_t slots = bag_slots(bag);
+    for (size_t i = 0; i < slots; ++i) {
+        bag->values[i] = (int)(i % bag->piece_count);
     }
 
-    for (size_t i = bag->piece_count; i > 1; --i) {
-        size_t j = (size_t)(rand() % (int)i);
+    for (size_t i = slots; i > 1; --i) {
+        size_t j = (size_t)(bag_random(bag) % i);
         size_t idx = i - 1;
         int tmp = bag->values[idx];
         bag->values[idx] = bag->values[j];
@@ -25,21 +52,96 @@ static void piece_bag_refill(PieceBag *bag) {
     bag->cursor = 0;
 }
 
-// Prepare a bag with the provided number of unique pieces.
+// Reroll while the candidate is among the last four pieces, at most PIECE_TGM_ROLLS
+// tries in all; the last roll stands either way.
+static int tgm_next(PieceBag *bag) {
+    int piece = 0;
+    for (int roll = 0; roll < PIECE_TGM_ROLLS; ++roll) {
+        piece = bag_below(bag, bag->piece_count);
+        if (piece != bag->values[0] && piece != bag->values[1] && piece != bag->values[2] &&
+            piece != bag->values[3]) {
+            break;
+        }
+    }
+    bag->values[3] = bag->values[2];
+    bag->values[2] = bag->values[1];
+    bag->values[1] = bag->values[0];
+    bag->values[0] = piece;
+    ++bag->cursor;
+    return piece;
+}
+
+// Roll one past the piece count; the extra value or a repeat of the previous piece earns
+// a single plain reroll, whose result stands.
+static int nes_next(PieceBag *bag) {
+    int piece = bag_below(bag, bag->piece_count + 1);
+    if (piece == (int)bag->piece_count || piece == bag->values[0]) {
+        piece = bag_below(bag, bag->piece_count);
+    }
+    bag->values[0] = piece;
+    ++bag->cursor;
+    return piece;
+}
+
+// Prepare a bag with the provided number of unique pieces, seeded from rand().
 void piece_bag_init(PieceBag *bag, size_t piece_count) {
+    uint64_t seed = ((uint64_t)(unsigned)rand() << 32) ^ (uint64_t)(unsigned)rand();
+    piece_bag_seed(bag, piece_count, seed);
+}
+
+// Prepare a seven-bag whose sequence is fully determined by seed.
+void piece_bag_seed(PieceBag *bag, size_t piece_count, uint64_t seed) {
+    piece_bag_seed_kind(bag, PIECE_RANDOMIZER_BAG7, piece_count, seed);
+}
+
+// Prepare a randomizer of the given kind whose sequence is fully determined by seed.
+// The fourteen-piece bag holds at most PIECE_BAG_MAX / 2 piece types.
+void piece_bag_seed_kind(PieceBag *bag, PieceRandomizer kind, size_t piece_count, uint64_t seed) {
     if (bag == NULL) {
         return;
     }
 
-    if (piece_count > PIECE_BAG_MAX) {
-        piece_count = PIECE_BAG_MAX;
+    // splitmix64 finalizer spreads small seeds; xorshift state must be non-zero.
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    bag->rng_state = (z != 0) ? z : 0x9E3779B97F4A7C15ULL;
+
+    if (kind < 0 || kind >= PIECE_RANDOMIZER_COUNT) {
+        kind = PIECE_RANDOMIZER_BAG7;
+    }
+    size_t limit = (kind == PIECE_RANDOMIZER_BAG14) ? PIECE_BAG_MAX / 2 : PIECE_BAG_MAX;
+    if (piece_count > limit) {
+        piece_count = limit;
     }
 
+    bag->kind = kind;
     bag->piece_count = piece_count;
-    bag->cursor = piece_count;
+    bag->cursor = 0;
+    for (size_t i = 0; i < PIECE_BAG_MAX; ++i) {
+        bag->values[i] = -1;
+    }
 
-    if (piece_count > 0) {
-        piece_bag_refill(bag);
+    if (piece_count == 0) {
+        return;
+    }
+    switch (kind) {
+        case PIECE_RANDOMIZER_BAG7:
+        case PIECE_RANDOMIZER_BAG14:
+            piece_bag_refill(bag);
+            break;
+        case PIECE_RANDOMIZER_TGM:
+            // TGM2 starts from a Z S Z S history, so games rarely open on an S or Z.
+            if (piece_count > BAG_Z_PIECE) {
+                bag->values[0] = BAG_Z_PIECE;
+                bag->values[1] = BAG_S_PIECE;
+                bag->values[2] = BAG_Z_PIECE;
+                bag->values[3] = BAG_S_PIECE;
+            }
+            break;
+        default:
+            break;
     }
 }
 
@@ -49,9 +151,120 @@ int piece_bag_next(PieceBag *bag) {
         return -1;
     }
 
-    if (bag->cursor >= bag->piece_count) {
-        piece_bag_refill(bag);
+    switch (bag->kind) {
+        case PIECE_RANDOMIZER_UNIFORM:
+            return bag_below(bag, bag->piece_count);
+        case PIECE_RANDOMIZER_TGM:
+            return tgm_next(bag);
+        case PIECE_RANDOMIZER_NES:
+            return nes_next(bag);
+        default:
+            break;
     }
 
+    if (bag->cursor >= bag_slots(bag)) {
+        piece_bag_refill(bag);
+    }
     return bag->values[bag->cursor++];
 }
+
+// Draw count pieces into pieces_out: the same sequence as count calls to piece_bag_next,
+// but with the kind dispatched once and bag contents copied a run at a time.
+size_t piece_bag_generate(PieceBag *bag, int *pieces_out, size_t count) {
+    if (bag == NULL || pieces_out == NULL || bag->piece_count == 0) {
+        return 0;
+    }
+
+    switch (bag->kind) {
+        case PIECE_RANDOMIZER_UNIFORM:
+            for (size_t i = 0; i < count; ++i) {
+                pieces_out[i] = bag_below(bag, bag->piece_count);
+            }
+            break;
+        case PIECE_RANDOMIZER_TGM:
+            for (size_t i = 0; i < count; ++i) {
+                pieces_out[i] = tgm_next(bag);
+            }
+            break;
+        case PIECE_RANDOMIZER_NES:
+            for (size_t i = 0; i < count; ++i) {
+                pieces_out[i] = nes_next(bag);
+            }
+            break;
+        default: {
+            size_t slots = bag_slots(bag);
+            size_t done = 0;
+            while (done < count) {
+                if (bag->cursor >= slots) {
+                    piece_bag_refill(bag);
+                }
+                size_t run = slots - bag->cursor;
+                if (run > count - done) {
+                    run = count - done;
+                }
+                for (size_t i = 0; i < run; ++i) {
+                    pieces_out[done + i] = bag->values[bag->cursor + i];
+                }
+                bag->cursor += run;
+                done += run;
+            }
+            break;
+        }
+    }
+    return count;
+}
+
+// Preview the next count pieces without consuming them; draws from a copy so the
+// upcoming refill shuffle is predicted exactly.
+size_t piece_bag_peek(const PieceBag *bag, int *pieces_out, size_t count) {
+    if (bag == NULL || pieces_out == NULL || bag->piece_count == 0) {
+        return 0;
+    }
+
+    PieceBag preview = *bag;
+    return piece_bag_generate(&preview, pieces_out, count);
+}
+
+// True when every field the kind reads is in range, so a bag from a saved snapshot can
+// be drawn from without indexing past values or returning an invalid piece.
+bool piece_bag_valid(const PieceBag *bag) {
+    if (bag == NULL || bag->kind < 0 || bag->kind >= PIECE_RANDOMIZER_COUNT) {
+        return false;
+    }
+    size_t limit = (bag->kind == PIECE_RANDOMIZER_BAG14) ? PIECE_BAG_MAX / 2 : PIECE_BAG_MAX;
+    if (bag->piece_count > limit) {
+        return false;
+    }
+
+    if (bag->kind == PIECE_RANDOMIZER_BAG7 || bag->kind == PIECE_RANDOMIZER_BAG14) {
+        size_t slots = bag_slots(bag);
+        if (bag->cursor > slots) {
+            return false;
+        }
+        for (size_t i = 0; i < slots; ++i) {
+            if (bag->values[i] < 0 || (size_t)bag->values[i] >= bag->piece_count) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // History kinds start from -1 (no piece yet) in any slot they compare against.
+    size_t history = (bag->kind == PIECE_RANDOMIZER_TGM)   ? PIECE_TGM_HISTORY
+                     : (bag->kind == PIECE_RANDOMIZER_NES) ? 1
+                                                           : 0;
+    for (size_t i = 0; i < history; ++i) {
+        if (bag->values[i] < -1 || bag->values[i] >= (int)bag->piece_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const char *piece_randomizer_name(PieceRandomizer kind) {
+    static const char *const names[PIECE_RANDOMIZER_COUNT] = {"7-bag", "14-bag", "uniform", "tgm", "nes"};
+    if (kind < 0 || kind >= PIECE_RANDOMIZER_COUNT) {
+        return "unknown";
+    }
+    return names[kind];
+}
@@ -0,0 +1,284 @@
+#include "bitboard.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include "metrics.h"
+
+// Mask-based board operations mirroring board.c.
+
+#define BITBOARD_FULL_ROW ((uint16_t)((1U << BOARD_WIDTH) - 1U))
+#define BITBOARD_PIECE_TYPES 7
+
+// One rotation's pattern as row masks (bit c = pattern column c) plus the bounding box of
+// its filled cells, so bounds checks are four comparisons.
+typedef struct {
+    uint16_t rows[4];
+    int8_t lowest[4]; // lowest filled pattern row per pattern column, -1 if none
+    int top;
+    int bottom;
+    int left;
+    int right;
+} BitShape;
+
+static BitShape g_shapes[BITBOARD_PIECE_TYPES][4];
+static pthread_once_t g_shapes_once = PTHREAD_ONCE_INIT;
+
+static void build_bit_shape(const PieceShape *shape, int rotation, BitShape *bits) {
+    memset(bits, 0, sizeof(*bits));
+    bits->top = shape->size;
+    bits->bottom = -1;
+    bits->left = shape->size;
+    bits->right = -1;
+    for (int c = 0; c < 4; ++c) {
+        bits->lowest[c] = -1;
+    }
+    for (int r = 0; r < shape->size && r < 4; ++r) {
+        for (int c = 0; c < shape->size && c < 4; ++c) {
+            if (!piece_shape_cell_filled(shape, rotation, r, c)) {
+                continue;
+            }
+            bits->rows[r] |= (uint16_t)(1U << c);
+            bits->lowest[c] = (int8_t)r;
+            bits->top = (r < bits->top) ? r : bits->top;
+            bits->bottom = r;
+            bits->left = (c < bits->left) ? c : bits->left;
+            bits->right = (c > bits->right) ? c : bits->right;
+        }
+    }
+}
+
+static void build_shapes(void) {
+    for (int type = 0; type < BITBOARD_PIECE_TYPES && type < (int)piece_shape_count(); ++type) {
+        const PieceShape *shape = piece_shape_get((size_t)type);
+        for (int rotation = 0; rotation < shape->rotation_count; ++rotation) {
+            build_bit_shape(shape, rotation, &g_shapes[type][rotation]);
+        }
+    }
+}
+
+// Cached masks for the built-in shapes; any other shape is built into `scratch`.
+static const BitShape *bit_shape(const PieceShape *shape, int rotation, BitShape *scratch) {
+    pthread_once(&g_shapes_once, build_shapes);
+    for (int type = 0; type < BITBOARD_PIECE_TYPES; ++type) {
+        if (shape == piece_shape_get((size_t)type)) {
+            return &g_shapes[type][rotation];
+        }
+    }
+    build_bit_shape(shape, rotation, scratch);
+    return scratch;
+}
+
+static uint16_t shift_row(uint16_t bits, int col) {
+    if (col >= 16 || col <= -16) {
+        return 0;
+    }
+    return (uint16_t)((col >= 0) ? (unsigned)bits << col : (unsigned)bits >> -col);
+}
+
+static void rebuild_columns(BitBoard *board) {
+    memset(board->columns, 0, sizeof(board->columns));
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (uint16_t bits = board->rows[row]; bits != 0; bits &= (uint16_t)(bits - 1)) {
+            board->columns[__builtin_ctz(bits)] |= 1U << row;
+        }
+    }
+}
+
+void bitboard_reset(BitBoard *board) {
+    if (board == NULL) {
+        return;
+    }
+
+    memset(board, 0, sizeof(*board));
+}
+
+void bitboard_from_board(BitBoard *board, const Board *source) {
+    if (board == NULL || source == NULL) {
+        return;
+    }
+
+    board->board = *source;
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        uint16_t bits = 0;
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            bits |= (uint16_t)((source->cells[row][col] != 0) << col);
+        }
+        board->rows[row] = bits;
+    }
+    rebuild_columns(board);
+}
+
+// Same rules as board_can_place: walls extend above the board, rows above it are free.
+bool bitboard_can_place(const BitBoard *board,
+                        const PieceShape *shape,
+                        int rotation,
+                        int test_row,
+                        int test_col) {
+    if (board == NULL || shape == NULL || rotation < 0 || rotation >= shape->rotation_count) {
+        return false;
+    }
+
+    metrics_inc(METRIC_COLLISION_CHECKS);
+    BitShape scratch;
+    const BitShape *bits = bit_shape(shape, rotation, &scratch);
+    if (bits->bottom < 0) {
+        return true;
+    }
+    if (test_col + bits->left < 0 || test_col + bits->right >= BOARD_WIDTH || test_row + bits->bottom >= BOARD_HEIGHT) {
+        return false;
+    }
+
+    int first = (test_row + bits->top < 0) ? -test_row : bits->top;
+    for (int r = first; r <= bits->bottom; ++r) {
+        if ((board->rows[test_row + r] & shift_row(bits->rows[r], test_col)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void bitboard_lock_shape(BitBoard *board,
+                         const PieceShape *shape,
+                         int rotation,
+                         int base_row,
+                         int base_col,
+                         int value) {
+    if (board == NULL || shape == NULL || rotation < 0 || rotation >= shape->rotation_count) {
+        return;
+    }
+
+    BitShape scratch;
+    const BitShape *bits = bit_shape(shape, rotation, &scratch);
+    for (int r = bits->top; r <= bits->bottom; ++r) {
+        int row = base_row + r;
+        if (row < 0 || row >= BOARD_HEIGHT) {
+            continue;
+        }
+        // Cells past the left wall fall off the shift; cells past the right wall are masked.
+        uint16_t mask = shift_row(bits->rows[r], base_col) & BITBOARD_FULL_ROW;
+        for (uint16_t rest = mask; rest != 0; rest &= (uint16_t)(rest - 1)) {
+            int col = __builtin_ctz(rest);
+            board->board.cells[row][col] = value;
+            if (value != 0) {
+                board->columns[col] |= 1U << row;
+            } else {
+                board->columns[col] &= ~(1U << row);
+            }
+        }
+        board->rows[row] = (value != 0) ? (uint16_t)(board->rows[row] | mask) : (uint16_t)(board->rows[row] & ~mask);
+    }
+}
+
+// One bottom-up compaction pass. rows_out matches the reference, which re-checks a row
+// index after each shift: a full row is reported at its index plus the full rows below it.
+int bitboard_clear_completed_lines(BitBoard *board, int *rows_out, int max_rows) {
+    if (board == NULL) {
+        return 0;
+    }
+
+    int cleared = 0;
+    int write = BOARD_HEIGHT - 1;
+    for (int row = BOARD_HEIGHT - 1; row >= 0; --row) {
+        if (board->rows[row] == BITBOARD_FULL_ROW) {
+            if (rows_out != NULL && cleared < max_rows) {
+                rows_out[cleared] = row + cleared;
+            }
+            ++cleared;
+            continue;
+        }
+        if (write != row) {
+            board->rows[write] = board->rows[row];
+            memcpy(board->board.cells[write], board->board.cells[row], sizeof(board->board.cells[row]));
+        }
+        --write;
+    }
+    if (cleared == 0) {
+        return 0;
+    }
+
+    for (int row = write; row >= 0; --row) {
+        board->rows[row] = 0;
+        memset(board->board.cells[row], 0, sizeof(board->board.cells[row]));
+    }
+    rebuild_columns(board);
+    return cleared;
+}
+
+bool bitboard_insert_garbage(BitBoard *board, int lines, int hole_col, int value) {
+    if (board == NULL || lines <= 0) {
+        return false;
+    }
+    if (lines > BOARD_HEIGHT) {
+        lines = BOARD_HEIGHT;
+    }
+
+    bool topped_out = false;
+    for (int row = 0; row < lines; ++row) {
+        topped_out = topped_out || board->rows[row] != 0;
+    }
+
+    memmove(board->board.cells[0], board->board.cells[lines],
+            sizeof(board->board.cells[0]) * (size_t)(BOARD_HEIGHT - lines));
+    memmove(board->rows, board->rows + lines, sizeof(board->rows[0]) * (size_t)(BOARD_HEIGHT - lines));
+    uint16_t garbage = 0;
+    if (value != 0) {
+        garbage = (hole_col >= 0 && hole_col < BOARD_WIDTH) ? (uint16_t)(BITBOARD_FULL_ROW & ~(1U << hole_col))
+                                                            : BITBOARD_FULL_ROW;
+    }
+    for (int row = BOARD_HEIGHT - lines; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            board->board.cells[row][col] = (col == hole_col) ? 0 : value;
+        }
+        board->rows[row] = garbage;
+    }
+
+    uint32_t bottom = ((1U << lines) - 1U) << (BOARD_HEIGHT - lines);
+    for (int col = 0; col < BOARD_WIDTH; ++col) {
+        board->columns[col] = (board->columns[col] >> lines) | (((garbage >> col) & 1U) ? bottom : 0U);
+    }
+    return topped_out;
+}
+
+bool bitboard_is_empty(const BitBoard *board) {
+    if (board == NULL) {
+        return true;
+    }
+    uint16_t any = 0;
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        any |= board->rows[row];
+    }
+    return any == 0;
+}
+
+// Same scan as board_drop_distance, answered per column from the column mask: the first
+// occupied row at or below the cell under the piece's lowest cell.
+int bitboard_drop_distance(const BitBoard *board, const PieceShape *shape, int rotation, int row, int col) {
+    if (board == NULL || shape == NULL || rotation < 0 || rotation >= shape->rotation_count) {
+        return 0;
+    }
+
+    BitShape scratch;
+    const BitShape *bits = bit_shape(shape, rotation, &scratch);
+    int distance = BOARD_HEIGHT + shape->size;
+    bool any = false;
+    for (int local_col = 0; local_col < shape->size && local_col < 4; ++local_col) {
+        int board_col = col + local_col;
+        if (bits->lowest[local_col] < 0 || board_col < 0 || board_col >= BOARD_WIDTH) {
+            continue;
+        }
+
+        int start = row + bits->lowest[local_col] + 1;
+        int free_row = start;
+        if (start < BOARD_HEIGHT) {
+            int from = (start < 0) ? 0 : start;
+            uint32_t below = board->columns[board_col] & ~((1U << from) - 1U);
+            free_row = (below != 0) ? __builtin_ctz(below) : BOARD_HEIGHT;
+        }
+        if (free_row - start < distance) {
+            distance = free_row - start;
+        }
+        any = true;
+    }
+    return any ? distance : 0;
+}
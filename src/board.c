@@ -1,6 +1,7 @@
 #include <string.h>
 
 #include "board.h"
+#include "metrics.h"
 
 // Core board helpers: reset, collision detection, locking, and line clears.
 
@@ -22,6 +23,7 @@ bool board_can_place(const Board *board,
         return false;
     }
 
+    metrics_inc(METRIC_COLLISION_CHECKS);
     const char *pattern = shape->rotations[rotation];
 
     for (int r = 0; r < shape->size; ++r) {
@@ -33,14 +35,15 @@ bool board_can_place(const Board *board,
             int board_row = test_row + r;
             int board_col = test_col + c;
 
-            if (board_row < 0) {
-                continue;
-            }
-
+            // Side walls extend above the visible board; only the floor/stack test is skipped there.
             if (board_col < 0 || board_col >= BOARD_WIDTH || board_row >= BOARD_HEIGHT) {
                 return false;
             }
 
+            if (board_row < 0) {
+                continue;
+            }
+
             if (board->cells[board_row][board_col] != 0) {
                 return false;
             }
@@ -116,3 +119,122 @@ int board_clear_completed_lines(Board *board, int *rows_out, int max_rows) {
 
     return cleared;
 }
+
+// Push the stack up by `lines` and fill the bottom rows with garbage (every column but
+// hole_col). The board is row-major, so the shift is a single memmove. Returns true when
+// occupied cells were pushed off the top, i.e. the player topped out.
+bool board_insert_garbage(Board *board, int lines, int hole_col, int value) {
+    if (board == NULL || lines <= 0) {
+        return false;
+    }
+    if (lines > BOARD_HEIGHT) {
+        lines = BOARD_HEIGHT;
+    }
+
+    bool topped_out = false;
+    for (int row = 0; row < lines && !topped_out; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            if (board->cells[row][col] != 0) {
+                topped_out = true;
+                break;
+            }
+        }
+    }
+
+    memmove(board->cells[0], board->cells[lines], sizeof(board->cells[0]) * (size_t)(BOARD_HEIGHT - lines));
+    for (int row = BOARD_HEIGHT - lines; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            board->cells[row][col] = (col == hole_col) ? 0 : value;
+        }
+    }
+    return topped_out;
+}
+
+// Perfect-clear check. Scans from the bottom row, where a non-empty board almost always
+// has a cell, so the common case is a handful of reads.
+bool board_is_empty(const Board *board) {
+    if (board == NULL) {
+        return true;
+    }
+    for (int row = BOARD_HEIGHT - 1; row >= 0; --row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            if (board->cells[row][col] != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Rows a shape placed at (row, col) can fall before it collides. Tetromino columns have no
+// gaps, so each occupied column only needs a scan down from its lowest cell: one query
+// whatever the distance, instead of a board_can_place per row.
+int board_drop_distance(const Board *board, const PieceShape *shape, int rotation, int row, int col) {
+    if (board == NULL || shape == NULL || rotation < 0 || rotation >= shape->rotation_count) {
+        return 0;
+    }
+
+    int distance = BOARD_HEIGHT + shape->size;
+    bool any = false;
+    for (int local_col = 0; local_col < shape->size; ++local_col) {
+        int lowest = -1;
+        for (int local_row = shape->size - 1; local_row >= 0; --local_row) {
+            if (piece_shape_cell_filled(shape, rotation, local_row, local_col)) {
+                lowest = local_row;
+                break;
+            }
+        }
+        int board_col = col + local_col;
+        if (lowest < 0 || board_col < 0 || board_col >= BOARD_WIDTH) {
+            continue;
+        }
+
+        int start = row + lowest + 1;
+        int free_row = start;
+        while (free_row < BOARD_HEIGHT && (free_row < 0 || board->cells[free_row][board_col] == 0)) {
+            ++free_row;
+        }
+        if (free_row - start < distance) {
+            distance = free_row - start;
+        }
+        any = true;
+    }
+    return any ? distance : 0;
+}
+
+// Translate a piece if the destination is free; the piece is left untouched otherwise.
+bool board_try_move_piece(const Board *board, ActivePiece *piece, int drow, int dcol) {
+    if (board == NULL || piece == NULL || !piece->active) {
+        return false;
+    }
+
+    const PieceShape *shape = piece_shape_get((size_t)piece->type);
+    int next_row = piece->row + drow;
+    int next_col = piece->col + dcol;
+    if (!board_can_place(board, shape, piece->rotation, next_row, next_col)) {
+        return false;
+    }
+
+    piece->row = next_row;
+    piece->col = next_col;
+    return true;
+}
+
+// Rotate in place (no wall kicks); the piece is left untouched if the new orientation collides.
+bool board_try_rotate_piece(const Board *board, ActivePiece *piece, int direction) {
+    if (board == NULL || piece == NULL || !piece->active) {
+        return false;
+    }
+
+    const PieceShape *shape = piece_shape_get((size_t)piece->type);
+    if (shape == NULL) {
+        return false;
+    }
+    int next_rotation = (piece->rotation + direction + shape->rotation_count) % shape->rotation_count;
+    if (!board_can_place(board, shape, next_rotation, piece->row, piece->col)) {
+        return false;
+    }
+
+    piece->rotation = next_rotation;
+    return true;
+}
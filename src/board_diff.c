@@ -0,0 +1,687 @@
+#include "board_diff.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitboard.h"
+#include "engine.h"
+
+// Backend tables, operation streams, the lockstep checker, and the stream minimizer.
+
+#define BOARD_DIFF_SEED_STEP 0x9E3779B97F4A7C15ULL
+
+// --- Backends ------------------------------------------------------------------------------
+
+static void reference_reset(void *state) {
+    board_reset(state);
+}
+
+static void reference_load(void *state, const Board *source) {
+    *(Board *)state = *source;
+}
+
+static bool reference_can_place(const void *state, const PieceShape *shape, int rotation, int row, int col) {
+    return board_can_place(state, shape, rotation, row, col);
+}
+
+static void reference_lock_shape(void *state, const PieceShape *shape, int rotation, int row, int col, int value) {
+    board_lock_shape(state, shape, rotation, row, col, value);
+}
+
+static int reference_clear_lines(void *state, int *rows_out, int max_rows) {
+    return board_clear_completed_lines(state, rows_out, max_rows);
+}
+
+static bool reference_insert_garbage(void *state, int lines, int hole_col, int value) {
+    return board_insert_garbage(state, lines, hole_col, value);
+}
+
+static int reference_drop_distance(const void *state, const PieceShape *shape, int rotation, int row, int col) {
+    return board_drop_distance(state, shape, rotation, row, col);
+}
+
+static bool reference_is_empty(const void *state) {
+    return board_is_empty(state);
+}
+
+static const Board *reference_cells(const void *state, Board *scratch) {
+    (void)scratch;
+    return state;
+}
+
+static void bitboard_backend_reset(void *state) {
+    bitboard_reset(state);
+}
+
+static void bitboard_backend_load(void *state, const Board *source) {
+    bitboard_from_board(state, source);
+}
+
+static bool bitboard_backend_can_place(const void *state, const PieceShape *shape, int rotation, int row, int col) {
+    return bitboard_can_place(state, shape, rotation, row, col);
+}
+
+static void bitboard_backend_lock_shape(void *state, const PieceShape *shape, int rotation, int row, int col,
+                                        int value) {
+    bitboard_lock_shape(state, shape, rotation, row, col, value);
+}
+
+static int bitboard_backend_clear_lines(void *state, int *rows_out, int max_rows) {
+    return bitboard_clear_completed_lines(state, rows_out, max_rows);
+}
+
+static bool bitboard_backend_insert_garbage(void *state, int lines, int hole_col, int value) {
+    return bitboard_insert_garbage(state, lines, hole_col, value);
+}
+
+static int bitboard_backend_drop_distance(const void *state, const PieceShape *shape, int rotation, int row, int col) {
+    return bitboard_drop_distance(state, shape, rotation, row, col);
+}
+
+static bool bitboard_backend_is_empty(const void *state) {
+    return bitboard_is_empty(state);
+}
+
+static const Board *bitboard_backend_cells(const void *state, Board *scratch) {
+    (void)scratch;
+    return &((const BitBoard *)state)->board;
+}
+
+const BoardBackend *board_backend_reference(void) {
+    static const BoardBackend k_reference = {
+        "reference",
+        sizeof(Board),
+        reference_reset,
+        reference_load,
+        reference_can_place,
+        reference_lock_shape,
+        reference_clear_lines,
+        reference_insert_garbage,
+        reference_drop_distance,
+        reference_is_empty,
+        reference_cells,
+    };
+    return &k_reference;
+}
+
+const BoardBackend *board_backend_bitboard(void) {
+    static const BoardBackend k_bitboard = {
+        "bitboard",
+        sizeof(BitBoard),
+        bitboard_backend_reset,
+        bitboard_backend_load,
+        bitboard_backend_can_place,
+        bitboard_backend_lock_shape,
+        bitboard_backend_clear_lines,
+        bitboard_backend_insert_garbage,
+        bitboard_backend_drop_distance,
+        bitboard_backend_is_empty,
+        bitboard_backend_cells,
+    };
+    return &k_bitboard;
+}
+
+// --- Streams -------------------------------------------------------------------------------
+
+void board_op_stream_init(BoardOpStream *stream) {
+    if (stream != NULL) {
+        memset(stream, 0, sizeof(*stream));
+    }
+}
+
+void board_op_stream_free(BoardOpStream *stream) {
+    if (stream == NULL) {
+        return;
+    }
+    free(stream->ops);
+    free(stream->boards);
+    memset(stream, 0, sizeof(*stream));
+}
+
+int board_op_stream_append(BoardOpStream *stream, const BoardOp *op) {
+    if (stream == NULL || op == NULL) {
+        return -1;
+    }
+    if (stream->count == stream->capacity) {
+        size_t capacity = (stream->capacity > 0) ? stream->capacity * 2 : 1024;
+        BoardOp *ops = realloc(stream->ops, capacity * sizeof(*ops));
+        if (ops == NULL) {
+            return -1;
+        }
+        stream->ops = ops;
+        stream->capacity = capacity;
+    }
+    stream->ops[stream->count++] = *op;
+    return 0;
+}
+
+int board_op_stream_add_board(BoardOpStream *stream, const uint16_t *rows, uint32_t *index_out) {
+    if (stream == NULL || rows == NULL || stream->board_count >= UINT32_MAX) {
+        return -1;
+    }
+    if (stream->board_count == stream->board_capacity) {
+        size_t capacity = (stream->board_capacity > 0) ? stream->board_capacity * 2 : 64;
+        uint16_t(*boards)[BOARD_HEIGHT] = realloc(stream->boards, capacity * sizeof(*boards));
+        if (boards == NULL) {
+            return -1;
+        }
+        stream->boards = boards;
+        stream->board_capacity = capacity;
+    }
+    memcpy(stream->boards[stream->board_count], rows, sizeof(stream->boards[0]));
+    if (index_out != NULL) {
+        *index_out = (uint32_t)stream->board_count;
+    }
+    ++stream->board_count;
+    return 0;
+}
+
+static bool op_mutates(const BoardOp *op) {
+    return op->kind == BOARD_OP_RESET || op->kind == BOARD_OP_LOAD || op->kind == BOARD_OP_LOCK ||
+           op->kind == BOARD_OP_CLEAR || op->kind == BOARD_OP_GARBAGE;
+}
+
+void board_diff_apply(const BoardBackend *backend, void *state, const BoardOpStream *stream, const BoardOp *op,
+                      BoardOpResult *result) {
+    const PieceShape *shape = piece_shape_get((size_t)(op->type >= 0 ? op->type : 0));
+    result->value = 0;
+    switch ((BoardOpKind)op->kind) {
+        case BOARD_OP_RESET:
+            backend->reset(state);
+            break;
+        case BOARD_OP_LOAD: {
+            Board source;
+            board_reset(&source);
+            const uint16_t *rows = (op->load < stream->board_count) ? stream->boards[op->load] : NULL;
+            for (int row = 0; rows != NULL && row < BOARD_HEIGHT; ++row) {
+                for (int col = 0; col < BOARD_WIDTH; ++col) {
+                    source.cells[row][col] = ((rows[row] >> col) & 1U) ? op->value : 0;
+                }
+            }
+            backend->load(state, &source);
+            break;
+        }
+        case BOARD_OP_CAN_PLACE:
+            result->value = backend->can_place(state, shape, op->rotation, op->row, op->col);
+            break;
+        case BOARD_OP_DROP_DISTANCE:
+            result->value = backend->drop_distance(state, shape, op->rotation, op->row, op->col);
+            break;
+        case BOARD_OP_LOCK:
+            backend->lock_shape(state, shape, op->rotation, op->row, op->col, op->value);
+            break;
+        case BOARD_OP_CLEAR:
+            result->value = backend->clear_lines(state, result->rows, BOARD_HEIGHT);
+            break;
+        case BOARD_OP_GARBAGE:
+            result->value = backend->insert_garbage(state, op->lines, op->col, op->value);
+            break;
+        case BOARD_OP_IS_EMPTY:
+            result->value = backend->is_empty(state);
+            break;
+        case BOARD_OP_KIND_COUNT:
+            break;
+    }
+}
+
+// --- Stream generation ---------------------------------------------------------------------
+
+static uint64_t next_random(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+static int random_between(uint64_t *rng, int low, int high) {
+    return low + (int)(next_random(rng) % (uint64_t)(high - low + 1));
+}
+
+// Append an op and play it on the steering board, returning its result value.
+static int emit(BoardOpStream *stream, Board *steer, const BoardOp *op, bool *failed) {
+    if (board_op_stream_append(stream, op) != 0) {
+        *failed = true;
+        return 0;
+    }
+    BoardOpResult result;
+    board_diff_apply(board_backend_reference(), steer, stream, op, &result);
+    return result.value;
+}
+
+// Random operations, mostly legal drops from the spawn row that lock onto the stack and
+// clear lines, mixed with probes and locks at arbitrary (also off-board) positions,
+// garbage, loads of random stacks, and resets once the stack nears the top.
+int board_diff_random_stream(BoardOpStream *stream, uint64_t seed, size_t count) {
+    if (stream == NULL) {
+        return -1;
+    }
+    stream->count = 0;
+    stream->board_count = 0;
+    uint64_t rng = (seed ^ 0xA0761D6478BD642FULL) | 1ULL;
+    Board steer;
+    board_reset(&steer);
+    bool failed = false;
+
+    while (stream->count < count && !failed) {
+        BoardOp op;
+        memset(&op, 0, sizeof(op));
+        op.type = (int8_t)random_between(&rng, 0, (int)piece_shape_count() - 1);
+        const PieceShape *shape = piece_shape_get((size_t)op.type);
+        op.rotation = (int8_t)random_between(&rng, 0, shape->rotation_count - 1);
+        int roll = random_between(&rng, 0, 99);
+
+        bool near_top = false;
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            near_top = near_top || steer.cells[2][col] != 0;
+        }
+        if (near_top || roll >= 98) {
+            op.kind = BOARD_OP_RESET;
+            emit(stream, &steer, &op, &failed);
+        } else if (roll < 50) {
+            op.kind = BOARD_OP_CAN_PLACE;
+            op.row = -2;
+            op.col = (int8_t)random_between(&rng, -2, BOARD_WIDTH - 1);
+            if (emit(stream, &steer, &op, &failed)) {
+                op.kind = BOARD_OP_DROP_DISTANCE;
+                op.row = (int8_t)(op.row + emit(stream, &steer, &op, &failed));
+                op.kind = BOARD_OP_LOCK;
+                op.value = (int16_t)(op.type + 1);
+                emit(stream, &steer, &op, &failed);
+                op.kind = BOARD_OP_CLEAR;
+                emit(stream, &steer, &op, &failed);
+            }
+        } else if (roll < 82) {
+            op.kind = (roll < 70) ? BOARD_OP_CAN_PLACE : BOARD_OP_DROP_DISTANCE;
+            op.row = (int8_t)random_between(&rng, -4, BOARD_HEIGHT + 1);
+            op.col = (int8_t)random_between(&rng, -4, BOARD_WIDTH + 1);
+            emit(stream, &steer, &op, &failed);
+        } else if (roll < 87) {
+            op.kind = BOARD_OP_LOCK;
+            op.row = (int8_t)random_between(&rng, -4, BOARD_HEIGHT + 1);
+            op.col = (int8_t)random_between(&rng, -4, BOARD_WIDTH + 1);
+            op.value = (int16_t)random_between(&rng, 0, ENGINE_GARBAGE_CELL + 1);
+            emit(stream, &steer, &op, &failed);
+            op.kind = BOARD_OP_CLEAR;
+            emit(stream, &steer, &op, &failed);
+        } else if (roll < 91) {
+            op.kind = BOARD_OP_GARBAGE;
+            op.lines = (int8_t)random_between(&rng, -1, 4);
+            op.lines = (roll == 90) ? (int8_t)random_between(&rng, 5, BOARD_HEIGHT + 2) : op.lines;
+            op.col = (int8_t)random_between(&rng, -1, BOARD_WIDTH);
+            op.value = (int16_t)random_between(&rng, 0, ENGINE_GARBAGE_CELL);
+            emit(stream, &steer, &op, &failed);
+        } else if (roll < 95) {
+            op.kind = BOARD_OP_IS_EMPTY;
+            emit(stream, &steer, &op, &failed);
+        } else {
+            // A random stack, sometimes with full rows so the next clear has work to do.
+            uint16_t rows[BOARD_HEIGHT];
+            int top = random_between(&rng, 4, BOARD_HEIGHT);
+            for (int row = 0; row < BOARD_HEIGHT; ++row) {
+                uint16_t bits = (uint16_t)(next_random(&rng) & ((1U << BOARD_WIDTH) - 1U));
+                bits = (next_random(&rng) % 4 == 0) ? (uint16_t)((1U << BOARD_WIDTH) - 1U) : bits;
+                rows[row] = (row >= top) ? bits : 0;
+            }
+            op.kind = BOARD_OP_LOAD;
+            op.value = (int16_t)random_between(&rng, 1, ENGINE_GARBAGE_CELL);
+            if (board_op_stream_add_board(stream, rows, &op.load) != 0) {
+                return -1;
+            }
+            emit(stream, &steer, &op, &failed);
+        }
+    }
+    // A drop emits several ops at once; cut the overshoot so streams have exactly `count`.
+    stream->count = (stream->count > count) ? count : stream->count;
+    return failed ? -1 : 0;
+}
+
+// Operations derived from recorded placements: load each record's stack, probe the piece
+// from the spawn row and at its placement, lock it there, and clear.
+int board_diff_replay_stream(BoardOpStream *stream, const DatasetView *view, uint64_t first_record, size_t count) {
+    if (stream == NULL || view == NULL || view->header == NULL) {
+        return -1;
+    }
+    stream->count = 0;
+    stream->board_count = 0;
+
+    for (uint64_t index = first_record; index < first_record + count && index < view->header->record_count; ++index) {
+        DatasetRecord record;
+        if (dataset_view_record(view, index, &record) != 0) {
+            return -1;
+        }
+        const PieceShape *shape = piece_shape_get((size_t)(record.piece >= 0 ? record.piece : 0));
+        if (record.piece < 0 || shape == NULL || record.rotation < 0 || record.rotation >= shape->rotation_count) {
+            continue;
+        }
+
+        BoardOp op;
+        memset(&op, 0, sizeof(op));
+        op.kind = BOARD_OP_LOAD;
+        op.value = ENGINE_GARBAGE_CELL;
+        if (board_op_stream_add_board(stream, record.board, &op.load) != 0 || board_op_stream_append(stream, &op) != 0) {
+            return -1;
+        }
+        op.type = record.piece;
+        op.rotation = record.rotation;
+        op.col = record.col;
+        static const uint8_t k_probes[] = {BOARD_OP_CAN_PLACE, BOARD_OP_DROP_DISTANCE};
+        for (size_t p = 0; p < sizeof(k_probes); ++p) {
+            op.kind = k_probes[p];
+            op.row = -2;
+            if (board_op_stream_append(stream, &op) != 0) {
+                return -1;
+            }
+        }
+        static const uint8_t k_place[] = {BOARD_OP_CAN_PLACE, BOARD_OP_LOCK, BOARD_OP_CLEAR, BOARD_OP_IS_EMPTY};
+        for (size_t p = 0; p < sizeof(k_place); ++p) {
+            op.kind = k_place[p];
+            op.row = record.row;
+            op.value = (int16_t)(record.piece + 1);
+            if (board_op_stream_append(stream, &op) != 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+// --- Checking ------------------------------------------------------------------------------
+
+// Run the first `limit` ops on the reference and the candidate side by side. Returns the
+// index of the first op whose result differs or that leaves different cells, or
+// BOARD_DIFF_NO_DIVERGENCE.
+size_t board_diff_check(const BoardBackend *candidate, const BoardOpStream *stream, size_t limit) {
+    if (candidate == NULL || stream == NULL) {
+        return BOARD_DIFF_NO_DIVERGENCE;
+    }
+    const BoardBackend *reference = board_backend_reference();
+    Board expected;
+    void *actual = malloc(candidate->state_size);
+    if (actual == NULL) {
+        return BOARD_DIFF_NO_DIVERGENCE;
+    }
+    reference->reset(&expected);
+    candidate->reset(actual);
+
+    size_t end = (limit < stream->count) ? limit : stream->count;
+    size_t divergence = BOARD_DIFF_NO_DIVERGENCE;
+    for (size_t i = 0; i < end; ++i) {
+        const BoardOp *op = &stream->ops[i];
+        BoardOpResult want;
+        BoardOpResult got;
+        board_diff_apply(reference, &expected, stream, op, &want);
+        board_diff_apply(candidate, actual, stream, op, &got);
+        bool same = want.value == got.value;
+        if (same && op->kind == BOARD_OP_CLEAR) {
+            size_t reported = (size_t)(want.value < BOARD_HEIGHT ? want.value : BOARD_HEIGHT);
+            same = memcmp(want.rows, got.rows, reported * sizeof(int)) == 0;
+        }
+        if (same && op_mutates(op)) {
+            Board scratch;
+            same = memcmp(&expected, candidate->cells(actual, &scratch), sizeof(Board)) == 0;
+        }
+        if (!same) {
+            divergence = i;
+            break;
+        }
+    }
+    free(actual);
+    return divergence;
+}
+
+// View of a subsequence of a stream's ops, sharing its LOAD boards.
+static size_t check_ops(const BoardBackend *candidate, const BoardOpStream *stream, const BoardOp *ops, size_t count) {
+    BoardOpStream view = *stream;
+    view.ops = (BoardOp *)ops;
+    view.count = count;
+    return board_diff_check(candidate, &view, count);
+}
+
+// Cut a diverging stream down to a short reproducer. Everything before the last reset or
+// load ahead of the divergence cannot matter; the rest goes through delta debugging
+// (drop ever smaller chunks while the streams still diverge) and is truncated at its own
+// first divergence. The result owns copies of the boards its loads use.
+int board_diff_minimize(const BoardBackend *candidate, const BoardOpStream *stream, size_t divergence,
+                        BoardOpStream *out) {
+    if (candidate == NULL || stream == NULL || out == NULL || divergence >= stream->count) {
+        return -1;
+    }
+    board_op_stream_init(out);
+
+    size_t start = divergence;
+    while (start > 0 && stream->ops[start].kind != BOARD_OP_RESET && stream->ops[start].kind != BOARD_OP_LOAD) {
+        --start;
+    }
+    size_t length = divergence - start + 1;
+    BoardOp *ops = malloc(length * sizeof(*ops));
+    BoardOp *trial = malloc(length * sizeof(*trial));
+    if (ops == NULL || trial == NULL) {
+        free(ops);
+        free(trial);
+        return -1;
+    }
+    memcpy(ops, stream->ops + start, length * sizeof(*ops));
+    if (check_ops(candidate, stream, ops, length) == BOARD_DIFF_NO_DIVERGENCE) {
+        // The divergence depends on earlier state after all; keep the whole prefix.
+        free(ops);
+        free(trial);
+        ops = malloc((divergence + 1) * sizeof(*ops));
+        trial = malloc((divergence + 1) * sizeof(*trial));
+        if (ops == NULL || trial == NULL) {
+            free(ops);
+            free(trial);
+            return -1;
+        }
+        length = divergence + 1;
+        memcpy(ops, stream->ops, length * sizeof(*ops));
+    }
+
+    size_t chunks = 2;
+    while (length > 1) {
+        size_t chunk = (length + chunks - 1) / chunks;
+        bool removed = false;
+        for (size_t first = 0; first < length; first += chunk) {
+            size_t last = (first + chunk < length) ? first + chunk : length;
+            size_t kept = 0;
+            memcpy(trial, ops, first * sizeof(*ops));
+            kept += first;
+            memcpy(trial + kept, ops + last, (length - last) * sizeof(*ops));
+            kept += length - last;
+            size_t found = check_ops(candidate, stream, trial, kept);
+            if (kept > 0 && found != BOARD_DIFF_NO_DIVERGENCE) {
+                length = found + 1;
+                memcpy(ops, trial, length * sizeof(*ops));
+                removed = true;
+                break;
+            }
+        }
+        if (removed) {
+            chunks = (chunks > 2) ? chunks - 1 : 2;
+        } else if (chunk == 1) {
+            break;
+        } else {
+            chunks = (chunks * 2 < length) ? chunks * 2 : length;
+        }
+    }
+
+    int status = 0;
+    for (size_t i = 0; i < length && status == 0; ++i) {
+        BoardOp op = ops[i];
+        if (op.kind == BOARD_OP_LOAD && op.load < stream->board_count) {
+            status = board_op_stream_add_board(out, stream->boards[op.load], &op.load);
+        }
+        status = (status == 0) ? board_op_stream_append(out, &op) : status;
+    }
+    free(ops);
+    free(trial);
+    if (status != 0) {
+        board_op_stream_free(out);
+    }
+    return status;
+}
+
+// One op as a line of text, e.g. "lock T rot 2 row 17 col 3 value 3".
+int board_diff_format_op(const BoardOp *op, const BoardOpStream *stream, char *buffer, size_t capacity) {
+    if (op == NULL || buffer == NULL || capacity == 0) {
+        return -1;
+    }
+    static const char k_pieces[] = "IOTLJSZ";
+    char piece = (op->type >= 0 && op->type < 7) ? k_pieces[op->type] : '?';
+    switch ((BoardOpKind)op->kind) {
+        case BOARD_OP_RESET:
+            return snprintf(buffer, capacity, "reset");
+        case BOARD_OP_LOAD: {
+            int used = snprintf(buffer, capacity, "load value %d rows", op->value);
+            for (int row = 0; row < BOARD_HEIGHT && stream != NULL && op->load < stream->board_count &&
+                              used >= 0 && (size_t)used < capacity;
+                 ++row) {
+                used += snprintf(buffer + used, capacity - (size_t)used, " %03x", stream->boards[op->load][row]);
+            }
+            return used;
+        }
+        case BOARD_OP_CAN_PLACE:
+            return snprintf(buffer, capacity, "can_place %c rot %d row %d col %d", piece, op->rotation, op->row,
+                            op->col);
+        case BOARD_OP_DROP_DISTANCE:
+            return snprintf(buffer, capacity, "drop_distance %c rot %d row %d col %d", piece, op->rotation, op->row,
+                            op->col);
+        case BOARD_OP_LOCK:
+            return snprintf(buffer, capacity, "lock %c rot %d row %d col %d value %d", piece, op->rotation, op->row,
+                            op->col, op->value);
+        case BOARD_OP_CLEAR:
+            return snprintf(buffer, capacity, "clear");
+        case BOARD_OP_GARBAGE:
+            return snprintf(buffer, capacity, "garbage lines %d hole %d value %d", op->lines, op->col, op->value);
+        case BOARD_OP_IS_EMPTY:
+            return snprintf(buffer, capacity, "is_empty");
+        case BOARD_OP_KIND_COUNT:
+            break;
+    }
+    return snprintf(buffer, capacity, "unknown op %d", op->kind);
+}
+
+// --- Parallel runs -------------------------------------------------------------------------
+
+typedef struct {
+    const BoardBackend *candidate;
+    const BoardDiffConfig *config;
+    int streams;
+    _Atomic int next_stream;
+    _Atomic uint64_t ops;
+    _Atomic int failing_stream; // lowest diverging stream so far, INT32_MAX if none
+    pthread_mutex_t lock;
+    size_t failing_op;
+    bool failed; // a stream could not be built
+} BoardDiffJobs;
+
+static int build_stream(const BoardDiffConfig *config, int index, BoardOpStream *stream) {
+    if (config->replay != NULL) {
+        return board_diff_replay_stream(stream, config->replay, (uint64_t)index * config->records_per_stream,
+                                        config->records_per_stream);
+    }
+    return board_diff_random_stream(stream, config->seed + (uint64_t)index * BOARD_DIFF_SEED_STEP,
+                                    config->ops_per_stream);
+}
+
+// Threads take streams off a shared counter; once one diverges, streams after it are
+// skipped, and the lowest diverging stream is the one reported whatever the thread count.
+static void *check_streams(void *arg) {
+    BoardDiffJobs *jobs = arg;
+    BoardOpStream stream;
+    board_op_stream_init(&stream);
+    for (;;) {
+        int index = atomic_fetch_add_explicit(&jobs->next_stream, 1, memory_order_relaxed);
+        if (index >= jobs->streams || index > atomic_load_explicit(&jobs->failing_stream, memory_order_relaxed)) {
+            break;
+        }
+        if (build_stream(jobs->config, index, &stream) != 0) {
+            pthread_mutex_lock(&jobs->lock);
+            jobs->failed = true;
+            pthread_mutex_unlock(&jobs->lock);
+            break;
+        }
+        size_t divergence = board_diff_check(jobs->candidate, &stream, stream.count);
+        uint64_t checked = (divergence == BOARD_DIFF_NO_DIVERGENCE) ? stream.count : divergence + 1;
+        atomic_fetch_add_explicit(&jobs->ops, checked, memory_order_relaxed);
+        if (divergence != BOARD_DIFF_NO_DIVERGENCE) {
+            pthread_mutex_lock(&jobs->lock);
+            if (index < atomic_load_explicit(&jobs->failing_stream, memory_order_relaxed)) {
+                atomic_store_explicit(&jobs->failing_stream, index, memory_order_relaxed);
+                jobs->failing_op = divergence;
+            }
+            pthread_mutex_unlock(&jobs->lock);
+        }
+    }
+    board_op_stream_free(&stream);
+    return NULL;
+}
+
+// Check `config->streams` streams against the reference on all requested threads, and
+// minimize the first divergence into report->reproducer. The calling thread works
+// alongside the helpers, so a helper that fails to start only costs speed.
+int board_diff_run(const BoardBackend *candidate, const BoardDiffConfig *config, BoardDiffReport *report) {
+    if (candidate == NULL || config == NULL || report == NULL || config->streams < 1 ||
+        (config->replay == NULL && config->ops_per_stream == 0) ||
+        (config->replay != NULL && config->records_per_stream == 0)) {
+        return -1;
+    }
+    memset(report, 0, sizeof(*report));
+    report->failing_stream = -1;
+
+    BoardDiffJobs jobs;
+    jobs.candidate = candidate;
+    jobs.config = config;
+    jobs.streams = config->streams;
+    if (config->replay != NULL) {
+        uint64_t records = config->replay->header->record_count;
+        uint64_t available = (records + config->records_per_stream - 1) / config->records_per_stream;
+        jobs.streams = (available < (uint64_t)jobs.streams) ? (int)available : jobs.streams;
+    }
+    atomic_init(&jobs.next_stream, 0);
+    atomic_init(&jobs.ops, 0);
+    atomic_init(&jobs.failing_stream, INT32_MAX);
+    pthread_mutex_init(&jobs.lock, NULL);
+    jobs.failing_op = 0;
+    jobs.failed = false;
+
+    int helpers = (config->threads < 1) ? 0 : config->threads - 1;
+    if (helpers > BOARD_DIFF_MAX_THREADS - 1) {
+        helpers = BOARD_DIFF_MAX_THREADS - 1;
+    }
+    pthread_t threads[BOARD_DIFF_MAX_THREADS];
+    int started = 0;
+    while (started < helpers && pthread_create(&threads[started], NULL, check_streams, &jobs) == 0) {
+        ++started;
+    }
+    check_streams(&jobs);
+    for (int t = 0; t < started; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+    pthread_mutex_destroy(&jobs.lock);
+
+    int failing = atomic_load_explicit(&jobs.failing_stream, memory_order_relaxed);
+    report->ops = atomic_load_explicit(&jobs.ops, memory_order_relaxed);
+    report->streams = (failing == INT32_MAX) ? jobs.streams : failing + 1;
+    if (jobs.failed) {
+        return -1;
+    }
+    if (failing == INT32_MAX) {
+        return 0;
+    }
+
+    report->failing_stream = failing;
+    report->failing_op = jobs.failing_op;
+    BoardOpStream stream;
+    board_op_stream_init(&stream);
+    int status = build_stream(config, failing, &stream);
+    if (status == 0) {
+        status = board_diff_minimize(candidate, &stream, jobs.failing_op, &report->reproducer);
+    }
+    board_op_stream_free(&stream);
+    return status;
+}
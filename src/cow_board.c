@@ -0,0 +1,293 @@
+#include "cow_board.h"
+
+#include <string.h>
+
+#include "metrics.h"
+
+// Copy-on-write boards for search trees: children share unchanged rows with parents.
+
+static CowRow *row_alloc(CowRowPool *pool) {
+    CowRow *row = pool_alloc(&pool->rows);
+    if (row == NULL) {
+        return NULL;
+    }
+    row->refs = 1;
+    return row;
+}
+
+static void row_retain(CowRow *row) {
+    if (row->refs != COW_ROW_IMMORTAL) {
+        ++row->refs;
+    }
+}
+
+static void row_release(CowRowPool *pool, CowRow *row) {
+    if (row->refs == COW_ROW_IMMORTAL) {
+        return;
+    }
+    if (--row->refs == 0) {
+        pool_free(&pool->rows, row);
+    }
+}
+
+// Give the board its own copy of a row before writing to it.
+static CowRow *row_make_unique(CowRowPool *pool, CowBoard *board, int row_index) {
+    CowRow *row = board->rows[row_index];
+    if (row->refs == 1) {
+        return row;
+    }
+
+    CowRow *copy = row_alloc(pool);
+    if (copy == NULL) {
+        return NULL;
+    }
+    memcpy(copy->cells, row->cells, sizeof(copy->cells));
+    row_release(pool, row);
+    board->rows[row_index] = copy;
+    return copy;
+}
+
+// Rows are carved from arena (the calling thread's arena when NULL).
+void cow_pool_init(CowRowPool *pool, Arena *arena) {
+    if (pool == NULL) {
+        return;
+    }
+
+    memset(&pool->empty_row, 0, sizeof(pool->empty_row));
+    pool->empty_row.refs = COW_ROW_IMMORTAL;
+    pool_init(&pool->rows, arena, sizeof(CowRow));
+}
+
+// Forget all rows; their memory goes back when the owning arena is rewound.
+void cow_pool_destroy(CowRowPool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    pool_reset(&pool->rows);
+}
+
+size_t cow_pool_live_rows(const CowRowPool *pool) {
+    return (pool == NULL) ? 0 : pool->rows.live;
+}
+
+void cow_board_init(CowRowPool *pool, CowBoard *board) {
+    if (pool == NULL || board == NULL) {
+        return;
+    }
+
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        board->rows[row] = &pool->empty_row;
+    }
+}
+
+// Import a flat board; empty rows all point at the pool's shared empty row.
+int cow_board_from_board(CowRowPool *pool, CowBoard *board, const Board *source) {
+    if (pool == NULL || board == NULL || source == NULL) {
+        return -1;
+    }
+
+    cow_board_init(pool, board);
+    static const int empty_cells[BOARD_WIDTH];
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        if (memcmp(source->cells[row], empty_cells, sizeof(empty_cells)) == 0) {
+            continue;
+        }
+
+        CowRow *copy = row_alloc(pool);
+        if (copy == NULL) {
+            cow_board_release(pool, board);
+            return -1;
+        }
+        memcpy(copy->cells, source->cells[row], sizeof(copy->cells));
+        board->rows[row] = copy;
+    }
+    return 0;
+}
+
+void cow_board_clone(CowBoard *dest, const CowBoard *source) {
+    if (dest == NULL || source == NULL) {
+        return;
+    }
+
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        dest->rows[row] = source->rows[row];
+        row_retain(dest->rows[row]);
+    }
+}
+
+void cow_board_release(CowRowPool *pool, CowBoard *board) {
+    if (pool == NULL || board == NULL) {
+        return;
+    }
+
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        row_release(pool, board->rows[row]);
+        board->rows[row] = &pool->empty_row;
+    }
+}
+
+void cow_board_to_board(const CowBoard *board, Board *dest) {
+    if (board == NULL || dest == NULL) {
+        return;
+    }
+
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        memcpy(dest->cells[row], board->rows[row]->cells, sizeof(dest->cells[row]));
+    }
+}
+
+// Same rules as board_can_place, reading through the row pointers.
+bool cow_board_can_place(const CowBoard *board,
+                         const PieceShape *shape,
+                         int rotation,
+                         int test_row,
+                         int test_col) {
+    if (board == NULL || shape == NULL) {
+        return false;
+    }
+
+    metrics_inc(METRIC_COLLISION_CHECKS);
+    const char *pattern = shape->rotations[rotation];
+
+    for (int r = 0; r < shape->size; ++r) {
+        for (int c = 0; c < shape->size; ++c) {
+            if (pattern[r * shape->size + c] != '1') {
+                continue;
+            }
+
+            int board_row = test_row + r;
+            int board_col = test_col + c;
+
+            // Side walls extend above the visible board; only the floor/stack test is skipped there.
+            if (board_col < 0 || board_col >= BOARD_WIDTH || board_row >= BOARD_HEIGHT) {
+                return false;
+            }
+
+            if (board_row < 0) {
+                continue;
+            }
+
+            if (board->rows[board_row]->cells[board_col] != 0) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Same as board_try_move_piece: shift the piece when the new pose fits.
+bool cow_board_try_move_piece(const CowBoard *board, ActivePiece *piece, int drow, int dcol) {
+    if (board == NULL || piece == NULL || !piece->active) {
+        return false;
+    }
+
+    const PieceShape *shape = piece_shape_get((size_t)piece->type);
+    int next_row = piece->row + drow;
+    int next_col = piece->col + dcol;
+    if (!cow_board_can_place(board, shape, piece->rotation, next_row, next_col)) {
+        return false;
+    }
+
+    piece->row = next_row;
+    piece->col = next_col;
+    return true;
+}
+
+// Same as board_try_rotate_piece: rotate in place, no wall kicks.
+bool cow_board_try_rotate_piece(const CowBoard *board, ActivePiece *piece, int direction) {
+    if (board == NULL || piece == NULL || !piece->active) {
+        return false;
+    }
+
+    const PieceShape *shape = piece_shape_get((size_t)piece->type);
+    if (shape == NULL) {
+        return false;
+    }
+    int next_rotation = (piece->rotation + direction + shape->rotation_count) % shape->rotation_count;
+    if (!cow_board_can_place(board, shape, next_rotation, piece->row, piece->col)) {
+        return false;
+    }
+
+    piece->rotation = next_rotation;
+    return true;
+}
+
+// Same rules as board_lock_shape; only the rows the shape touches are copied.
+int cow_board_lock_shape(CowRowPool *pool,
+                         CowBoard *board,
+                         const PieceShape *shape,
+                         int rotation,
+                         int base_row,
+                         int base_col,
+                         int value) {
+    if (pool == NULL || board == NULL || shape == NULL) {
+        return -1;
+    }
+
+    const char *pattern = shape->rotations[rotation];
+
+    for (int r = 0; r < shape->size; ++r) {
+        int board_row = base_row + r;
+        if (board_row < 0 || board_row >= BOARD_HEIGHT) {
+            continue;
+        }
+
+        CowRow *row = NULL;
+        for (int c = 0; c < shape->size; ++c) {
+            if (pattern[r * shape->size + c] != '1') {
+                continue;
+            }
+
+            int board_col = base_col + c;
+            if (board_col < 0 || board_col >= BOARD_WIDTH) {
+                continue;
+            }
+
+            if (row == NULL) {
+                row = row_make_unique(pool, board, board_row);
+                if (row == NULL) {
+                    return -1;
+                }
+            }
+            row->cells[board_col] = value;
+        }
+    }
+
+    return 0;
+}
+
+// Same row reporting as board_clear_completed_lines; collapsing moves pointers, not cells.
+int cow_board_clear_completed_lines(CowRowPool *pool, CowBoard *board, int *rows_out, int max_rows) {
+    if (pool == NULL || board == NULL) {
+        return 0;
+    }
+
+    int cleared = 0;
+
+    for (int row = BOARD_HEIGHT - 1; row >= 0; --row) {
+        bool full = true;
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            if (board->rows[row]->cells[col] == 0) {
+                full = false;
+                break;
+            }
+        }
+
+        if (!full) {
+            continue;
+        }
+
+        if (rows_out != NULL && cleared < max_rows) {
+            rows_out[cleared] = row;
+        }
+
+        row_release(pool, board->rows[row]);
+        memmove(&board->rows[1], &board->rows[0], sizeof(board->rows[0]) * (size_t)row);
+        board->rows[0] = &pool->empty_row;
+        ++cleared;
+        ++row; // re-check the same row index after rows shift downward
+    }
+
+    return cleared;
+}
@@ -0,0 +1,336 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "dataset.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Columnar training-data files: the writer lays out each block exactly as it sits on disk,
+// so the background thread writes it with one fwrite and a loader reads it with pointer
+// arithmetic over an mmap.
+
+_Static_assert(sizeof(DatasetHeader) <= DATASET_HEADER_BYTES, "header must fit its reserved space");
+_Static_assert(BOARD_WIDTH <= 16, "board rows are 16-bit masks");
+
+static const struct {
+    const char *name;
+    uint32_t element_bytes;
+} k_columns[DATASET_COLUMN_COUNT] = {
+    [DATASET_COL_BOARD] = {"board", sizeof(uint16_t) * BOARD_HEIGHT},
+    [DATASET_COL_PIECE] = {"piece", sizeof(int8_t)},
+    [DATASET_COL_NEXT] = {"next", sizeof(int8_t)},
+    [DATASET_COL_ROTATION] = {"rotation", sizeof(int8_t)},
+    [DATASET_COL_ROW] = {"row", sizeof(int8_t)},
+    [DATASET_COL_COL] = {"col", sizeof(int8_t)},
+    [DATASET_COL_LINES] = {"lines", sizeof(uint8_t)},
+    [DATASET_COL_DONE] = {"done", sizeof(uint8_t)},
+    [DATASET_COL_SCORE_DELTA] = {"score_delta", sizeof(int32_t)},
+    [DATASET_COL_GAME] = {"game", sizeof(uint32_t)},
+};
+
+// Column table for a fresh file; each column starts on a cache-line boundary.
+void dataset_header_init(DatasetHeader *header) {
+    memset(header, 0, sizeof(*header));
+    header->magic = DATASET_MAGIC;
+    header->version = DATASET_VERSION;
+    header->header_bytes = DATASET_HEADER_BYTES;
+    header->records_per_block = DATASET_RECORDS_PER_BLOCK;
+    header->column_count = DATASET_COLUMN_COUNT;
+
+    uint64_t offset = 0;
+    for (int c = 0; c < DATASET_COLUMN_COUNT; ++c) {
+        DatasetColumnInfo *column = &header->columns[c];
+        strncpy(column->name, k_columns[c].name, DATASET_COLUMN_NAME - 1);
+        column->element_bytes = k_columns[c].element_bytes;
+        column->offset = (uint32_t)offset;
+        offset += (uint64_t)column->element_bytes * DATASET_RECORDS_PER_BLOCK;
+        offset = (offset + DATASET_COLUMN_ALIGN - 1) / DATASET_COLUMN_ALIGN * DATASET_COLUMN_ALIGN;
+    }
+    header->block_bytes = offset;
+}
+
+// State half of a record: the locked stack, the piece about to be placed, and the next one.
+void dataset_record_from_engine(DatasetRecord *record, const Engine *engine) {
+    memset(record, 0, sizeof(*record));
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        uint16_t bits = 0;
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            if (engine->board.cells[row][col] != 0) {
+                bits |= (uint16_t)(1U << col);
+            }
+        }
+        record->board[row] = bits;
+    }
+    record->piece = (int8_t)engine->active.type;
+    record->next = (int8_t)engine->next_piece_type;
+}
+
+static void *column_at(const DatasetHeader *header, unsigned char *block, DatasetColumn column, uint32_t index) {
+    const DatasetColumnInfo *info = &header->columns[column];
+    return block + info->offset + (size_t)index * info->element_bytes;
+}
+
+static void *writer_main(void *arg) {
+    DatasetWriter *writer = arg;
+
+    pthread_mutex_lock(&writer->lock);
+    for (;;) {
+        while (writer->queued < 0 && !writer->stopping) {
+            pthread_cond_wait(&writer->ready, &writer->lock);
+        }
+        if (writer->queued < 0) {
+            break;
+        }
+
+        unsigned char *block = writer->blocks[writer->queued];
+        pthread_mutex_unlock(&writer->lock);
+        bool ok = fwrite(block, 1, (size_t)writer->header.block_bytes, writer->fp) == writer->header.block_bytes;
+        pthread_mutex_lock(&writer->lock);
+
+        if (!ok) {
+            writer->failed = true;
+        }
+        writer->queued = -1;
+        pthread_cond_signal(&writer->drained);
+    }
+    pthread_mutex_unlock(&writer->lock);
+    return NULL;
+}
+
+// Hand the filled block to the writer thread and start filling the other one.
+static void submit_block(DatasetWriter *writer) {
+    pthread_mutex_lock(&writer->lock);
+    if (writer->queued >= 0) {
+        ++writer->stalls;
+        while (writer->queued >= 0) {
+            pthread_cond_wait(&writer->drained, &writer->lock);
+        }
+    }
+    writer->queued = writer->filling;
+    pthread_cond_signal(&writer->ready);
+    pthread_mutex_unlock(&writer->lock);
+
+    ++writer->header.block_count;
+    writer->filling ^= 1;
+    writer->fill = 0;
+}
+
+int dataset_writer_open(DatasetWriter *writer, const char *path) {
+    if (writer == NULL || path == NULL) {
+        return -1;
+    }
+
+    memset(writer, 0, sizeof(*writer));
+    dataset_header_init(&writer->header);
+    writer->queued = -1;
+
+    writer->fp = fopen(path, "wb");
+    if (writer->fp == NULL) {
+        return -1;
+    }
+
+    // Placeholder header; the real counts are written by dataset_writer_close.
+    unsigned char header[DATASET_HEADER_BYTES];
+    memset(header, 0, sizeof(header));
+    writer->blocks[0] = calloc(1, (size_t)writer->header.block_bytes);
+    writer->blocks[1] = calloc(1, (size_t)writer->header.block_bytes);
+    if (writer->blocks[0] == NULL || writer->blocks[1] == NULL ||
+        fwrite(header, 1, sizeof(header), writer->fp) != sizeof(header)) {
+        free(writer->blocks[0]);
+        free(writer->blocks[1]);
+        fclose(writer->fp);
+        writer->fp = NULL;
+        return -1;
+    }
+
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->ready, NULL);
+    pthread_cond_init(&writer->drained, NULL);
+    if (pthread_create(&writer->thread, NULL, writer_main, writer) != 0) {
+        pthread_cond_destroy(&writer->drained);
+        pthread_cond_destroy(&writer->ready);
+        pthread_mutex_destroy(&writer->lock);
+        free(writer->blocks[0]);
+        free(writer->blocks[1]);
+        fclose(writer->fp);
+        writer->fp = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+// Scatter one record into the filling block's columns; never touches the disk itself.
+int dataset_writer_append(DatasetWriter *writer, const DatasetRecord *record) {
+    if (writer == NULL || writer->fp == NULL || record == NULL) {
+        return -1;
+    }
+
+    const DatasetHeader *header = &writer->header;
+    unsigned char *block = writer->blocks[writer->filling];
+    uint32_t i = writer->fill;
+    memcpy(column_at(header, block, DATASET_COL_BOARD, i), record->board, sizeof(record->board));
+    *(int8_t *)column_at(header, block, DATASET_COL_PIECE, i) = record->piece;
+    *(int8_t *)column_at(header, block, DATASET_COL_NEXT, i) = record->next;
+    *(int8_t *)column_at(header, block, DATASET_COL_ROTATION, i) = record->rotation;
+    *(int8_t *)column_at(header, block, DATASET_COL_ROW, i) = record->row;
+    *(int8_t *)column_at(header, block, DATASET_COL_COL, i) = record->col;
+    *(uint8_t *)column_at(header, block, DATASET_COL_LINES, i) = record->lines;
+    *(uint8_t *)column_at(header, block, DATASET_COL_DONE, i) = record->done;
+    memcpy(column_at(header, block, DATASET_COL_SCORE_DELTA, i), &record->score_delta, sizeof(int32_t));
+    memcpy(column_at(header, block, DATASET_COL_GAME, i), &record->game, sizeof(uint32_t));
+
+    ++writer->header.record_count;
+    if (++writer->fill == DATASET_RECORDS_PER_BLOCK) {
+        submit_block(writer);
+    }
+    return writer->failed ? -1 : 0;
+}
+
+// Flush the partial last block (zero-padded), stop the writer thread, and rewrite the
+// header with the final counts. Returns -1 if any write failed.
+int dataset_writer_close(DatasetWriter *writer) {
+    if (writer == NULL || writer->fp == NULL) {
+        return -1;
+    }
+
+    if (writer->fill > 0) {
+        unsigned char *block = writer->blocks[writer->filling];
+        for (int c = 0; c < DATASET_COLUMN_COUNT; ++c) {
+            const DatasetColumnInfo *info = &writer->header.columns[c];
+            memset(column_at(&writer->header, block, (DatasetColumn)c, writer->fill), 0,
+                   (size_t)(DATASET_RECORDS_PER_BLOCK - writer->fill) * info->element_bytes);
+        }
+        submit_block(writer);
+    }
+
+    pthread_mutex_lock(&writer->lock);
+    writer->stopping = true;
+    pthread_cond_signal(&writer->ready);
+    pthread_mutex_unlock(&writer->lock);
+    pthread_join(writer->thread, NULL);
+
+    unsigned char header[DATASET_HEADER_BYTES];
+    memset(header, 0, sizeof(header));
+    memcpy(header, &writer->header, sizeof(writer->header));
+    bool ok = !writer->failed && fseek(writer->fp, 0, SEEK_SET) == 0 &&
+              fwrite(header, 1, sizeof(header), writer->fp) == sizeof(header);
+    ok = (fclose(writer->fp) == 0) && ok;
+    writer->fp = NULL;
+
+    pthread_cond_destroy(&writer->drained);
+    pthread_cond_destroy(&writer->ready);
+    pthread_mutex_destroy(&writer->lock);
+    free(writer->blocks[0]);
+    free(writer->blocks[1]);
+    writer->blocks[0] = writer->blocks[1] = NULL;
+    return ok ? 0 : -1;
+}
+
+#if defined(_WIN32)
+
+int dataset_view_open(DatasetView *view, const char *path) {
+    (void)path;
+    if (view != NULL) {
+        memset(view, 0, sizeof(*view));
+    }
+    return -1;
+}
+
+void dataset_view_close(DatasetView *view) {
+    (void)view;
+}
+
+#else
+
+// Map a finished file read-only and check that its header describes this layout.
+int dataset_view_open(DatasetView *view, const char *path) {
+    if (view == NULL || path == NULL) {
+        return -1;
+    }
+    memset(view, 0, sizeof(*view));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < DATASET_HEADER_BYTES) {
+        close(fd);
+        return -1;
+    }
+    void *mapped = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return -1;
+    }
+
+    view->base = mapped;
+    view->length = (size_t)info.st_size;
+    view->header = mapped;
+
+    DatasetHeader expected;
+    dataset_header_init(&expected);
+    const DatasetHeader *header = view->header;
+    if (header->magic != DATASET_MAGIC || header->version != DATASET_VERSION ||
+        header->block_bytes != expected.block_bytes ||
+        memcmp(header->columns, expected.columns, sizeof(expected.columns)) != 0 ||
+        header->block_count > (view->length - DATASET_HEADER_BYTES) / header->block_bytes ||
+        header->record_count > header->block_count * DATASET_RECORDS_PER_BLOCK) {
+        dataset_view_close(view);
+        return -1;
+    }
+    return 0;
+}
+
+void dataset_view_close(DatasetView *view) {
+    if (view == NULL || view->base == NULL) {
+        return;
+    }
+    munmap((void *)view->base, view->length);
+    memset(view, 0, sizeof(*view));
+}
+
+#endif
+
+// Start of one column within one block: records_per_block contiguous elements.
+const void *dataset_view_column(const DatasetView *view, uint64_t block, DatasetColumn column) {
+    if (view == NULL || view->header == NULL || block >= view->header->block_count || column < 0 ||
+        column >= DATASET_COLUMN_COUNT) {
+        return NULL;
+    }
+    return view->base + DATASET_HEADER_BYTES + block * view->header->block_bytes +
+           view->header->columns[column].offset;
+}
+
+// Gather one record back out of the columns (tests and spot checks; loaders use columns).
+int dataset_view_record(const DatasetView *view, uint64_t index, DatasetRecord *record) {
+    if (view == NULL || view->header == NULL || record == NULL || index >= view->header->record_count) {
+        return -1;
+    }
+
+    uint64_t block = index / DATASET_RECORDS_PER_BLOCK;
+    size_t i = (size_t)(index % DATASET_RECORDS_PER_BLOCK);
+    const uint8_t *bytes[DATASET_COLUMN_COUNT];
+    for (int c = 0; c < DATASET_COLUMN_COUNT; ++c) {
+        bytes[c] = dataset_view_column(view, block, (DatasetColumn)c);
+    }
+
+    memcpy(record->board, bytes[DATASET_COL_BOARD] + i * sizeof(record->board), sizeof(record->board));
+    record->piece = (int8_t)bytes[DATASET_COL_PIECE][i];
+    record->next = (int8_t)bytes[DATASET_COL_NEXT][i];
+    record->rotation = (int8_t)bytes[DATASET_COL_ROTATION][i];
+    record->row = (int8_t)bytes[DATASET_COL_ROW][i];
+    record->col = (int8_t)bytes[DATASET_COL_COL][i];
+    record->lines = bytes[DATASET_COL_LINES][i];
+    record->done = bytes[DATASET_COL_DONE][i];
+    memcpy(&record->score_delta, bytes[DATASET_COL_SCORE_DELTA] + i * sizeof(int32_t), sizeof(int32_t));
+    memcpy(&record->game, bytes[DATASET_COL_GAME] + i * sizeof(uint32_t), sizeof(uint32_t));
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "effects.h"
+
+#include <string.h>
+
+// Row-mask overlays and the timed effects drawn over the board.
+
+// Columns of one pattern row, shifted to the piece's board column and clipped to the board.
+static uint16_t pattern_row_mask(const PieceShape *shape, int rotation, int r, int col) {
+    unsigned bits = 0;
+    for (int c = 0; c < shape->size; ++c) {
+        if (piece_shape_cell_filled(shape, rotation, r, c)) {
+            bits |= 1U << c;
+        }
+    }
+    bits = (col >= 0) ? bits << col : bits >> -col;
+    return (uint16_t)(bits & OVERLAY_COLUMNS_MASK);
+}
+
+// OR a piece's cells into per-row masks; rows above or below the board are dropped.
+void overlay_add_piece(uint16_t *rows, const ActivePiece *piece) {
+    if (rows == NULL || piece == NULL) {
+        return;
+    }
+    const PieceShape *shape = piece_shape_get((size_t)piece->type);
+    if (shape == NULL) {
+        return;
+    }
+    for (int r = 0; r < shape->size; ++r) {
+        int row = piece->row + r;
+        if (row >= 0 && row < BOARD_HEIGHT) {
+            rows[row] |= pattern_row_mask(shape, piece->rotation, r, piece->col);
+        }
+    }
+}
+
+void effects_reset(Effects *effects) {
+    if (effects != NULL) {
+        memset(effects, 0, sizeof(*effects));
+    }
+}
+
+// Run every effect's timer down; an effect that runs out clears its masks.
+void effects_tick(Effects *effects, uint64_t delta_ms) {
+    if (effects == NULL) {
+        return;
+    }
+    for (int kind = 0; kind < EFFECT_COUNT; ++kind) {
+        Effect *effect = &effects->effects[kind];
+        if (effect->timer_ms == 0) {
+            continue;
+        }
+        if (effect->timer_ms > delta_ms) {
+            effect->timer_ms -= delta_ms;
+        } else {
+            memset(effect, 0, sizeof(*effect));
+        }
+    }
+}
+
+// Flash whole rows (the ones just cleared); replaces any flash still running.
+void effects_flash_rows(Effects *effects, const int *rows, int count, uint64_t duration_ms) {
+    if (effects == NULL) {
+        return;
+    }
+    Effect *flash = &effects->effects[EFFECT_LINE_FLASH];
+    memset(flash, 0, sizeof(*flash));
+    if (rows == NULL || count <= 0) {
+        return;
+    }
+    for (int i = 0; i < count && i < BOARD_HEIGHT; ++i) {
+        if (rows[i] >= 0 && rows[i] < BOARD_HEIGHT) {
+            flash->rows[rows[i]] = OVERLAY_COLUMNS_MASK;
+        }
+    }
+    flash->timer_ms = duration_ms;
+}
+
+// Trail of a piece that locked at `piece` after falling `drop_distance` rows: every cell it
+// passed through, including where it landed. Each pattern column covers one contiguous row
+// range from its top cell at the start to its bottom cell at the end, so the trail is that
+// column's bit ORed over the range, with no per-step walk of the pattern.
+void effects_drop_trail(Effects *effects, const ActivePiece *piece, int drop_distance, uint64_t duration_ms) {
+    if (effects == NULL) {
+        return;
+    }
+    Effect *trail = &effects->effects[EFFECT_DROP_TRAIL];
+    memset(trail, 0, sizeof(*trail));
+    const PieceShape *shape = (piece != NULL) ? piece_shape_get((size_t)piece->type) : NULL;
+    if (shape == NULL || drop_distance <= 0) {
+        return;
+    }
+
+    int start_row = piece->row - drop_distance;
+    bool any = false;
+    for (int c = 0; c < shape->size; ++c) {
+        int col = piece->col + c;
+        if (col < 0 || col >= BOARD_WIDTH) {
+            continue;
+        }
+        int top = -1;
+        int bottom = -1;
+        for (int r = 0; r < shape->size; ++r) {
+            if (piece_shape_cell_filled(shape, piece->rotation, r, c)) {
+                top = (top < 0) ? r : top;
+                bottom = r;
+            }
+        }
+        if (top < 0) {
+            continue;
+        }
+        int first = start_row + top;
+        int last = piece->row + bottom;
+        first = (first < 0) ? 0 : first;
+        last = (last >= BOARD_HEIGHT) ? BOARD_HEIGHT - 1 : last;
+        for (int row = first; row <= last; ++row) {
+            trail->rows[row] |= (uint16_t)(1U << col);
+            any = true;
+        }
+    }
+    trail->timer_ms = any ? duration_ms : 0;
+}
+
+uint16_t effects_row_mask(const Effects *effects, EffectKind kind, int row) {
+    if (effects == NULL || (int)kind < 0 || kind >= EFFECT_COUNT || row < 0 || row >= BOARD_HEIGHT) {
+        return 0;
+    }
+    return effects->effects[kind].rows[row];
+}
@@ -0,0 +1,911 @@
+#include "engine.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "metrics.h"
+
+// Headless game rules: spawning, movement, gravity, lock delay, scoring, and levels.
+// The terminal front end (game.c) drives an Engine and renders whatever it reports.
+
+static void spawn_piece(Engine *engine);
+static void ensure_next_piece(Engine *engine);
+static bool try_move_piece(Engine *engine, int drow, int dcol);
+static bool try_rotate_piece(Engine *engine, int direction);
+static void lock_piece(Engine *engine);
+static void reset_board_state(Engine *engine);
+static void settle_active_piece(Engine *engine, int drop_bonus_cells);
+static void begin_lock_delay(Engine *engine);
+static void cancel_lock_delay(Engine *engine);
+static void update_level_and_speed(Engine *engine);
+static void apply_gravity(Engine *engine, uint64_t rows);
+static void apply_instant_gravity(Engine *engine);
+static void insert_pending_garbage(Engine *engine);
+static void record_lock_stats(Engine *engine, int cleared, ScoreSpin spin, bool perfect_clear, int attack);
+
+// Prepare an idle engine; score persistence is left to the caller (see score_state_init).
+void engine_init(Engine *engine, uint64_t seed) {
+    if (engine == NULL) {
+        return;
+    }
+
+    memset(engine, 0, sizeof(*engine));
+    engine->phase = ENGINE_PHASE_IDLE;
+    engine_reseed(engine, seed);
+    reset_board_state(engine);
+    ensure_next_piece(engine);
+}
+
+// Restart the piece and garbage-hole sequences from seed, e.g. so every player in a
+// versus match sees the same pieces. Takes effect from the next engine_start.
+void engine_reseed(Engine *engine, uint64_t seed) {
+    if (engine == NULL) {
+        return;
+    }
+
+    piece_bag_seed_kind(&engine->bag, engine->bag.kind, piece_shape_count(), seed);
+    engine->garbage_rng = (seed ^ 0xD1B54A32D192ED03ULL) | 1ULL;
+    engine->next_piece_type = -1;
+}
+
+// Begin a fresh game on this engine, continuing the bag's random sequence.
+void engine_start(Engine *engine) {
+    if (engine == NULL) {
+        return;
+    }
+
+    reset_board_state(engine);
+    ensure_next_piece(engine);
+    engine->phase = ENGINE_PHASE_PLAYING;
+    spawn_piece(engine);
+}
+
+// Advance gravity, locking, and spawning while in the PLAYING phase.
+void engine_tick(Engine *engine, uint64_t delta_ms) {
+    if (engine == NULL || engine->phase != ENGINE_PHASE_PLAYING) {
+        return;
+    }
+
+    engine->stats.play_ms += delta_ms;
+    if (!engine->active.active) {
+        spawn_piece(engine);
+    }
+
+    engine->gravity_accumulator_ms += delta_ms * (uint64_t)engine->gravity_rows;
+    uint64_t rows = engine->gravity_accumulator_ms / engine->gravity_interval_ms;
+    engine->gravity_accumulator_ms -= rows * engine->gravity_interval_ms;
+    if (rows > 0) {
+        apply_gravity(engine, rows);
+    }
+
+    if (engine->lock_pending) {
+        engine->lock_timer_ms += delta_ms;
+        if (engine->lock_timer_ms >= ENGINE_LOCK_DELAY_MS) {
+            settle_active_piece(engine, 0);
+        }
+    }
+}
+
+bool engine_shift(Engine *engine, int dcol) {
+    if (engine == NULL || engine->phase != ENGINE_PHASE_PLAYING) {
+        return false;
+    }
+
+    if (!try_move_piece(engine, 0, dcol)) {
+        return false;
+    }
+    cancel_lock_delay(engine);
+    apply_instant_gravity(engine);
+    return true;
+}
+
+bool engine_rotate(Engine *engine, int direction) {
+    if (engine == NULL || engine->phase != ENGINE_PHASE_PLAYING) {
+        return false;
+    }
+
+    if (!try_rotate_piece(engine, direction)) {
+        return false;
+    }
+    cancel_lock_delay(engine);
+    apply_instant_gravity(engine);
+    return true;
+}
+
+void engine_soft_drop(Engine *engine) {
+    if (engine == NULL || engine->phase != ENGINE_PHASE_PLAYING) {
+        return;
+    }
+
+    if (!try_move_piece(engine, 1, 0)) {
+        begin_lock_delay(engine);
+    }
+}
+
+// Drop the active piece to its landing row and lock it immediately.
+int engine_hard_drop(Engine *engine) {
+    if (engine == NULL || engine->phase != ENGINE_PHASE_PLAYING) {
+        return 0;
+    }
+
+    int dropped = engine->active.active ? engine_ghost_row(engine) - engine->active.row : 0;
+    if (dropped > 0) {
+        engine->active.row += dropped;
+        engine->last_move_rotation = false;
+    }
+    settle_active_piece(engine, dropped);
+    return dropped;
+}
+
+// Hand pending events to the caller and clear them.
+uint32_t engine_take_events(Engine *engine, EngineEvents *events_out) {
+    if (engine == NULL) {
+        return 0;
+    }
+
+    uint32_t flags = engine->events.flags;
+    if (events_out != NULL) {
+        *events_out = engine->events;
+    }
+    engine->events.flags = 0;
+    engine->events.attack_lines = 0;
+    engine->events.garbage_lines = 0;
+    return flags;
+}
+
+// Queue garbage from an opponent; it is cancelled by this player's next attacks or pushed
+// in under the stack when a piece locks without clearing.
+void engine_receive_garbage(Engine *engine, int lines) {
+    if (engine == NULL || lines <= 0 || engine->phase != ENGINE_PHASE_PLAYING) {
+        return;
+    }
+
+    engine->garbage_pending += lines;
+    if (engine->garbage_pending > ENGINE_GARBAGE_MAX) {
+        engine->garbage_pending = ENGINE_GARBAGE_MAX;
+    }
+}
+
+// Garbage sent for a clear: nothing for a single, then 1, 2, and 4 lines.
+int engine_attack_for_clear(int cleared) {
+    static const int k_attack[] = {0, 0, 1, 2, 4};
+    if (cleared <= 0) {
+        return 0;
+    }
+    return (cleared < 4) ? k_attack[cleared] : k_attack[4];
+}
+
+// Spawn position shared by the engine and anything that enumerates moves from spawn.
+void engine_spawn_pose(int piece_type, ActivePiece *piece) {
+    if (piece == NULL) {
+        return;
+    }
+
+    const PieceShape *shape = piece_shape_get((size_t)piece_type);
+    piece->type = piece_type;
+    piece->rotation = 0;
+    piece->row = -2;
+    piece->col = (shape != NULL) ? (BOARD_WIDTH - shape->size) / 2 : 0;
+    piece->active = shape != NULL;
+}
+
+const PieceShape *engine_active_shape(const Engine *engine) {
+    if (engine == NULL) {
+        return NULL;
+    }
+    return piece_shape_get((size_t)engine->active.type);
+}
+
+const PieceShape *engine_next_shape(const Engine *engine) {
+    if (engine == NULL || engine->next_piece_type < 0) {
+        return NULL;
+    }
+    return piece_shape_get((size_t)engine->next_piece_type);
+}
+
+// Row the active piece would land on if hard dropped now.
+int engine_ghost_row(const Engine *engine) {
+    if (engine == NULL || !engine->active.active) {
+        return 0;
+    }
+
+    const PieceShape *shape = engine_active_shape(engine);
+    return engine->active.row +
+           board_drop_distance(&engine->board, shape, engine->active.rotation, engine->active.row, engine->active.col);
+}
+
+// Past level 13 gravity keeps speeding up through fractional G to 20G: {rows, per ms}.
+static const struct {
+    int rows;
+    uint64_t interval_ms;
+} k_extended_gravity[] = {
+    {1, 100}, // level 14, 1/6 G
+    {1, 80},
+    {1, 60},
+    {1, 40},
+    {1, 25},  // 2/3 G
+    {3, 50},  // 1G
+    {3, 25},  // 2G
+    {3, 10},  // 5G
+    {6, 5},   // level 22 and up, 20G
+};
+
+#define ENGINE_EXTENDED_FIRST_LEVEL 14
+
+// Gravity for a level as `rows` rows every `interval_ms`: 700 ms per row at level 1,
+// 50 ms faster per level down to 120 ms at level 13, then the extended table.
+void engine_gravity_for_level(int level, uint64_t *interval_ms, int *rows) {
+    uint64_t interval = ENGINE_GRAVITY_INTERVAL_MS;
+    int per_interval = 1;
+    if (level >= ENGINE_EXTENDED_FIRST_LEVEL) {
+        size_t count = sizeof(k_extended_gravity) / sizeof(k_extended_gravity[0]);
+        size_t index = (size_t)(level - ENGINE_EXTENDED_FIRST_LEVEL);
+        if (index >= count) {
+            index = count - 1;
+        }
+        interval = k_extended_gravity[index].interval_ms;
+        per_interval = k_extended_gravity[index].rows;
+    } else {
+        for (int i = 1; i < level; ++i) {
+            if (interval > ENGINE_MIN_GRAVITY_INTERVAL_MS + 50ULL) {
+                interval -= 50ULL;
+            } else {
+                interval = ENGINE_MIN_GRAVITY_INTERVAL_MS;
+                break;
+            }
+        }
+    }
+
+    if (interval_ms != NULL) {
+        *interval_ms = interval;
+    }
+    if (rows != NULL) {
+        *rows = per_interval;
+    }
+}
+
+// 20G: at least ENGINE_GRAVITY_MAX_G rows per 1/60 s frame.
+bool engine_gravity_is_instant(const Engine *engine) {
+    if (engine == NULL) {
+        return false;
+    }
+    return (uint64_t)engine->gravity_rows * 1000ULL >=
+           (uint64_t)ENGINE_GRAVITY_MAX_G * ENGINE_FRAMES_PER_SECOND * engine->gravity_interval_ms;
+}
+
+// Jump to a level (e.g. a chosen starting level); line clears only ever raise it further.
+void engine_set_level(Engine *engine, int level) {
+    if (engine == NULL || level < 1) {
+        return;
+    }
+
+    engine->level = level;
+    engine_gravity_for_level(level, &engine->gravity_interval_ms, &engine->gravity_rows);
+    engine->gravity_accumulator_ms = 0ULL;
+    apply_instant_gravity(engine);
+}
+
+// Pull the next tetromino from the bag and position it at the spawn point.
+static void spawn_piece(Engine *engine) {
+    size_t total_shapes = piece_shape_count();
+    if (total_shapes == 0) {
+        engine->active.active = false;
+        return;
+    }
+
+    ensure_next_piece(engine);
+    engine_spawn_pose(engine->next_piece_type, &engine->active);
+    engine->next_piece_type = piece_bag_next(&engine->bag);
+    engine->last_move_rotation = false;
+    const PieceShape *shape = engine_active_shape(engine);
+
+    if (!board_can_place(&engine->board, shape, engine->active.rotation, engine->active.row, engine->active.col)) {
+        engine->phase = ENGINE_PHASE_GAME_OVER;
+        engine->events.flags |= ENGINE_EVENT_GAME_OVER;
+        cancel_lock_delay(engine);
+        engine->active.active = false;
+        return;
+    }
+    apply_instant_gravity(engine);
+}
+
+static void ensure_next_piece(Engine *engine) {
+    if (engine->next_piece_type >= 0) {
+        return;
+    }
+
+    size_t total_shapes = piece_shape_count();
+    if (total_shapes == 0) {
+        engine->next_piece_type = -1;
+        return;
+    }
+
+    if (engine->bag.piece_count == 0) {
+        piece_bag_init(&engine->bag, total_shapes);
+    }
+    engine->next_piece_type = piece_bag_next(&engine->bag);
+}
+
+static bool try_move_piece(Engine *engine, int drow, int dcol) {
+    if (!board_try_move_piece(&engine->board, &engine->active, drow, dcol)) {
+        return false;
+    }
+    engine->last_move_rotation = false;
+    return true;
+}
+
+static bool try_rotate_piece(Engine *engine, int direction) {
+    if (!board_try_rotate_piece(&engine->board, &engine->active, direction)) {
+        if (engine->active.active) {
+            metrics_inc(METRIC_ROTATIONS_FAILED);
+        }
+        return false;
+    }
+    engine->last_move_rotation = true;
+    return true;
+}
+
+static void lock_piece(Engine *engine) {
+    if (!engine->active.active) {
+        return;
+    }
+
+    const PieceShape *shape = engine_active_shape(engine);
+    board_lock_shape(&engine->board, shape, engine->active.rotation, engine->active.row, engine->active.col,
+                     engine->active.type + 1);
+    engine->active.active = false;
+    metrics_inc(METRIC_PIECES_LOCKED);
+}
+
+static void reset_board_state(Engine *engine) {
+    board_reset(&engine->board);
+    engine->active.active = false;
+    engine->gravity_accumulator_ms = 0ULL;
+    engine->next_piece_type = -1;
+    engine->total_lines_cleared = 0;
+    engine->level = 1;
+    engine_gravity_for_level(engine->level, &engine->gravity_interval_ms, &engine->gravity_rows);
+    engine->lock_pending = false;
+    engine->lock_timer_ms = 0ULL;
+    engine->garbage_pending = 0;
+    engine->last_move_rotation = false;
+    piece_bag_seed_kind(&engine->bag, engine->bag.kind, piece_shape_count(), engine->bag.rng_state);
+    memset(&engine->events, 0, sizeof(engine->events));
+    memset(&engine->stats, 0, sizeof(engine->stats));
+    score_reset_current(&engine->score);
+}
+
+// Finalize the current piece, award scoring, clear lines, and queue the next piece.
+static void settle_active_piece(Engine *engine, int drop_bonus_cells) {
+    cancel_lock_delay(engine);
+
+    engine->events.flags |= ENGINE_EVENT_LOCKED;
+    engine->events.locked_piece = engine->active;
+    engine->events.drop_distance = drop_bonus_cells;
+    ScoreLock scored = {
+        .spin = score_detect_tspin(&engine->board, &engine->active, engine->last_move_rotation),
+        .level = engine->level,
+    };
+    lock_piece(engine);
+
+    if (drop_bonus_cells > 0) {
+        score_add_drop(&engine->score, drop_bonus_cells);
+    }
+
+    int cleared = board_clear_completed_lines(&engine->board, engine->events.cleared_rows, BOARD_HEIGHT);
+    engine->events.cleared_count = cleared;
+    scored.lines = cleared;
+    scored.perfect_clear = cleared > 0 && board_is_empty(&engine->board);
+    bool chained = engine->score.chain.back_to_back && (cleared >= 4 || (cleared > 0 && scored.spin != SCORE_SPIN_NONE));
+    engine->events.lock_points = score_add_lock(&engine->score, &scored);
+    engine->events.spin = scored.spin;
+    engine->events.perfect_clear = scored.perfect_clear;
+    engine->events.combo = engine->score.chain.combo;
+    engine->events.back_to_back = chained;
+    if (cleared > 0) {
+        metrics_record_clear(cleared);
+        engine->total_lines_cleared += cleared;
+        engine->events.flags |= ENGINE_EVENT_LINES_CLEARED;
+        update_level_and_speed(engine);
+    }
+
+    int attack = engine_attack_for_clear(cleared);
+    record_lock_stats(engine, cleared, scored.spin, scored.perfect_clear, attack);
+    int cancelled = (attack < engine->garbage_pending) ? attack : engine->garbage_pending;
+    engine->garbage_pending -= cancelled;
+    attack -= cancelled;
+    if (attack > 0) {
+        engine->events.attack_lines += attack;
+        engine->events.flags |= ENGINE_EVENT_ATTACK;
+    }
+
+    if (score_commit_highscore(&engine->score)) {
+        engine->events.flags |= ENGINE_EVENT_HIGHSCORE;
+    }
+
+    if (cleared == 0 && engine->garbage_pending > 0) {
+        insert_pending_garbage(engine);
+        if (engine->phase == ENGINE_PHASE_GAME_OVER) {
+            return;
+        }
+    }
+
+    spawn_piece(engine);
+}
+
+// Tallest column and covered empty cells, one top-down pass per column.
+static void measure_stack(const Board *board, int *height_out, int *holes_out) {
+    int tallest = 0;
+    int holes = 0;
+    for (int col = 0; col < BOARD_WIDTH; ++col) {
+        int row = 0;
+        while (row < BOARD_HEIGHT && board->cells[row][col] == 0) {
+            ++row;
+        }
+        if (BOARD_HEIGHT - row > tallest) {
+            tallest = BOARD_HEIGHT - row;
+        }
+        for (; row < BOARD_HEIGHT; ++row) {
+            holes += board->cells[row][col] == 0;
+        }
+    }
+    *height_out = tallest;
+    *holes_out = holes;
+}
+
+static void record_lock_stats(Engine *engine, int cleared, ScoreSpin spin, bool perfect_clear, int attack) {
+    EngineStats *stats = &engine->stats;
+    ++stats->pieces;
+    stats->attack += (uint32_t)attack;
+    if (cleared > 4) {
+        cleared = 4;
+    }
+    if (spin == SCORE_SPIN_MINI) {
+        ++stats->clears[ENGINE_CLEAR_TSPIN_MINI];
+    } else if (spin == SCORE_SPIN_FULL) {
+        ++stats->clears[ENGINE_CLEAR_TSPIN_ZERO + (cleared < 3 ? cleared : 3)];
+    } else if (cleared > 0) {
+        ++stats->clears[ENGINE_CLEAR_SINGLE + cleared - 1];
+    }
+    if (perfect_clear) {
+        ++stats->clears[ENGINE_CLEAR_PERFECT];
+    }
+    if (engine->score.chain.combo > stats->max_combo) {
+        stats->max_combo = engine->score.chain.combo;
+    }
+
+    int height = 0;
+    int holes = 0;
+    measure_stack(&engine->board, &height, &holes);
+    stats->stack_height_sum += (uint64_t)height;
+    stats->holes_sum += (uint64_t)holes;
+}
+
+// Push all queued garbage in below the stack with one random hole column; stack cells
+// pushed off the top end the game.
+static void insert_pending_garbage(Engine *engine) {
+    uint64_t x = engine->garbage_rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    engine->garbage_rng = x;
+    int hole = (int)(x % BOARD_WIDTH);
+
+    int lines = engine->garbage_pending;
+    engine->garbage_pending = 0;
+    engine->events.garbage_lines += lines;
+    engine->events.flags |= ENGINE_EVENT_GARBAGE;
+    if (board_insert_garbage(&engine->board, lines, hole, ENGINE_GARBAGE_CELL)) {
+        engine->phase = ENGINE_PHASE_GAME_OVER;
+        engine->events.flags |= ENGINE_EVENT_GAME_OVER;
+    }
+}
+
+static void begin_lock_delay(Engine *engine) {
+    if (engine->lock_pending) {
+        return;
+    }
+    engine->lock_pending = true;
+    engine->lock_timer_ms = 0ULL;
+}
+
+static void cancel_lock_delay(Engine *engine) {
+    engine->lock_pending = false;
+    engine->lock_timer_ms = 0ULL;
+}
+
+// Move the piece down by up to `rows` with one drop-distance query, so a tick costs the
+// same at 20G as at level 1. Reaching the stack with rows to spare starts the lock delay,
+// as a blocked gravity step always has.
+static void apply_gravity(Engine *engine, uint64_t rows) {
+    if (!engine->active.active) {
+        return;
+    }
+
+    int distance = engine_ghost_row(engine) - engine->active.row;
+    if ((uint64_t)distance >= rows) {
+        distance = (int)rows;
+    }
+    if (distance > 0) {
+        engine->active.row += distance;
+        engine->last_move_rotation = false;
+        cancel_lock_delay(engine);
+    }
+    if ((uint64_t)distance < rows) {
+        begin_lock_delay(engine);
+    }
+}
+
+static void apply_instant_gravity(Engine *engine) {
+    if (engine_gravity_is_instant(engine)) {
+        apply_gravity(engine, BOARD_HEIGHT + 4);
+    }
+}
+
+static void update_level_and_speed(Engine *engine) {
+    int new_level = (engine->total_lines_cleared / ENGINE_LINES_PER_LEVEL) + 1;
+    if (new_level > engine->level) {
+        engine->level = new_level;
+        engine_gravity_for_level(engine->level, &engine->gravity_interval_ms, &engine->gravity_rows);
+        engine->events.flags |= ENGINE_EVENT_LEVEL_UP;
+    }
+}
+
+// --- Analytics ------------------------------------------------------------------------------
+
+// One input (shift, rotate, drop) made by whoever drives the engine; only feeds KPP.
+void engine_count_key(Engine *engine) {
+    if (engine != NULL && engine->phase == ENGINE_PHASE_PLAYING) {
+        ++engine->stats.keys;
+    }
+}
+
+double engine_stats_pps(const EngineStats *stats) {
+    return (stats != NULL && stats->play_ms > 0) ? stats->pieces * 1000.0 / (double)stats->play_ms : 0.0;
+}
+
+double engine_stats_kpp(const EngineStats *stats) {
+    return (stats != NULL && stats->pieces > 0) ? (double)stats->keys / stats->pieces : 0.0;
+}
+
+double engine_stats_apm(const EngineStats *stats) {
+    return (stats != NULL && stats->play_ms > 0) ? stats->attack * 60000.0 / (double)stats->play_ms : 0.0;
+}
+
+double engine_stats_mean_height(const EngineStats *stats) {
+    return (stats != NULL && stats->pieces > 0) ? (double)stats->stack_height_sum / stats->pieces : 0.0;
+}
+
+double engine_stats_mean_holes(const EngineStats *stats) {
+    return (stats != NULL && stats->pieces > 0) ? (double)stats->holes_sum / stats->pieces : 0.0;
+}
+
+const char *engine_clear_kind_name(EngineClearKind kind) {
+    static const char *const k_names[ENGINE_CLEAR_KIND_COUNT] = {
+        "single", "double", "triple", "tetris", "tspin_mini",
+        "tspin_zero", "tspin_single", "tspin_double", "tspin_triple", "perfect_clear",
+    };
+    return ((int)kind >= 0 && kind < ENGINE_CLEAR_KIND_COUNT) ? k_names[kind] : "unknown";
+}
+
+// One-line JSON summary of a game's analytics; returns the length snprintf reports.
+int engine_stats_format(const EngineStats *stats, char *buffer, size_t capacity) {
+    if (stats == NULL || buffer == NULL || capacity == 0) {
+        return -1;
+    }
+
+    int used = snprintf(buffer, capacity,
+                        "{\"seconds\":%.1f,\"pieces\":%u,\"pps\":%.3f,\"kpp\":%.3f,\"apm\":%.2f,"
+                        "\"max_combo\":%d,\"mean_height\":%.2f,\"mean_holes\":%.2f,\"clears\":{",
+                        stats->play_ms / 1000.0, stats->pieces, engine_stats_pps(stats), engine_stats_kpp(stats),
+                        engine_stats_apm(stats), stats->max_combo, engine_stats_mean_height(stats),
+                        engine_stats_mean_holes(stats));
+    for (int kind = 0; kind < ENGINE_CLEAR_KIND_COUNT && used >= 0 && (size_t)used < capacity; ++kind) {
+        used += snprintf(buffer + used, capacity - (size_t)used, "%s\"%s\":%u", kind > 0 ? "," : "",
+                         engine_clear_kind_name((EngineClearKind)kind), stats->clears[kind]);
+    }
+    if (used >= 0 && (size_t)used < capacity) {
+        used += snprintf(buffer + used, capacity - (size_t)used, "}}");
+    }
+    return used;
+}
+
+// --- Snapshots ------------------------------------------------------------------------------
+
+void engine_snapshot(const Engine *engine, EngineSnapshot *snapshot) {
+    if (engine == NULL || snapshot == NULL) {
+        return;
+    }
+
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->phase = engine->phase;
+    snapshot->board = engine->board;
+    snapshot->active = engine->active;
+    snapshot->next_piece_type = engine->next_piece_type;
+    snapshot->bag = engine->bag;
+    snapshot->score_current = engine->score.current;
+    snapshot->score_high = engine->score.high;
+    snapshot->score_chain = engine->score.chain;
+    snapshot->last_move_rotation = engine->last_move_rotation;
+    snapshot->gravity_accumulator_ms = engine->gravity_accumulator_ms;
+    snapshot->lock_pending = engine->lock_pending;
+    snapshot->lock_timer_ms = engine->lock_timer_ms;
+    snapshot->total_lines_cleared = engine->total_lines_cleared;
+    snapshot->level = engine->level;
+    snapshot->gravity_interval_ms = engine->gravity_interval_ms;
+    snapshot->gravity_rows = engine->gravity_rows;
+    snapshot->garbage_pending = engine->garbage_pending;
+    snapshot->garbage_rng = engine->garbage_rng;
+    snapshot->stats = engine->stats;
+}
+
+// Rewind to a snapshot; the score file path is kept and pending events are dropped.
+void engine_restore(Engine *engine, const EngineSnapshot *snapshot) {
+    if (engine == NULL || snapshot == NULL) {
+        return;
+    }
+
+    engine->phase = snapshot->phase;
+    engine->board = snapshot->board;
+    engine->active = snapshot->active;
+    engine->next_piece_type = snapshot->next_piece_type;
+    engine->bag = snapshot->bag;
+    engine->score.current = snapshot->score_current;
+    if (snapshot->score_high > engine->score.high) {
+        engine->score.high = snapshot->score_high;
+    }
+    engine->score.chain = snapshot->score_chain;
+    engine->last_move_rotation = snapshot->last_move_rotation;
+    engine->gravity_accumulator_ms = snapshot->gravity_accumulator_ms;
+    engine->lock_pending = snapshot->lock_pending;
+    engine->lock_timer_ms = snapshot->lock_timer_ms;
+    engine->total_lines_cleared = snapshot->total_lines_cleared;
+    engine->level = snapshot->level;
+    engine->gravity_interval_ms = snapshot->gravity_interval_ms;
+    engine->gravity_rows = snapshot->gravity_rows;
+    engine->garbage_pending = snapshot->garbage_pending;
+    engine->garbage_rng = snapshot->garbage_rng;
+    engine->stats = snapshot->stats;
+    memset(&engine->events, 0, sizeof(engine->events));
+}
+
+// Explicit little-endian field encoding so saved sessions do not depend on struct padding.
+typedef struct {
+    unsigned char *data;
+    const unsigned char *cdata;
+    size_t length;
+    size_t capacity;
+    bool failed;
+} SnapshotCursor;
+
+static void put_u32(SnapshotCursor *cursor, uint32_t value) {
+    if (cursor->length + 4 > cursor->capacity) {
+        cursor->failed = true;
+        return;
+    }
+    for (int i = 0; i < 4; ++i) {
+        cursor->data[cursor->length++] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static void put_u64(SnapshotCursor *cursor, uint64_t value) {
+    put_u32(cursor, (uint32_t)value);
+    put_u32(cursor, (uint32_t)(value >> 32));
+}
+
+static uint32_t get_u32(SnapshotCursor *cursor) {
+    if (cursor->length + 4 > cursor->capacity) {
+        cursor->failed = true;
+        return 0;
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= (uint32_t)cursor->cdata[cursor->length++] << (8 * i);
+    }
+    return value;
+}
+
+static uint64_t get_u64(SnapshotCursor *cursor) {
+    uint64_t low = get_u32(cursor);
+    uint64_t high = get_u32(cursor);
+    return low | (high << 32);
+}
+
+static uint32_t snapshot_checksum(const unsigned char *data, size_t length) {
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= data[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+size_t engine_snapshot_encode(const EngineSnapshot *snapshot, unsigned char *buffer, size_t capacity) {
+    if (snapshot == NULL || buffer == NULL) {
+        return 0;
+    }
+
+    SnapshotCursor cursor = {buffer, buffer, 0, capacity, false};
+    put_u32(&cursor, ENGINE_SNAPSHOT_MAGIC);
+    put_u32(&cursor, ENGINE_SNAPSHOT_VERSION);
+    put_u32(&cursor, (uint32_t)snapshot->phase);
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            put_u32(&cursor, (uint32_t)snapshot->board.cells[row][col]);
+        }
+    }
+    put_u32(&cursor, (uint32_t)snapshot->active.type);
+    put_u32(&cursor, (uint32_t)snapshot->active.rotation);
+    put_u32(&cursor, (uint32_t)snapshot->active.row);
+    put_u32(&cursor, (uint32_t)snapshot->active.col);
+    put_u32(&cursor, snapshot->active.active ? 1U : 0U);
+    put_u32(&cursor, (uint32_t)snapshot->next_piece_type);
+    for (int i = 0; i < PIECE_BAG_MAX; ++i) {
+        put_u32(&cursor, (uint32_t)snapshot->bag.values[i]);
+    }
+    put_u32(&cursor, (uint32_t)snapshot->bag.piece_count);
+    put_u32(&cursor, (uint32_t)snapshot->bag.cursor);
+    put_u64(&cursor, snapshot->bag.rng_state);
+    put_u32(&cursor, (uint32_t)snapshot->bag.kind);
+    put_u64(&cursor, (uint64_t)snapshot->score_current);
+    put_u64(&cursor, (uint64_t)snapshot->score_high);
+    put_u32(&cursor, (uint32_t)snapshot->score_chain.combo);
+    put_u32(&cursor, snapshot->score_chain.back_to_back ? 1U : 0U);
+    put_u32(&cursor, snapshot->last_move_rotation ? 1U : 0U);
+    put_u64(&cursor, snapshot->gravity_accumulator_ms);
+    put_u32(&cursor, snapshot->lock_pending ? 1U : 0U);
+    put_u64(&cursor, snapshot->lock_timer_ms);
+    put_u32(&cursor, (uint32_t)snapshot->total_lines_cleared);
+    put_u32(&cursor, (uint32_t)snapshot->level);
+    put_u64(&cursor, snapshot->gravity_interval_ms);
+    put_u32(&cursor, (uint32_t)snapshot->gravity_rows);
+    put_u32(&cursor, (uint32_t)snapshot->garbage_pending);
+    put_u64(&cursor, snapshot->garbage_rng);
+    put_u64(&cursor, snapshot->stats.play_ms);
+    put_u32(&cursor, snapshot->stats.pieces);
+    put_u32(&cursor, snapshot->stats.keys);
+    put_u32(&cursor, snapshot->stats.attack);
+    for (int i = 0; i < ENGINE_CLEAR_KIND_COUNT; ++i) {
+        put_u32(&cursor, snapshot->stats.clears[i]);
+    }
+    put_u32(&cursor, (uint32_t)snapshot->stats.max_combo);
+    put_u64(&cursor, snapshot->stats.stack_height_sum);
+    put_u64(&cursor, snapshot->stats.holes_sum);
+    put_u32(&cursor, snapshot_checksum(buffer, cursor.length));
+
+    return cursor.failed ? 0 : cursor.length;
+}
+
+int engine_snapshot_decode(EngineSnapshot *snapshot, const unsigned char *buffer, size_t length) {
+    if (snapshot == NULL || buffer == NULL || length != ENGINE_SNAPSHOT_ENCODED_SIZE) {
+        return -1;
+    }
+
+    SnapshotCursor cursor = {NULL, buffer, 0, length, false};
+    if (get_u32(&cursor) != ENGINE_SNAPSHOT_MAGIC || get_u32(&cursor) != ENGINE_SNAPSHOT_VERSION) {
+        return -1;
+    }
+
+    SnapshotCursor tail = {NULL, buffer, length - 4, length, false};
+    if (get_u32(&tail) != snapshot_checksum(buffer, length - 4)) {
+        return -1;
+    }
+
+    EngineSnapshot decoded;
+    memset(&decoded, 0, sizeof(decoded));
+    uint32_t phase = get_u32(&cursor);
+    if (phase > ENGINE_PHASE_GAME_OVER) {
+        return -1;
+    }
+    decoded.phase = (EnginePhase)phase;
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            int cell = (int)get_u32(&cursor);
+            if (cell < 0 || cell > ENGINE_GARBAGE_CELL) {
+                return -1;
+            }
+            decoded.board.cells[row][col] = cell;
+        }
+    }
+    decoded.active.type = (int)get_u32(&cursor);
+    decoded.active.rotation = (int)get_u32(&cursor);
+    decoded.active.row = (int)get_u32(&cursor);
+    decoded.active.col = (int)get_u32(&cursor);
+    decoded.active.active = get_u32(&cursor) != 0;
+    decoded.next_piece_type = (int)get_u32(&cursor);
+    for (int i = 0; i < PIECE_BAG_MAX; ++i) {
+        decoded.bag.values[i] = (int)get_u32(&cursor);
+    }
+    decoded.bag.piece_count = get_u32(&cursor);
+    decoded.bag.cursor = get_u32(&cursor);
+    decoded.bag.rng_state = get_u64(&cursor);
+    uint32_t kind = get_u32(&cursor);
+    if (kind >= PIECE_RANDOMIZER_COUNT) {
+        return -1;
+    }
+    decoded.bag.kind = (PieceRandomizer)kind;
+    decoded.score_current = (int64_t)get_u64(&cursor);
+    decoded.score_high = (int64_t)get_u64(&cursor);
+    decoded.score_chain.combo = (int)get_u32(&cursor);
+    decoded.score_chain.back_to_back = get_u32(&cursor) != 0;
+    decoded.last_move_rotation = get_u32(&cursor) != 0;
+    decoded.gravity_accumulator_ms = get_u64(&cursor);
+    decoded.lock_pending = get_u32(&cursor) != 0;
+    decoded.lock_timer_ms = get_u64(&cursor);
+    decoded.total_lines_cleared = (int)get_u32(&cursor);
+    decoded.level = (int)get_u32(&cursor);
+    decoded.gravity_interval_ms = get_u64(&cursor);
+    decoded.gravity_rows = (int)get_u32(&cursor);
+    decoded.garbage_pending = (int)get_u32(&cursor);
+    decoded.garbage_rng = get_u64(&cursor);
+    decoded.stats.play_ms = get_u64(&cursor);
+    decoded.stats.pieces = get_u32(&cursor);
+    decoded.stats.keys = get_u32(&cursor);
+    decoded.stats.attack = get_u32(&cursor);
+    for (int i = 0; i < ENGINE_CLEAR_KIND_COUNT; ++i) {
+        decoded.stats.clears[i] = get_u32(&cursor);
+    }
+    decoded.stats.max_combo = (int)get_u32(&cursor);
+    decoded.stats.stack_height_sum = get_u64(&cursor);
+    decoded.stats.holes_sum = get_u64(&cursor);
+
+    // next_piece_type is -1 until the engine draws one (before the first spawn).
+    if (cursor.failed || decoded.bag.piece_count > piece_shape_count() || !piece_bag_valid(&decoded.bag) ||
+        decoded.next_piece_type < -1 || decoded.next_piece_type >= (int)piece_shape_count() ||
+        decoded.gravity_interval_ms == 0 || decoded.gravity_rows < 1 || decoded.garbage_pending < 0 ||
+        decoded.garbage_pending > ENGINE_GARBAGE_MAX || decoded.active.type < 0 ||
+        (size_t)decoded.active.type >= piece_shape_count() || decoded.active.rotation < 0 ||
+        decoded.active.rotation >= piece_shape_get((size_t)decoded.active.type)->rotation_count) {
+        return -1;
+    }
+
+    *snapshot = decoded;
+    return 0;
+}
+
+// Persist a snapshot via write-then-rename so a crash mid-save keeps the previous one.
+int engine_snapshot_save(const EngineSnapshot *snapshot, const char *path) {
+    if (snapshot == NULL || path == NULL) {
+        return -1;
+    }
+
+    unsigned char buffer[ENGINE_SNAPSHOT_ENCODED_SIZE];
+    size_t length = engine_snapshot_encode(snapshot, buffer, sizeof(buffer));
+    if (length == 0) {
+        return -1;
+    }
+
+    char temp_path[512];
+    int written = snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    if (written < 0 || (size_t)written >= sizeof(temp_path)) {
+        return -1;
+    }
+
+    FILE *fp = fopen(temp_path, "wb");
+    if (fp == NULL) {
+        return -1;
+    }
+    bool ok = fwrite(buffer, 1, length, fp) == length;
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return -1;
+    }
+    return 0;
+}
+
+int engine_snapshot_load(EngineSnapshot *snapshot, const char *path) {
+    if (snapshot == NULL || path == NULL) {
+        return -1;
+    }
+
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return -1;
+    }
+
+    unsigned char buffer[ENGINE_SNAPSHOT_ENCODED_SIZE + 1];
+    size_t length = fread(buffer, 1, sizeof(buffer), fp);
+    fclose(fp);
+    return engine_snapshot_decode(snapshot, buffer, length);
+}
@@ -0,0 +1,227 @@
+#include "finesse.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include "arena.h"
+#include "cow_board.h"
+#include "engine.h"
+#include "hint.h"
+
+// Optimal-input tables and the per-piece finesse checks built on them.
+
+#define FINESSE_PIECE_TYPES 7
+#define FINESSE_UNREACHABLE UINT8_MAX
+#define FINESSE_STATES (4 * FINESSE_COLUMNS)
+
+static FinessePath g_paths[FINESSE_PIECE_TYPES][4][FINESSE_COLUMNS];
+static pthread_once_t g_paths_once = PTHREAD_ONCE_INIT;
+
+static const char *const k_input_names[FINESSE_INPUT_COUNT] = {"left", "right", "rotate", "soft_drop"};
+
+// Breadth-first search from the spawn pose over (rotation, column) using the board's own
+// move and rotate checks, so walls and rotation limits match play. Rotation is expanded
+// before shifts, so among equally short paths the table turns the piece first.
+static void build_paths_for(int type) {
+    Board empty;
+    board_reset(&empty);
+    for (int rotation = 0; rotation < 4; ++rotation) {
+        for (int c = 0; c < FINESSE_COLUMNS; ++c) {
+            g_paths[type][rotation][c].length = FINESSE_UNREACHABLE;
+        }
+    }
+
+    ActivePiece queue[FINESSE_STATES];
+    int head = 0;
+    int tail = 0;
+    engine_spawn_pose(type, &queue[tail++]);
+    g_paths[type][0][queue[0].col - FINESSE_COL_MIN].length = 0;
+
+    while (head < tail) {
+        ActivePiece from = queue[head++];
+        const FinessePath *path = &g_paths[type][from.rotation][from.col - FINESSE_COL_MIN];
+        if (path->length >= FINESSE_MAX_PATH) {
+            continue;
+        }
+        for (int input = FINESSE_INPUT_ROTATE; input >= FINESSE_INPUT_LEFT; --input) {
+            ActivePiece to = from;
+            bool moved;
+            if (input == FINESSE_INPUT_ROTATE) {
+                moved = board_try_rotate_piece(&empty, &to, 1);
+            } else {
+                moved = board_try_move_piece(&empty, &to, 0, (input == FINESSE_INPUT_LEFT) ? -1 : 1);
+            }
+            int c = to.col - FINESSE_COL_MIN;
+            if (!moved || c < 0 || c >= FINESSE_COLUMNS ||
+                g_paths[type][to.rotation][c].length != FINESSE_UNREACHABLE) {
+                continue;
+            }
+            FinessePath *next = &g_paths[type][to.rotation][c];
+            *next = *path;
+            next->inputs[next->length++] = (uint8_t)input;
+            queue[tail++] = to;
+        }
+    }
+}
+
+static void build_paths(void) {
+    for (int type = 0; type < FINESSE_PIECE_TYPES && type < (int)piece_shape_count(); ++type) {
+        build_paths_for(type);
+    }
+}
+
+static const FinessePath *lookup(int type, int rotation, int col) {
+    if (type < 0 || type >= FINESSE_PIECE_TYPES || rotation < 0 || rotation >= 4 || col < FINESSE_COL_MIN ||
+        col - FINESSE_COL_MIN >= FINESSE_COLUMNS) {
+        return NULL;
+    }
+    const FinessePath *path = &g_paths[type][rotation][col - FINESSE_COL_MIN];
+    return (path->length == FINESSE_UNREACHABLE) ? NULL : path;
+}
+
+// Shortest press sequence from spawn to this rotation and pattern-box column, or NULL when
+// none reaches it.
+const FinessePath *finesse_path(int type, int rotation, int col) {
+    pthread_once(&g_paths_once, build_paths);
+    return lookup(type, rotation, col);
+}
+
+int finesse_optimal_inputs(int type, int rotation, int col) {
+    const FinessePath *path = finesse_path(type, rotation, col);
+    return (path != NULL) ? path->length : -1;
+}
+
+// The placement the hint evaluation likes best among those a finesse path and a hard drop
+// from the spawn row reach (the hint search itself would also pick tucks under overhangs).
+// Candidates are copy-on-write clones of the board, so each one copies only the rows its
+// piece lands in. NULL when the piece cannot be placed at all.
+const FinessePath *finesse_best_path(const Board *board, int type) {
+    const PieceShape *shape = piece_shape_get((size_t)type);
+    if (board == NULL || shape == NULL) {
+        return NULL;
+    }
+
+    Arena *arena = arena_thread_local();
+    ArenaMark mark = arena_mark(arena);
+    CowRowPool rows;
+    cow_pool_init(&rows, arena);
+    CowBoard root;
+    if (cow_board_from_board(&rows, &root, board) != 0) {
+        arena_reset_to(arena, mark);
+        return NULL;
+    }
+
+    ActivePiece spawn;
+    engine_spawn_pose(type, &spawn);
+    const FinessePath *best = NULL;
+    double best_value = 0.0;
+    for (int rotation = 0; rotation < shape->rotation_count; ++rotation) {
+        for (int col = FINESSE_COL_MIN; col < BOARD_WIDTH; ++col) {
+            const FinessePath *path = finesse_path(type, rotation, col);
+            if (path == NULL || !board_can_place(board, shape, rotation, spawn.row, col)) {
+                continue;
+            }
+            ActivePiece placement = spawn;
+            placement.rotation = rotation;
+            placement.col = col;
+            placement.row = spawn.row + board_drop_distance(board, shape, rotation, spawn.row, col);
+            CowBoard child;
+            cow_board_clone(&child, &root);
+            if (cow_board_lock_shape(&rows, &child, shape, rotation, placement.row, col, type + 1) != 0) {
+                cow_board_release(&rows, &child);
+                continue;
+            }
+            int lines = cow_board_clear_completed_lines(&rows, &child, NULL, 0);
+            double value = hint_locks_above_board(&placement) ? -1e9 : hint_evaluate_cow(&child, lines);
+            cow_board_release(&rows, &child);
+            if (best == NULL || value > best_value) {
+                best = path;
+                best_value = value;
+            }
+        }
+    }
+
+    cow_board_release(&rows, &root);
+    cow_pool_destroy(&rows);
+    arena_reset_to(arena, mark);
+    return best;
+}
+
+const char *finesse_input_name(FinesseInput input) {
+    return ((int)input >= 0 && input < FINESSE_INPUT_COUNT) ? k_input_names[input] : "unknown";
+}
+
+// --- Streaming ------------------------------------------------------------------------------
+
+void finesse_tracker_reset(FinesseTracker *tracker) {
+    if (tracker == NULL) {
+        return;
+    }
+    memset(tracker, 0, sizeof(*tracker));
+    tracker->last_extra = -1;
+}
+
+void finesse_tracker_input(FinesseTracker *tracker, FinesseInput input) {
+    if (tracker == NULL) {
+        return;
+    }
+    if (input == FINESSE_INPUT_SOFT_DROP) {
+        tracker->soft_dropped = true;
+    } else {
+        ++tracker->inputs;
+    }
+}
+
+// Judge the piece that just locked against its table entry and start counting the next
+// one. Returns the presses over optimal, or -1 when the piece is not judged.
+int finesse_tracker_lock(FinesseTracker *tracker, const ActivePiece *placement) {
+    if (tracker == NULL || placement == NULL) {
+        return -1;
+    }
+    int optimal = tracker->soft_dropped ? -1
+                                        : finesse_optimal_inputs(placement->type, placement->rotation, placement->col);
+    int extra = -1;
+    ++tracker->pieces;
+    if (optimal >= 0) {
+        extra = (tracker->inputs > optimal) ? tracker->inputs - optimal : 0;
+        ++tracker->judged;
+        tracker->faults += extra > 0;
+        tracker->extra_inputs += (uint64_t)extra;
+    }
+    tracker->last_extra = extra;
+    tracker->inputs = 0;
+    tracker->soft_dropped = false;
+    return extra;
+}
+
+// --- Bulk -----------------------------------------------------------------------------------
+
+// Column-at-a-time analysis over a corpus (e.g. the piece, rotation, and column columns of
+// a dataset block). `inputs` may be NULL, or hold -1 per piece, when presses were not
+// recorded; only the optimal side is counted then.
+void finesse_analyze(const int8_t *types, const int8_t *rotations, const int8_t *cols, const int8_t *inputs,
+                     size_t count, FinesseSummary *summary) {
+    if (types == NULL || rotations == NULL || cols == NULL || summary == NULL) {
+        return;
+    }
+    pthread_once(&g_paths_once, build_paths);
+
+    summary->pieces += count;
+    for (size_t i = 0; i < count; ++i) {
+        const FinessePath *path = lookup(types[i], rotations[i], cols[i]);
+        if (path == NULL) {
+            ++summary->unreachable;
+            continue;
+        }
+        summary->optimal_inputs += path->length;
+        ++summary->optimal_histogram[path->length];
+        if (inputs != NULL && inputs[i] >= 0) {
+            int extra = inputs[i] - path->length;
+            ++summary->judged;
+            if (extra > 0) {
+                ++summary->faults;
+                summary->extra_inputs += (uint64_t)extra;
+            }
+        }
+    }
+}
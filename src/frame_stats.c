@@ -0,0 +1,133 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "frame_stats.h"
+
+#include <string.h>
+#include <time.h>
+
+// Per-phase frame timing windows plus a streaming Chrome trace exporter.
+
+static const char *const phase_names[FRAME_PHASE_COUNT] = {
+    "input",
+    "update",
+    "draw",
+    "refresh",
+    "latency"
+};
+
+// Monotonic, so clock steps (NTP, manual changes) never land in a frame-time histogram.
+uint64_t frame_stats_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)(ts.tv_nsec / 1000);
+}
+
+const char *frame_phase_name(FramePhase phase) {
+    if ((unsigned)phase >= FRAME_PHASE_COUNT) {
+        return "unknown";
+    }
+    return phase_names[phase];
+}
+
+void frame_stats_reset(FrameStats *stats) {
+    if (stats == NULL) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+}
+
+// Push a sample into the phase's ring, overwriting the oldest once full.
+void frame_stats_record(FrameStats *stats, FramePhase phase, uint64_t duration_us) {
+    if (stats == NULL || (unsigned)phase >= FRAME_PHASE_COUNT) {
+        return;
+    }
+
+    FrameSampleWindow *window = &stats->windows[phase];
+    window->samples[window->cursor] = (duration_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)duration_us;
+    window->cursor = (window->cursor + 1) % FRAME_STATS_WINDOW;
+    if (window->count < FRAME_STATS_WINDOW) {
+        ++window->count;
+    }
+}
+
+size_t frame_stats_sample_count(const FrameStats *stats, FramePhase phase) {
+    if (stats == NULL || (unsigned)phase >= FRAME_PHASE_COUNT) {
+        return 0;
+    }
+    return stats->windows[phase].count;
+}
+
+// Nearest-rank p50/p99 over the current window (zero when no samples exist yet).
+void frame_stats_percentiles(const FrameStats *stats, FramePhase phase, uint64_t *p50_out, uint64_t *p99_out) {
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+
+    size_t count = frame_stats_sample_count(stats, phase);
+    if (count > 0) {
+        uint32_t sorted[FRAME_STATS_WINDOW];
+        memcpy(sorted, stats->windows[phase].samples, count * sizeof(sorted[0]));
+
+        for (size_t i = 1; i < count; ++i) {
+            uint32_t value = sorted[i];
+            size_t j = i;
+            while (j > 0 && sorted[j - 1] > value) {
+                sorted[j] = sorted[j - 1];
+                --j;
+            }
+            sorted[j] = value;
+        }
+
+        p50 = sorted[(count * 50 + 99) / 100 - 1];
+        p99 = sorted[(count * 99 + 99) / 100 - 1];
+    }
+
+    if (p50_out != NULL) {
+        *p50_out = p50;
+    }
+    if (p99_out != NULL) {
+        *p99_out = p99;
+    }
+}
+
+// Start a trace file; timestamps are written relative to origin_us.
+int trace_writer_open(TraceWriter *writer, const char *path, uint64_t origin_us) {
+    if (writer == NULL || path == NULL) {
+        return -1;
+    }
+
+    writer->fp = fopen(path, "w");
+    writer->origin_us = origin_us;
+    writer->wrote_event = false;
+    if (writer->fp == NULL) {
+        return -1;
+    }
+
+    fputs("{\"traceEvents\":[\n", writer->fp);
+    return 0;
+}
+
+// Emit a complete ("X") event; nested spans on the same thread stack in the viewer.
+void trace_writer_span(TraceWriter *writer, const char *name, uint64_t start_us, uint64_t duration_us) {
+    if (writer == NULL || writer->fp == NULL || name == NULL) {
+        return;
+    }
+
+    uint64_t ts = (start_us >= writer->origin_us) ? start_us - writer->origin_us : 0ULL;
+    fprintf(writer->fp,
+            "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%llu,\"dur\":%llu}",
+            writer->wrote_event ? ",\n" : "",
+            name,
+            (unsigned long long)ts,
+            (unsigned long long)duration_us);
+    writer->wrote_event = true;
+}
+
+void trace_writer_close(TraceWriter *writer) {
+    if (writer == NULL || writer->fp == NULL) {
+        return;
+    }
+
+    fputs("\n],\"displayTimeUnit\":\"ms\"}\n", writer->fp);
+    fclose(writer->fp);
+    writer->fp = NULL;
+}
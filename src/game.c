@@ -1,125 +1,237 @@
-#if defined(_WIN32)
-#include <curses.h>
-#else
-#include <ncurses.h>
-#endif
-
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
-#include "bag.h"
 #include "board.h"
+#include "effects.h"
+#include "engine.h"
+#include "finesse.h"
+#include "frame_stats.h"
 #include "game.h"
+#include "hint.h"
+#include "metrics.h"
 #include "piece.h"
 #include "score.h"
+#include "spectate.h"
+#include "term.h"
+#include "versus.h"
 
 typedef enum {
     GAME_STATE_TITLE,
+    GAME_STATE_WAITING,
     GAME_STATE_PLAYING,
     GAME_STATE_GAME_OVER
 } GameState;
 
 // --- Timing and gameplay constants ----------------------------------------------------------
-#define GRAVITY_INTERVAL_MS 700ULL
-#define MIN_GRAVITY_INTERVAL_MS 120ULL
-#define LOCK_DELAY_MS 500ULL
-#define LINES_PER_LEVEL 10
 #define CELL_EMPTY 0
 #define LINE_FLASH_DURATION_MS 220ULL
 #define DROP_FLASH_DURATION_MS 180ULL
 #define HUD_PULSE_DURATION_MS 350ULL
-#define DROP_FLASH_MAX_POINTS 256
+#define STATS_WRITE_INTERVAL_MS 1000ULL
+#define SESSION_SAVE_INTERVAL_MS 5000ULL
+#define OPPONENT_PANEL_WIDTH (BOARD_WIDTH + 3)
+
+// Board cells are composed here first so each row reaches the terminal as a handful of
+// attribute runs instead of one attribute switch per cell.
+typedef struct {
+    const char *glyph[BOARD_HEIGHT][BOARD_WIDTH];
+    TermAttr attr[BOARD_HEIGHT][BOARD_WIDTH];
+} BoardCanvas;
+
+// Last board and score reported by each versus opponent, drawn one character per cell.
+typedef struct {
+    uint16_t rows[BOARD_HEIGHT];
+    uint32_t score;
+    bool alive;
+} Opponent;
+
+typedef struct {
+    bool enabled;
+    VersusConn conn;
+    int self;
+    int player_count;
+    bool finished;
+    int winner;
+    uint16_t sent_rows[BOARD_HEIGHT];
+    uint32_t sent_score;
+    bool sent_valid;
+    Opponent opponents[VERSUS_MAX_PLAYERS];
+} VersusSession;
+
+// --watch mirrors another process's game; the local engine is only used for drawing.
+typedef struct {
+    bool enabled;
+    bool ended;
+    SpectateFeed feed;
+    SpectateState state;
+} WatchSession;
 
 // --- Global game state ----------------------------------------------------------------------
 static GameState g_state = GAME_STATE_TITLE;
 static bool g_use_color = false;
-static Board g_board;
-static ActivePiece g_active_piece;
-static uint64_t g_gravity_accumulator_ms = 0ULL;
-static ScoreState g_score;
-static int g_next_piece_type = -1;
-static PieceBag g_piece_bag;
-static bool g_lock_pending = false;
-static uint64_t g_lock_timer_ms = 0ULL;
-static int g_total_lines_cleared = 0;
-static int g_level = 1;
-static uint64_t g_current_gravity_interval_ms = GRAVITY_INTERVAL_MS;
+static Engine g_engine;
 static uint64_t g_last_frame_delta_ms = 16ULL; // used by animation tickers
-static bool g_line_flash_rows[BOARD_HEIGHT];
-static uint64_t g_line_flash_timer_ms = 0ULL;
-static int g_cleared_rows_buffer[BOARD_HEIGHT];
-static uint64_t g_drop_flash_timer_ms = 0ULL;
-static int g_drop_flash_row[DROP_FLASH_MAX_POINTS];
-static int g_drop_flash_col[DROP_FLASH_MAX_POINTS];
-static int g_drop_flash_count = 0;
+static Effects g_effects; // line flash and drop trail, as row masks
 static uint64_t g_hud_pulse_timer_ms = 0ULL;
+static char g_clear_label[32];
+static GameOptions g_options;
+static bool g_instrument = false;
+static FrameStats g_frame_stats;
+static TraceWriter g_trace;
+static BoardCanvas g_canvas;
+static VersusSession g_versus;
+static SpectateHub g_spectate;
+static bool g_spectating = false;
+static WatchSession g_watch;
+static HintWorker g_hint;
+static bool g_hinting = false;
+static uint64_t g_hint_id = 0; // bumped per spawned piece; older results are ignored
+static FinesseTracker g_finesse;
+static bool g_session_dirty = false; // a piece locked since the last session save
 // --- Forward declarations -------------------------------------------------------------------
 static void start_new_game(void);
-
-static void spawn_piece(void);
-static const PieceShape *current_piece_shape(void);
-static const PieceShape *next_piece_shape(void);
-static void ensure_next_piece(void);
-static bool try_move_piece(int drow, int dcol);
-static bool try_rotate_piece(int direction);
-static void lock_piece(void);
-static int clear_completed_lines(void);
-static void reset_board_state(void);
+static void reset_animations(void);
 static void handle_input(int ch, bool *running);
 static void update_game(uint64_t delta_ms);
+static void apply_engine_events(void);
+static void save_session(void);
+static void append_analytics(void);
+static void request_hint(void);
+static void versus_join(void);
+static void versus_send(const VersusMessage *message);
+static void versus_receive(void);
+static void versus_publish_board(void);
+static void spectate_broadcast(void);
+static void watch_receive(void);
 static uint64_t monotonic_millis(void);
-static void settle_active_piece(int drop_bonus_cells);
-static void begin_lock_delay(void);
-static void cancel_lock_delay(void);
-static void update_level_and_speed(void);
-static uint64_t gravity_interval_for_level(int level);
-static void trigger_line_flash(const int *rows, int count);
-static void record_drop_flash(const PieceShape *shape, int drop_distance);
-static void draw_drop_flash(int origin_y, int origin_x);
 static void trigger_hud_pulse(void);
+static void describe_clear(const EngineEvents *events);
 static void tick_animation_timers(void);
 static void draw_frame(void);
 static bool has_enough_space(void);
 static void draw_banner(void);
+static void compose_board(void);
 static void draw_board(int origin_y, int origin_x);
-static void draw_ghost_piece(int origin_y, int origin_x);
-static void draw_active_piece(int origin_y, int origin_x);
 static void draw_score_panel(int origin_y, int origin_x);
+static void draw_analytics_panel(int origin_y, int origin_x);
+static void draw_debug_panel(int origin_y, int origin_x);
+static void draw_opponents(int origin_y, int origin_x);
+static void draw_waiting_overlay(void);
+static void record_frame_timings(uint64_t frame_start_us,
+                                 uint64_t input_done_us,
+                                 uint64_t update_done_us,
+                                 uint64_t draw_done_us,
+                                 uint64_t refresh_done_us,
+                                 uint64_t key_time_us);
 static void draw_next_piece_panel(int origin_y, int origin_x);
 static void draw_piece_preview(int origin_y, int origin_x, const PieceShape *shape);
 static void draw_title_overlay(void);
 static void draw_game_over_overlay(void);
+static TermAttr accent_attr(TermColor color, TermAttr monochrome);
+static TermAttr piece_attr(int piece_type);
+
+void game_options_default(GameOptions *options) {
+    if (options == NULL) {
+        return;
+    }
+    options->debug_hud = false;
+    options->hint = false;
+    options->trace_path = NULL;
+    options->stats_path = NULL;
+    options->session_path = NULL;
+    options->analytics_path = NULL;
+    options->highscore_path = NULL;
+    options->versus_address = NULL;
+    options->spectate_address = NULL;
+    options->spectate_shm = NULL;
+    options->watch_address = NULL;
+    options->backend = TERM_BACKEND_NCURSES;
+}
+
+// Initialize the terminal backend, RNG, and persistent score state.
+int game_init(const GameOptions *options) {
+    game_options_default(&g_options);
+    if (options != NULL) {
+        g_options = *options;
+    }
 
-// Initialize ncurses, colors, RNG, and persistent score state.
-int game_init(void) {
-    if (initscr() == NULL) {
+    frame_stats_reset(&g_frame_stats);
+    g_trace.fp = NULL;
+    if (g_options.trace_path != NULL &&
+        trace_writer_open(&g_trace, g_options.trace_path, frame_stats_now_us()) != 0) {
         return -1;
     }
+    g_instrument = g_options.debug_hud || g_trace.fp != NULL;
 
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    nodelay(stdscr, TRUE);
-    curs_set(0);
+    memset(&g_versus, 0, sizeof(g_versus));
+    if (g_options.versus_address != NULL) {
+        versus_conn_init(&g_versus.conn, versus_connect(g_options.versus_address));
+        if (g_versus.conn.closed) {
+            trace_writer_close(&g_trace);
+            return -1;
+        }
+        g_versus.enabled = true;
+        g_options.session_path = NULL; // versus games are not resumable
+    }
 
-    if (has_colors()) {
-        start_color();
-        use_default_colors();
-        init_pair(1, COLOR_CYAN, -1);
-        init_pair(2, COLOR_YELLOW, -1);
-        init_pair(3, COLOR_BLUE, -1);
-        init_pair(4, COLOR_WHITE, -1);
-        g_use_color = true;
+    memset(&g_watch, 0, sizeof(g_watch));
+    g_spectating = false;
+    if (g_options.watch_address != NULL) {
+        if (spectate_feed_open(&g_watch.feed, g_options.watch_address) != 0) {
+            if (g_versus.enabled) {
+                versus_conn_close(&g_versus.conn);
+            }
+            trace_writer_close(&g_trace);
+            return -1;
+        }
+        g_watch.enabled = true;
+        g_options.session_path = NULL;
+    } else if (g_options.spectate_address != NULL || g_options.spectate_shm != NULL) {
+        if (spectate_hub_open(&g_spectate, g_options.spectate_address, g_options.spectate_shm) != 0) {
+            if (g_versus.enabled) {
+                versus_conn_close(&g_versus.conn);
+            }
+            trace_writer_close(&g_trace);
+            return -1;
+        }
+        g_spectating = true;
     }
 
+    if (term_init(g_options.backend) != 0) {
+        if (g_versus.enabled) {
+            versus_conn_close(&g_versus.conn);
+        }
+        if (g_watch.enabled) {
+            spectate_feed_close(&g_watch.feed);
+        }
+        if (g_spectating) {
+            spectate_hub_close(&g_spectate);
+        }
+        trace_writer_close(&g_trace);
+        return -1;
+    }
+    g_use_color = term_has_colors();
+    g_hinting = g_options.hint && !g_versus.enabled && !g_watch.enabled &&
+                hint_worker_start(&g_hint, HINT_DEFAULT_DEPTH) == 0;
+
     srand((unsigned int)time(NULL));
-    score_state_init(&g_score, SCORE_DEFAULT_FILE);
-    reset_board_state();
-    ensure_next_piece();
-    g_state = GAME_STATE_TITLE;
+    engine_init(&g_engine, ((uint64_t)time(NULL) << 16) ^ (uint64_t)rand());
+    score_state_init(&g_engine.score, g_options.highscore_path);
+    reset_animations();
+    g_state = g_watch.enabled ? GAME_STATE_WAITING : GAME_STATE_TITLE;
+
+    EngineSnapshot resumed;
+    if (g_options.session_path != NULL && engine_snapshot_load(&resumed, g_options.session_path) == 0 &&
+        resumed.phase == ENGINE_PHASE_PLAYING) {
+        engine_restore(&g_engine, &resumed);
+        g_state = GAME_STATE_PLAYING;
+        request_hint();
+    }
 
     return 0;
 }
@@ -128,10 +240,18 @@ int game_init(void) {
 void game_loop(void) {
     bool running = true;
     uint64_t last_tick = monotonic_millis();
+    uint64_t pending_key_us = 0ULL; // earliest keypress not yet on screen
+    uint64_t stats_written_ms = last_tick;
+    uint64_t session_saved_ms = last_tick;
 
     while (running) {
-        int ch = getch();
+        uint64_t frame_start_us = g_instrument ? frame_stats_now_us() : 0ULL;
+        int ch = term_read_key();
+        if (g_instrument && ch != TERM_KEY_NONE && pending_key_us == 0ULL) {
+            pending_key_us = frame_stats_now_us();
+        }
         handle_input(ch, &running);
+        uint64_t input_done_us = g_instrument ? frame_stats_now_us() : 0ULL;
 
         uint64_t now = monotonic_millis();
         uint64_t delta = now - last_tick;
@@ -139,25 +259,119 @@ void game_loop(void) {
         g_last_frame_delta_ms = delta;
 
         update_game(delta);
+        spectate_broadcast();
+        uint64_t update_done_us = g_instrument ? frame_stats_now_us() : 0ULL;
 
         draw_frame();
-        napms(1);
+        uint64_t draw_done_us = g_instrument ? frame_stats_now_us() : 0ULL;
+
+        term_flush();
+        metrics_inc(METRIC_FRAMES_RENDERED);
+        if (g_options.stats_path != NULL && now - stats_written_ms >= STATS_WRITE_INTERVAL_MS) {
+            metrics_write_stats_file(g_options.stats_path);
+            stats_written_ms = now;
+        }
+        if (g_session_dirty && now - session_saved_ms >= SESSION_SAVE_INTERVAL_MS) {
+            save_session();
+            session_saved_ms = now;
+        }
+        if (g_instrument) {
+            record_frame_timings(frame_start_us, input_done_us, update_done_us, draw_done_us,
+                                 frame_stats_now_us(), pending_key_us);
+            pending_key_us = 0ULL;
+        }
+        term_nap(1);
+    }
+}
+
+// Headless replay of one recorded session (see perf_suite.h) through the same frame steps
+// as game_loop, with a fixed frame time and no naps or clock reads. Starts a fresh game on
+// `seed` and stops when the keys run out or the game is over. Call after game_init,
+// normally with the null renderer and no versus or watch session.
+int game_run_script(uint64_t seed, const uint8_t *keys, size_t count, uint64_t frame_ms, PerfSessionResult *result) {
+    if ((keys == NULL && count > 0) || result == NULL || g_versus.enabled || g_watch.enabled) {
+        return -1;
     }
+
+    memset(result, 0, sizeof(*result));
+    engine_reseed(&g_engine, seed);
+    start_new_game();
+    bool running = true;
+    g_last_frame_delta_ms = frame_ms;
+    for (size_t i = 0; i < count && running && g_state == GAME_STATE_PLAYING; ++i) {
+        handle_input(perf_key_term_code((PerfKey)keys[i]), &running);
+        update_game(frame_ms);
+        spectate_broadcast();
+        draw_frame();
+        term_flush();
+        metrics_inc(METRIC_FRAMES_RENDERED);
+        ++result->frames;
+    }
+    result->pieces = g_engine.stats.pieces;
+    result->lines = (uint32_t)g_engine.total_lines_cleared;
+    result->score = g_engine.score.current;
+    result->topped_out = g_state == GAME_STATE_GAME_OVER;
+    return 0;
 }
 
 void game_shutdown(void) {
-    endwin();
+    term_shutdown();
+    if (g_hinting) {
+        hint_worker_stop(&g_hint);
+    }
+    if (g_versus.enabled) {
+        versus_conn_close(&g_versus.conn);
+    }
+    if (g_watch.enabled) {
+        spectate_feed_close(&g_watch.feed);
+    }
+    if (g_spectating) {
+        spectate_hub_close(&g_spectate);
+    }
+    save_session();
+    if (g_options.stats_path != NULL) {
+        metrics_write_stats_file(g_options.stats_path);
+    }
+    trace_writer_close(&g_trace);
+}
+
+// Feed the rolling windows and, when tracing, emit one span per frame phase.
+static void record_frame_timings(uint64_t frame_start_us,
+                                 uint64_t input_done_us,
+                                 uint64_t update_done_us,
+                                 uint64_t draw_done_us,
+                                 uint64_t refresh_done_us,
+                                 uint64_t key_time_us) {
+    frame_stats_record(&g_frame_stats, FRAME_PHASE_INPUT, input_done_us - frame_start_us);
+    frame_stats_record(&g_frame_stats, FRAME_PHASE_UPDATE, update_done_us - input_done_us);
+    frame_stats_record(&g_frame_stats, FRAME_PHASE_DRAW, draw_done_us - update_done_us);
+    frame_stats_record(&g_frame_stats, FRAME_PHASE_REFRESH, refresh_done_us - draw_done_us);
+    if (key_time_us != 0ULL) {
+        frame_stats_record(&g_frame_stats, FRAME_PHASE_LATENCY, refresh_done_us - key_time_us);
+    }
+
+    if (g_trace.fp == NULL) {
+        return;
+    }
+
+    trace_writer_span(&g_trace, "frame", frame_start_us, refresh_done_us - frame_start_us);
+    trace_writer_span(&g_trace, "getch", frame_start_us, input_done_us - frame_start_us);
+    trace_writer_span(&g_trace, "update_game", input_done_us, update_done_us - input_done_us);
+    trace_writer_span(&g_trace, "draw_frame", update_done_us, draw_done_us - update_done_us);
+    trace_writer_span(&g_trace, "refresh", draw_done_us, refresh_done_us - draw_done_us);
+    if (key_time_us != 0ULL) {
+        trace_writer_span(&g_trace, "input_to_render", key_time_us, refresh_done_us - key_time_us);
+    }
 }
 
-// Render the entire scene (board, HUD, overlays) for the current frame.
+// Compose the entire scene (board, HUD, overlays); game_loop flushes it with term_flush().
 static void draw_frame(void) {
     tick_animation_timers();
-    erase();
-    box(stdscr, 0, 0);
+    term_clear();
+    term_box();
 
     if (!has_enough_space()) {
-        mvprintw(LINES / 2, (COLS - 30) / 2, "Enlarge the terminal window.");
-        refresh();
+        term_put(term_rows() / 2, (term_cols() - 30) / 2, "Enlarge the terminal window.");
         return;
     }
 
@@ -166,197 +380,240 @@ static void draw_frame(void) {
     const int hud_origin_x = board_origin_x + BOARD_WIDTH * 2 + 4;
 
     draw_banner();
+    compose_board();
     draw_board(board_origin_y, board_origin_x);
-    draw_ghost_piece(board_origin_y, board_origin_x);
-    draw_active_piece(board_origin_y, board_origin_x);
-    draw_drop_flash(board_origin_y, board_origin_x);
     draw_score_panel(board_origin_y, hud_origin_x);
-    draw_next_piece_panel(board_origin_y + 6, hud_origin_x);
+    draw_analytics_panel(board_origin_y + 7, hud_origin_x);
+    draw_next_piece_panel(board_origin_y + 12, hud_origin_x);
+    if (g_options.debug_hud) {
+        draw_debug_panel(board_origin_y + 20, hud_origin_x);
+    }
+    if (g_versus.enabled) {
+        draw_opponents(board_origin_y, hud_origin_x + 26);
+    }
     if (g_state == GAME_STATE_TITLE) {
         draw_title_overlay();
+    } else if (g_state == GAME_STATE_WAITING) {
+        draw_waiting_overlay();
     } else if (g_state == GAME_STATE_GAME_OVER) {
         draw_game_over_overlay();
     }
-
-    refresh();
 }
 
 static bool has_enough_space(void) {
     const int min_rows = BOARD_HEIGHT + 8;
     const int min_cols = BOARD_WIDTH * 2 + 18;
-    return (LINES >= min_rows) && (COLS >= min_cols);
+    return (term_rows() >= min_rows) && (term_cols() >= min_cols);
+}
+
+// Color when available, otherwise a monochrome style with the same intent.
+static TermAttr accent_attr(TermColor color, TermAttr monochrome) {
+    return g_use_color ? (TermAttr)color : monochrome;
+}
+
+// Locked cells store type + 1; anything else (e.g. garbage) is drawn white.
+static TermAttr piece_attr(int piece_type) {
+    return accent_attr(term_piece_color(piece_type), TERM_ATTR_NORMAL);
 }
 
 static void draw_banner(void) {
-    if (g_use_color) {
-        attron(COLOR_PAIR(1));
-    }
-    mvprintw(1, 2, "Terminal Tetris Prototype");
-    if (g_use_color) {
-        attroff(COLOR_PAIR(1));
-    }
+    term_set_attr(accent_attr(TERM_COLOR_CYAN, TERM_ATTR_NORMAL));
+    term_put(1, 2, "Terminal Tetris Prototype");
+    term_set_attr(TERM_ATTR_NORMAL);
 
     if (g_state == GAME_STATE_TITLE) {
-        mvprintw(2, 2, "Press ENTER to start, 'q' to quit");
+        term_put(2, 2, "Press ENTER to start, 'q' to quit");
+    } else if (g_state == GAME_STATE_WAITING) {
+        term_put(2, 2, "Waiting for opponents - press 'q' to quit");
     } else if (g_state == GAME_STATE_GAME_OVER) {
-        mvprintw(2, 2, "Game Over - press 'r' to restart or 'q' to quit");
+        term_put(2, 2, "Game Over - press 'r' to restart or 'q' to quit");
     } else {
-        mvprintw(2, 2, "Press 'q' to quit");
-        mvprintw(3, 2, "Arrows/WASD move, Space hard drops.");
+        term_put(2, 2, "Press 'q' to quit");
+        term_put(3, 2, "Arrows/WASD move, Space hard drops.");
     }
 }
 
-static void draw_board(int origin_y, int origin_x) {
-    const int inner_width = BOARD_WIDTH * 2;
-
-    move(origin_y - 1, origin_x - 1);
-    addch('+');
-    for (int i = 0; i < inner_width; ++i) {
-        addch('-');
-    }
-    addch('+');
-
-    for (int row = 0; row < BOARD_HEIGHT; ++row) {
-        move(origin_y + row, origin_x - 1);
-        addch('|');
-        bool flashing = g_line_flash_timer_ms > 0 && g_line_flash_rows[row];
-        if (flashing) {
-            attron(A_REVERSE);
-            if (g_use_color) {
-                attron(COLOR_PAIR(2));
-            }
-        }
-        for (int col = 0; col < BOARD_WIDTH; ++col) {
-            if (g_board.cells[row][col] != CELL_EMPTY) {
-                if (g_use_color) {
-                    attron(COLOR_PAIR(1));
-                }
-                addstr("[]");
-                if (g_use_color) {
-                    attroff(COLOR_PAIR(1));
-                }
-            } else {
-                addstr("  ");
-            }
-        }
-        if (flashing) {
-            attroff(A_REVERSE);
-            if (g_use_color) {
-                attroff(COLOR_PAIR(2));
-            }
-        }
-        addch('|');
+// Overlays drawn over the locked stack, bottom to top; the topmost layer with a column's
+// bit set in a row supplies that cell.
+typedef enum {
+    LAYER_GHOST,
+    LAYER_HINT,
+    LAYER_ACTIVE,
+    LAYER_DROP_TRAIL,
+    LAYER_COUNT
+} CanvasLayerKind;
+
+typedef struct {
+    uint16_t rows[BOARD_HEIGHT];
+    const char *glyph;
+    TermAttr attr;
+} CanvasLayer;
+
+// Where the active piece would land, unless it is already there.
+static void collect_ghost_layer(CanvasLayer *layer) {
+    if (g_state != GAME_STATE_PLAYING || !g_engine.active.active) {
+        return;
     }
-
-    move(origin_y + BOARD_HEIGHT, origin_x - 1);
-    addch('+');
-    for (int i = 0; i < inner_width; ++i) {
-        addch('-');
+    ActivePiece ghost = g_engine.active;
+    ghost.row = engine_ghost_row(&g_engine);
+    if (ghost.row == g_engine.active.row) {
+        return;
     }
-    addch('+');
+    overlay_add_piece(layer->rows, &ghost);
+    layer->glyph = "..";
+    layer->attr = g_use_color ? (TermAttr)(piece_attr(ghost.type) | TERM_ATTR_DIM) : TERM_ATTR_DIM;
 }
 
-static void draw_ghost_piece(int origin_y, int origin_x) {
-    if (g_state != GAME_STATE_PLAYING || !g_active_piece.active) {
+// Where the hint worker would put the current piece, once its answer is in. Polls without
+// waiting, so a slow search only means the outline appears a few frames later.
+static void collect_hint_layer(CanvasLayer *layer) {
+    HintResult hint;
+    if (!g_hinting || g_state != GAME_STATE_PLAYING || !hint_worker_poll(&g_hint, g_hint_id, &hint)) {
         return;
     }
+    // A placement on the way to a perfect clear is marked in yellow.
+    overlay_add_piece(layer->rows, &hint.placement);
+    layer->glyph = "<>";
+    layer->attr = accent_attr(hint.perfect_clear ? TERM_COLOR_YELLOW : TERM_COLOR_GREEN, TERM_ATTR_BOLD);
+}
 
-    ActivePiece ghost = g_active_piece;
-    const PieceShape *shape = current_piece_shape();
-    if (shape == NULL) {
+static void collect_active_layer(CanvasLayer *layer) {
+    if (!g_engine.active.active) {
         return;
     }
+    overlay_add_piece(layer->rows, &g_engine.active);
+    layer->glyph = "[]";
+    layer->attr = piece_attr(g_engine.active.type);
+}
 
-    while (board_can_place(&g_board, shape, ghost.rotation, ghost.row + 1, ghost.col)) {
-        ++ghost.row;
+// Fill the canvas row by row: the locked stack (flashing rows take the flash style
+// wholesale), then each overlay layer wherever its mask has the column's bit.
+static void compose_board(void) {
+    CanvasLayer layers[LAYER_COUNT];
+    memset(layers, 0, sizeof(layers));
+    collect_ghost_layer(&layers[LAYER_GHOST]);
+    collect_hint_layer(&layers[LAYER_HINT]);
+    collect_active_layer(&layers[LAYER_ACTIVE]);
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        layers[LAYER_DROP_TRAIL].rows[row] = effects_row_mask(&g_effects, EFFECT_DROP_TRAIL, row);
     }
+    layers[LAYER_DROP_TRAIL].glyph = "::";
+    layers[LAYER_DROP_TRAIL].attr = accent_attr(TERM_COLOR_BLUE, TERM_ATTR_DIM);
+    TermAttr flash_attr = TERM_ATTR_REVERSE | accent_attr(TERM_COLOR_YELLOW, TERM_ATTR_NORMAL);
 
-    if (ghost.row == g_active_piece.row) {
-        return;
-    }
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        uint16_t flashing = effects_row_mask(&g_effects, EFFECT_LINE_FLASH, row);
+        uint16_t covered = 0;
+        for (int layer = 0; layer < LAYER_COUNT; ++layer) {
+            covered |= layers[layer].rows[row];
+        }
 
-    const char *pattern = shape->rotations[ghost.rotation];
-    for (int r = 0; r < shape->size; ++r) {
-        for (int c = 0; c < shape->size; ++c) {
-            if (pattern[r * shape->size + c] != '1') {
-                continue;
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            uint16_t bit = (uint16_t)(1U << col);
+            int cell = g_engine.board.cells[row][col];
+            g_canvas.glyph[row][col] = (cell != CELL_EMPTY) ? "[]" : "  ";
+            if (flashing & bit) {
+                g_canvas.attr[row][col] = flash_attr;
+            } else {
+                g_canvas.attr[row][col] = (cell != CELL_EMPTY) ? piece_attr(cell - 1) : TERM_ATTR_NORMAL;
             }
-
-            int board_row = ghost.row + r;
-            int board_col = ghost.col + c;
-            if (board_row < 0 || board_row >= BOARD_HEIGHT || board_col < 0 || board_col >= BOARD_WIDTH) {
+            if ((covered & bit) == 0) {
                 continue;
             }
-
-            move(origin_y + board_row, origin_x + board_col * 2);
-            if (g_use_color) {
-                attron(COLOR_PAIR(4));
-            } else {
-                attron(A_DIM);
-            }
-            addstr("..");
-            if (g_use_color) {
-                attroff(COLOR_PAIR(4));
-            } else {
-                attroff(A_DIM);
+            for (int layer = LAYER_COUNT - 1; layer >= 0; --layer) {
+                if (layers[layer].rows[row] & bit) {
+                    g_canvas.glyph[row][col] = layers[layer].glyph;
+                    g_canvas.attr[row][col] = layers[layer].attr;
+                    break;
+                }
             }
         }
     }
 }
 
-static void draw_active_piece(int origin_y, int origin_x) {
-    if (!g_active_piece.active) {
-        return;
-    }
-
-    const PieceShape *shape = current_piece_shape();
-    const char *pattern = shape->rotations[g_active_piece.rotation];
+// Emit the canvas inside its frame: one attribute change and one write per run of
+// same-attribute cells, skipping the change when the run continues the previous style.
+static void draw_board(int origin_y, int origin_x) {
+    char border[BOARD_WIDTH * 2 + 3];
+    memset(border, '-', sizeof(border) - 1);
+    border[0] = '+';
+    border[sizeof(border) - 2] = '+';
+    border[sizeof(border) - 1] = '\0';
 
-    for (int r = 0; r < shape->size; ++r) {
-        for (int c = 0; c < shape->size; ++c) {
-            if (pattern[r * shape->size + c] != '1') {
-                continue;
-            }
+    term_set_attr(TERM_ATTR_NORMAL);
+    TermAttr current = TERM_ATTR_NORMAL;
+    term_put(origin_y - 1, origin_x - 1, border);
 
-            int board_row = g_active_piece.row + r;
-            int board_col = g_active_piece.col + c;
-            if (board_row < 0 || board_row >= BOARD_HEIGHT || board_col < 0 || board_col >= BOARD_WIDTH) {
-                continue;
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        int col = 0;
+        while (col < BOARD_WIDTH) {
+            TermAttr attr = g_canvas.attr[row][col];
+            char run[BOARD_WIDTH * 2 + 1];
+            int start = col;
+            int len = 0;
+            while (col < BOARD_WIDTH && g_canvas.attr[row][col] == attr) {
+                run[len++] = g_canvas.glyph[row][col][0];
+                run[len++] = g_canvas.glyph[row][col][1];
+                ++col;
             }
+            run[len] = '\0';
 
-            int screen_y = origin_y + board_row;
-            int screen_x = origin_x + board_col * 2;
-
-            move(screen_y, screen_x);
-            if (g_use_color) {
-                attron(COLOR_PAIR(1));
-            }
-            addstr("[]");
-            if (g_use_color) {
-                attroff(COLOR_PAIR(1));
+            if (attr != current) {
+                term_set_attr(attr);
+                current = attr;
             }
+            term_put(origin_y + row, origin_x + start * 2, run);
         }
     }
+
+    term_set_attr(TERM_ATTR_NORMAL);
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        term_putc(origin_y + row, origin_x - 1, '|');
+        term_putc(origin_y + row, origin_x + BOARD_WIDTH * 2, '|');
+    }
+    term_put(origin_y + BOARD_HEIGHT, origin_x - 1, border);
 }
 
 // Translate keyboard input into state changes for the current screen.
 static void handle_input(int ch, bool *running) {
-    if (ch == ERR) {
+    if (ch == TERM_KEY_NONE) {
+        return;
+    }
+
+    if (g_watch.enabled) {
+        if (ch == 'q' || ch == 'Q') {
+            *running = false;
+        }
         return;
     }
 
     if (g_state == GAME_STATE_TITLE) {
         if (ch == 'q' || ch == 'Q') {
             *running = false;
-        } else if (ch == '\n' || ch == '\r' || ch == KEY_ENTER || ch == ' ') {
-            start_new_game();
+        } else if (ch == '\n' || ch == '\r' || ch == TERM_KEY_ENTER || ch == ' ') {
+            if (g_versus.enabled) {
+                versus_join();
+            } else {
+                start_new_game();
+            }
+        }
+        return;
+    }
+
+    if (g_state == GAME_STATE_WAITING) {
+        if (ch == 'q' || ch == 'Q') {
+            *running = false;
         }
         return;
     }
 
     if (g_state == GAME_STATE_GAME_OVER) {
         if (ch == 'r' || ch == 'R' || ch == ' ') {
-            start_new_game();
+            if (!g_versus.enabled) {
+                start_new_game();
+            } else if (g_versus.finished && !g_versus.conn.closed) {
+                versus_join();
+            }
         } else if (ch == 'q' || ch == 'Q') {
             *running = false;
         }
@@ -368,335 +625,336 @@ static void handle_input(int ch, bool *running) {
         case 'Q':
             *running = false;
             break;
-        case KEY_LEFT:
+        case TERM_KEY_LEFT:
         case 'a':
         case 'A':
-            if (try_move_piece(0, -1)) {
-                cancel_lock_delay();
-            }
+            finesse_tracker_input(&g_finesse, FINESSE_INPUT_LEFT);
+            engine_count_key(&g_engine);
+            engine_shift(&g_engine, -1);
             break;
-        case KEY_RIGHT:
+        case TERM_KEY_RIGHT:
         case 'd':
         case 'D':
-            if (try_move_piece(0, 1)) {
-                cancel_lock_delay();
-            }
+            finesse_tracker_input(&g_finesse, FINESSE_INPUT_RIGHT);
+            engine_count_key(&g_engine);
+            engine_shift(&g_engine, 1);
             break;
-        case KEY_DOWN:
+        case TERM_KEY_DOWN:
         case 's':
         case 'S':
-            if (!try_move_piece(1, 0)) {
-                begin_lock_delay();
-            }
+            finesse_tracker_input(&g_finesse, FINESSE_INPUT_SOFT_DROP);
+            engine_count_key(&g_engine);
+            engine_soft_drop(&g_engine);
             break;
-        case KEY_UP:
+        case TERM_KEY_UP:
         case 'w':
         case 'W':
-            if (try_rotate_piece(1)) {
-                cancel_lock_delay();
-            }
+            finesse_tracker_input(&g_finesse, FINESSE_INPUT_ROTATE);
+            engine_count_key(&g_engine);
+            engine_rotate(&g_engine, 1);
             break;
         case ' ':
-            {
-                int dropped = 0;
-                while (try_move_piece(1, 0)) {
-                    ++dropped;
-                }
-                settle_active_piece(dropped);
-            }
+            engine_count_key(&g_engine);
+            engine_hard_drop(&g_engine);
             break;
     }
+    apply_engine_events();
 }
 
 // Advance gravity, locking, and spawning while in the PLAYING state.
 static void update_game(uint64_t delta_ms) {
-    if (g_state != GAME_STATE_PLAYING) {
+    if (g_watch.enabled) {
+        watch_receive();
         return;
     }
-
-    if (!g_active_piece.active) {
-        spawn_piece();
+    if (g_versus.enabled) {
+        versus_receive();
     }
-
-    g_gravity_accumulator_ms += delta_ms;
-    while (g_gravity_accumulator_ms >= g_current_gravity_interval_ms) {
-        g_gravity_accumulator_ms -= g_current_gravity_interval_ms;
-        if (!try_move_piece(1, 0)) {
-            begin_lock_delay();
-        } else {
-            cancel_lock_delay();
-        }
+    if (g_state != GAME_STATE_PLAYING) {
+        return;
     }
 
-    if (g_lock_pending) {
-        g_lock_timer_ms += delta_ms;
-        if (g_lock_timer_ms >= LOCK_DELAY_MS) {
-            settle_active_piece(0);
-        }
+    engine_tick(&g_engine, delta_ms);
+    apply_engine_events();
+    if (g_versus.enabled) {
+        versus_publish_board();
     }
 }
 
-static uint64_t monotonic_millis(void) {
-    struct timespec ts;
-    timespec_get(&ts, TIME_UTC);
-    return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)(ts.tv_nsec / 1000000ULL);
-}
-
-// Pull the next tetromino from the bag and position it at the spawn point.
-static void spawn_piece(void) {
-    size_t total_shapes = piece_shape_count();
-    if (total_shapes == 0) {
-        g_active_piece.active = false;
+// Turn engine events into animations, highscore writes, and state transitions.
+static void apply_engine_events(void) {
+    EngineEvents events;
+    uint32_t flags = engine_take_events(&g_engine, &events);
+    if (flags == 0) {
         return;
     }
 
-    ensure_next_piece();
-    g_active_piece.type = g_next_piece_type;
-    g_next_piece_type = piece_bag_next(&g_piece_bag);
-    g_active_piece.rotation = 0;
-    g_active_piece.row = -2;
-    const PieceShape *shape = current_piece_shape();
-    g_active_piece.col = (BOARD_WIDTH - shape->size) / 2;
-    g_active_piece.active = true;
-
-    if (!board_can_place(&g_board, shape, g_active_piece.rotation, g_active_piece.row, g_active_piece.col)) {
-        g_state = GAME_STATE_GAME_OVER;
-        cancel_lock_delay();
-        g_active_piece.active = false;
+    if (flags & ENGINE_EVENT_LOCKED) {
+        effects_drop_trail(&g_effects, &events.locked_piece, events.drop_distance, DROP_FLASH_DURATION_MS);
+        finesse_tracker_lock(&g_finesse, &events.locked_piece);
+        g_session_dirty = true;
+        request_hint();
     }
-}
-
-static bool try_move_piece(int drow, int dcol) {
-    if (!g_active_piece.active) {
-        return false;
+    if (flags & ENGINE_EVENT_LINES_CLEARED) {
+        effects_flash_rows(&g_effects, events.cleared_rows, events.cleared_count, LINE_FLASH_DURATION_MS);
+        trigger_hud_pulse();
     }
-
-    int next_row = g_active_piece.row + drow;
-    int next_col = g_active_piece.col + dcol;
-    const PieceShape *shape = current_piece_shape();
-    if (!board_can_place(&g_board, shape, g_active_piece.rotation, next_row, next_col)) {
-        return false;
+    if ((flags & ENGINE_EVENT_LOCKED) && (events.cleared_count > 0 || events.spin != SCORE_SPIN_NONE)) {
+        describe_clear(&events);
     }
-
-    g_active_piece.row = next_row;
-    g_active_piece.col = next_col;
-    return true;
-}
-
-static bool try_rotate_piece(int direction) {
-    if (!g_active_piece.active) {
-        return false;
+    if (flags & ENGINE_EVENT_LEVEL_UP) {
+        trigger_hud_pulse();
     }
-
-    const PieceShape *shape = current_piece_shape();
-    int next_rotation = (g_active_piece.rotation + direction + shape->rotation_count) % shape->rotation_count;
-    if (!board_can_place(&g_board, shape, next_rotation, g_active_piece.row, g_active_piece.col)) {
-        return false;
+    if (flags & ENGINE_EVENT_HIGHSCORE) {
+        score_state_save(&g_engine.score);
+    }
+    if ((flags & ENGINE_EVENT_ATTACK) && g_versus.enabled) {
+        VersusMessage attack = {.type = VERSUS_MSG_ATTACK};
+        attack.lines = (uint8_t)(events.attack_lines > 255 ? 255 : events.attack_lines);
+        versus_send(&attack);
+    }
+    if (flags & ENGINE_EVENT_GAME_OVER) {
+        g_state = GAME_STATE_GAME_OVER;
+        if (g_versus.enabled) {
+            versus_publish_board();
+            VersusMessage topped_out = {.type = VERSUS_MSG_TOPPED_OUT};
+            versus_send(&topped_out);
+        }
+        if (g_options.session_path != NULL) {
+            remove(g_options.session_path);
+        }
+        append_analytics();
     }
-
-    g_active_piece.rotation = next_rotation;
-    return true;
 }
 
-static void lock_piece(void) {
-    if (!g_active_piece.active) {
+// Append the finished game's analytics to the --analytics file as one JSON line.
+static void append_analytics(void) {
+    if (g_options.analytics_path == NULL || g_engine.stats.pieces == 0) {
         return;
     }
-
-    const PieceShape *shape = current_piece_shape();
-    board_lock_shape(&g_board, shape, g_active_piece.rotation, g_active_piece.row, g_active_piece.col, g_active_piece.type + 1);
-    g_active_piece.active = false;
-}
-
-static int clear_completed_lines(void) {
-    return board_clear_completed_lines(&g_board, g_cleared_rows_buffer, BOARD_HEIGHT);
-}
-
-static const PieceShape *current_piece_shape(void) {
-    return piece_shape_get((size_t)g_active_piece.type);
-}
-
-static const PieceShape *next_piece_shape(void) {
-    if (g_next_piece_type < 0) {
-        return NULL;
+    char line[512];
+    if (engine_stats_format(&g_engine.stats, line, sizeof(line)) < 0) {
+        return;
+    }
+    FILE *fp = fopen(g_options.analytics_path, "a");
+    if (fp != NULL) {
+        fprintf(fp, "%s\n", line);
+        fclose(fp);
     }
-    return piece_shape_get((size_t)g_next_piece_type);
 }
 
-static void ensure_next_piece(void) {
-    if (g_next_piece_type >= 0) {
+// Hand the newly spawned piece to the hint worker; the result shows up in a later frame.
+static void request_hint(void) {
+    if (!g_hinting || g_engine.phase != ENGINE_PHASE_PLAYING || !g_engine.active.active) {
         return;
     }
 
-    size_t total_shapes = piece_shape_count();
-    if (total_shapes == 0) {
-        g_next_piece_type = -1;
+    HintRequest request = {
+        .board = g_engine.board,
+        .piece = g_engine.active.type,
+        .next = g_engine.next_piece_type,
+        .id = ++g_hint_id,
+    };
+    request.queue_length = pc_queue_from_engine(&g_engine, request.queue, PC_MAX_PIECES);
+    hint_worker_post(&g_hint, &request);
+}
+
+// Write the crash-recovery snapshot while a game is in progress. game_loop calls this at
+// most every SESSION_SAVE_INTERVAL_MS, and shutdown once more, so the file I/O stays off
+// the per-lock path.
+static void save_session(void) {
+    g_session_dirty = false;
+    if (g_options.session_path == NULL || g_engine.phase != ENGINE_PHASE_PLAYING) {
         return;
     }
 
-    if (g_piece_bag.piece_count == 0) {
-        piece_bag_init(&g_piece_bag, total_shapes);
-    }
-    g_next_piece_type = piece_bag_next(&g_piece_bag);
+    EngineSnapshot snapshot;
+    engine_snapshot(&g_engine, &snapshot);
+    engine_snapshot_save(&snapshot, g_options.session_path);
 }
 
-static void reset_board_state(void) {
-    board_reset(&g_board);
-    g_active_piece.active = false;
-    g_gravity_accumulator_ms = 0ULL;
-    g_next_piece_type = -1;
-    g_total_lines_cleared = 0;
-    g_level = 1;
-    g_current_gravity_interval_ms = gravity_interval_for_level(g_level);
-    g_lock_pending = false;
-    g_lock_timer_ms = 0ULL;
-    piece_bag_init(&g_piece_bag, piece_shape_count());
-    memset(g_line_flash_rows, 0, sizeof(g_line_flash_rows));
-    g_line_flash_timer_ms = 0ULL;
-    g_drop_flash_timer_ms = 0ULL;
-    g_drop_flash_count = 0;
-    g_hud_pulse_timer_ms = 0ULL;
-    score_reset_current(&g_score);
-}
+// --- Versus mode ----------------------------------------------------------------------------
 
-static void start_new_game(void) {
-    reset_board_state();
-    ensure_next_piece();
-    spawn_piece();
-    g_state = GAME_STATE_PLAYING;
+// Enter the server's lobby; the game starts when a MATCH message arrives.
+static void versus_join(void) {
+    VersusMessage hello = {.type = VERSUS_MSG_HELLO, .version = VERSUS_PROTOCOL_VERSION};
+    versus_send(&hello);
+    g_state = GAME_STATE_WAITING;
 }
 
-// Finalize the current piece, award scoring, clear lines, and queue the next piece.
-static void settle_active_piece(int drop_bonus_cells) {
-    cancel_lock_delay();
-    const PieceShape *shape = current_piece_shape();
-    if (drop_bonus_cells > 0) {
-        record_drop_flash(shape, drop_bonus_cells);
-    } else {
-        g_drop_flash_count = 0;
-        g_drop_flash_timer_ms = 0ULL;
+static void versus_send(const VersusMessage *message) {
+    if (versus_conn_send(&g_versus.conn, message) != 0) {
+        g_versus.finished = true;
     }
+}
 
-    lock_piece();
-
-    if (drop_bonus_cells > 0) {
-        score_add_drop(&g_score, drop_bonus_cells);
+// Drain every message the server has sent since the last frame (never blocks).
+static void versus_receive(void) {
+    VersusMessage message;
+    int status;
+    while ((status = versus_conn_receive(&g_versus.conn, &message)) > 0) {
+        int player = message.player;
+        switch (message.type) {
+            case VERSUS_MSG_MATCH:
+                g_versus.self = player;
+                g_versus.player_count = message.player_count;
+                g_versus.finished = false;
+                g_versus.winner = VERSUS_NO_PLAYER;
+                g_versus.sent_valid = false;
+                memset(g_versus.opponents, 0, sizeof(g_versus.opponents));
+                for (int p = 0; p < g_versus.player_count && p < VERSUS_MAX_PLAYERS; ++p) {
+                    g_versus.opponents[p].alive = true;
+                }
+                engine_reseed(&g_engine, message.seed);
+                start_new_game();
+                break;
+            case VERSUS_MSG_GARBAGE:
+                engine_receive_garbage(&g_engine, message.lines);
+                break;
+            case VERSUS_MSG_BOARD:
+                if (player < VERSUS_MAX_PLAYERS) {
+                    memcpy(g_versus.opponents[player].rows, message.rows, sizeof(message.rows));
+                    g_versus.opponents[player].score = message.score;
+                }
+                break;
+            case VERSUS_MSG_TOPPED_OUT:
+                if (player < VERSUS_MAX_PLAYERS) {
+                    g_versus.opponents[player].alive = false;
+                }
+                break;
+            case VERSUS_MSG_RESULT:
+                g_versus.finished = true;
+                g_versus.winner = player;
+                if (g_state == GAME_STATE_PLAYING) {
+                    g_state = GAME_STATE_GAME_OVER;
+                }
+                break;
+            default:
+                break;
+        }
     }
 
-    int cleared = clear_completed_lines();
-    if (cleared > 0) {
-        score_add_lines(&g_score, cleared);
-        g_total_lines_cleared += cleared;
-        trigger_line_flash(g_cleared_rows_buffer, cleared);
-        trigger_hud_pulse();
-        update_level_and_speed();
+    if (status < 0 && !g_versus.finished) {
+        g_versus.finished = true;
+        g_versus.winner = VERSUS_NO_PLAYER;
+        if (g_state == GAME_STATE_PLAYING || g_state == GAME_STATE_WAITING) {
+            g_state = GAME_STATE_GAME_OVER;
+        }
     }
+}
 
-    if (score_commit_highscore(&g_score)) {
-        score_state_save(&g_score);
+// Send the visible board (stack plus falling piece) whenever it or the score changed.
+static void versus_publish_board(void) {
+    VersusMessage board = {.type = VERSUS_MSG_BOARD, .score = (uint32_t)g_engine.score.current};
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            if (g_engine.board.cells[row][col] != CELL_EMPTY) {
+                board.rows[row] |= (uint16_t)(1U << col);
+            }
+        }
     }
 
-    spawn_piece();
-}
+    const PieceShape *shape = engine_active_shape(&g_engine);
+    if (g_engine.active.active && shape != NULL) {
+        for (int r = 0; r < shape->size; ++r) {
+            for (int c = 0; c < shape->size; ++c) {
+                int row = g_engine.active.row + r;
+                int col = g_engine.active.col + c;
+                if (piece_shape_cell_filled(shape, g_engine.active.rotation, r, c) && row >= 0 &&
+                    row < BOARD_HEIGHT && col >= 0 && col < BOARD_WIDTH) {
+                    board.rows[row] |= (uint16_t)(1U << col);
+                }
+            }
+        }
+    }
 
-static void begin_lock_delay(void) {
-    if (g_lock_pending) {
+    if (g_versus.sent_valid && board.score == g_versus.sent_score &&
+        memcmp(board.rows, g_versus.sent_rows, sizeof(board.rows)) == 0) {
         return;
     }
-    g_lock_pending = true;
-    g_lock_timer_ms = 0ULL;
+    memcpy(g_versus.sent_rows, board.rows, sizeof(board.rows));
+    g_versus.sent_score = board.score;
+    g_versus.sent_valid = true;
+    versus_send(&board);
 }
 
-static void cancel_lock_delay(void) {
-    g_lock_pending = false;
-    g_lock_timer_ms = 0ULL;
-}
-
-static void update_level_and_speed(void) {
-    int new_level = (g_total_lines_cleared / LINES_PER_LEVEL) + 1;
-    if (new_level != g_level) {
-        g_level = new_level;
-        g_current_gravity_interval_ms = gravity_interval_for_level(g_level);
-        trigger_hud_pulse();
-    }
-}
+// --- Spectators ---------------------------------------------------------------------------
 
-static uint64_t gravity_interval_for_level(int level) {
-    uint64_t interval = GRAVITY_INTERVAL_MS;
-    for (int i = 1; i < level; ++i) {
-        if (interval > MIN_GRAVITY_INTERVAL_MS + 50ULL) {
-            interval -= 50ULL;
-        } else {
-            interval = MIN_GRAVITY_INTERVAL_MS;
-            break;
-        }
+// Encode this frame's changes once and hand the same bytes to every viewer.
+static void spectate_broadcast(void) {
+    if (!g_spectating) {
+        return;
     }
-    return interval;
+    spectate_hub_publish(&g_spectate, &g_engine);
+    spectate_hub_pump(&g_spectate);
 }
 
-// Start the flashing animation for recently cleared rows.
-static void trigger_line_flash(const int *rows, int count) {
-    memset(g_line_flash_rows, 0, sizeof(g_line_flash_rows));
-    if (rows == NULL || count <= 0) {
-        g_line_flash_timer_ms = 0ULL;
+// Apply whatever the watched game sent since the last frame and follow its phase.
+static void watch_receive(void) {
+    if (g_watch.ended) {
         return;
     }
 
-    for (int i = 0; i < count && i < BOARD_HEIGHT; ++i) {
-        int row = rows[i];
-        if (row >= 0 && row < BOARD_HEIGHT) {
-            g_line_flash_rows[row] = true;
-        }
+    int status = spectate_feed_poll(&g_watch.feed, &g_watch.state);
+    if (status < 0) {
+        g_watch.ended = true;
+        g_state = GAME_STATE_GAME_OVER;
+        return;
     }
-    g_line_flash_timer_ms = LINE_FLASH_DURATION_MS;
-}
-
-// Record every board cell traversed by a hard drop for the trail effect.
-static void record_drop_flash(const PieceShape *shape, int drop_distance) {
-    if (shape == NULL || drop_distance <= 0) {
-        g_drop_flash_count = 0;
-        g_drop_flash_timer_ms = 0ULL;
+    if (status == 0) {
         return;
     }
 
-    g_drop_flash_count = 0;
-
-    const char *pattern = shape->rotations[g_active_piece.rotation];
-    int start_row = g_active_piece.row - drop_distance;
-    if (start_row < -shape->size) {
-        start_row = -shape->size;
+    spectate_state_to_engine(&g_watch.state, &g_engine);
+    if (g_engine.phase == ENGINE_PHASE_PLAYING) {
+        g_state = GAME_STATE_PLAYING;
+    } else if (g_engine.phase == ENGINE_PHASE_GAME_OVER) {
+        g_state = GAME_STATE_GAME_OVER;
+    } else {
+        g_state = GAME_STATE_WAITING;
     }
+}
 
-    for (int step = 0; step <= drop_distance; ++step) {
-        int base_row = start_row + step;
-        for (int r = 0; r < shape->size; ++r) {
-            for (int c = 0; c < shape->size; ++c) {
-                if (pattern[r * shape->size + c] != '1') {
-                    continue;
-                }
-
-                int board_row = base_row + r;
-                int board_col = g_active_piece.col + c;
-                if (board_row < 0 || board_row >= BOARD_HEIGHT || board_col < 0 || board_col >= BOARD_WIDTH) {
-                    continue;
-                }
+static uint64_t monotonic_millis(void) {
+    return frame_stats_now_us() / 1000ULL;
+}
 
-                if (g_drop_flash_count < DROP_FLASH_MAX_POINTS) {
-                    g_drop_flash_row[g_drop_flash_count] = board_row;
-                    g_drop_flash_col[g_drop_flash_count] = board_col;
-                    ++g_drop_flash_count;
-                }
-            }
-        }
-    }
+static void reset_animations(void) {
+    effects_reset(&g_effects);
+    g_hud_pulse_timer_ms = 0ULL;
+    g_clear_label[0] = '\0';
+}
 
-    g_drop_flash_timer_ms = (g_drop_flash_count > 0) ? DROP_FLASH_DURATION_MS : 0ULL;
+static void start_new_game(void) {
+    reset_animations();
+    finesse_tracker_reset(&g_finesse);
+    engine_start(&g_engine);
+    g_state = GAME_STATE_PLAYING;
+    apply_engine_events();
+    request_hint();
 }
 
 static void trigger_hud_pulse(void) {
     g_hud_pulse_timer_ms = HUD_PULSE_DURATION_MS;
 }
 
+// Short name for the last scoring lock, e.g. "B2B T-SPIN DOUBLE x2"; kept until the next one.
+static void describe_clear(const EngineEvents *events) {
+    static const char *const k_line_names[] = {"", "SINGLE", "DOUBLE", "TRIPLE", "TETRIS"};
+    int lines = events->cleared_count > 4 ? 4 : events->cleared_count;
+    const char *spin = (events->spin == SCORE_SPIN_FULL) ? "T-SPIN " : (events->spin == SCORE_SPIN_MINI) ? "MINI T-SPIN " : "";
+    if (events->perfect_clear) {
+        snprintf(g_clear_label, sizeof(g_clear_label), "PERFECT CLEAR");
+    } else {
+        snprintf(g_clear_label, sizeof(g_clear_label), "%s%s%s", events->back_to_back ? "B2B " : "", spin,
+                 k_line_names[lines]);
+    }
+    if (events->combo > 0) {
+        size_t used = strlen(g_clear_label);
+        snprintf(g_clear_label + used, sizeof(g_clear_label) - used, " x%d", events->combo + 1);
+    }
+}
+
 // Decrement animation timers once per frame so effects self-expire.
 static void tick_animation_timers(void) {
     uint64_t delta = g_last_frame_delta_ms;
@@ -704,23 +962,7 @@ static void tick_animation_timers(void) {
         delta = 1;
     }
 
-    if (g_line_flash_timer_ms > 0) {
-        if (g_line_flash_timer_ms > delta) {
-            g_line_flash_timer_ms -= delta;
-        } else {
-            g_line_flash_timer_ms = 0;
-            memset(g_line_flash_rows, 0, sizeof(g_line_flash_rows));
-        }
-    }
-
-    if (g_drop_flash_timer_ms > 0) {
-        if (g_drop_flash_timer_ms > delta) {
-            g_drop_flash_timer_ms -= delta;
-        } else {
-            g_drop_flash_timer_ms = 0;
-            g_drop_flash_count = 0;
-        }
-    }
+    effects_tick(&g_effects, delta);
 
     if (g_hud_pulse_timer_ms > 0) {
         if (g_hud_pulse_timer_ms > delta) {
@@ -733,40 +975,117 @@ static void tick_animation_timers(void) {
 
 static void draw_score_panel(int origin_y, int origin_x) {
     bool pulsing = g_hud_pulse_timer_ms > 0;
-    if (pulsing && g_use_color) {
-        attron(COLOR_PAIR(2));
-    } else if (pulsing) {
-        attron(A_BOLD);
+    term_set_attr(pulsing ? accent_attr(TERM_COLOR_YELLOW, TERM_ATTR_BOLD) : TERM_ATTR_NORMAL);
+
+    term_printf(origin_y, origin_x,     "Score     : %" PRId64, g_engine.score.current);
+    term_printf(origin_y + 1, origin_x, "High Score: %" PRId64, g_engine.score.high);
+    term_printf(origin_y + 2, origin_x, "Level     : %d", g_engine.level);
+    term_printf(origin_y + 3, origin_x, "Lines     : %d", g_engine.total_lines_cleared);
+    if (engine_gravity_is_instant(&g_engine)) {
+        term_printf(origin_y + 4, origin_x, "Gravity   : %dG   ", ENGINE_GRAVITY_MAX_G);
+    } else if (g_engine.gravity_rows > 1) {
+        double g = g_engine.gravity_rows * 1000.0 / (ENGINE_FRAMES_PER_SECOND * (double)g_engine.gravity_interval_ms);
+        term_printf(origin_y + 4, origin_x, "Gravity   : %.1fG  ", g);
+    } else {
+        term_printf(origin_y + 4, origin_x, "Gravity   : %lums", (unsigned long)g_engine.gravity_interval_ms);
+    }
+    term_printf(origin_y + 5, origin_x, "%-24.24s", g_clear_label);
+    if (g_versus.enabled && g_engine.garbage_pending > 0) {
+        term_set_attr(accent_attr(TERM_COLOR_RED, TERM_ATTR_BOLD));
+        term_printf(origin_y + 6, origin_x, "Incoming  : %d", g_engine.garbage_pending);
+    } else if (g_finesse.judged > 0) {
+        // Red for a moment after a piece took more presses than it needed.
+        term_set_attr(g_finesse.last_extra > 0 ? accent_attr(TERM_COLOR_RED, TERM_ATTR_BOLD) : TERM_ATTR_NORMAL);
+        term_printf(origin_y + 6, origin_x, "Finesse   : %" PRIu64 "/%" PRIu64, g_finesse.faults, g_finesse.judged);
     }
 
-    mvprintw(origin_y, origin_x,   "Score     : %d", g_score.current);
-    mvprintw(origin_y + 1, origin_x, "High Score: %d", g_score.high);
-    mvprintw(origin_y + 2, origin_x, "Level     : %d", g_level);
-    mvprintw(origin_y + 3, origin_x, "Lines     : %d", g_total_lines_cleared);
-    mvprintw(origin_y + 4, origin_x, "Gravity   : %lums", (unsigned long)g_current_gravity_interval_ms);
+    term_set_attr(TERM_ATTR_NORMAL);
+}
 
-    if (pulsing && g_use_color) {
-        attroff(COLOR_PAIR(2));
-    } else if (pulsing) {
-        attroff(A_BOLD);
+// Live play analytics under the score: speed, efficiency, and the clear mix so far.
+static void draw_analytics_panel(int origin_y, int origin_x) {
+    const EngineStats *stats = &g_engine.stats;
+    if (g_watch.enabled || stats->pieces == 0) {
+        return;
     }
+
+    term_set_attr(accent_attr(TERM_COLOR_WHITE, TERM_ATTR_DIM));
+    term_printf(origin_y, origin_x, "PPS %5.2f  KPP %5.2f", engine_stats_pps(stats), engine_stats_kpp(stats));
+    term_printf(origin_y + 1, origin_x, "APM %5.1f  Combo %3d", engine_stats_apm(stats), stats->max_combo);
+    term_printf(origin_y + 2, origin_x, "Stack %4.1f Holes %4.1f", engine_stats_mean_height(stats),
+                engine_stats_mean_holes(stats));
+    term_printf(origin_y + 3, origin_x, "1:%u 2:%u 3:%u 4:%u TS:%u PC:%u", stats->clears[ENGINE_CLEAR_SINGLE],
+                stats->clears[ENGINE_CLEAR_DOUBLE], stats->clears[ENGINE_CLEAR_TRIPLE],
+                stats->clears[ENGINE_CLEAR_TETRIS],
+                stats->clears[ENGINE_CLEAR_TSPIN_SINGLE] + stats->clears[ENGINE_CLEAR_TSPIN_DOUBLE] +
+                    stats->clears[ENGINE_CLEAR_TSPIN_TRIPLE],
+                stats->clears[ENGINE_CLEAR_PERFECT]);
+    term_set_attr(TERM_ATTR_NORMAL);
+}
+
+// Opponents side by side, one character per cell and one write per row; as many as fit.
+static void draw_opponents(int origin_y, int origin_x) {
+    int x = origin_x;
+    for (int p = 0; p < g_versus.player_count && p < VERSUS_MAX_PLAYERS; ++p) {
+        if (p == g_versus.self) {
+            continue;
+        }
+        if (x + OPPONENT_PANEL_WIDTH > term_cols()) {
+            break;
+        }
+
+        const Opponent *opponent = &g_versus.opponents[p];
+        term_set_attr(opponent->alive ? accent_attr(TERM_COLOR_WHITE, TERM_ATTR_NORMAL) : TERM_ATTR_DIM);
+        term_printf(origin_y - 2, x, "P%d %s", p + 1, opponent->alive ? "" : "KO");
+        term_printf(origin_y - 1, x, "%-*lu", BOARD_WIDTH + 2, (unsigned long)opponent->score);
+
+        char line[BOARD_WIDTH + 3];
+        line[0] = '|';
+        line[BOARD_WIDTH + 1] = '|';
+        line[BOARD_WIDTH + 2] = '\0';
+        for (int row = 0; row < BOARD_HEIGHT; ++row) {
+            for (int col = 0; col < BOARD_WIDTH; ++col) {
+                line[1 + col] = (opponent->rows[row] & (1U << col)) ? '#' : ' ';
+            }
+            term_put(origin_y + row, x, line);
+        }
+        memset(line, '-', BOARD_WIDTH + 2);
+        line[0] = '+';
+        line[BOARD_WIDTH + 1] = '+';
+        term_put(origin_y + BOARD_HEIGHT, x, line);
+        x += OPPONENT_PANEL_WIDTH;
+    }
+    term_set_attr(TERM_ATTR_NORMAL);
+}
+
+// Rolling frame-phase timings (microseconds) for the --debug-hud overlay.
+static void draw_debug_panel(int origin_y, int origin_x) {
+    if (term_cols() - origin_x < 24) {
+        return;
+    }
+
+    term_set_attr(accent_attr(TERM_COLOR_WHITE, TERM_ATTR_DIM));
+    term_put(origin_y, origin_x, "Timing us   p50    p99");
+    for (int phase = 0; phase < FRAME_PHASE_COUNT; ++phase) {
+        uint64_t p50 = 0;
+        uint64_t p99 = 0;
+        frame_stats_percentiles(&g_frame_stats, (FramePhase)phase, &p50, &p99);
+        term_printf(origin_y + 1 + phase, origin_x, "%-9s %6lu %6lu",
+                    frame_phase_name((FramePhase)phase), (unsigned long)p50, (unsigned long)p99);
+    }
+    term_set_attr(TERM_ATTR_NORMAL);
 }
 
 static void draw_next_piece_panel(int origin_y, int origin_x) {
-    mvprintw(origin_y, origin_x, "Next Piece:");
+    term_put(origin_y, origin_x, "Next Piece:");
 
-    move(origin_y + 1, origin_x);
-    addstr("+--------+");
+    term_put(origin_y + 1, origin_x, "+--------+");
     for (int row = 0; row < 4; ++row) {
-        move(origin_y + 2 + row, origin_x);
-        addch('|');
-        addstr("        ");
-        addch('|');
+        term_put(origin_y + 2 + row, origin_x, "|        |");
     }
-    move(origin_y + 6, origin_x);
-    addstr("+--------+");
+    term_put(origin_y + 6, origin_x, "+--------+");
 
-    draw_piece_preview(origin_y + 2, origin_x + 1, next_piece_shape());
+    draw_piece_preview(origin_y + 2, origin_x + 1, engine_next_shape(&g_engine));
 }
 
 static void draw_piece_preview(int origin_y, int origin_x, const PieceShape *shape) {
@@ -776,50 +1095,17 @@ static void draw_piece_preview(int origin_y, int origin_x, const PieceShape *sha
 
     const int preview_offset = (4 - shape->size) / 2;
     const char *pattern = shape->rotations[0];
+    term_set_attr(piece_attr(g_engine.next_piece_type));
     for (int r = 0; r < shape->size; ++r) {
         for (int c = 0; c < shape->size; ++c) {
             if (pattern[r * shape->size + c] != '1') {
                 continue;
             }
 
-            move(origin_y + preview_offset + r, origin_x + preview_offset * 2 + c * 2);
-            if (g_use_color) {
-                attron(COLOR_PAIR(1));
-            }
-            addstr("[]");
-            if (g_use_color) {
-                attroff(COLOR_PAIR(1));
-            }
-        }
-    }
-}
-
-// Render the transient trail left by a hard drop.
-static void draw_drop_flash(int origin_y, int origin_x) {
-    if (g_drop_flash_timer_ms == 0 || g_drop_flash_count == 0) {
-        return;
-    }
-
-    for (int i = 0; i < g_drop_flash_count; ++i) {
-        int row = g_drop_flash_row[i];
-        int col = g_drop_flash_col[i];
-        if (row < 0 || row >= BOARD_HEIGHT || col < 0 || col >= BOARD_WIDTH) {
-            continue;
-        }
-
-        move(origin_y + row, origin_x + col * 2);
-        if (g_use_color) {
-            attron(COLOR_PAIR(3));
-        } else {
-            attron(A_DIM);
-        }
-        addstr("::");
-        if (g_use_color) {
-            attroff(COLOR_PAIR(3));
-        } else {
-            attroff(A_DIM);
+            term_put(origin_y + preview_offset + r, origin_x + preview_offset * 2 + c * 2, "[]");
         }
     }
+    term_set_attr(TERM_ATTR_NORMAL);
 }
 
 // Display controls while waiting on the title screen.
@@ -828,48 +1114,68 @@ static void draw_title_overlay(void) {
     const char *subtitle = "Press ENTER to start, Q to quit";
     const char *controls = "Use arrows/WASD, space for hard drop";
 
-    int center_y = LINES / 3;
-    int center_x = COLS / 2;
+    int center_y = term_rows() / 3;
+    int center_x = term_cols() / 2;
 
-    if (g_use_color) {
-        attron(COLOR_PAIR(2));
-    } else {
-        attron(A_BOLD);
-    }
-    mvprintw(center_y, center_x - (int)strlen(title) / 2, "%s", title);
-    if (g_use_color) {
-        attroff(COLOR_PAIR(2));
-    } else {
-        attroff(A_BOLD);
-    }
+    term_set_attr(accent_attr(TERM_COLOR_YELLOW, TERM_ATTR_BOLD));
+    term_put(center_y, center_x - (int)strlen(title) / 2, title);
+    term_set_attr(TERM_ATTR_NORMAL);
+
+    term_put(center_y + 2, center_x - (int)strlen(subtitle) / 2, subtitle);
+    term_put(center_y + 3, center_x - (int)strlen(controls) / 2, controls);
+}
+
+static void draw_waiting_overlay(void) {
+    const char *title = g_watch.enabled ? "Waiting for the player..." : "Waiting for opponents...";
+    int center_y = term_rows() / 3;
+    int center_x = term_cols() / 2;
 
-    mvprintw(center_y + 2, center_x - (int)strlen(subtitle) / 2, "%s", subtitle);
-    mvprintw(center_y + 3, center_x - (int)strlen(controls) / 2, "%s", controls);
+    term_set_attr(accent_attr(TERM_COLOR_YELLOW, TERM_ATTR_BOLD));
+    term_put(center_y, center_x - (int)strlen(title) / 2, title);
+    term_set_attr(TERM_ATTR_NORMAL);
 }
 
 // Show final stats plus restart instructions when the player tops out.
 static void draw_game_over_overlay(void) {
     const char *title = "Game Over";
     const char *subtitle = "Press R to restart or Q to quit";
-
-    int center_y = LINES / 3;
-    int center_x = COLS / 2;
-
-    if (g_use_color) {
-        attron(COLOR_PAIR(2));
-    } else {
-        attron(A_BOLD);
+    char versus_title[32];
+    if (g_versus.enabled) {
+        if (!g_versus.finished) {
+            title = "Knocked Out";
+            subtitle = "Waiting for the match to finish";
+        } else if (g_versus.conn.closed) {
+            title = "Disconnected";
+            subtitle = "Press Q to quit";
+        } else if (g_versus.winner == g_versus.self) {
+            title = "You Win!";
+            subtitle = "Press R for a rematch or Q to quit";
+        } else {
+            snprintf(versus_title, sizeof(versus_title), "Player %d Wins", g_versus.winner + 1);
+            title = (g_versus.winner == VERSUS_NO_PLAYER) ? "Draw" : versus_title;
+            subtitle = "Press R for a rematch or Q to quit";
+        }
+    } else if (g_watch.enabled) {
+        title = g_watch.ended ? "Broadcast Ended" : "Game Over";
+        subtitle = "Press Q to quit";
     }
 
-    mvprintw(center_y, center_x - (int)strlen(title) / 2, "%s", title);
-    mvprintw(center_y + 2, center_x - (int)strlen(subtitle) / 2, "%s", subtitle);
-    mvprintw(center_y + 4, center_x - 12, "Score     : %d", g_score.current);
-    mvprintw(center_y + 5, center_x - 12, "High Score: %d", g_score.high);
-    mvprintw(center_y + 6, center_x - 12, "Lines     : %d", g_total_lines_cleared);
+    int center_y = term_rows() / 3;
+    int center_x = term_cols() / 2;
 
-    if (g_use_color) {
-        attroff(COLOR_PAIR(2));
-    } else {
-        attroff(A_BOLD);
+    term_set_attr(accent_attr(TERM_COLOR_YELLOW, TERM_ATTR_BOLD));
+    term_put(center_y, center_x - (int)strlen(title) / 2, title);
+    term_put(center_y + 2, center_x - (int)strlen(subtitle) / 2, subtitle);
+    term_printf(center_y + 4, center_x - 12, "Score     : %" PRId64, g_engine.score.current);
+    term_printf(center_y + 5, center_x - 12, "High Score: %" PRId64, g_engine.score.high);
+    term_printf(center_y + 6, center_x - 12, "Lines     : %d", g_engine.total_lines_cleared);
+    if (g_engine.stats.pieces > 0 && !g_watch.enabled) {
+        term_printf(center_y + 8, center_x - 12, "PPS %.2f  KPP %.2f  APM %.1f", engine_stats_pps(&g_engine.stats),
+                    engine_stats_kpp(&g_engine.stats), engine_stats_apm(&g_engine.stats));
+    }
+    if (g_finesse.judged > 0) {
+        term_printf(center_y + 7, center_x - 12, "Finesse   : %" PRIu64 " faults, %" PRIu64 " extra keys", g_finesse.faults,
+                    g_finesse.extra_inputs);
     }
+    term_set_attr(TERM_ATTR_NORMAL);
 }
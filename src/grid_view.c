@@ -0,0 +1,238 @@
+#include "grid_view.h"
+
+#include <string.h>
+
+// Tiled live view of many games: snapshot slots written by simulation threads, and the
+// throttled, row-diffed tile renderer that reads them.
+
+// Two board rows per terminal cell, indexed by (top filled) | (bottom filled) << 1.
+static const char k_half_glyphs[4] = {' ', '\'', '.', ':'};
+
+// --- Snapshot slots -------------------------------------------------------------------------
+
+void grid_slot_init(GridSlot *slot) {
+    if (slot == NULL) {
+        return;
+    }
+
+    memset(slot->boards, 0, sizeof(slot->boards));
+    atomic_init(&slot->published, 0);
+    atomic_init(&slot->sequence[0], 0);
+    atomic_init(&slot->sequence[1], 0);
+    atomic_init(&slot->wanted, true);
+}
+
+void grid_board_from_engine(const Engine *engine, GridBoard *board) {
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            int cell = engine->board.cells[row][col];
+            board->cells[row][col] = (uint8_t)(cell < 0 ? 0 : cell > UINT8_MAX ? UINT8_MAX : cell);
+        }
+    }
+
+    const PieceShape *shape = engine->active.active ? engine_active_shape(engine) : NULL;
+    for (int r = 0; shape != NULL && r < shape->size; ++r) {
+        for (int c = 0; c < shape->size; ++c) {
+            int row = engine->active.row + r;
+            int col = engine->active.col + c;
+            if (row >= 0 && row < BOARD_HEIGHT && col >= 0 && col < BOARD_WIDTH &&
+                piece_shape_cell_filled(shape, engine->active.rotation, r, c)) {
+                board->cells[row][col] = (uint8_t)(engine->active.type + 1);
+            }
+        }
+    }
+    board->score = (uint32_t)(engine->score.current > UINT32_MAX ? UINT32_MAX : engine->score.current);
+    board->lines = (uint32_t)engine->total_lines_cleared;
+    board->pieces = engine->stats.pieces;
+    board->phase = (uint8_t)engine->phase;
+}
+
+// Writes the buffer the viewer was not pointed at, then points it there. The request flag
+// is cleared first, so a request made while publishing asks for one more snapshot rather
+// than being lost.
+void grid_slot_publish(GridSlot *slot, const Engine *engine) {
+    if (slot == NULL || engine == NULL) {
+        return;
+    }
+
+    atomic_store_explicit(&slot->wanted, false, memory_order_relaxed);
+    uint32_t published = atomic_load_explicit(&slot->published, memory_order_relaxed);
+    unsigned index = (published & 1U) ^ 1U;
+    uint32_t sequence = atomic_load_explicit(&slot->sequence[index], memory_order_relaxed);
+    atomic_store_explicit(&slot->sequence[index], sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    grid_board_from_engine(engine, &slot->boards[index]);
+    atomic_store_explicit(&slot->sequence[index], sequence + 2, memory_order_release);
+    atomic_store_explicit(&slot->published, (((published >> 1) + 1) << 1) | index, memory_order_release);
+}
+
+// Copies the newest snapshot when it is newer than *generation: 1 when board and
+// *generation were updated, 0 when nothing newer was published, -1 when the writer reused
+// the buffer during the copy (it had published twice since this read started).
+int grid_slot_read(GridSlot *slot, uint32_t *generation, GridBoard *board) {
+    uint32_t published = atomic_load_explicit(&slot->published, memory_order_acquire);
+    if ((published >> 1) == *generation) {
+        return 0;
+    }
+
+    unsigned index = published & 1U;
+    uint32_t before = atomic_load_explicit(&slot->sequence[index], memory_order_acquire);
+    if (before & 1U) {
+        return -1;
+    }
+    memcpy(board, &slot->boards[index], sizeof(*board));
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&slot->sequence[index], memory_order_relaxed) != before) {
+        return -1;
+    }
+    *generation = published >> 1;
+    return 1;
+}
+
+// --- Rendering ------------------------------------------------------------------------------
+
+void grid_image_from_board(const GridBoard *board, GridImage *image) {
+    for (int row = 0; row < GRID_TILE_ROWS; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            uint8_t top = board->cells[2 * row][col];
+            uint8_t bottom = board->cells[2 * row + 1][col];
+            image->glyphs[row][col] = k_half_glyphs[(top != 0) | (bottom != 0) << 1];
+            image->colors[row][col] = (top != 0) ? top : bottom;
+        }
+    }
+}
+
+static TermAttr cell_attr(const GridView *view, uint8_t cell) {
+    if (!view->color || cell == 0) {
+        return TERM_ATTR_NORMAL;
+    }
+    return (TermAttr)term_piece_color(cell - 1);
+}
+
+// Recomputes how many tiles fit; after a resize every tile is drawn again from scratch.
+static void update_layout(GridView *view) {
+    int rows = term_rows();
+    int cols = term_cols();
+    if (rows == view->screen_rows && cols == view->screen_cols) {
+        return;
+    }
+
+    view->screen_rows = rows;
+    view->screen_cols = cols;
+    view->columns = (cols + GRID_TILE_GAP) / (GRID_TILE_WIDTH + GRID_TILE_GAP);
+    int tile_rows = (rows - 1) / GRID_TILE_HEIGHT; // row 0 is the caller's status line
+    int fit = (view->columns > 0 && tile_rows > 0) ? view->columns * tile_rows : 0;
+    view->shown = (fit < view->count) ? fit : view->count;
+    for (int i = 0; i < view->count; ++i) {
+        view->tiles[i].generation = 0;
+        view->tiles[i].due_us = 0;
+        view->tiles[i].drawn = false;
+    }
+    term_clear();
+}
+
+// Sends the label and board rows that differ from what the tile shows, one run per color.
+// Returns whether anything was sent.
+static bool draw_tile(GridView *view, int index, const GridBoard *board) {
+    GridTile *tile = &view->tiles[index];
+    bool changed = !tile->drawn;
+    int y = 1 + (index / view->columns) * GRID_TILE_HEIGHT;
+    int x = (index % view->columns) * (GRID_TILE_WIDTH + GRID_TILE_GAP);
+    bool over = board->phase == ENGINE_PHASE_GAME_OVER;
+
+    if (!tile->drawn || tile->score != board->score || tile->phase != board->phase) {
+        term_set_attr(over ? TERM_ATTR_DIM : TERM_ATTR_NORMAL);
+        term_printf(y, x, "%2d %9lu", index + 1, (unsigned long)board->score);
+        tile->score = board->score;
+        tile->phase = board->phase;
+        changed = true;
+    }
+    if (!tile->drawn) {
+        char floor[GRID_TILE_WIDTH + 1];
+        memset(floor, '-', GRID_TILE_WIDTH);
+        floor[0] = '+';
+        floor[GRID_TILE_WIDTH - 1] = '+';
+        floor[GRID_TILE_WIDTH] = '\0';
+        term_set_attr(TERM_ATTR_NORMAL);
+        term_put(y + 1 + GRID_TILE_ROWS, x, floor);
+        for (int row = 0; row < GRID_TILE_ROWS; ++row) {
+            term_putc(y + 1 + row, x, '|');
+            term_putc(y + 1 + row, x + GRID_TILE_WIDTH - 1, '|');
+        }
+    }
+
+    GridImage image;
+    grid_image_from_board(board, &image);
+    for (int row = 0; row < GRID_TILE_ROWS; ++row) {
+        if (tile->drawn && memcmp(image.glyphs[row], tile->image.glyphs[row], BOARD_WIDTH) == 0 &&
+            memcmp(image.colors[row], tile->image.colors[row], BOARD_WIDTH) == 0) {
+            continue;
+        }
+        for (int start = 0; start < BOARD_WIDTH;) {
+            TermAttr attr = cell_attr(view, image.colors[row][start]);
+            char run[BOARD_WIDTH + 1];
+            int length = 0;
+            while (start + length < BOARD_WIDTH && cell_attr(view, image.colors[row][start + length]) == attr) {
+                run[length] = image.glyphs[row][start + length];
+                ++length;
+            }
+            run[length] = '\0';
+            term_set_attr(over ? (TermAttr)(attr | TERM_ATTR_DIM) : attr);
+            term_put(y + 1 + row, x + 1 + start, run);
+            start += length;
+        }
+        view->rows_written++;
+        changed = true;
+    }
+    term_set_attr(TERM_ATTR_NORMAL);
+    tile->image = image;
+    tile->drawn = true;
+    return changed;
+}
+
+int grid_view_init(GridView *view, GridSlot *slots, int count, uint32_t interval_ms) {
+    if (view == NULL || slots == NULL || count < GRID_MIN_BOARDS || count > GRID_MAX_BOARDS) {
+        return -1;
+    }
+
+    memset(view, 0, sizeof(*view));
+    view->slots = slots;
+    view->count = count;
+    view->interval_us = (uint64_t)interval_ms * 1000U;
+    view->color = term_has_colors();
+    view->screen_rows = -1;
+    view->screen_cols = -1;
+    return 0;
+}
+
+// One viewer pass. A tile whose interval has not run out is skipped without touching its
+// slot; otherwise it takes the newest snapshot, or asks its game for one when there is
+// none yet. Returns how many tiles changed on screen; the caller flushes when any did.
+int grid_view_draw(GridView *view, uint64_t now_us) {
+    if (view == NULL) {
+        return 0;
+    }
+
+    update_layout(view);
+    int redrawn = 0;
+    for (int i = 0; i < view->shown; ++i) {
+        GridTile *tile = &view->tiles[i];
+        if (now_us < tile->due_us) {
+            continue;
+        }
+
+        GridBoard board;
+        int read = grid_slot_read(&view->slots[i], &tile->generation, &board);
+        if (read <= 0) {
+            view->torn_reads += (read < 0);
+            atomic_store_explicit(&view->slots[i].wanted, true, memory_order_relaxed);
+            continue;
+        }
+        tile->due_us = now_us + view->interval_us;
+        if (draw_tile(view, i, &board)) {
+            view->tile_redraws++;
+            ++redrawn;
+        }
+    }
+    return redrawn;
+}
@@ -0,0 +1,402 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "hint.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "arena.h"
+#include "perft.h"
+
+// Best-placement search for the in-game hint, and the worker thread that runs it.
+
+#define HINT_MAILBOX_FRESH 4U
+#define HINT_LOST -1e9
+#define HINT_IDLE_SLEEP_NS 1000000L
+
+// --- Single-slot mailbox ----------------------------------------------------------------
+
+static void mailbox_init(HintMailbox *box) {
+    box->writer = 0;
+    atomic_init(&box->shared, 1U);
+    box->reader = 2;
+}
+
+// The writer's buffer is filled: make it the shared one and keep whichever was there.
+static void mailbox_publish(HintMailbox *box) {
+    unsigned previous =
+        atomic_exchange_explicit(&box->shared, box->writer | HINT_MAILBOX_FRESH, memory_order_acq_rel);
+    box->writer = previous & ~HINT_MAILBOX_FRESH;
+}
+
+// Swap the shared buffer in as the reader's when it holds something not yet taken. Only
+// the reader clears the fresh bit, so a fresh load here means the exchange gets a value.
+static bool mailbox_take(HintMailbox *box) {
+    if ((atomic_load_explicit(&box->shared, memory_order_relaxed) & HINT_MAILBOX_FRESH) == 0) {
+        return false;
+    }
+    unsigned previous = atomic_exchange_explicit(&box->shared, box->reader, memory_order_acq_rel);
+    box->reader = previous & ~HINT_MAILBOX_FRESH;
+    return true;
+}
+
+// --- Search ---------------------------------------------------------------------------------
+
+// Hand-set weights: lines cleared against high, bumpy stacks with covered holes.
+const HintWeights hint_default_weights = {{-0.51, 0.76, -0.36, -0.18, 0.0, 0.0, 0.0}};
+
+// Features of the board whose row r is rows[r], so flat and copy-on-write boards share it.
+static void features_from_rows(const int *const rows[BOARD_HEIGHT], int cleared, double *features_out) {
+    int heights[BOARD_WIDTH];
+    int aggregate = 0;
+    int tallest = 0;
+    int holes = 0;
+    for (int col = 0; col < BOARD_WIDTH; ++col) {
+        heights[col] = 0;
+        bool covered = false;
+        for (int row = 0; row < BOARD_HEIGHT; ++row) {
+            if (rows[row][col] != 0) {
+                if (!covered) {
+                    heights[col] = BOARD_HEIGHT - row;
+                    covered = true;
+                }
+            } else if (covered) {
+                ++holes;
+            }
+        }
+        aggregate += heights[col];
+        if (heights[col] > tallest) {
+            tallest = heights[col];
+        }
+    }
+
+    int bumpiness = 0;
+    int wells = 0;
+    for (int col = 0; col < BOARD_WIDTH; ++col) {
+        int left = (col > 0) ? heights[col - 1] : BOARD_HEIGHT;
+        int right = (col + 1 < BOARD_WIDTH) ? heights[col + 1] : BOARD_HEIGHT;
+        int rim = (left < right) ? left : right;
+        if (rim > heights[col]) {
+            wells += rim - heights[col];
+        }
+        if (col + 1 < BOARD_WIDTH) {
+            bumpiness += abs(heights[col] - heights[col + 1]);
+        }
+    }
+
+    int transitions = 0;
+    for (int row = BOARD_HEIGHT - tallest; row < BOARD_HEIGHT; ++row) {
+        bool filled = true;
+        for (int col = 0; col <= BOARD_WIDTH; ++col) {
+            bool cell = (col == BOARD_WIDTH) || rows[row][col] != 0;
+            transitions += cell != filled;
+            filled = cell;
+        }
+    }
+
+    features_out[HINT_FEATURE_HEIGHT] = aggregate;
+    features_out[HINT_FEATURE_LINES] = cleared;
+    features_out[HINT_FEATURE_HOLES] = holes;
+    features_out[HINT_FEATURE_BUMPINESS] = bumpiness;
+    features_out[HINT_FEATURE_MAX_HEIGHT] = tallest;
+    features_out[HINT_FEATURE_WELLS] = wells;
+    features_out[HINT_FEATURE_ROW_TRANSITIONS] = transitions;
+}
+
+void hint_features(const Board *board, int cleared, double *features_out) {
+    const int *rows[BOARD_HEIGHT];
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        rows[row] = board->cells[row];
+    }
+    features_from_rows(rows, cleared, features_out);
+}
+
+// Higher is better: the weighted sum of the board's features.
+static double evaluate_rows(const int *const rows[BOARD_HEIGHT], int cleared, const HintWeights *weights) {
+    double features[HINT_FEATURE_COUNT];
+    features_from_rows(rows, cleared, features);
+    double value = 0.0;
+    for (int i = 0; i < HINT_FEATURE_COUNT; ++i) {
+        value += weights->weights[i] * features[i];
+    }
+    return value;
+}
+
+double hint_evaluate_weights(const Board *board, int cleared, const HintWeights *weights) {
+    const int *rows[BOARD_HEIGHT];
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        rows[row] = board->cells[row];
+    }
+    return evaluate_rows(rows, cleared, weights);
+}
+
+double hint_evaluate(const Board *board, int cleared) {
+    return hint_evaluate_weights(board, cleared, &hint_default_weights);
+}
+
+double hint_evaluate_cow_weights(const CowBoard *board, int cleared, const HintWeights *weights) {
+    const int *rows[BOARD_HEIGHT];
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        rows[row] = board->rows[row]->cells;
+    }
+    return evaluate_rows(rows, cleared, weights);
+}
+
+double hint_evaluate_cow(const CowBoard *board, int cleared) {
+    return hint_evaluate_cow_weights(board, cleared, &hint_default_weights);
+}
+
+// A piece locked with cells above the visible board would lose them; treat it as a loss.
+bool hint_locks_above_board(const ActivePiece *placement) {
+    const PieceShape *shape = piece_shape_get((size_t)placement->type);
+    for (int r = 0; r < shape->size && placement->row + r < 0; ++r) {
+        for (int c = 0; c < shape->size; ++c) {
+            if (piece_shape_cell_filled(shape, placement->rotation, r, c)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// A search notices within one placement that the game has moved on to another piece.
+// Child boards are copy-on-write, with rows from the worker thread's arena; failed is set
+// when that runs out, and the search gives up as if cancelled.
+typedef struct {
+    _Atomic uint64_t *latest_id;
+    uint64_t id;
+    bool cancelled;
+    CowRowPool rows;
+    bool failed;
+} HintSearch;
+
+static bool search_cancelled(HintSearch *search) {
+    if (!search->cancelled && search->latest_id != NULL &&
+        atomic_load_explicit(search->latest_id, memory_order_relaxed) != search->id) {
+        search->cancelled = true;
+    }
+    return search->cancelled || search->failed;
+}
+
+// Clone board, lock the placement into the clone and clear its lines. Returns the lines
+// cleared, or -1 (child released) when no row could be had.
+static int place_child(HintSearch *search, const CowBoard *board, const ActivePiece *placement, CowBoard *child) {
+    const PieceShape *shape = piece_shape_get((size_t)placement->type);
+    cow_board_clone(child, board);
+    if (cow_board_lock_shape(&search->rows, child, shape, placement->rotation, placement->row, placement->col,
+                             placement->type + 1) != 0) {
+        cow_board_release(&search->rows, child);
+        search->failed = true;
+        return -1;
+    }
+    return cow_board_clear_completed_lines(&search->rows, child, NULL, 0);
+}
+
+static double best_value(HintSearch *search, const CowBoard *board, const int *queue, int depth, int cleared);
+
+// Value of placing `piece` as well as possible, then searching the rest of the queue.
+static double piece_value(HintSearch *search, const CowBoard *board, int piece, const int *queue, int depth,
+                          int cleared) {
+    ActivePiece placements[PERFT_MAX_PLACEMENTS];
+    int count = perft_generate_cow(board, piece, placements, PERFT_MAX_PLACEMENTS);
+    double best = HINT_LOST;
+    for (int i = 0; i < count && !search_cancelled(search); ++i) {
+        if (hint_locks_above_board(&placements[i])) {
+            continue;
+        }
+        CowBoard child;
+        int lines = place_child(search, board, &placements[i], &child);
+        if (lines < 0) {
+            break;
+        }
+        double value = (depth > 1) ? best_value(search, &child, queue + 1, depth - 1, cleared + lines)
+                                   : hint_evaluate_cow(&child, cleared + lines);
+        cow_board_release(&search->rows, &child);
+        if (value > best) {
+            best = value;
+        }
+    }
+    return best;
+}
+
+// queue[0] is the piece to place; -1 stands for a piece not yet known, averaged over all.
+static double best_value(HintSearch *search, const CowBoard *board, const int *queue, int depth, int cleared) {
+    if (queue[0] >= 0) {
+        return piece_value(search, board, queue[0], queue, depth, cleared);
+    }
+
+    int types = (int)piece_shape_count();
+    double total = 0.0;
+    for (int piece = 0; piece < types; ++piece) {
+        total += piece_value(search, board, piece, queue, depth, cleared);
+    }
+    return total / types;
+}
+
+static bool search_root(HintSearch *search, const HintRequest *request, const int *queue, int depth,
+                        HintResult *result) {
+    CowBoard root;
+    if (cow_board_from_board(&search->rows, &root, &request->board) != 0) {
+        return false;
+    }
+
+    ActivePiece placements[PERFT_MAX_PLACEMENTS];
+    int count = perft_generate_cow(&root, request->piece, placements, PERFT_MAX_PLACEMENTS);
+    for (int i = 0; i < count; ++i) {
+        CowBoard child;
+        int lines = place_child(search, &root, &placements[i], &child);
+        if (lines < 0) {
+            break;
+        }
+        double value = HINT_LOST;
+        if (!hint_locks_above_board(&placements[i])) {
+            value = (depth > 1) ? best_value(search, &child, queue + 1, depth - 1, lines)
+                                : hint_evaluate_cow(&child, lines);
+        }
+        cow_board_release(&search->rows, &child);
+        if (search_cancelled(search)) {
+            break;
+        }
+        if (!result->found || value > result->value) {
+            result->found = true;
+            result->value = value;
+            result->placement = placements[i];
+        }
+    }
+    cow_board_release(&search->rows, &root);
+    return !search_cancelled(search);
+}
+
+// Search `depth` pieces ahead (current, preview, then unknown pieces) for the current
+// piece's best placement. Returns false without a result when latest_id moves past the
+// request, i.e. the piece has already locked and nobody wants the answer any more.
+bool hint_search(const HintRequest *request, int depth, _Atomic uint64_t *latest_id, HintResult *result) {
+    if (request == NULL || result == NULL || request->piece < 0 ||
+        (size_t)request->piece >= piece_shape_count()) {
+        return false;
+    }
+    if (depth < 1) {
+        depth = 1;
+    } else if (depth > HINT_MAX_DEPTH) {
+        depth = HINT_MAX_DEPTH;
+    }
+
+    int queue[HINT_MAX_DEPTH];
+    queue[0] = request->piece;
+    queue[1] = request->next;
+    for (int i = 2; i < HINT_MAX_DEPTH; ++i) {
+        queue[i] = -1;
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->id = request->id;
+    result->value = HINT_LOST;
+
+    Arena *arena = arena_thread_local();
+    ArenaMark mark = arena_mark(arena);
+    HintSearch search;
+    search.latest_id = latest_id;
+    search.id = request->id;
+    search.cancelled = false;
+    search.failed = false;
+    cow_pool_init(&search.rows, arena);
+    bool done = search_root(&search, request, queue, depth, result);
+    cow_pool_destroy(&search.rows);
+    arena_reset_to(arena, mark);
+    return done;
+}
+
+// --- Worker -------------------------------------------------------------------------------
+
+static void *worker_main(void *arg) {
+    HintWorker *worker = arg;
+    const struct timespec idle = {0, HINT_IDLE_SLEEP_NS};
+    while (!atomic_load_explicit(&worker->stopping, memory_order_acquire)) {
+        if (!mailbox_take(&worker->requests)) {
+            nanosleep(&idle, NULL);
+            continue;
+        }
+
+        const HintRequest *request = &worker->request_slots[worker->requests.reader];
+        HintResult *result = &worker->result_slots[worker->results.writer];
+        PcSolution solution;
+        worker->perfect_clear.id = request->id;
+        if (worker->perfect_clear_ready && request->queue_length > 0 &&
+            pc_solve(&worker->perfect_clear, &request->board, request->queue, request->queue_length, &solution)) {
+            memset(result, 0, sizeof(*result));
+            result->id = request->id;
+            result->found = true;
+            result->placement = solution.placements[0];
+            result->perfect_clear = true;
+            mailbox_publish(&worker->results);
+        } else if (hint_search(request, worker->depth, &worker->latest_id, result)) {
+            mailbox_publish(&worker->results);
+        }
+    }
+    return NULL;
+}
+
+int hint_worker_start(HintWorker *worker, int depth) {
+    if (worker == NULL) {
+        return -1;
+    }
+
+    memset(worker, 0, sizeof(*worker));
+    mailbox_init(&worker->requests);
+    mailbox_init(&worker->results);
+    atomic_init(&worker->latest_id, 0);
+    atomic_init(&worker->stopping, false);
+    worker->depth = depth;
+    worker->perfect_clear_ready = pc_solver_init(&worker->perfect_clear, 1, HINT_PC_NODE_BUDGET) == 0;
+    worker->perfect_clear.latest_id = &worker->latest_id;
+    if (pthread_create(&worker->thread, NULL, worker_main, worker) != 0) {
+        pc_solver_free(&worker->perfect_clear);
+        return -1;
+    }
+    worker->running = true;
+    return 0;
+}
+
+// Hand the worker a new position. Never blocks; an older request still in the slot is
+// replaced, and a search already running for one stops at its next candidate.
+void hint_worker_post(HintWorker *worker, const HintRequest *request) {
+    if (worker == NULL || !worker->running || request == NULL) {
+        return;
+    }
+
+    worker->request_slots[worker->requests.writer] = *request;
+    atomic_store_explicit(&worker->latest_id, request->id, memory_order_release);
+    mailbox_publish(&worker->requests);
+}
+
+// Newest result for request `id`, if the worker has finished it. Never blocks; results
+// for earlier pieces are dropped as they come in.
+bool hint_worker_poll(HintWorker *worker, uint64_t id, HintResult *result) {
+    if (worker == NULL || !worker->running) {
+        return false;
+    }
+
+    while (mailbox_take(&worker->results)) {
+        worker->current = worker->result_slots[worker->results.reader];
+    }
+    if (!worker->current.found || worker->current.id != id) {
+        return false;
+    }
+    if (result != NULL) {
+        *result = worker->current;
+    }
+    return true;
+}
+
+void hint_worker_stop(HintWorker *worker) {
+    if (worker == NULL || !worker->running) {
+        return;
+    }
+
+    atomic_store_explicit(&worker->stopping, true, memory_order_release);
+    atomic_store_explicit(&worker->latest_id, UINT64_MAX, memory_order_release);
+    pthread_join(worker->thread, NULL);
+    pc_solver_free(&worker->perfect_clear);
+    worker->running = false;
+}
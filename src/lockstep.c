@@ -0,0 +1,591 @@
+#include "lockstep.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include "metrics.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LOCKSTEP_HAVE_AVX2 1
+#include <immintrin.h>
+#else
+#define LOCKSTEP_HAVE_AVX2 0
+#endif
+
+// Structure-of-arrays stepping of many engines: the vector and scalar kernels for the
+// falling-piece frames, and the hand-off to engine.c for everything else.
+
+#define LOCKSTEP_PIECE_TYPES 7
+#define LOCKSTEP_SHAPES (LOCKSTEP_PIECE_TYPES * 4)
+#define LOCKSTEP_WALLS ((uint16_t)~(((1U << BOARD_WIDTH) - 1U) << LOCKSTEP_PAD))
+#define LOCKSTEP_LAST_WINDOW (LOCKSTEP_ROWS - 4)
+
+// Each (type, rotation) as four 16-bit pattern rows, bit 16 * r + c for pattern cell (r, c),
+// matching a 64-bit load of four board rows. Shifted left by the column plus the pad, no
+// cell crosses into the next row: filled cells of a pose one step from a legal one land
+// on board columns -1 to 10, which are bits 3 to 14.
+static uint64_t g_patterns[LOCKSTEP_SHAPES];
+static pthread_once_t g_patterns_once = PTHREAD_ONCE_INIT;
+
+static void build_patterns(void) {
+    for (int type = 0; type < LOCKSTEP_PIECE_TYPES && type < (int)piece_shape_count(); ++type) {
+        const PieceShape *shape = piece_shape_get((size_t)type);
+        for (int rotation = 0; rotation < shape->rotation_count && rotation < 4; ++rotation) {
+            for (int r = 0; r < shape->size && r < 4; ++r) {
+                for (int c = 0; c < shape->size && c < 4; ++c) {
+                    if (piece_shape_cell_filled(shape, rotation, r, c)) {
+                        g_patterns[type * 4 + rotation] |= 1ULL << (16 * r + c);
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool lockstep_avx2_supported(void) {
+#if LOCKSTEP_HAVE_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+const char *lockstep_kernel_name(LockstepKernel kernel) {
+    switch (kernel) {
+        case LOCKSTEP_KERNEL_AUTO:
+            return "auto";
+        case LOCKSTEP_KERNEL_SCALAR:
+            return "scalar";
+        case LOCKSTEP_KERNEL_AVX2:
+            return "avx2";
+    }
+    return "unknown";
+}
+
+// --- Lane hand-off -------------------------------------------------------------------------
+
+// Writes the hot fields back into the lane's Engine; a lane the Engine plays every frame
+// has none.
+static void sync_lane(LockstepBatch *batch, int lane) {
+    if (!batch->live[lane] || batch->engine_only[lane]) {
+        return;
+    }
+
+    Engine *engine = &batch->engines[lane];
+    engine->active.rotation = batch->shape[lane] & 3;
+    engine->active.row = batch->row[lane];
+    engine->active.col = batch->col[lane];
+    engine->last_move_rotation = batch->last_move_rotation[lane] != 0;
+    engine->lock_pending = batch->lock_pending[lane] != 0;
+    engine->lock_timer_ms = batch->lock_timer_ms[lane];
+    engine->gravity_accumulator_ms = batch->gravity_accumulator_ms[lane];
+    engine->stats.play_ms += batch->play_ms[lane];
+    batch->play_ms[lane] = 0;
+}
+
+// Reads the hot fields, board masks included, from the lane's Engine.
+static void load_lane(LockstepBatch *batch, int lane) {
+    const Engine *engine = &batch->engines[lane];
+    bool live = engine->phase == ENGINE_PHASE_PLAYING && !batch->stopped[lane];
+    batch->playing += (int)live - (batch->live[lane] != 0);
+    batch->live[lane] = live ? -1 : 0;
+    batch->shape[lane] = 0;
+    batch->row[lane] = 0;
+    batch->col[lane] = 0;
+    if (!live) {
+        return;
+    }
+
+    const PieceShape *shape = engine_active_shape(engine);
+    bool engine_only = !engine->active.active || shape == NULL || engine->active.type >= LOCKSTEP_PIECE_TYPES ||
+                       engine_gravity_is_instant(engine);
+    batch->engine_only[lane] = engine_only ? -1 : 0;
+    if (!batch->engine_only[lane]) {
+        batch->shape[lane] = engine->active.type * 4 + engine->active.rotation;
+        batch->rotation_count[lane] = shape->rotation_count;
+        batch->row[lane] = engine->active.row;
+        batch->col[lane] = engine->active.col;
+    }
+    batch->last_move_rotation[lane] = engine->last_move_rotation ? -1 : 0;
+    batch->lock_pending[lane] = engine->lock_pending ? -1 : 0;
+    batch->lock_timer_ms[lane] = (uint32_t)engine->lock_timer_ms;
+    batch->gravity_accumulator_ms[lane] = (uint32_t)engine->gravity_accumulator_ms;
+    batch->gravity_interval_ms[lane] = (uint32_t)engine->gravity_interval_ms;
+    batch->gravity_rows[lane] = (uint32_t)engine->gravity_rows;
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        unsigned bits = LOCKSTEP_WALLS;
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            bits |= (unsigned)(engine->board.cells[row][col] != 0) << (col + LOCKSTEP_PAD);
+        }
+        batch->rows[lane][row + LOCKSTEP_PAD] = (uint16_t)bits;
+    }
+}
+
+// A whole frame played by the Engine, exactly as perf_engine_step.
+static void engine_frame(LockstepBatch *batch, int lane, PerfKey key, uint64_t frame_ms) {
+    sync_lane(batch, lane);
+    perf_engine_step(&batch->engines[lane], key, frame_ms);
+    load_lane(batch, lane);
+}
+
+// The tick half of a frame whose key the kernel already applied.
+static void engine_tick_lane(LockstepBatch *batch, int lane, uint64_t frame_ms) {
+    sync_lane(batch, lane);
+    engine_tick(&batch->engines[lane], frame_ms);
+    EngineEvents events;
+    engine_take_events(&batch->engines[lane], &events);
+    load_lane(batch, lane);
+}
+
+// --- Scalar kernel -------------------------------------------------------------------------
+
+// Splits the playing lanes into those the kernel steps (mask set, key in input) and those
+// the Engine plays this frame, returned as a bit per lane.
+static uint32_t plan_scalar(LockstepBatch *batch, const uint8_t *keys, int32_t *input, int32_t *mask,
+                            bool vector_ticks, int lanes) {
+    uint32_t engine_lanes = 0;
+    for (int lane = 0; lane < lanes; ++lane) {
+        int32_t key = (keys[lane] < PERF_KEY_COUNT) ? keys[lane] : PERF_KEY_IDLE;
+        bool live = batch->live[lane] != 0;
+        bool engine = live && (batch->engine_only[lane] || key == PERF_KEY_HARD_DROP || !vector_ticks);
+        batch->frames[lane] += live;
+        input[lane] = key;
+        mask[lane] = (live && !engine) ? -1 : 0;
+        engine_lanes |= (uint32_t)engine << lane;
+    }
+    return engine_lanes;
+}
+
+// The four board rows from `row` as one word, in the layout of g_patterns.
+static uint64_t board_window(const LockstepBatch *batch, int lane, int row) {
+    int first = row + LOCKSTEP_PAD;
+    first = (first < 0) ? 0 : (first > LOCKSTEP_LAST_WINDOW) ? LOCKSTEP_LAST_WINDOW : first;
+    uint64_t window;
+    memcpy(&window, &batch->rows[lane][first], sizeof(window));
+    return window;
+}
+
+static bool lane_fits(const LockstepBatch *batch, int lane, int shape, int row, int col) {
+    int shift = col + LOCKSTEP_PAD;
+    if (shift < 0 || shift > 15) {
+        return false;
+    }
+    return (board_window(batch, lane, row) & (g_patterns[shape] << shift)) == 0;
+}
+
+// engine_shift, engine_rotate, and engine_soft_drop for lanes without instant gravity.
+static void input_scalar(LockstepBatch *batch, const int32_t *keys, const int32_t *mask, int lanes) {
+    uint64_t checks = 0;
+    uint64_t failed = 0;
+    for (int lane = 0; lane < lanes; ++lane) {
+        int32_t key = keys[lane];
+        if (!mask[lane] || key == PERF_KEY_IDLE) {
+            continue;
+        }
+
+        int shape = batch->shape[lane];
+        int row = batch->row[lane] + (key == PERF_KEY_SOFT_DROP);
+        int col = batch->col[lane] + (key == PERF_KEY_RIGHT) - (key == PERF_KEY_LEFT);
+        if (key == PERF_KEY_ROTATE) {
+            int rotation = (shape & 3) + 1;
+            shape = (shape & ~3) | ((rotation == batch->rotation_count[lane]) ? 0 : rotation);
+        }
+        ++checks;
+        if (lane_fits(batch, lane, shape, row, col)) {
+            batch->shape[lane] = shape;
+            batch->row[lane] = row;
+            batch->col[lane] = col;
+            batch->last_move_rotation[lane] = (key == PERF_KEY_ROTATE) ? -1 : 0;
+            if (key != PERF_KEY_SOFT_DROP) {
+                batch->lock_pending[lane] = 0;
+                batch->lock_timer_ms[lane] = 0;
+            }
+        } else if (key == PERF_KEY_SOFT_DROP && !batch->lock_pending[lane]) {
+            batch->lock_pending[lane] = -1;
+            batch->lock_timer_ms[lane] = 0;
+        } else if (key == PERF_KEY_ROTATE) {
+            ++failed;
+        }
+    }
+    metrics_add(METRIC_COLLISION_CHECKS, checks);
+    if (failed > 0) {
+        metrics_add(METRIC_ROTATIONS_FAILED, failed);
+    }
+}
+
+// engine_tick: gravity as one drop of up to `rows` rows, then the lock timer. A lane whose
+// lock delay may run out this frame ends in a lock, so it is left for the Engine and
+// returned as a bit.
+static uint32_t tick_scalar(LockstepBatch *batch, const int32_t *mask, uint32_t delta_ms, int lanes) {
+    uint64_t checks = 0;
+    uint32_t expiring = 0;
+    for (int lane = 0; lane < lanes; ++lane) {
+        if (!mask[lane]) {
+            continue;
+        }
+        if (batch->lock_pending[lane] && batch->lock_timer_ms[lane] + delta_ms >= ENGINE_LOCK_DELAY_MS) {
+            expiring |= 1U << lane;
+            continue;
+        }
+
+        batch->play_ms[lane] += delta_ms;
+        uint32_t accumulator = batch->gravity_accumulator_ms[lane] + delta_ms * batch->gravity_rows[lane];
+        uint32_t rows = accumulator / batch->gravity_interval_ms[lane];
+        batch->gravity_accumulator_ms[lane] = accumulator - rows * batch->gravity_interval_ms[lane];
+        if (rows > 0) {
+            uint32_t distance = 0;
+            while (distance < rows) {
+                ++checks;
+                if (!lane_fits(batch, lane, batch->shape[lane], batch->row[lane] + (int)distance + 1,
+                               batch->col[lane])) {
+                    break;
+                }
+                ++distance;
+            }
+            if (distance > 0) {
+                batch->row[lane] += (int32_t)distance;
+                batch->last_move_rotation[lane] = 0;
+                batch->lock_pending[lane] = 0;
+                batch->lock_timer_ms[lane] = 0;
+            }
+            if (distance < rows && !batch->lock_pending[lane]) {
+                batch->lock_pending[lane] = -1;
+                batch->lock_timer_ms[lane] = 0;
+            }
+        }
+        if (batch->lock_pending[lane]) {
+            batch->lock_timer_ms[lane] += delta_ms;
+        }
+    }
+    metrics_add(METRIC_COLLISION_CHECKS, checks);
+    return expiring;
+}
+
+// --- AVX2 kernel ---------------------------------------------------------------------------
+
+#if LOCKSTEP_HAVE_AVX2
+
+#define LOCKSTEP_AVX2 __attribute__((target("avx2")))
+
+static LOCKSTEP_AVX2 int lanes_set(__m256i mask) {
+    return __builtin_popcount((unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+}
+
+// All-ones where the pose fits. Each half of the vector gathers four lanes' board windows
+// and patterns as 64-bit words; indices are clamped so masked-out lanes stay in bounds.
+static LOCKSTEP_AVX2 __m256i fits8(const LockstepBatch *batch, __m256i lane, __m256i shape, __m256i row,
+                                   __m256i col) {
+    const long long *rows = (const long long *)(const void *)&batch->rows[0][0];
+    const long long *patterns = (const long long *)(const void *)g_patterns;
+    __m256i first = _mm256_add_epi32(row, _mm256_set1_epi32(LOCKSTEP_PAD));
+    first = _mm256_min_epi32(_mm256_max_epi32(first, _mm256_setzero_si256()), _mm256_set1_epi32(LOCKSTEP_LAST_WINDOW));
+    __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(lane, _mm256_set1_epi32(LOCKSTEP_ROWS)), first);
+    __m256i shift = _mm256_add_epi32(col, _mm256_set1_epi32(LOCKSTEP_PAD));
+
+    __m256i fit[2];
+    for (int half = 0; half < 2; ++half) {
+        __m128i index4 = half ? _mm256_extracti128_si256(index, 1) : _mm256_castsi256_si128(index);
+        __m128i shape4 = half ? _mm256_extracti128_si256(shape, 1) : _mm256_castsi256_si128(shape);
+        __m128i shift4 = half ? _mm256_extracti128_si256(shift, 1) : _mm256_castsi256_si128(shift);
+        __m256i window = _mm256_i32gather_epi64(rows, index4, 2);
+        __m256i pattern = _mm256_sllv_epi64(_mm256_i32gather_epi64(patterns, shape4, 8), _mm256_cvtepi32_epi64(shift4));
+        fit[half] = _mm256_cmpeq_epi64(_mm256_and_si256(window, pattern), _mm256_setzero_si256());
+    }
+    // Back to one 32-bit mask per lane: the low halves of the 64-bit results, in order.
+    __m256i low = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    return _mm256_blend_epi32(_mm256_permutevar8x32_epi32(fit[0], low), _mm256_permutevar8x32_epi32(fit[1], low),
+                              0xF0);
+}
+
+static LOCKSTEP_AVX2 __m256i load8(const void *p) {
+    return _mm256_loadu_si256((const __m256i *)p);
+}
+
+static LOCKSTEP_AVX2 void store8(void *p, __m256i v) {
+    _mm256_storeu_si256((__m256i *)p, v);
+}
+
+static LOCKSTEP_AVX2 uint32_t plan_avx2(LockstepBatch *batch, const uint8_t *keys, int32_t *input, int32_t *mask,
+                                        bool vector_ticks, int lanes) {
+    uint32_t engine_lanes = 0;
+    __m256i always = vector_ticks ? _mm256_setzero_si256() : _mm256_set1_epi32(-1);
+    for (int base = 0; base < lanes; base += LOCKSTEP_VECTOR_LANES) {
+        __m256i key = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(const void *)(keys + base)));
+        key = _mm256_andnot_si256(_mm256_cmpgt_epi32(key, _mm256_set1_epi32(PERF_KEY_COUNT - 1)), key);
+        __m256i live = load8(batch->live + base);
+        __m256i engine = _mm256_or_si256(_mm256_or_si256(load8(batch->engine_only + base), always),
+                                         _mm256_cmpeq_epi32(key, _mm256_set1_epi32(PERF_KEY_HARD_DROP)));
+        engine = _mm256_and_si256(live, engine);
+        store8(batch->frames + base, _mm256_sub_epi32(load8(batch->frames + base), live));
+        store8(input + base, key);
+        store8(mask + base, _mm256_andnot_si256(engine, live));
+        engine_lanes |= (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(engine)) << base;
+    }
+    return engine_lanes;
+}
+
+static LOCKSTEP_AVX2 void input_avx2(LockstepBatch *batch, const int32_t *keys, const int32_t *mask, int lanes) {
+    uint64_t checks = 0;
+    uint64_t failed = 0;
+    for (int base = 0; base < lanes; base += LOCKSTEP_VECTOR_LANES) {
+        __m256i active = load8(mask + base);
+        if (_mm256_testz_si256(active, active)) {
+            continue;
+        }
+
+        __m256i key = load8(keys + base);
+        __m256i left = _mm256_and_si256(active, _mm256_cmpeq_epi32(key, _mm256_set1_epi32(PERF_KEY_LEFT)));
+        __m256i right = _mm256_and_si256(active, _mm256_cmpeq_epi32(key, _mm256_set1_epi32(PERF_KEY_RIGHT)));
+        __m256i soft = _mm256_and_si256(active, _mm256_cmpeq_epi32(key, _mm256_set1_epi32(PERF_KEY_SOFT_DROP)));
+        __m256i rotate = _mm256_and_si256(active, _mm256_cmpeq_epi32(key, _mm256_set1_epi32(PERF_KEY_ROTATE)));
+        __m256i moving = _mm256_or_si256(_mm256_or_si256(left, right), _mm256_or_si256(soft, rotate));
+        if (_mm256_testz_si256(moving, moving)) {
+            continue;
+        }
+
+        // Masks are -1, so subtracting one adds one.
+        __m256i row = load8(batch->row + base);
+        __m256i col = load8(batch->col + base);
+        __m256i shape = load8(batch->shape + base);
+        __m256i next_row = _mm256_sub_epi32(row, soft);
+        __m256i next_col = _mm256_add_epi32(_mm256_sub_epi32(col, right), left);
+        __m256i rotation = _mm256_add_epi32(_mm256_and_si256(shape, _mm256_set1_epi32(3)), _mm256_set1_epi32(1));
+        __m256i wrap = _mm256_cmpeq_epi32(rotation, load8(batch->rotation_count + base));
+        __m256i rotated = _mm256_or_si256(_mm256_andnot_si256(_mm256_set1_epi32(3), shape),
+                                          _mm256_andnot_si256(wrap, rotation));
+        __m256i next_shape = _mm256_blendv_epi8(shape, rotated, rotate);
+
+        __m256i lane = _mm256_add_epi32(_mm256_set1_epi32(base), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256i fit = _mm256_and_si256(moving, fits8(batch, lane, next_shape, next_row, next_col));
+        checks += (uint64_t)lanes_set(moving);
+        failed += (uint64_t)lanes_set(_mm256_andnot_si256(fit, rotate));
+
+        store8(batch->row + base, _mm256_blendv_epi8(row, next_row, fit));
+        store8(batch->col + base, _mm256_blendv_epi8(col, next_col, fit));
+        store8(batch->shape + base, _mm256_blendv_epi8(shape, next_shape, fit));
+        __m256i last_rotation = load8(batch->last_move_rotation + base);
+        store8(batch->last_move_rotation + base, _mm256_blendv_epi8(last_rotation, rotate, fit));
+
+        // A successful shift or rotation cancels the lock delay; a blocked soft drop starts it.
+        __m256i pending = load8(batch->lock_pending + base);
+        __m256i timer = load8(batch->lock_timer_ms + base);
+        __m256i cancel = _mm256_andnot_si256(soft, fit);
+        __m256i blocked = _mm256_andnot_si256(fit, soft);
+        __m256i begin = _mm256_andnot_si256(pending, blocked);
+        pending = _mm256_or_si256(_mm256_andnot_si256(cancel, pending), blocked);
+        timer = _mm256_andnot_si256(_mm256_or_si256(cancel, begin), timer);
+        store8(batch->lock_pending + base, pending);
+        store8(batch->lock_timer_ms + base, timer);
+    }
+    metrics_add(METRIC_COLLISION_CHECKS, checks);
+    if (failed > 0) {
+        metrics_add(METRIC_ROTATIONS_FAILED, failed);
+    }
+}
+
+static LOCKSTEP_AVX2 uint32_t tick_avx2(LockstepBatch *batch, const int32_t *mask, uint32_t delta_ms, int lanes) {
+    uint64_t checks = 0;
+    uint32_t expiring = 0;
+    __m256i delta = _mm256_set1_epi32((int)delta_ms);
+    __m256i one = _mm256_set1_epi32(1);
+    for (int base = 0; base < lanes; base += LOCKSTEP_VECTOR_LANES) {
+        __m256i active = load8(mask + base);
+        if (_mm256_testz_si256(active, active)) {
+            continue;
+        }
+        __m256i expires = _mm256_cmpgt_epi32(_mm256_add_epi32(load8(batch->lock_timer_ms + base), delta),
+                                             _mm256_set1_epi32((int)ENGINE_LOCK_DELAY_MS - 1));
+        expires = _mm256_and_si256(_mm256_and_si256(active, load8(batch->lock_pending + base)), expires);
+        expiring |= (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(expires)) << base;
+        active = _mm256_andnot_si256(expires, active);
+        if (_mm256_testz_si256(active, active)) {
+            continue;
+        }
+
+        __m256i play = load8(batch->play_ms + base);
+        store8(batch->play_ms + base, _mm256_add_epi32(play, _mm256_and_si256(delta, active)));
+
+        // Division by repeated subtraction: below 20G a frame rarely owes more than a row.
+        __m256i interval = load8(batch->gravity_interval_ms + base);
+        __m256i accumulator = _mm256_add_epi32(load8(batch->gravity_accumulator_ms + base),
+                                               _mm256_and_si256(active, _mm256_mullo_epi32(
+                                                                            delta, load8(batch->gravity_rows + base))));
+        __m256i rows = _mm256_setzero_si256();
+        for (;;) {
+            __m256i owed = _mm256_andnot_si256(_mm256_cmpgt_epi32(interval, accumulator), active);
+            if (_mm256_testz_si256(owed, owed)) {
+                break;
+            }
+            accumulator = _mm256_sub_epi32(accumulator, _mm256_and_si256(interval, owed));
+            rows = _mm256_sub_epi32(rows, owed);
+        }
+        store8(batch->gravity_accumulator_ms + base, accumulator);
+
+        __m256i falling = _mm256_cmpgt_epi32(rows, _mm256_setzero_si256());
+        if (_mm256_testz_si256(falling, falling)) {
+            __m256i pending = _mm256_and_si256(active, load8(batch->lock_pending + base));
+            __m256i timer = load8(batch->lock_timer_ms + base);
+            store8(batch->lock_timer_ms + base, _mm256_add_epi32(timer, _mm256_and_si256(delta, pending)));
+            continue;
+        }
+
+        // Step every falling lane down one row at a time until it is blocked or has moved
+        // its rows; the same distance engine_ghost_row would give, capped at `rows`.
+        __m256i lane = _mm256_add_epi32(_mm256_set1_epi32(base), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256i shape = load8(batch->shape + base);
+        __m256i row = load8(batch->row + base);
+        __m256i col = load8(batch->col + base);
+        __m256i distance = _mm256_setzero_si256();
+        while (!_mm256_testz_si256(falling, falling)) {
+            checks += (uint64_t)lanes_set(falling);
+            __m256i below = _mm256_add_epi32(_mm256_add_epi32(row, distance), one);
+            falling = _mm256_and_si256(falling, fits8(batch, lane, shape, below, col));
+            distance = _mm256_sub_epi32(distance, falling);
+            falling = _mm256_and_si256(falling, _mm256_cmpgt_epi32(rows, distance));
+        }
+
+        __m256i moved = _mm256_cmpgt_epi32(distance, _mm256_setzero_si256());
+        __m256i landed = _mm256_cmpgt_epi32(rows, distance);
+        __m256i pending = _mm256_andnot_si256(moved, load8(batch->lock_pending + base));
+        __m256i timer = _mm256_andnot_si256(moved, load8(batch->lock_timer_ms + base));
+        timer = _mm256_andnot_si256(_mm256_andnot_si256(pending, landed), timer);
+        pending = _mm256_or_si256(pending, landed);
+        store8(batch->row + base, _mm256_add_epi32(row, distance));
+        store8(batch->last_move_rotation + base,
+               _mm256_andnot_si256(moved, load8(batch->last_move_rotation + base)));
+        store8(batch->lock_pending + base, pending);
+        __m256i counting = _mm256_and_si256(active, pending);
+        store8(batch->lock_timer_ms + base, _mm256_add_epi32(timer, _mm256_and_si256(delta, counting)));
+    }
+    metrics_add(METRIC_COLLISION_CHECKS, checks);
+    return expiring;
+}
+
+#endif /* LOCKSTEP_HAVE_AVX2 */
+
+// --- Batch ---------------------------------------------------------------------------------
+
+int lockstep_init(LockstepBatch *batch, int lane_count, LockstepKernel kernel) {
+    if (batch == NULL || lane_count < 1 || lane_count > LOCKSTEP_MAX_LANES) {
+        return -1;
+    }
+    if (kernel == LOCKSTEP_KERNEL_AUTO) {
+        kernel = lockstep_avx2_supported() ? LOCKSTEP_KERNEL_AVX2 : LOCKSTEP_KERNEL_SCALAR;
+    }
+    if (kernel == LOCKSTEP_KERNEL_AVX2 && !lockstep_avx2_supported()) {
+        return -1;
+    }
+
+    pthread_once(&g_patterns_once, build_patterns);
+    memset(batch, 0, sizeof(*batch));
+    batch->lane_count = lane_count;
+    batch->kernel = kernel;
+    for (int lane = 0; lane < LOCKSTEP_MAX_LANES; ++lane) {
+        for (int row = 0; row < LOCKSTEP_ROWS; ++row) {
+            batch->rows[lane][row] = (row < LOCKSTEP_PAD + BOARD_HEIGHT) ? LOCKSTEP_WALLS : UINT16_MAX;
+        }
+        if (lane < lane_count) {
+            engine_init(&batch->engines[lane], 0);
+        }
+    }
+    return 0;
+}
+
+// Starts a fresh game on a lane the way perf_engine_start does.
+void lockstep_start(LockstepBatch *batch, int lane, uint64_t seed) {
+    if (batch == NULL || lane < 0 || lane >= batch->lane_count) {
+        return;
+    }
+
+    batch->stopped[lane] = false;
+    batch->frames[lane] = 0;
+    batch->play_ms[lane] = 0;
+    perf_engine_start(&batch->engines[lane], seed);
+    load_lane(batch, lane);
+}
+
+// engine_set_level on a lane, e.g. to start a population at a higher speed.
+void lockstep_set_level(LockstepBatch *batch, int lane, int level) {
+    if (batch == NULL || lane < 0 || lane >= batch->lane_count) {
+        return;
+    }
+
+    sync_lane(batch, lane);
+    engine_set_level(&batch->engines[lane], level);
+    load_lane(batch, lane);
+}
+
+// One frame on every playing lane, keys[lane] being its PerfKey. Returns the lanes still
+// playing, or -1 for bad arguments.
+int lockstep_step(LockstepBatch *batch, const uint8_t *keys, uint64_t frame_ms) {
+    if (batch == NULL || keys == NULL) {
+        return -1;
+    }
+
+    uint8_t padded[LOCKSTEP_MAX_LANES] = {0};
+    int32_t input[LOCKSTEP_MAX_LANES];
+    int32_t mask[LOCKSTEP_MAX_LANES];
+    memcpy(padded, keys, (size_t)batch->lane_count);
+    int lanes = (batch->lane_count + LOCKSTEP_VECTOR_LANES - 1) / LOCKSTEP_VECTOR_LANES * LOCKSTEP_VECTOR_LANES;
+    bool vector_ticks = frame_ms < ENGINE_LOCK_DELAY_MS;
+    uint32_t engine_lanes;
+    uint32_t expiring;
+
+#if LOCKSTEP_HAVE_AVX2
+    if (batch->kernel == LOCKSTEP_KERNEL_AVX2) {
+        engine_lanes = plan_avx2(batch, padded, input, mask, vector_ticks, lanes);
+        input_avx2(batch, input, mask, lanes);
+        expiring = tick_avx2(batch, mask, (uint32_t)frame_ms, lanes);
+    } else
+#endif
+    {
+        engine_lanes = plan_scalar(batch, padded, input, mask, vector_ticks, lanes);
+        input_scalar(batch, input, mask, lanes);
+        expiring = tick_scalar(batch, mask, (uint32_t)frame_ms, lanes);
+    }
+
+    for (; engine_lanes != 0; engine_lanes &= engine_lanes - 1) {
+        int lane = __builtin_ctz(engine_lanes);
+        engine_frame(batch, lane, (PerfKey)input[lane], frame_ms);
+    }
+    for (; expiring != 0; expiring &= expiring - 1) {
+        engine_tick_lane(batch, __builtin_ctz(expiring), frame_ms);
+    }
+    return batch->playing;
+}
+
+// Masks a lane out, e.g. when its script has ended; lockstep_start brings it back.
+void lockstep_stop(LockstepBatch *batch, int lane) {
+    if (batch == NULL || lane < 0 || lane >= batch->lane_count) {
+        return;
+    }
+
+    sync_lane(batch, lane);
+    batch->stopped[lane] = true;
+    load_lane(batch, lane);
+}
+
+// The lane's Engine with the hot fields written back.
+const Engine *lockstep_engine(LockstepBatch *batch, int lane) {
+    if (batch == NULL || lane < 0 || lane >= batch->lane_count) {
+        return NULL;
+    }
+
+    sync_lane(batch, lane);
+    return &batch->engines[lane];
+}
+
+// Same figures perf_replay_engine reports for the lane's game so far.
+void lockstep_result(LockstepBatch *batch, int lane, PerfSessionResult *result) {
+    const Engine *engine = lockstep_engine(batch, lane);
+    if (engine == NULL || result == NULL) {
+        return;
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->frames = batch->frames[lane];
+    result->pieces = engine->stats.pieces;
+    result->lines = (uint32_t)engine->total_lines_cleared;
+    result->score = engine->score.current;
+    result->topped_out = engine->phase == ENGINE_PHASE_GAME_OVER;
+}
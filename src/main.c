@@ -1,12 +1,128 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include "game.h"
+#include "match_server.h"
 
 // Entry point that wires the terminal lifecycle to the game module.
 
-int main(void) {
-    if (game_init() != 0) {
+static void print_usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [--debug-hud] [--hint] [--trace FILE] [--stats-file FILE] [--session FILE]\n"
+            "       [--analytics FILE]\n"
+            "       [--renderer ncurses|vt100] [--versus ADDR] [--spectate ADDR] [--watch ADDR]\n"
+            "       %s --serve ADDR [--players N]\n"
+            "  --debug-hud   show rolling p50/p99 frame timings next to the score panel\n"
+            "  --hint        outline the best placement for each piece, searched on a background\n"
+            "                thread (not available in versus or watch mode)\n"
+            "  --trace FILE  write Chrome trace-event JSON for every frame to FILE\n"
+            "  --stats-file FILE  refresh Prometheus-format runtime counters in FILE every second\n"
+            "  --session FILE  autosave the game after every lock and resume it on the next launch\n"
+            "  --analytics FILE  append each finished game's PPS, KPP, APM, clear counts, and stack\n"
+            "                    shape to FILE as one JSON line\n"
+            "  --renderer NAME  output backend: ncurses (default) or vt100 (raw ANSI, one write per\n"
+            "                   frame; falls back to ncurses when the terminal is not a tty)\n"
+            "  --versus ADDR  play a versus match through the server at ADDR (unix:PATH or tcp:PORT)\n"
+            "  --spectate ADDR  broadcast this game to viewers on ADDR (unix:PATH, tcp:PORT) or\n"
+            "                   through a shared-memory ring (shm:NAME)\n"
+            "  --watch ADDR  view a game broadcast with --spectate (read-only)\n"
+            "  --serve ADDR   run a headless match server pairing clients into matches of N (2-8)\n",
+            program, program);
+}
+
+typedef struct {
+    const char *address;
+    int players;
+} ServeOptions;
+
+// Strict decimal in [min, max]; anything else (trailing text, overflow) is rejected.
+static int parse_int(const char *text, int min, int max, int *out) {
+    char *end = NULL;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value < min || value > max) {
+        return -1;
+    }
+    *out = (int)value;
+    return 0;
+}
+
+static int parse_args(int argc, char **argv, GameOptions *options, ServeOptions *serve) {
+    bool players_given = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--debug-hud") == 0) {
+            options->debug_hud = true;
+        } else if (strcmp(argv[i], "--hint") == 0) {
+            options->hint = true;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            options->trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--stats-file") == 0 && i + 1 < argc) {
+            options->stats_path = argv[++i];
+        } else if (strcmp(argv[i], "--session") == 0 && i + 1 < argc) {
+            options->session_path = argv[++i];
+        } else if (strcmp(argv[i], "--analytics") == 0 && i + 1 < argc) {
+            options->analytics_path = argv[++i];
+        } else if (strcmp(argv[i], "--renderer") == 0 && i + 1 < argc) {
+            // The null renderer takes no input, so it is only for headless replays.
+            if (term_backend_parse(argv[++i], &options->backend) != 0 || options->backend == TERM_BACKEND_NULL) {
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--versus") == 0 && i + 1 < argc) {
+            options->versus_address = argv[++i];
+        } else if (strcmp(argv[i], "--spectate") == 0 && i + 1 < argc) {
+            const char *address = argv[++i];
+            if (strncmp(address, "shm:", 4) == 0) {
+                options->spectate_shm = address + 4;
+            } else {
+                options->spectate_address = address;
+            }
+        } else if (strcmp(argv[i], "--watch") == 0 && i + 1 < argc) {
+            options->watch_address = argv[++i];
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            serve->address = argv[++i];
+        } else if (strcmp(argv[i], "--players") == 0 && i + 1 < argc) {
+            if (parse_int(argv[++i], 2, VERSUS_MAX_PLAYERS, &serve->players) != 0) {
+                return -1;
+            }
+            players_given = true;
+        } else {
+            return -1;
+        }
+    }
+    // --players only sizes the server's matches.
+    return (players_given && serve->address == NULL) ? -1 : 0;
+}
+
+// Headless lobby for --serve; runs until the process is killed.
+static int run_match_server(const ServeOptions *serve) {
+    static MatchServer server;
+    if (match_server_open(&server, serve->address, serve->players, (uint64_t)time(NULL)) != 0) {
+        fprintf(stderr, "Failed to listen on %s.\n", serve->address);
+        return EXIT_FAILURE;
+    }
+
+    printf("Match server on %s, %d players per match.\n", serve->address, serve->players);
+    fflush(stdout);
+    while (match_server_poll(&server, 1000) == 0) {
+    }
+    match_server_close(&server);
+    return EXIT_FAILURE;
+}
+
+int main(int argc, char **argv) {
+    GameOptions options;
+    ServeOptions serve = {NULL, 2};
+    game_options_default(&options);
+    if (parse_args(argc, argv, &options, &serve) != 0) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (serve.address != NULL) {
+        return run_match_server(&serve);
+    }
+
+    if (game_init(&options) != 0) {
         fprintf(stderr, "Failed to initialize game.\n");
         return EXIT_FAILURE;
     }
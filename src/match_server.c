@@ -0,0 +1,328 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "match_server.h"
+
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <poll.h>
+#endif
+
+// Single-threaded match server: one poll() over the listening socket and every client,
+// each message handled as soon as it is decoded.
+
+static void drop_client(MatchServer *server, int index);
+
+static uint64_t next_match_seed(MatchServer *server) {
+    uint64_t z = (server->seed_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static void send_to(MatchServer *server, int index, const VersusMessage *message) {
+    MatchClient *client = &server->clients[index];
+    if (client->in_use && !client->conn.closed) {
+        versus_conn_send(&client->conn, message);
+    }
+}
+
+// Send to every connected member of a match except `skip` (-1 for everyone).
+static void broadcast(MatchServer *server, Match *match, int skip, const VersusMessage *message) {
+    for (int p = 0; p < match->player_count; ++p) {
+        if (p != skip && match->clients[p] >= 0) {
+            send_to(server, match->clients[p], message);
+        }
+    }
+}
+
+// Start a match from the oldest players in the lobby, all sharing one piece seed.
+static void start_match(MatchServer *server) {
+    Match *match = NULL;
+    for (int i = 0; i < MATCH_SERVER_MAX_CLIENTS / 2; ++i) {
+        if (!server->matches[i].active) {
+            match = &server->matches[i];
+            break;
+        }
+    }
+    if (match == NULL) {
+        return;
+    }
+
+    memset(match, 0, sizeof(*match));
+    match->active = true;
+    match->player_count = server->players_per_match;
+
+    VersusMessage message;
+    memset(&message, 0, sizeof(message));
+    message.type = VERSUS_MSG_MATCH;
+    message.player_count = (uint8_t)match->player_count;
+    message.seed = next_match_seed(server);
+
+    for (int p = 0; p < match->player_count; ++p) {
+        int index = server->lobby[p];
+        MatchClient *client = &server->clients[index];
+        client->waiting = false;
+        client->match = (int)(match - server->matches);
+        client->player = (uint8_t)p;
+        match->clients[p] = index;
+        match->alive[p] = true;
+        match->next_target[p] = (uint8_t)((p + 1) % match->player_count);
+
+        message.player = (uint8_t)p;
+        send_to(server, index, &message);
+    }
+
+    server->lobby_count -= match->player_count;
+    memmove(server->lobby, server->lobby + match->player_count, sizeof(int) * (size_t)server->lobby_count);
+}
+
+static void end_match(MatchServer *server, Match *match, uint8_t winner) {
+    VersusMessage message;
+    memset(&message, 0, sizeof(message));
+    message.type = VERSUS_MSG_RESULT;
+    message.player = winner;
+    broadcast(server, match, -1, &message);
+
+    for (int p = 0; p < match->player_count; ++p) {
+        if (match->clients[p] >= 0) {
+            server->clients[match->clients[p]].match = -1;
+        }
+    }
+    match->active = false;
+}
+
+static void eliminate(MatchServer *server, Match *match, int player) {
+    if (!match->alive[player]) {
+        return;
+    }
+    match->alive[player] = false;
+
+    VersusMessage message;
+    memset(&message, 0, sizeof(message));
+    message.type = VERSUS_MSG_TOPPED_OUT;
+    message.player = (uint8_t)player;
+    broadcast(server, match, player, &message);
+
+    int alive = 0;
+    uint8_t winner = VERSUS_NO_PLAYER;
+    for (int p = 0; p < match->player_count; ++p) {
+        if (match->alive[p]) {
+            ++alive;
+            winner = (uint8_t)p;
+        }
+    }
+    if (alive <= 1) {
+        end_match(server, match, winner);
+    }
+}
+
+// Attacks go to the next surviving opponent in turn, so garbage spreads around the table.
+static void route_attack(MatchServer *server, Match *match, int attacker, uint8_t lines) {
+    for (int step = 0; step < match->player_count; ++step) {
+        int target = (match->next_target[attacker] + step) % match->player_count;
+        if (target == attacker || !match->alive[target]) {
+            continue;
+        }
+
+        VersusMessage message;
+        memset(&message, 0, sizeof(message));
+        message.type = VERSUS_MSG_GARBAGE;
+        message.player = (uint8_t)attacker;
+        message.lines = lines;
+        send_to(server, match->clients[target], &message);
+        match->next_target[attacker] = (uint8_t)((target + 1) % match->player_count);
+        return;
+    }
+}
+
+static void handle_message(MatchServer *server, int index, VersusMessage *message) {
+    MatchClient *client = &server->clients[index];
+    Match *match = (client->match >= 0) ? &server->matches[client->match] : NULL;
+
+    switch (message->type) {
+        case VERSUS_MSG_HELLO:
+            if (message->version != VERSUS_PROTOCOL_VERSION) {
+                drop_client(server, index);
+                return;
+            }
+            if (match == NULL && !client->waiting) {
+                client->waiting = true;
+                server->lobby[server->lobby_count++] = index;
+                if (server->lobby_count >= server->players_per_match) {
+                    start_match(server);
+                }
+            }
+            break;
+        case VERSUS_MSG_ATTACK:
+            if (match != NULL && match->alive[client->player] && message->lines > 0) {
+                route_attack(server, match, client->player, message->lines);
+            }
+            break;
+        case VERSUS_MSG_BOARD:
+            if (match != NULL) {
+                message->player = client->player;
+                broadcast(server, match, client->player, message);
+            }
+            break;
+        case VERSUS_MSG_TOPPED_OUT:
+            if (match != NULL) {
+                eliminate(server, match, client->player);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void drop_client(MatchServer *server, int index) {
+    MatchClient *client = &server->clients[index];
+    if (!client->in_use) {
+        return;
+    }
+
+    if (client->waiting) {
+        for (int i = 0; i < server->lobby_count; ++i) {
+            if (server->lobby[i] == index) {
+                --server->lobby_count;
+                memmove(server->lobby + i, server->lobby + i + 1, sizeof(int) * (size_t)(server->lobby_count - i));
+                break;
+            }
+        }
+    }
+    if (client->match >= 0) {
+        Match *match = &server->matches[client->match];
+        match->clients[client->player] = -1;
+        eliminate(server, match, client->player);
+    }
+
+    versus_conn_close(&client->conn);
+    client->in_use = false;
+}
+
+static void accept_clients(MatchServer *server) {
+    for (;;) {
+        int fd = versus_accept(server->listen_fd);
+        if (fd < 0) {
+            return;
+        }
+
+        int slot = -1;
+        for (int i = 0; i < MATCH_SERVER_MAX_CLIENTS; ++i) {
+            if (!server->clients[i].in_use) {
+                slot = i;
+                break;
+            }
+        }
+        MatchClient *client = (slot >= 0) ? &server->clients[slot] : NULL;
+        if (client == NULL) {
+            VersusConn refused;
+            versus_conn_init(&refused, fd);
+            versus_conn_close(&refused);
+            continue;
+        }
+
+        versus_conn_init(&client->conn, fd);
+        client->in_use = true;
+        client->waiting = false;
+        client->match = -1;
+        client->player = 0;
+    }
+}
+
+int match_server_open(MatchServer *server, const char *address, int players_per_match, uint64_t seed) {
+    if (server == NULL || players_per_match < 2 || players_per_match > VERSUS_MAX_PLAYERS) {
+        return -1;
+    }
+
+    memset(server, 0, sizeof(*server));
+    server->players_per_match = players_per_match;
+    server->seed_state = seed;
+    server->listen_fd = versus_listen(address);
+    return (server->listen_fd < 0) ? -1 : 0;
+}
+
+#if defined(_WIN32)
+
+int match_server_poll(MatchServer *server, int timeout_ms) {
+    (void)server;
+    (void)timeout_ms;
+    return -1;
+}
+
+#else
+
+// Wait up to timeout_ms for activity, then accept, read, route, and flush everything ready.
+int match_server_poll(MatchServer *server, int timeout_ms) {
+    if (server == NULL || server->listen_fd < 0) {
+        return -1;
+    }
+
+    struct pollfd fds[MATCH_SERVER_MAX_CLIENTS + 1];
+    int owners[MATCH_SERVER_MAX_CLIENTS + 1];
+    nfds_t count = 0;
+    fds[count].fd = server->listen_fd;
+    fds[count].events = POLLIN;
+    owners[count++] = -1;
+    for (int i = 0; i < MATCH_SERVER_MAX_CLIENTS; ++i) {
+        MatchClient *client = &server->clients[i];
+        if (!client->in_use) {
+            continue;
+        }
+        fds[count].fd = client->conn.fd;
+        fds[count].events = (short)(POLLIN | (client->conn.out_len > 0 ? POLLOUT : 0));
+        owners[count++] = i;
+    }
+
+    if (poll(fds, count, timeout_ms) < 0) {
+        return 0;
+    }
+
+    if (fds[0].revents & POLLIN) {
+        accept_clients(server);
+    }
+    for (nfds_t k = 1; k < count; ++k) {
+        int index = owners[k];
+        MatchClient *client = &server->clients[index];
+        if (!client->in_use || fds[k].revents == 0) {
+            continue;
+        }
+
+        VersusMessage message;
+        while (client->in_use && versus_conn_receive(&client->conn, &message) > 0) {
+            handle_message(server, index, &message);
+        }
+        if (client->in_use && client->conn.closed) {
+            drop_client(server, index);
+        }
+    }
+
+    for (int i = 0; i < MATCH_SERVER_MAX_CLIENTS; ++i) {
+        MatchClient *client = &server->clients[i];
+        if (client->in_use && client->conn.out_len > 0 && versus_conn_flush(&client->conn) != 0) {
+            drop_client(server, i);
+        }
+    }
+    return 0;
+}
+
+#endif
+
+void match_server_close(MatchServer *server) {
+    if (server == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < MATCH_SERVER_MAX_CLIENTS; ++i) {
+        if (server->clients[i].in_use) {
+            versus_conn_close(&server->clients[i].conn);
+            server->clients[i].in_use = false;
+        }
+    }
+    if (server->listen_fd >= 0) {
+        VersusConn listener;
+        versus_conn_init(&listener, server->listen_fd);
+        versus_conn_close(&listener);
+        server->listen_fd = -1;
+    }
+}
@@ -0,0 +1,157 @@
+#include "metrics.h"
+
+#include <pthread.h>
+#include <string.h>
+
+// Always-on runtime counters: per-thread blocks aggregated on demand, exported as
+// Prometheus text so a local scraper can tail the stats file.
+
+_Thread_local MetricsBlock *metrics_thread_block = NULL;
+
+#define METRICS_OVERFLOW_BLOCK (METRICS_MAX_BLOCKS - 1)
+
+// The overflow block is shared from the start; every other block has one owner at a time.
+static MetricsBlock g_blocks[METRICS_MAX_BLOCKS] = {[METRICS_OVERFLOW_BLOCK] = {.shared = true}};
+static atomic_uint g_blocks_used = 0; // blocks ever handed out; the overflow block counts once
+
+// Blocks of exited threads, handed to the next new thread. Their counts stay in place, so
+// totals never go down; the mutex orders the old owner's last write before the new one's.
+static pthread_mutex_t g_free_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned g_free_blocks[METRICS_OVERFLOW_BLOCK];
+static unsigned g_free_count = 0;
+static pthread_key_t g_block_key;
+static pthread_once_t g_block_key_once = PTHREAD_ONCE_INIT;
+
+typedef struct {
+    const char *name;
+    const char *labels;
+    const char *help;
+} MetricDescriptor;
+
+// Metrics that share a name must be adjacent so HELP/TYPE are printed once.
+static const MetricDescriptor g_descriptors[METRIC_COUNT] = {
+    {"tetris_pieces_locked_total", NULL, "Pieces committed to the board."},
+    {"tetris_line_clears_total", "lines=\"1\"", "Line clear events by number of rows cleared."},
+    {"tetris_line_clears_total", "lines=\"2\"", NULL},
+    {"tetris_line_clears_total", "lines=\"3\"", NULL},
+    {"tetris_line_clears_total", "lines=\"4\"", NULL},
+    {"tetris_collision_checks_total", NULL, "board_can_place calls."},
+    {"tetris_rotations_failed_total", NULL, "Rotation attempts rejected by collision."},
+    {"tetris_frames_rendered_total", NULL, "Frames flushed to the terminal."},
+    {"tetris_terminal_bytes_total", NULL, "Bytes written to the terminal by backends that own their output path."},
+    {"tetris_score_saves_total", NULL, "Successful high score writes."}
+};
+
+// Thread-exit destructor: returns the thread's own block to the free list.
+static void release_block(void *block) {
+    MetricsBlock *owned = block;
+    metrics_thread_block = NULL;
+    if (owned == NULL || owned->shared) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_free_lock);
+    g_free_blocks[g_free_count++] = (unsigned)(owned - g_blocks);
+    pthread_mutex_unlock(&g_free_lock);
+}
+
+static void create_block_key(void) {
+    pthread_key_create(&g_block_key, release_block);
+}
+
+// Hand the calling thread its own block, reusing one an exited thread gave back; while
+// every block is owned, late threads share the overflow block.
+MetricsBlock *metrics_claim_block(void) {
+    if (metrics_thread_block != NULL) {
+        return metrics_thread_block;
+    }
+
+    pthread_once(&g_block_key_once, create_block_key);
+    pthread_mutex_lock(&g_free_lock);
+    unsigned slot = METRICS_OVERFLOW_BLOCK;
+    unsigned used = atomic_load_explicit(&g_blocks_used, memory_order_relaxed);
+    if (g_free_count > 0) {
+        slot = g_free_blocks[--g_free_count];
+    } else if (used < METRICS_OVERFLOW_BLOCK) {
+        slot = used;
+        atomic_store_explicit(&g_blocks_used, used + 1, memory_order_relaxed);
+    } else if (used == METRICS_OVERFLOW_BLOCK) {
+        atomic_store_explicit(&g_blocks_used, METRICS_MAX_BLOCKS, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&g_free_lock);
+
+    metrics_thread_block = &g_blocks[slot];
+    pthread_setspecific(g_block_key, metrics_thread_block);
+    return metrics_thread_block;
+}
+
+// Sum every claimed block. Values are monotonic, so a racing reader only lags slightly.
+void metrics_snapshot(uint64_t values_out[METRIC_COUNT]) {
+    if (values_out == NULL) {
+        return;
+    }
+
+    memset(values_out, 0, sizeof(uint64_t) * METRIC_COUNT);
+
+    unsigned used = atomic_load_explicit(&g_blocks_used, memory_order_relaxed);
+    for (unsigned block = 0; block < used; ++block) {
+        for (int id = 0; id < METRIC_COUNT; ++id) {
+            values_out[id] += atomic_load_explicit(&g_blocks[block].values[id], memory_order_relaxed);
+        }
+    }
+}
+
+int metrics_write_prometheus(FILE *fp, const uint64_t values[METRIC_COUNT]) {
+    if (fp == NULL || values == NULL) {
+        return -1;
+    }
+
+    for (int id = 0; id < METRIC_COUNT; ++id) {
+        const MetricDescriptor *desc = &g_descriptors[id];
+        if (desc->help != NULL) {
+            fprintf(fp, "# HELP %s %s\n", desc->name, desc->help);
+            fprintf(fp, "# TYPE %s counter\n", desc->name);
+        }
+
+        if (desc->labels != NULL) {
+            fprintf(fp, "%s{%s} %llu\n", desc->name, desc->labels, (unsigned long long)values[id]);
+        } else {
+            fprintf(fp, "%s %llu\n", desc->name, (unsigned long long)values[id]);
+        }
+    }
+
+    return ferror(fp) ? -1 : 0;
+}
+
+// Write a fresh snapshot next to the target and rename it over, so scrapers never see
+// a half-written file.
+int metrics_write_stats_file(const char *path) {
+    if (path == NULL) {
+        return -1;
+    }
+
+    char temp_path[512];
+    int written = snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    if (written < 0 || (size_t)written >= sizeof(temp_path)) {
+        return -1;
+    }
+
+    FILE *fp = fopen(temp_path, "w");
+    if (fp == NULL) {
+        return -1;
+    }
+
+    uint64_t values[METRIC_COUNT];
+    metrics_snapshot(values);
+    int status = metrics_write_prometheus(fp, values);
+    if (fclose(fp) != 0) {
+        status = -1;
+    }
+
+    if (status != 0 || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return -1;
+    }
+
+    return 0;
+}
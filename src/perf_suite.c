@@ -0,0 +1,329 @@
+#include "perf_suite.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "term.h"
+
+// Session scripts, headless engine replay, and the statistics behind the regression check.
+
+static const char k_key_chars[PERF_KEY_COUNT] = {'.', 'L', 'R', 'D', 'U', 'H'};
+
+static const char *const k_metric_names[PERF_METRIC_COUNT] = {
+    [PERF_METRIC_PIECES_PER_SEC] = "pieces_per_sec",
+    [PERF_METRIC_FRAMES_PER_SEC] = "frames_per_sec",
+    [PERF_METRIC_ALLOCS_PER_GAME] = "allocs_per_game",
+};
+
+// Two-sided 95% critical values of Student's t for 1-30 degrees of freedom.
+static const double k_t_critical[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+// --- Scripts -------------------------------------------------------------------------------
+
+static int key_from_char(char ch) {
+    for (int key = 0; key < PERF_KEY_COUNT; ++key) {
+        if (k_key_chars[key] == ch) {
+            return key;
+        }
+    }
+    return -1;
+}
+
+// Expands a script into one PerfKey per frame. Returns the frame count, or -1 for a bad
+// character, a bad repeat count, or more frames than `capacity`.
+int perf_script_decode(const char *script, uint8_t *keys, size_t capacity) {
+    if (script == NULL || (keys == NULL && capacity > 0)) {
+        return -1;
+    }
+
+    size_t count = 0;
+    for (const char *p = script; *p != '\0'; ++p) {
+        int repeat = 0;
+        int digits = 0;
+        for (; *p >= '0' && *p <= '9'; ++p, ++digits) {
+            repeat = repeat * 10 + (*p - '0');
+            if (repeat > PERF_MAX_RUN_LENGTH) {
+                return -1;
+            }
+        }
+        int key = key_from_char(*p);
+        if (key < 0 || (digits > 0 && repeat == 0)) {
+            return -1;
+        }
+        repeat = (digits == 0) ? 1 : repeat;
+        if ((size_t)repeat > capacity - count || count + (size_t)repeat > (size_t)INT32_MAX) {
+            return -1;
+        }
+        memset(keys + count, key, (size_t)repeat);
+        count += (size_t)repeat;
+    }
+    return (int)count;
+}
+
+// Run-length encodes keys; runs of three or more get a count. Returns the length written
+// (without the terminator), or -1 if it does not fit.
+int perf_script_encode(const uint8_t *keys, size_t count, char *buffer, size_t capacity) {
+    if ((keys == NULL && count > 0) || buffer == NULL || capacity == 0) {
+        return -1;
+    }
+
+    size_t used = 0;
+    for (size_t i = 0; i < count;) {
+        if (keys[i] >= PERF_KEY_COUNT) {
+            return -1;
+        }
+        size_t run = 1;
+        while (i + run < count && keys[i + run] == keys[i] && run < PERF_MAX_RUN_LENGTH) {
+            ++run;
+        }
+        char token[8];
+        int length = (int)run;
+        if (run >= 3) {
+            length = snprintf(token, sizeof(token), "%zu%c", run, k_key_chars[keys[i]]);
+        } else {
+            memset(token, k_key_chars[keys[i]], run);
+        }
+        if ((size_t)length >= capacity - used) {
+            return -1;
+        }
+        memcpy(buffer + used, token, (size_t)length);
+        used += (size_t)length;
+        i += run;
+    }
+    buffer[used] = '\0';
+    return (int)used;
+}
+
+// The key code game.c's input handler expects for a script key.
+int perf_key_term_code(PerfKey key) {
+    switch (key) {
+        case PERF_KEY_LEFT:
+            return TERM_KEY_LEFT;
+        case PERF_KEY_RIGHT:
+            return TERM_KEY_RIGHT;
+        case PERF_KEY_SOFT_DROP:
+            return TERM_KEY_DOWN;
+        case PERF_KEY_ROTATE:
+            return TERM_KEY_UP;
+        case PERF_KEY_HARD_DROP:
+            return ' ';
+        case PERF_KEY_IDLE:
+        case PERF_KEY_COUNT:
+            break;
+    }
+    return TERM_KEY_NONE;
+}
+
+// --- Headless replay -----------------------------------------------------------------------
+
+// Same sequence as a new game in game.c: reseed the running engine, then start it.
+void perf_engine_start(Engine *engine, uint64_t seed) {
+    engine_init(engine, 0);
+    engine_reseed(engine, seed);
+    engine_start(engine);
+}
+
+// One frame as game_loop plays it: the key first, then gravity for the frame time.
+void perf_engine_step(Engine *engine, PerfKey key, uint64_t frame_ms) {
+    switch (key) {
+        case PERF_KEY_LEFT:
+            engine_shift(engine, -1);
+            break;
+        case PERF_KEY_RIGHT:
+            engine_shift(engine, 1);
+            break;
+        case PERF_KEY_SOFT_DROP:
+            engine_soft_drop(engine);
+            break;
+        case PERF_KEY_ROTATE:
+            engine_rotate(engine, 1);
+            break;
+        case PERF_KEY_HARD_DROP:
+            engine_hard_drop(engine);
+            break;
+        case PERF_KEY_IDLE:
+        case PERF_KEY_COUNT:
+            break;
+    }
+    engine_tick(engine, frame_ms);
+    EngineEvents events;
+    engine_take_events(engine, &events);
+}
+
+// Plays a session on a bare engine, without the game module; the result must match what
+// game_run_script reports for the same session.
+int perf_replay_engine(uint64_t seed, const uint8_t *keys, size_t count, uint64_t frame_ms,
+                       PerfSessionResult *result) {
+    if ((keys == NULL && count > 0) || result == NULL) {
+        return -1;
+    }
+
+    Engine engine;
+    perf_engine_start(&engine, seed);
+    memset(result, 0, sizeof(*result));
+    for (size_t i = 0; i < count && engine.phase == ENGINE_PHASE_PLAYING; ++i) {
+        perf_engine_step(&engine, (PerfKey)keys[i], frame_ms);
+        ++result->frames;
+    }
+    result->pieces = engine.stats.pieces;
+    result->lines = (uint32_t)engine.total_lines_cleared;
+    result->score = engine.score.current;
+    result->topped_out = engine.phase == ENGINE_PHASE_GAME_OVER;
+    return 0;
+}
+
+// --- Statistics ----------------------------------------------------------------------------
+
+const char *perf_metric_name(PerfMetric metric) {
+    if ((int)metric < 0 || metric >= PERF_METRIC_COUNT) {
+        return "unknown";
+    }
+    return k_metric_names[metric];
+}
+
+bool perf_metric_higher_is_better(PerfMetric metric) {
+    return metric != PERF_METRIC_ALLOCS_PER_GAME;
+}
+
+void perf_sample_from_runs(const double *values, int count, PerfSample *sample) {
+    memset(sample, 0, sizeof(*sample));
+    if (values == NULL || count < 1) {
+        return;
+    }
+
+    double sum = 0.0;
+    for (int i = 0; i < count; ++i) {
+        sum += values[i];
+    }
+    double mean = sum / count;
+    double squares = 0.0;
+    for (int i = 0; i < count; ++i) {
+        squares += (values[i] - mean) * (values[i] - mean);
+    }
+    sample->count = count;
+    sample->mean = mean;
+    sample->stddev = (count > 1) ? sqrt(squares / (count - 1)) : 0.0;
+}
+
+// Table value for small samples; past 30 degrees of freedom t approaches 1.96 as 1/df.
+double perf_t_critical(double degrees_of_freedom) {
+    if (degrees_of_freedom < 1.0) {
+        return k_t_critical[0];
+    }
+    if (degrees_of_freedom <= 30.0) {
+        return k_t_critical[(int)degrees_of_freedom - 1];
+    }
+    return 1.960 + 2.45 / degrees_of_freedom;
+}
+
+// Half-width of the 95% confidence interval of the mean.
+double perf_sample_interval(const PerfSample *sample) {
+    if (sample == NULL || sample->count < 2) {
+        return 0.0;
+    }
+    return perf_t_critical(sample->count - 1) * sample->stddev / sqrt(sample->count);
+}
+
+// Welch's interval for the difference of two means. A regression is a change for the worse
+// that is larger than both the tolerance (a fraction of the baseline mean) and the interval,
+// so neither run-to-run noise nor a real but negligible slowdown fails the suite.
+void perf_compare(PerfMetric metric, const PerfSample *baseline, const PerfSample *current, double tolerance,
+                  PerfVerdict *verdict) {
+    memset(verdict, 0, sizeof(*verdict));
+    if (baseline == NULL || current == NULL || baseline->count < 1 || current->count < 1) {
+        return;
+    }
+
+    double a = baseline->stddev * baseline->stddev / baseline->count;
+    double b = current->stddev * current->stddev / current->count;
+    double degrees = 1.0;
+    if (baseline->count > 1 && current->count > 1 && a + b > 0.0) {
+        degrees = (a + b) * (a + b) / (a * a / (baseline->count - 1) + b * b / (current->count - 1));
+    }
+    double interval = perf_t_critical(degrees) * sqrt(a + b);
+    double better = perf_metric_higher_is_better(metric) ? current->mean - baseline->mean
+                                                          : baseline->mean - current->mean;
+    double scale = (baseline->mean != 0.0) ? fabs(baseline->mean) : 1.0;
+    verdict->change = better / scale;
+    verdict->noise = interval / scale;
+    verdict->regressed = -better > interval && -better > tolerance * scale;
+}
+
+// --- Baselines -----------------------------------------------------------------------------
+
+// Text file, one line per metric: name, run count, mean, standard deviation.
+int perf_baseline_save(const PerfBaseline *baseline, const char *path) {
+    if (baseline == NULL || path == NULL) {
+        return -1;
+    }
+
+    char temp_path[1024];
+    int written = snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    if (written < 0 || (size_t)written >= sizeof(temp_path)) {
+        return -1;
+    }
+    FILE *fp = fopen(temp_path, "w");
+    if (fp == NULL) {
+        return -1;
+    }
+    bool ok = fprintf(fp, "%s %d\n", PERF_BASELINE_MAGIC, PERF_BASELINE_VERSION) > 0;
+    ok = ok && fprintf(fp, "corpus %d %llu %llu\n", baseline->corpus.sessions,
+                       (unsigned long long)baseline->corpus.frames, (unsigned long long)baseline->corpus.pieces) > 0;
+    for (int m = 0; m < PERF_METRIC_COUNT && ok; ++m) {
+        const PerfSample *sample = &baseline->metrics[m];
+        ok = fprintf(fp, "%s %d %.17g %.17g\n", k_metric_names[m], sample->count, sample->mean, sample->stddev) > 0;
+    }
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return -1;
+    }
+    return 0;
+}
+
+int perf_baseline_load(PerfBaseline *baseline, const char *path) {
+    if (baseline == NULL || path == NULL) {
+        return -1;
+    }
+
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return -1;
+    }
+    memset(baseline, 0, sizeof(*baseline));
+    char magic[32];
+    int version = 0;
+    unsigned long long frames = 0;
+    unsigned long long pieces = 0;
+    bool ok = fscanf(fp, "%31s %d", magic, &version) == 2 && strcmp(magic, PERF_BASELINE_MAGIC) == 0 &&
+              version == PERF_BASELINE_VERSION &&
+              fscanf(fp, " corpus %d %llu %llu", &baseline->corpus.sessions, &frames, &pieces) == 3 &&
+              baseline->corpus.sessions > 0;
+    baseline->corpus.frames = frames;
+    baseline->corpus.pieces = pieces;
+    bool seen[PERF_METRIC_COUNT] = {false};
+    char name[32];
+    PerfSample sample;
+    while (ok && fscanf(fp, "%31s %d %lf %lf", name, &sample.count, &sample.mean, &sample.stddev) == 4) {
+        for (int m = 0; m < PERF_METRIC_COUNT; ++m) {
+            if (strcmp(name, k_metric_names[m]) == 0) {
+                baseline->metrics[m] = sample;
+                seen[m] = sample.count >= 1 && sample.stddev >= 0.0;
+            }
+        }
+    }
+    fclose(fp);
+    for (int m = 0; m < PERF_METRIC_COUNT; ++m) {
+        ok = ok && seen[m];
+    }
+    return ok ? 0 : -1;
+}
+
+bool perf_corpus_equal(const PerfCorpus *a, const PerfCorpus *b) {
+    return a->sessions == b->sessions && a->frames == b->frames && a->pieces == b->pieces;
+}
@@ -0,0 +1,515 @@
+#include "perfect_clear.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Perfect-clear search over packed 40-bit fields, run on several threads that share one
+// set of failed subproblems.
+
+#define PC_ROW_MASK ((1ULL << BOARD_WIDTH) - 1)
+#define PC_MAX_MOVES 64
+#define PC_PIECE_TYPES 7
+#define PC_PROBES 16
+#define PC_EPOCH_SHIFT 48
+#define PC_EPOCH_LIMIT (1ULL << 16)
+#define PC_NODE_BATCH 256
+
+// A piece in one rotation, anchored at the lower-left corner of its filled cells: placing
+// the anchor at field row y, column x is a shift of `cells` by y * BOARD_WIDTH + x.
+typedef struct {
+    int bottom; // pattern row of the lowest filled cell
+    int left;   // pattern column of the leftmost filled cell
+    int width;
+    int height;
+    int offsets[4]; // bit offset of each cell from the anchor
+    uint64_t cells;
+} PcRotation;
+
+typedef struct {
+    uint64_t mask; // field cells the piece fills
+    int rotation;
+    int y;   // field row of the piece's lowest cell, 0 at the bottom
+    int col; // pattern-box column
+} PcMove;
+
+static PcRotation g_rotations[PC_PIECE_TYPES][4];
+static pthread_once_t g_rotations_once = PTHREAD_ONCE_INIT;
+
+static void load_rotations(void) {
+    for (int type = 0; type < PC_PIECE_TYPES; ++type) {
+        const PieceShape *shape = piece_shape_get((size_t)type);
+        for (int rotation = 0; rotation < shape->rotation_count; ++rotation) {
+            PcRotation *rot = &g_rotations[type][rotation];
+            int top = shape->size;
+            int right = 0;
+            rot->bottom = 0;
+            rot->left = shape->size;
+            for (int r = 0; r < shape->size; ++r) {
+                for (int c = 0; c < shape->size; ++c) {
+                    if (piece_shape_cell_filled(shape, rotation, r, c)) {
+                        top = (r < top) ? r : top;
+                        rot->bottom = r;
+                        rot->left = (c < rot->left) ? c : rot->left;
+                        right = (c > right) ? c : right;
+                    }
+                }
+            }
+            rot->width = right - rot->left + 1;
+            rot->height = rot->bottom - top + 1;
+
+            int count = 0;
+            rot->cells = 0;
+            for (int r = 0; r < shape->size; ++r) {
+                for (int c = 0; c < shape->size; ++c) {
+                    if (piece_shape_cell_filled(shape, rotation, r, c) && count < 4) {
+                        rot->offsets[count] = (rot->bottom - r) * BOARD_WIDTH + (c - rot->left);
+                        rot->cells |= 1ULL << rot->offsets[count];
+                        ++count;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// --- Field moves ---------------------------------------------------------------------------
+
+// Every distinct way to lock `type` entirely inside the field, with the moves
+// perft_generate uses: shifts, drops, and clockwise rotations. Anchor positions for rows
+// 0..height (row `height` is the open space above the stack) are bitboards with the same
+// layout as the field, so a whole set of positions moves with one shift, and the
+// reachable set is grown from the top row until nothing changes. A rotation keeps the
+// pattern box in place, which moves the anchor by the change in `left` and `bottom`.
+static int generate_moves(uint64_t field, int height, int type, PcMove *moves_out) {
+    int rotation_count = piece_shape_get((size_t)type)->rotation_count;
+    const PcRotation *rotations = g_rotations[type];
+    uint64_t every_row = 0;
+    for (int row = 0; row <= height; ++row) {
+        every_row |= 1ULL << (row * BOARD_WIDTH);
+    }
+    uint64_t top_row = PC_ROW_MASK << (height * BOARD_WIDTH);
+
+    uint64_t free[4];
+    uint64_t reach[4];
+    for (int r = 0; r < rotation_count; ++r) {
+        uint64_t blocked = 0;
+        for (int i = 0; i < 4; ++i) {
+            blocked |= field >> rotations[r].offsets[i];
+        }
+        uint64_t columns = ((1ULL << (BOARD_WIDTH - rotations[r].width + 1)) - 1) * every_row;
+        free[r] = ~blocked & columns;
+        reach[r] = free[r] & top_row;
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int r = 0; r < rotation_count; ++r) {
+            uint64_t grown = reach[r];
+            for (;;) {
+                uint64_t next = grown | (grown >> BOARD_WIDTH) | ((grown & ~every_row) >> 1) | ((grown << 1) & ~every_row);
+                next &= free[r];
+                if (next == grown) {
+                    break;
+                }
+                grown = next;
+            }
+            reach[r] = grown;
+
+            int t = (r + 1) % rotation_count;
+            int dx = rotations[t].left - rotations[r].left;
+            int dy = rotations[r].bottom - rotations[t].bottom;
+            int lowest = (dx < 0) ? -dx : 0;
+            int highest = BOARD_WIDTH - rotations[t].width - dx;
+            if (highest < lowest) {
+                continue;
+            }
+            uint64_t sources = grown & ((((1ULL << (highest + 1)) - 1) & ~((1ULL << lowest) - 1)) * every_row);
+            int shift = dy * BOARD_WIDTH + dx;
+            uint64_t turned = ((shift >= 0) ? sources << shift : sources >> -shift) & free[t];
+            if (turned & ~reach[t]) {
+                reach[t] |= turned;
+                changed = true;
+            }
+        }
+    }
+
+    int found = 0;
+    for (int r = 0; r < rotation_count; ++r) {
+        int highest_row = height - rotations[r].height;
+        if (highest_row < 0) {
+            continue;
+        }
+        uint64_t inside = (1ULL << ((highest_row + 1) * BOARD_WIDTH)) - 1;
+        uint64_t resting = reach[r] & ~(free[r] << BOARD_WIDTH) & inside;
+        while (resting != 0) {
+            int position = __builtin_ctzll(resting);
+            resting &= resting - 1;
+            uint64_t mask = rotations[r].cells << position;
+            bool duplicate = false;
+            for (int i = 0; i < found && !duplicate; ++i) {
+                duplicate = moves_out[i].mask == mask;
+            }
+            if (!duplicate && found < PC_MAX_MOVES) {
+                moves_out[found++] = (PcMove){mask, r, position / BOARD_WIDTH,
+                                              position % BOARD_WIDTH - rotations[r].left};
+            }
+        }
+    }
+    return found;
+}
+
+// Remove full rows, shifting the rows above down; returns the rows removed.
+static int clear_rows(uint64_t *field, int height) {
+    int cleared = 0;
+    for (int row = height - 1; row >= 0; --row) {
+        int shift = row * BOARD_WIDTH;
+        if (((*field >> shift) & PC_ROW_MASK) == PC_ROW_MASK) {
+            uint64_t below = *field & ((1ULL << shift) - 1);
+            uint64_t above = *field >> (shift + BOARD_WIDTH);
+            *field = below | (above << shift);
+            ++cleared;
+        }
+    }
+    return cleared;
+}
+
+// A column filled to the top stays filled through every clear, so no piece ever crosses
+// it: each stretch of columns between full ones must have a multiple of four empty cells.
+static bool walls_split_evenly(uint64_t field, int height) {
+    uint64_t full = PC_ROW_MASK;
+    uint64_t every_row = 0;
+    for (int row = 0; row < height; ++row) {
+        full &= field >> (row * BOARD_WIDTH);
+        every_row |= 1ULL << (row * BOARD_WIDTH);
+    }
+    int start = 0;
+    for (int col = 0; col <= BOARD_WIDTH; ++col) {
+        if (col < BOARD_WIDTH && (full & (1ULL << col)) == 0) {
+            continue;
+        }
+        if (col > start) {
+            uint64_t stretch = (((1ULL << col) - 1) & ~((1ULL << start) - 1)) * every_row;
+            int empty = __builtin_popcountll(stretch) - __builtin_popcountll(field & stretch);
+            if (empty % 4 != 0) {
+                return false;
+            }
+        }
+        start = col + 1;
+    }
+    return true;
+}
+
+// --- Failed-subproblem set -----------------------------------------------------------------
+
+// A subproblem is the field, its height, and how much of the queue is used; the epoch
+// keeps keys from earlier solves (other queues) from matching.
+static uint64_t failure_key(const PcSolver *solver, uint64_t field, int height, int index) {
+    return (solver->epoch << PC_EPOCH_SHIFT) | ((uint64_t)index << 44) | ((uint64_t)height << 40) | field;
+}
+
+static size_t key_slot(const PcSolver *solver, uint64_t key) {
+    uint64_t hash = key * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(hash >> 32) & solver->slot_mask;
+}
+
+static bool failure_known(const PcSolver *solver, uint64_t key) {
+    size_t slot = key_slot(solver, key);
+    for (int probe = 0; probe < PC_PROBES; ++probe) {
+        uint64_t stored = atomic_load_explicit(&solver->failed[slot], memory_order_relaxed);
+        if (stored == key) {
+            return true;
+        }
+        if (stored == 0) {
+            return false;
+        }
+        slot = (slot + 1) & solver->slot_mask;
+    }
+    return false;
+}
+
+// Lossy: when every probed slot holds another key the failure is simply not remembered.
+// Slots from earlier epochs count as free, so the set never fills up across solves.
+static void failure_insert(PcSolver *solver, uint64_t key) {
+    size_t slot = key_slot(solver, key);
+    for (int probe = 0; probe < PC_PROBES; ++probe) {
+        uint64_t stored = atomic_load_explicit(&solver->failed[slot], memory_order_relaxed);
+        if (stored == key) {
+            return;
+        }
+        if ((stored >> PC_EPOCH_SHIFT) != solver->epoch &&
+            atomic_compare_exchange_strong_explicit(&solver->failed[slot], &stored, key, memory_order_relaxed,
+                                                    memory_order_relaxed)) {
+            return;
+        }
+        slot = (slot + 1) & solver->slot_mask;
+    }
+}
+
+// --- Parallel search -----------------------------------------------------------------------
+
+typedef struct {
+    int type;
+    PcMove move;
+} PcStep;
+
+typedef struct {
+    PcSolver *solver;
+    const int *queue;
+    int count;
+    int height;
+    uint64_t field;
+    PcMove roots[PC_MAX_MOVES];
+    int root_count;
+    _Atomic int next_root;
+    _Atomic int best_root; // lowest root with a solution so far, INT_MAX while none
+    _Atomic uint64_t nodes;
+    _Atomic bool gave_up;
+    pthread_mutex_t lock;
+    PcStep best_path[PC_MAX_PIECES];
+    int best_length;
+} PcSearch;
+
+typedef enum { PC_FAILED, PC_FOUND, PC_ABORTED } PcOutcome;
+
+typedef struct {
+    PcSearch *search;
+    int root;
+    uint64_t pending_nodes;
+    PcStep path[PC_MAX_PIECES];
+} PcWorker;
+
+// Stop when a lower root has already found a solution, the node budget is spent, or the
+// caller's latest_id has moved past the request this solve is for.
+static bool worker_should_stop(PcWorker *worker) {
+    PcSearch *search = worker->search;
+    if (++worker->pending_nodes >= PC_NODE_BATCH) {
+        uint64_t total = atomic_fetch_add_explicit(&search->nodes, worker->pending_nodes, memory_order_relaxed) +
+                         worker->pending_nodes;
+        worker->pending_nodes = 0;
+        const PcSolver *solver = search->solver;
+        if ((solver->max_nodes != 0 && total >= solver->max_nodes) ||
+            (solver->latest_id != NULL &&
+             atomic_load_explicit(solver->latest_id, memory_order_relaxed) != solver->id)) {
+            atomic_store_explicit(&search->gave_up, true, memory_order_relaxed);
+        }
+    }
+    return atomic_load_explicit(&search->gave_up, memory_order_relaxed) ||
+           atomic_load_explicit(&search->best_root, memory_order_relaxed) < worker->root;
+}
+
+// Depth-first: place queue[index] every possible way. Only a fully explored subproblem is
+// recorded as failed; an aborted one proves nothing.
+static PcOutcome search_from(PcWorker *worker, uint64_t field, int height, int index) {
+    PcSearch *search = worker->search;
+    if (height == 0) {
+        return PC_FOUND;
+    }
+    int empty = height * BOARD_WIDTH - __builtin_popcountll(field);
+    if (index >= search->count || empty > 4 * (search->count - index) || !walls_split_evenly(field, height)) {
+        return PC_FAILED;
+    }
+    if (worker_should_stop(worker)) {
+        return PC_ABORTED;
+    }
+    uint64_t key = failure_key(search->solver, field, height, index);
+    if (failure_known(search->solver, key)) {
+        return PC_FAILED;
+    }
+
+    PcMove moves[PC_MAX_MOVES];
+    int type = search->queue[index];
+    int count = generate_moves(field, height, type, moves);
+    for (int i = 0; i < count; ++i) {
+        uint64_t child = field | moves[i].mask;
+        int cleared = clear_rows(&child, height);
+        PcOutcome outcome = search_from(worker, child, height - cleared, index + 1);
+        if (outcome == PC_FOUND) {
+            worker->path[index] = (PcStep){type, moves[i]};
+            return PC_FOUND;
+        }
+        if (outcome == PC_ABORTED) {
+            return PC_ABORTED;
+        }
+    }
+    failure_insert(search->solver, key);
+    return PC_FAILED;
+}
+
+// Threads take root placements in order; a solution under root r only has to beat
+// solutions under lower roots, so the answer is the one a serial search would find.
+static void *search_roots(void *arg) {
+    PcSearch *search = arg;
+    PcWorker worker;
+    worker.search = search;
+    worker.pending_nodes = 0;
+    for (;;) {
+        int root = atomic_fetch_add_explicit(&search->next_root, 1, memory_order_relaxed);
+        if (root >= search->root_count || root > atomic_load_explicit(&search->best_root, memory_order_relaxed)) {
+            break;
+        }
+        worker.root = root;
+        uint64_t child = search->field | search->roots[root].mask;
+        int cleared = clear_rows(&child, search->height);
+        if (search_from(&worker, child, search->height - cleared, 1) != PC_FOUND) {
+            continue;
+        }
+        worker.path[0] = (PcStep){search->queue[0], search->roots[root]};
+
+        pthread_mutex_lock(&search->lock);
+        if (root < atomic_load_explicit(&search->best_root, memory_order_relaxed)) {
+            atomic_store_explicit(&search->best_root, root, memory_order_relaxed);
+            memcpy(search->best_path, worker.path, sizeof(worker.path));
+            search->best_length = search->height * BOARD_WIDTH - __builtin_popcountll(search->field);
+            search->best_length /= 4;
+        }
+        pthread_mutex_unlock(&search->lock);
+    }
+    atomic_fetch_add_explicit(&search->nodes, worker.pending_nodes, memory_order_relaxed);
+    return NULL;
+}
+
+static bool solve_height(PcSolver *solver, PcSearch *search, PcSolution *solution) {
+    search->root_count = generate_moves(search->field, search->height, search->queue[0], search->roots);
+    atomic_init(&search->next_root, 0);
+    atomic_init(&search->best_root, INT_MAX);
+    search->best_length = 0;
+
+    int helpers = (solver->threads > 1) ? solver->threads - 1 : 0;
+    pthread_t threads[PC_MAX_THREADS];
+    int started = 0;
+    while (started < helpers && pthread_create(&threads[started], NULL, search_roots, search) == 0) {
+        ++started;
+    }
+    search_roots(search);
+    for (int t = 0; t < started; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    if (atomic_load_explicit(&search->best_root, memory_order_relaxed) == INT_MAX) {
+        return false;
+    }
+    solution->pieces = search->best_length;
+    for (int i = 0; i < search->best_length; ++i) {
+        const PcStep *step = &search->best_path[i];
+        solution->placements[i] = (ActivePiece){
+            .type = step->type,
+            .rotation = step->move.rotation,
+            .row = BOARD_HEIGHT - 1 - step->move.y - g_rotations[step->type][step->move.rotation].bottom,
+            .col = step->move.col,
+            .active = true,
+        };
+    }
+    return true;
+}
+
+// --- API -----------------------------------------------------------------------------------
+
+int pc_solver_init(PcSolver *solver, int threads, uint64_t max_nodes) {
+    if (solver == NULL || piece_shape_count() != PC_PIECE_TYPES) {
+        return -1;
+    }
+    pthread_once(&g_rotations_once, load_rotations);
+
+    size_t slots = (size_t)1 << PC_FAILED_SLOTS_LOG2;
+    solver->failed = calloc(slots, sizeof(*solver->failed));
+    if (solver->failed == NULL) {
+        return -1;
+    }
+    solver->slot_mask = slots - 1;
+    solver->epoch = 0;
+    solver->threads = (threads < 1) ? 1 : (threads > PC_MAX_THREADS) ? PC_MAX_THREADS : threads;
+    solver->max_nodes = max_nodes;
+    solver->latest_id = NULL;
+    solver->id = 0;
+    solver->nodes = 0;
+    return 0;
+}
+
+void pc_solver_free(PcSolver *solver) {
+    if (solver == NULL) {
+        return;
+    }
+    free(solver->failed);
+    solver->failed = NULL;
+}
+
+// Look for placements of queue[0..count) that leave the board empty, trying the lowest
+// field height first (a two-row clear needs five pieces, a four-row one ten). Returns false
+// when the stack reaches above PC_MAX_HEIGHT rows, no queue prefix can do it, or the node
+// budget runs out or the request is cancelled first.
+bool pc_solve(PcSolver *solver, const Board *board, const int *queue, int count, PcSolution *solution) {
+    if (solver == NULL || solver->failed == NULL || board == NULL || queue == NULL || solution == NULL) {
+        return false;
+    }
+    memset(solution, 0, sizeof(*solution));
+    if (count > PC_MAX_PIECES) {
+        count = PC_MAX_PIECES;
+    }
+    for (int i = 0; i < count; ++i) {
+        if (queue[i] < 0 || queue[i] >= PC_PIECE_TYPES) {
+            count = i;
+        }
+    }
+    if (count <= 0) {
+        return false;
+    }
+
+    uint64_t field = 0;
+    int stack_height = 0;
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            if (board->cells[row][col] == 0) {
+                continue;
+            }
+            int field_row = BOARD_HEIGHT - 1 - row;
+            if (field_row >= PC_MAX_HEIGHT) {
+                return false;
+            }
+            field |= 1ULL << (field_row * BOARD_WIDTH + col);
+            if (field_row + 1 > stack_height) {
+                stack_height = field_row + 1;
+            }
+        }
+    }
+
+    PcSearch search;
+    search.solver = solver;
+    search.queue = queue;
+    search.count = count;
+    search.field = field;
+    atomic_init(&search.nodes, 0);
+    atomic_init(&search.gave_up, false);
+    pthread_mutex_init(&search.lock, NULL);
+
+    if (++solver->epoch >= PC_EPOCH_LIMIT) {
+        memset((void *)solver->failed, 0, sizeof(*solver->failed) * (solver->slot_mask + 1));
+        solver->epoch = 1;
+    }
+
+    bool found = false;
+    for (int height = (stack_height > 0) ? stack_height : 1; height <= PC_MAX_HEIGHT && !found; ++height) {
+        int empty = height * BOARD_WIDTH - __builtin_popcountll(field);
+        if (empty % 4 != 0 || empty / 4 > count ||
+            atomic_load_explicit(&search.gave_up, memory_order_relaxed)) {
+            continue;
+        }
+        search.height = height;
+        found = solve_height(solver, &search, solution);
+    }
+    pthread_mutex_destroy(&search.lock);
+    solver->nodes = atomic_load_explicit(&search.nodes, memory_order_relaxed);
+    return found;
+}
+
+// The engine's known queue: the active piece, the preview, then the bag's upcoming pieces.
+int pc_queue_from_engine(const Engine *engine, int *queue, int capacity) {
+    if (engine == NULL || queue == NULL || capacity < 2 || !engine->active.active) {
+        return 0;
+    }
+    queue[0] = engine->active.type;
+    queue[1] = engine->next_piece_type;
+    return 2 + (int)piece_bag_peek(&engine->bag, queue + 2, (size_t)(capacity - 2));
+}
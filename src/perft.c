@@ -0,0 +1,321 @@
+#include "perft.h"
+
+#include <string.h>
+
+#include "arena.h"
+#include "cow_board.h"
+#include "engine.h"
+
+// Move-generation verifier: count every lock position reachable from spawn using the
+// same shift/soft-drop/rotate rules the engine applies, recursively over a piece list.
+
+// Exactly one of flat and cow is set; the generator probes whichever board it was given
+// through the matching move helpers, so both kinds see the same rules.
+typedef struct {
+    const Board *flat;
+    const CowBoard *cow;
+} PerftBoard;
+
+static bool probe_place(const PerftBoard *board, const PieceShape *shape, const ActivePiece *pose) {
+    return board->cow != NULL ? cow_board_can_place(board->cow, shape, pose->rotation, pose->row, pose->col)
+                              : board_can_place(board->flat, shape, pose->rotation, pose->row, pose->col);
+}
+
+static bool probe_move(const PerftBoard *board, ActivePiece *piece, int drow, int dcol) {
+    return board->cow != NULL ? cow_board_try_move_piece(board->cow, piece, drow, dcol)
+                              : board_try_move_piece(board->flat, piece, drow, dcol);
+}
+
+static bool probe_rotate(const PerftBoard *board, ActivePiece *piece, int direction) {
+    return board->cow != NULL ? cow_board_try_rotate_piece(board->cow, piece, direction)
+                              : board_try_rotate_piece(board->flat, piece, direction);
+}
+
+// Every resting pose reachable from spawn via left/right/down/rotate, in BFS order.
+// Returns 0 when the spawn pose itself collides (top-out).
+static int generate(const PerftBoard *board, int piece_type, ActivePiece *placements_out, int capacity) {
+    ActivePiece spawn;
+    engine_spawn_pose(piece_type, &spawn);
+    const PieceShape *shape = piece_shape_get((size_t)piece_type);
+    if (!spawn.active || !probe_place(board, shape, &spawn)) {
+        return 0;
+    }
+
+    static const int moves[][3] = {
+        {0, -1, 0},
+        {0, 1, 0},
+        {1, 0, 0},
+        {0, 0, 1}
+    };
+
+    bool visited[4][PERFT_ROW_SPAN][PERFT_COL_SPAN];
+    memset(visited, 0, sizeof(visited));
+    ActivePiece queue[PERFT_MAX_PLACEMENTS];
+    int head = 0;
+    int tail = 0;
+    int found = 0;
+
+    queue[tail++] = spawn;
+    visited[spawn.rotation][spawn.row + PERFT_ROW_OFFSET][spawn.col + PERFT_COL_OFFSET] = true;
+
+    while (head < tail) {
+        ActivePiece current = queue[head++];
+
+        ActivePiece below = current;
+        if (!probe_move(board, &below, 1, 0) && found < capacity) {
+            placements_out[found++] = current;
+        }
+
+        for (size_t m = 0; m < sizeof(moves) / sizeof(moves[0]); ++m) {
+            ActivePiece next = current;
+            bool moved = moves[m][2] != 0 ? probe_rotate(board, &next, moves[m][2])
+                                          : probe_move(board, &next, moves[m][0], moves[m][1]);
+            if (!moved) {
+                continue;
+            }
+
+            bool *seen = &visited[next.rotation][next.row + PERFT_ROW_OFFSET][next.col + PERFT_COL_OFFSET];
+            if (!*seen) {
+                *seen = true;
+                queue[tail++] = next;
+            }
+        }
+    }
+
+    return found;
+}
+
+int perft_generate(const Board *board, int piece_type, ActivePiece *placements_out, int capacity) {
+    if (board == NULL || placements_out == NULL || capacity <= 0) {
+        return 0;
+    }
+
+    PerftBoard probe = {board, NULL};
+    return generate(&probe, piece_type, placements_out, capacity);
+}
+
+int perft_generate_cow(const CowBoard *board, int piece_type, ActivePiece *placements_out, int capacity) {
+    if (board == NULL || placements_out == NULL || capacity <= 0) {
+        return 0;
+    }
+
+    PerftBoard probe = {NULL, board};
+    return generate(&probe, piece_type, placements_out, capacity);
+}
+
+static void place_and_clear(Board *board, const ActivePiece *piece) {
+    const PieceShape *shape = piece_shape_get((size_t)piece->type);
+    board_lock_shape(board, shape, piece->rotation, piece->row, piece->col, piece->type + 1);
+    board_clear_completed_lines(board, NULL, 0);
+}
+
+// Move-sequence counting walks the tree depth first on copy-on-write boards: a child
+// shares every row its placement leaves alone with its parent. failed is set when the
+// pool cannot get more rows from the arena.
+typedef struct {
+    CowRowPool rows;
+    bool failed;
+} PerftTree;
+
+static uint64_t perft_recurse(PerftTree *tree, const CowBoard *board, const int *pieces, int depth) {
+    if (depth == 0) {
+        return 1;
+    }
+
+    ActivePiece placements[PERFT_MAX_PLACEMENTS];
+    int count = perft_generate_cow(board, pieces[0], placements, PERFT_MAX_PLACEMENTS);
+    if (depth == 1) {
+        return (uint64_t)count;
+    }
+
+    uint64_t total = 0;
+    for (int i = 0; i < count && !tree->failed; ++i) {
+        const PieceShape *shape = piece_shape_get((size_t)placements[i].type);
+        CowBoard child;
+        cow_board_clone(&child, board);
+        if (cow_board_lock_shape(&tree->rows, &child, shape, placements[i].rotation, placements[i].row,
+                                 placements[i].col, placements[i].type + 1) != 0) {
+            tree->failed = true;
+        } else {
+            cow_board_clear_completed_lines(&tree->rows, &child, NULL, 0);
+            total += perft_recurse(tree, &child, pieces + 1, depth - 1);
+        }
+        cow_board_release(&tree->rows, &child);
+    }
+    return total;
+}
+
+// Rows come from the thread's arena and are handed back before returning; 0 when they
+// run out, like the merged count.
+static uint64_t perft_tree(const Board *board, const int *pieces, int depth) {
+    Arena *arena = arena_thread_local();
+    ArenaMark mark = arena_mark(arena);
+    PerftTree tree;
+    tree.failed = false;
+    cow_pool_init(&tree.rows, arena);
+
+    uint64_t total = 0;
+    CowBoard root;
+    if (cow_board_from_board(&tree.rows, &root, board) == 0) {
+        total = perft_recurse(&tree, &root, pieces, depth);
+        cow_board_release(&tree.rows, &root);
+    } else {
+        tree.failed = true;
+    }
+    cow_pool_destroy(&tree.rows);
+    arena_reset_to(arena, mark);
+    return tree.failed ? 0 : total;
+}
+
+// --- Transposition-merged counting ----------------------------------------------------------
+
+// Occupancy only: boards that differ just in piece colors are the same position.
+typedef struct {
+    uint16_t rows[BOARD_HEIGHT];
+} PerftKey;
+
+typedef struct {
+    Arena *arena;
+    Board *boards;
+    PerftKey *keys;
+    size_t count;
+    size_t capacity;
+    uint32_t *slots; // index + 1, 0 = empty
+    size_t slot_mask;
+} BoardSet;
+
+static PerftKey key_for_board(const Board *board) {
+    PerftKey key;
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        uint16_t mask = 0;
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            if (board->cells[row][col] != 0) {
+                mask |= (uint16_t)(1U << col);
+            }
+        }
+        key.rows[row] = mask;
+    }
+    return key;
+}
+
+static uint64_t key_hash(const PerftKey *key) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        hash ^= key->rows[row];
+        hash *= 1099511628211ULL;
+    }
+    return hash ^ (hash >> 29);
+}
+
+static bool board_set_init(BoardSet *set, Arena *arena, size_t capacity) {
+    set->arena = arena;
+    set->count = 0;
+    set->capacity = capacity;
+    set->boards = arena_alloc(arena, sizeof(Board) * capacity, 16);
+    set->keys = arena_alloc(arena, sizeof(PerftKey) * capacity, 16);
+    size_t slots = 16;
+    while (slots < capacity * 2) {
+        slots <<= 1;
+    }
+    set->slot_mask = slots - 1;
+    set->slots = arena_alloc(arena, sizeof(uint32_t) * slots, 16);
+    if (set->boards == NULL || set->keys == NULL || set->slots == NULL) {
+        return false;
+    }
+    memset(set->slots, 0, sizeof(uint32_t) * slots);
+    return true;
+}
+
+static bool board_set_grow(BoardSet *set) {
+    BoardSet bigger;
+    if (!board_set_init(&bigger, set->arena, set->capacity * 2)) {
+        return false;
+    }
+
+    memcpy(bigger.boards, set->boards, sizeof(Board) * set->count);
+    memcpy(bigger.keys, set->keys, sizeof(PerftKey) * set->count);
+    bigger.count = set->count;
+    for (size_t i = 0; i < set->count; ++i) {
+        size_t slot = key_hash(&bigger.keys[i]) & bigger.slot_mask;
+        while (bigger.slots[slot] != 0) {
+            slot = (slot + 1) & bigger.slot_mask;
+        }
+        bigger.slots[slot] = (uint32_t)(i + 1);
+    }
+    *set = bigger;
+    return true;
+}
+
+static bool board_set_insert(BoardSet *set, const Board *board) {
+    PerftKey key = key_for_board(board);
+    size_t slot = key_hash(&key) & set->slot_mask;
+    while (set->slots[slot] != 0) {
+        if (memcmp(&set->keys[set->slots[slot] - 1], &key, sizeof(key)) == 0) {
+            return true;
+        }
+        slot = (slot + 1) & set->slot_mask;
+    }
+
+    if (set->count == set->capacity) {
+        if (!board_set_grow(set)) {
+            return false;
+        }
+        return board_set_insert(set, board);
+    }
+
+    set->boards[set->count] = *board;
+    set->keys[set->count] = key;
+    set->slots[slot] = (uint32_t)(set->count + 1);
+    ++set->count;
+    return true;
+}
+
+// Level-by-level expansion keeping only distinct boards; all scratch lives in the
+// thread's arena and is released before returning.
+static uint64_t perft_dedupe(const Board *board, const int *pieces, int depth) {
+    Arena *arena = arena_thread_local();
+    ArenaMark mark = arena_mark(arena);
+
+    BoardSet current;
+    if (!board_set_init(&current, arena, 64) || !board_set_insert(&current, board)) {
+        arena_reset_to(arena, mark);
+        return 0;
+    }
+
+    ActivePiece placements[PERFT_MAX_PLACEMENTS];
+    for (int ply = 0; ply < depth; ++ply) {
+        BoardSet next;
+        if (!board_set_init(&next, arena, current.count * 16)) {
+            arena_reset_to(arena, mark);
+            return 0;
+        }
+
+        for (size_t i = 0; i < current.count; ++i) {
+            int count = perft_generate(&current.boards[i], pieces[ply], placements, PERFT_MAX_PLACEMENTS);
+            for (int p = 0; p < count; ++p) {
+                Board child = current.boards[i];
+                place_and_clear(&child, &placements[p]);
+                if (!board_set_insert(&next, &child)) {
+                    arena_reset_to(arena, mark);
+                    return 0;
+                }
+            }
+        }
+        current = next;
+    }
+
+    uint64_t total = current.count;
+    arena_reset_to(arena, mark);
+    return total;
+}
+
+// Count lock positions after placing pieces[0..depth-1] in order. Without dedupe this is
+// the number of move sequences (chess-style perft); with dedupe, transpositions that
+// produce the same occupancy are merged and the result is the number of distinct boards.
+uint64_t perft(const Board *board, const int *pieces, int depth, bool dedupe) {
+    if (board == NULL || depth < 0 || (depth > 0 && pieces == NULL)) {
+        return 0;
+    }
+
+    return dedupe ? perft_dedupe(board, pieces, depth) : perft_tree(board, pieces, depth);
+}
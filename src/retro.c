@@ -0,0 +1,812 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "retro.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "piece.h"
+
+// Small-board state exploration, parallel value iteration, and the perfect-hashed table.
+
+#define RETRO_SWEEP_CHUNK 256
+#define RETRO_BUCKET_LOAD 4
+#define RETRO_MAX_DISPLACEMENT (1U << 22)
+#define RETRO_BUILD_SEEDS 8
+#define RETRO_SEED_STEP 0x9E3779B97F4A7C15ULL
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// --- Geometry ------------------------------------------------------------------------------
+
+int retro_geometry_init(RetroGeometry *geometry, int width, int height) {
+    if (geometry == NULL || width < RETRO_MIN_WIDTH || width > BOARD_WIDTH || height < 1 ||
+        height > RETRO_MAX_HEIGHT || width * height > RETRO_MAX_CELLS ||
+        width * (height + RETRO_BUFFER_ROWS) > 64) {
+        return -1;
+    }
+
+    memset(geometry, 0, sizeof(*geometry));
+    geometry->width = width;
+    geometry->height = height;
+    geometry->row_mask = (1ULL << width) - 1;
+    geometry->field_mask = (1ULL << (width * height)) - 1;
+
+    int rows = height + RETRO_BUFFER_ROWS;
+    for (int type = 0; type < RETRO_PIECE_TYPES; ++type) {
+        const PieceShape *shape = piece_shape_get((size_t)type);
+        for (int rotation = 0; rotation < shape->rotation_count; ++rotation) {
+            for (int x = -3; x < width; ++x) {
+                for (int y = -3; y < rows; ++y) {
+                    uint64_t mask = 0;
+                    bool inside = true;
+                    for (int r = 0; r < shape->size && inside; ++r) {
+                        for (int c = 0; c < shape->size; ++c) {
+                            if (!piece_shape_cell_filled(shape, rotation, r, c)) {
+                                continue;
+                            }
+                            int col = x + c;
+                            int row = y + (shape->size - 1 - r);
+                            if (col < 0 || col >= width || row < 0 || row >= rows) {
+                                inside = false;
+                                break;
+                            }
+                            mask |= 1ULL << (row * width + col);
+                        }
+                    }
+                    geometry->poses[type][rotation][x + 3][y + 3] = inside ? mask : 0;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// Field from board-style rows: rows[0] is the top field row, bit c = column c.
+uint64_t retro_field_from_rows(const RetroGeometry *geometry, const uint16_t *rows) {
+    uint64_t field = 0;
+    if (geometry == NULL || rows == NULL) {
+        return 0;
+    }
+    for (int i = 0; i < geometry->height; ++i) {
+        int row = geometry->height - 1 - i;
+        field |= ((uint64_t)rows[i] & geometry->row_mask) << (row * geometry->width);
+    }
+    return field;
+}
+
+uint64_t retro_state_key(uint64_t field, unsigned bag) {
+    return field | ((uint64_t)(bag & RETRO_FULL_BAG) << RETRO_MAX_CELLS);
+}
+
+static uint64_t pose_mask(const RetroGeometry *geometry, int type, int rotation, int x, int y) {
+    if (x < -3 || x >= geometry->width || y < -3 || y >= geometry->height + RETRO_BUFFER_ROWS) {
+        return 0;
+    }
+    return geometry->poses[type][rotation][x + 3][y + 3];
+}
+
+// Remove full rows anywhere in the field and buffer, dropping the rows above them.
+static uint64_t clear_rows(const RetroGeometry *geometry, uint64_t cells, int *lines) {
+    uint64_t kept = 0;
+    int out = 0;
+    *lines = 0;
+    for (int row = 0; row < geometry->height + RETRO_BUFFER_ROWS; ++row) {
+        uint64_t bits = (cells >> (row * geometry->width)) & geometry->row_mask;
+        if (bits == geometry->row_mask) {
+            ++*lines;
+        } else {
+            kept |= bits << (out++ * geometry->width);
+        }
+    }
+    return kept;
+}
+
+// Every distinct lock for `type` reachable from its spawn pose at the top of the buffer by
+// shifts, drops, and clockwise rotations, deduplicated by the cells it fills. Returns the
+// count, or -1 when `capacity` is too small.
+int retro_place(const RetroGeometry *geometry, uint64_t field, int type, RetroPlacement *placements, int capacity) {
+    if (geometry == NULL || placements == NULL || type < 0 || type >= RETRO_PIECE_TYPES) {
+        return -1;
+    }
+    const PieceShape *shape = piece_shape_get((size_t)type);
+    enum { COLS = BOARD_WIDTH + 3, ROWS = RETRO_MAX_HEIGHT + RETRO_BUFFER_ROWS + 3 };
+    bool seen[4][COLS][ROWS];
+    int queue[4 * COLS * ROWS][3];
+    uint64_t locked[RETRO_MAX_PLACEMENTS];
+    memset(seen, 0, sizeof(seen));
+
+    int head = 0;
+    int tail = 0;
+    int count = 0;
+    int spawn_x = (geometry->width - shape->size) / 2;
+    int spawn_y = geometry->height + RETRO_BUFFER_ROWS - shape->size;
+    queue[tail][0] = 0;
+    queue[tail][1] = spawn_x;
+    queue[tail][2] = spawn_y;
+    ++tail;
+    seen[0][spawn_x + 3][spawn_y + 3] = true;
+
+    while (head < tail) {
+        int rotation = queue[head][0];
+        int x = queue[head][1];
+        int y = queue[head][2];
+        ++head;
+        uint64_t cells = pose_mask(geometry, type, rotation, x, y);
+
+        static const int k_moves[4][3] = {{0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {1, 0, 0}};
+        for (int m = 0; m < 4; ++m) {
+            int next_rotation = (rotation + k_moves[m][0]) % shape->rotation_count;
+            int nx = x + k_moves[m][1];
+            int ny = y + k_moves[m][2];
+            uint64_t moved = pose_mask(geometry, type, next_rotation, nx, ny);
+            if (moved == 0 || (moved & field) != 0) {
+                if (m == 2) {
+                    // Resting: lock unless an equal cell set was already found.
+                    bool duplicate = false;
+                    for (int i = 0; i < count && !duplicate; ++i) {
+                        duplicate = locked[i] == cells;
+                    }
+                    if (duplicate) {
+                        continue;
+                    }
+                    if (count >= capacity || count >= RETRO_MAX_PLACEMENTS) {
+                        return -1;
+                    }
+                    locked[count] = cells;
+                    RetroPlacement *placement = &placements[count++];
+                    uint64_t after = clear_rows(geometry, field | cells, &placement->lines);
+                    placement->topout = (after & ~geometry->field_mask) != 0;
+                    placement->field = after & geometry->field_mask;
+                }
+                continue;
+            }
+            if (!seen[next_rotation][nx + 3][ny + 3]) {
+                seen[next_rotation][nx + 3][ny + 3] = true;
+                queue[tail][0] = next_rotation;
+                queue[tail][1] = nx;
+                queue[tail][2] = ny;
+                ++tail;
+            }
+        }
+    }
+    return count;
+}
+
+// --- Exploration ---------------------------------------------------------------------------
+
+static bool grow(void **array, size_t *capacity, size_t needed, size_t element) {
+    if (needed <= *capacity) {
+        return true;
+    }
+    size_t next = (*capacity > 0) ? *capacity : 1024;
+    while (next < needed) {
+        next *= 2;
+    }
+    void *grown = realloc(*array, next * element);
+    if (grown == NULL) {
+        return false;
+    }
+    *array = grown;
+    *capacity = next;
+    return true;
+}
+
+static int32_t find_board(const RetroSolver *solver, uint64_t field) {
+    for (size_t slot = mix64(field) & solver->slot_mask;; slot = (slot + 1) & solver->slot_mask) {
+        if (solver->slots[slot] == 0) {
+            return -1;
+        }
+        if (solver->slots[slot] == field + 1) {
+            return solver->slot_boards[slot];
+        }
+    }
+}
+
+static bool rehash(RetroSolver *solver, size_t slot_count) {
+    uint64_t *slots = calloc(slot_count, sizeof(*slots));
+    int32_t *slot_boards = malloc(slot_count * sizeof(*slot_boards));
+    if (slots == NULL || slot_boards == NULL) {
+        free(slots);
+        free(slot_boards);
+        return false;
+    }
+    free(solver->slots);
+    free(solver->slot_boards);
+    solver->slots = slots;
+    solver->slot_boards = slot_boards;
+    solver->slot_mask = slot_count - 1;
+    for (size_t b = 0; b < solver->board_count; ++b) {
+        size_t slot = mix64(solver->boards[b]) & solver->slot_mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & solver->slot_mask;
+        }
+        slots[slot] = solver->boards[b] + 1;
+        slot_boards[slot] = (int32_t)b;
+    }
+    return true;
+}
+
+// Board index of a field, registering it (with no bags reached yet) the first time.
+static int32_t intern_board(RetroSolver *solver, uint64_t field) {
+    int32_t found = find_board(solver, field);
+    if (found >= 0) {
+        return found;
+    }
+    if (solver->board_count >= INT32_MAX - 1) {
+        return -1;
+    }
+    if (solver->board_count == solver->board_capacity) {
+        size_t capacity = (solver->board_capacity > 0) ? solver->board_capacity * 2 : 1024;
+        uint64_t *boards = realloc(solver->boards, capacity * sizeof(uint64_t));
+        solver->boards = (boards != NULL) ? boards : solver->boards;
+        uint64_t *reach = realloc(solver->reach, capacity * 2 * sizeof(uint64_t));
+        solver->reach = (reach != NULL) ? reach : solver->reach;
+        uint32_t *edges_at = realloc(solver->edges_at, capacity * 8 * sizeof(uint32_t));
+        solver->edges_at = (edges_at != NULL) ? edges_at : solver->edges_at;
+        if (boards == NULL || reach == NULL || edges_at == NULL) {
+            return -1;
+        }
+        solver->board_capacity = capacity;
+    }
+
+    int32_t index = (int32_t)solver->board_count++;
+    solver->boards[index] = field;
+    solver->reach[2 * (size_t)index] = 0;
+    solver->reach[2 * (size_t)index + 1] = 0;
+    solver->edges_at[8 * (size_t)index] = UINT32_MAX; // edges not generated yet
+    if (solver->board_count * 2 > solver->slot_mask + 1 && !rehash(solver, (solver->slot_mask + 1) * 2)) {
+        return -1;
+    }
+    size_t slot = mix64(field) & solver->slot_mask;
+    while (solver->slots[slot] != 0) {
+        slot = (slot + 1) & solver->slot_mask;
+    }
+    solver->slots[slot] = field + 1;
+    solver->slot_boards[slot] = index;
+    return index;
+}
+
+static bool bag_reached(const RetroSolver *solver, size_t board, unsigned bag) {
+    return (solver->reach[2 * board + (bag >> 6)] >> (bag & 63)) & 1U;
+}
+
+static int generate_edges(RetroSolver *solver, int32_t board) {
+    RetroPlacement placements[RETRO_MAX_PLACEMENTS];
+    for (int type = 0; type < RETRO_PIECE_TYPES; ++type) {
+        int count = retro_place(&solver->geometry, solver->boards[board], type, placements, RETRO_MAX_PLACEMENTS);
+        if (count < 0 || solver->edge_count + (size_t)count >= UINT32_MAX ||
+            !grow((void **)&solver->edges, &solver->edge_capacity, solver->edge_count + (size_t)count,
+                               sizeof(RetroEdge))) {
+            return -1;
+        }
+        solver->edges_at[8 * (size_t)board + (size_t)type] = (uint32_t)solver->edge_count;
+        for (int i = 0; i < count; ++i) {
+            int32_t next = placements[i].topout ? -1 : intern_board(solver, placements[i].field);
+            if (!placements[i].topout && next < 0) {
+                return -1;
+            }
+            solver->edges[solver->edge_count].next = next;
+            solver->edges[solver->edge_count].lines = placements[i].lines;
+            ++solver->edge_count;
+        }
+    }
+    solver->edges_at[8 * (size_t)board + RETRO_PIECE_TYPES] = (uint32_t)solver->edge_count;
+    return 0;
+}
+
+int retro_solver_init(RetroSolver *solver, int width, int height) {
+    if (solver == NULL) {
+        return -1;
+    }
+    memset(solver, 0, sizeof(*solver));
+    if (retro_geometry_init(&solver->geometry, width, height) != 0) {
+        return -1;
+    }
+    solver->gamma = 1.0;
+    return rehash(solver, 1024) ? 0 : -1;
+}
+
+void retro_solver_free(RetroSolver *solver) {
+    if (solver == NULL) {
+        return;
+    }
+    free(solver->boards);
+    free(solver->slots);
+    free(solver->slot_boards);
+    free(solver->reach);
+    free(solver->edges_at);
+    free(solver->edges);
+    free(solver->values);
+    memset(solver, 0, sizeof(*solver));
+}
+
+// Breadth-first walk of every (field, bag) state reachable from an empty field and a full
+// bag, generating each field's placements once. An emptied bag refills, so bag 0 never
+// appears in a state.
+int retro_solver_explore(RetroSolver *solver) {
+    if (solver == NULL || solver->board_count > 0) {
+        return -1;
+    }
+
+    uint64_t *queue = NULL; // board * RETRO_BAGS + bag
+    size_t queue_capacity = 0;
+    size_t head = 0;
+    size_t tail = 0;
+    int32_t start = intern_board(solver, 0);
+    if (start < 0 || !grow((void **)&queue, &queue_capacity, 1, sizeof(uint64_t))) {
+        free(queue);
+        return -1;
+    }
+    solver->reach[2 * (size_t)start + (RETRO_FULL_BAG >> 6)] |= 1ULL << (RETRO_FULL_BAG & 63);
+    queue[tail++] = (uint64_t)start * RETRO_BAGS + RETRO_FULL_BAG;
+
+    int status = 0;
+    while (head < tail && status == 0) {
+        size_t board = (size_t)(queue[head] / RETRO_BAGS);
+        unsigned bag = (unsigned)(queue[head] % RETRO_BAGS);
+        ++head;
+        if (solver->edges_at[8 * board] == UINT32_MAX && generate_edges(solver, (int32_t)board) != 0) {
+            status = -1;
+            break;
+        }
+        for (int type = 0; type < RETRO_PIECE_TYPES && status == 0; ++type) {
+            if ((bag & (1U << type)) == 0) {
+                continue;
+            }
+            unsigned next_bag = bag & ~(1U << type);
+            next_bag = (next_bag == 0) ? RETRO_FULL_BAG : next_bag;
+            for (uint32_t e = solver->edges_at[8 * board + (size_t)type]; e < solver->edges_at[8 * board + (size_t)type + 1];
+                 ++e) {
+                int32_t next = solver->edges[e].next;
+                if (next < 0 || bag_reached(solver, (size_t)next, next_bag)) {
+                    continue;
+                }
+                if (!grow((void **)&queue, &queue_capacity, tail + 1, sizeof(uint64_t))) {
+                    status = -1;
+                    break;
+                }
+                solver->reach[2 * (size_t)next + (next_bag >> 6)] |= 1ULL << (next_bag & 63);
+                queue[tail++] = (uint64_t)next * RETRO_BAGS + next_bag;
+            }
+        }
+    }
+    free(queue);
+    solver->state_count = tail;
+    return status;
+}
+
+double retro_solver_value(const RetroSolver *solver, uint64_t field, unsigned bag) {
+    if (solver == NULL || solver->values == NULL || bag == 0 || bag > RETRO_FULL_BAG) {
+        return -1.0;
+    }
+    int32_t board = find_board(solver, field);
+    if (board < 0 || !bag_reached(solver, (size_t)board, bag)) {
+        return -1.0;
+    }
+    return solver->values[(size_t)board * RETRO_BAGS + bag];
+}
+
+// --- Value iteration -----------------------------------------------------------------------
+
+typedef struct {
+    const RetroSolver *solver;
+    double gamma;
+    const double *current;
+    double *next;
+    _Atomic size_t next_chunk;
+    pthread_mutex_t lock;
+    double residual;
+} RetroSweep;
+
+// Value of one state under `current`: the mean over the pieces left in the bag of the best
+// placement's lines plus the discounted value of where it leads.
+static double backup(const RetroSolver *solver, const double *current, double gamma, size_t board, unsigned bag) {
+    double total = 0.0;
+    int pieces = 0;
+    for (int type = 0; type < RETRO_PIECE_TYPES; ++type) {
+        if ((bag & (1U << type)) == 0) {
+            continue;
+        }
+        unsigned next_bag = bag & ~(1U << type);
+        next_bag = (next_bag == 0) ? RETRO_FULL_BAG : next_bag;
+        double best = 0.0;
+        for (uint32_t e = solver->edges_at[8 * board + (size_t)type]; e < solver->edges_at[8 * board + (size_t)type + 1];
+             ++e) {
+            const RetroEdge *edge = &solver->edges[e];
+            double value = edge->lines;
+            if (edge->next >= 0) {
+                value += gamma * current[(size_t)edge->next * RETRO_BAGS + next_bag];
+            }
+            best = (value > best) ? value : best;
+        }
+        total += best;
+        ++pieces;
+    }
+    return total / pieces;
+}
+
+// Threads take chunks of boards off a shared counter; each board's states are written to
+// the next buffer only, so no chunk sees another's updates within a sweep.
+static void *sweep_chunks(void *arg) {
+    RetroSweep *sweep = arg;
+    const RetroSolver *solver = sweep->solver;
+    double residual = 0.0;
+    for (;;) {
+        size_t first = atomic_fetch_add_explicit(&sweep->next_chunk, RETRO_SWEEP_CHUNK, memory_order_relaxed);
+        if (first >= solver->board_count) {
+            break;
+        }
+        size_t last = (first + RETRO_SWEEP_CHUNK < solver->board_count) ? first + RETRO_SWEEP_CHUNK : solver->board_count;
+        for (size_t board = first; board < last; ++board) {
+            for (unsigned bag = 1; bag <= RETRO_FULL_BAG; ++bag) {
+                if (!bag_reached(solver, board, bag)) {
+                    continue;
+                }
+                size_t at = board * RETRO_BAGS + bag;
+                double value = backup(solver, sweep->current, sweep->gamma, board, bag);
+                sweep->next[at] = value;
+                double change = fabs(value - sweep->current[at]);
+                residual = (change > residual) ? change : residual;
+            }
+        }
+    }
+    pthread_mutex_lock(&sweep->lock);
+    if (residual > sweep->residual) {
+        sweep->residual = residual;
+    }
+    pthread_mutex_unlock(&sweep->lock);
+    return NULL;
+}
+
+// Jacobi sweeps from all-zero values until the largest change drops to the tolerance or
+// max_sweeps have run. Values only rise from zero towards the fixed point, and with gamma
+// below 1 they converge even where play can go on forever. The calling thread works
+// alongside the helpers, so a helper that fails to start only costs speed.
+int retro_solver_iterate(RetroSolver *solver, const RetroConfig *config) {
+    if (solver == NULL || config == NULL || solver->board_count == 0 || config->gamma <= 0.0 || config->gamma > 1.0 ||
+        config->max_sweeps < 1) {
+        return -1;
+    }
+
+    size_t cells = solver->board_count * RETRO_BAGS;
+    double *current = calloc(cells, sizeof(double));
+    double *next = calloc(cells, sizeof(double));
+    if (current == NULL || next == NULL) {
+        free(current);
+        free(next);
+        return -1;
+    }
+
+    int helpers = (config->threads < 1) ? 0 : config->threads - 1;
+    if (helpers > RETRO_MAX_THREADS - 1) {
+        helpers = RETRO_MAX_THREADS - 1;
+    }
+    RetroSweep sweep;
+    sweep.solver = solver;
+    sweep.gamma = config->gamma;
+    pthread_mutex_init(&sweep.lock, NULL);
+
+    solver->sweeps = 0;
+    solver->residual = 0.0;
+    while (solver->sweeps < config->max_sweeps) {
+        sweep.current = current;
+        sweep.next = next;
+        sweep.residual = 0.0;
+        atomic_init(&sweep.next_chunk, 0);
+
+        pthread_t threads[RETRO_MAX_THREADS];
+        int started = 0;
+        while (started < helpers && pthread_create(&threads[started], NULL, sweep_chunks, &sweep) == 0) {
+            ++started;
+        }
+        sweep_chunks(&sweep);
+        for (int t = 0; t < started; ++t) {
+            pthread_join(threads[t], NULL);
+        }
+
+        double *swap = current;
+        current = next;
+        next = swap;
+        ++solver->sweeps;
+        solver->residual = sweep.residual;
+        if (sweep.residual <= config->tolerance) {
+            break;
+        }
+    }
+    pthread_mutex_destroy(&sweep.lock);
+
+    free(next);
+    free(solver->values);
+    solver->values = current;
+    solver->gamma = config->gamma;
+    return 0;
+}
+
+// --- Perfect-hashed table ------------------------------------------------------------------
+
+static size_t key_bucket(uint64_t key, uint64_t seed, uint64_t buckets) {
+    return (size_t)(mix64(key ^ seed) % buckets);
+}
+
+static size_t key_slot(uint64_t key, uint64_t seed, uint32_t displacement, uint64_t slots) {
+    return (size_t)(mix64(key ^ (seed + (displacement + 1ULL) * RETRO_SEED_STEP)) % slots);
+}
+
+static uint32_t key_check(uint64_t key, uint64_t seed) {
+    return (uint32_t)(mix64(key ^ ~seed) >> 32) | 1U;
+}
+
+// Hash and displace: keys go to buckets by one hash, and each bucket, largest first, gets
+// the first displacement that sends all its keys to free slots under a second hash.
+// Returns 0 with the displacements and the slot of every key, or -1 when some bucket finds
+// no displacement under this seed.
+static int build_displacements(const uint64_t *keys, size_t count, uint64_t seed, uint64_t buckets, uint64_t slots,
+                               uint32_t *displacements, uint32_t *key_slots) {
+    uint32_t *bucket_start = calloc((size_t)buckets + 1, sizeof(uint32_t));
+    uint32_t *members = malloc(count * sizeof(uint32_t));
+    uint32_t *order = malloc((size_t)buckets * sizeof(uint32_t));
+    uint8_t *taken = calloc((size_t)slots, 1);
+    int status = (bucket_start && members && order && taken) ? 0 : -1;
+
+    uint32_t largest = 0;
+    if (status == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            ++bucket_start[key_bucket(keys[i], seed, buckets) + 1];
+        }
+        for (uint64_t b = 0; b < buckets; ++b) {
+            largest = (bucket_start[b + 1] > largest) ? bucket_start[b + 1] : largest;
+            bucket_start[b + 1] += bucket_start[b];
+        }
+        uint32_t *fill = calloc((size_t)buckets, sizeof(uint32_t));
+        uint32_t *by_size = calloc((size_t)largest + 2, sizeof(uint32_t));
+        if (fill == NULL || by_size == NULL) {
+            status = -1;
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                size_t b = key_bucket(keys[i], seed, buckets);
+                members[bucket_start[b] + fill[b]++] = (uint32_t)i;
+            }
+            // Counting sort of buckets by size, largest first.
+            for (uint64_t b = 0; b < buckets; ++b) {
+                ++by_size[largest - (bucket_start[b + 1] - bucket_start[b]) + 1];
+            }
+            for (uint32_t s = 0; s <= largest; ++s) {
+                by_size[s + 1] += by_size[s];
+            }
+            for (uint64_t b = 0; b < buckets; ++b) {
+                order[by_size[largest - (bucket_start[b + 1] - bucket_start[b])]++] = (uint32_t)b;
+            }
+        }
+        free(fill);
+        free(by_size);
+    }
+
+    size_t placed[RETRO_BUCKET_LOAD * 16];
+    for (uint64_t o = 0; o < buckets && status == 0; ++o) {
+        uint32_t b = order[o];
+        uint32_t size = bucket_start[b + 1] - bucket_start[b];
+        displacements[b] = 0;
+        if (size == 0) {
+            continue;
+        }
+        if (size > sizeof(placed) / sizeof(placed[0])) {
+            status = -1;
+            break;
+        }
+        uint32_t d = 0;
+        for (; d < RETRO_MAX_DISPLACEMENT; ++d) {
+            uint32_t k = 0;
+            for (; k < size; ++k) {
+                size_t slot = key_slot(keys[members[bucket_start[b] + k]], seed, d, slots);
+                bool clash = taken[slot] != 0;
+                for (uint32_t j = 0; j < k && !clash; ++j) {
+                    clash = placed[j] == slot;
+                }
+                if (clash) {
+                    break;
+                }
+                placed[k] = slot;
+            }
+            if (k == size) {
+                break;
+            }
+        }
+        if (d == RETRO_MAX_DISPLACEMENT) {
+            status = -1;
+            break;
+        }
+        displacements[b] = d;
+        for (uint32_t k = 0; k < size; ++k) {
+            taken[placed[k]] = 1;
+            key_slots[members[bucket_start[b] + k]] = (uint32_t)placed[k];
+        }
+    }
+
+    free(bucket_start);
+    free(members);
+    free(order);
+    free(taken);
+    return status;
+}
+
+// Write every explored state's value under a perfect hash of its key (field and bag),
+// trying further seeds if a displacement search fails.
+int retro_table_write(const RetroSolver *solver, const char *path, uint64_t seed) {
+    if (solver == NULL || path == NULL || solver->values == NULL || solver->state_count == 0 ||
+        solver->state_count >= UINT32_MAX) {
+        return -1;
+    }
+
+    size_t count = solver->state_count;
+    uint64_t *keys = malloc(count * sizeof(uint64_t));
+    float *values = malloc(count * sizeof(float));
+    uint32_t *key_slots = malloc(count * sizeof(uint32_t));
+    uint64_t buckets = count / RETRO_BUCKET_LOAD + 1;
+    uint64_t slots = count + count / 8 + 1;
+    uint32_t *displacements = calloc((size_t)buckets, sizeof(uint32_t));
+    RetroEntry *entries = calloc((size_t)slots, sizeof(RetroEntry));
+    int status = (keys && values && key_slots && displacements && entries) ? 0 : -1;
+
+    size_t n = 0;
+    for (size_t board = 0; board < solver->board_count && status == 0; ++board) {
+        for (unsigned bag = 1; bag <= RETRO_FULL_BAG; ++bag) {
+            if (bag_reached(solver, board, bag) && n < count) {
+                keys[n] = retro_state_key(solver->boards[board], bag);
+                values[n] = (float)solver->values[board * RETRO_BAGS + bag];
+                ++n;
+            }
+        }
+    }
+
+    int attempt = 0;
+    if (status == 0) {
+        status = -1;
+        for (; attempt < RETRO_BUILD_SEEDS && status != 0; ++attempt) {
+            status = build_displacements(keys, n, seed + (uint64_t)attempt * RETRO_SEED_STEP, buckets, slots,
+                                         displacements, key_slots);
+        }
+    }
+
+    FILE *fp = NULL;
+    if (status == 0) {
+        uint64_t used_seed = seed + (uint64_t)(attempt - 1) * RETRO_SEED_STEP;
+        for (size_t i = 0; i < n; ++i) {
+            entries[key_slots[i]].check = key_check(keys[i], used_seed);
+            entries[key_slots[i]].value = values[i];
+        }
+
+        RetroTableHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = RETRO_TABLE_MAGIC;
+        header.version = RETRO_TABLE_VERSION;
+        header.width = (uint32_t)solver->geometry.width;
+        header.height = (uint32_t)solver->geometry.height;
+        header.state_count = n;
+        header.slot_count = slots;
+        header.bucket_count = buckets;
+        header.seed = used_seed;
+        header.gamma = solver->gamma;
+        header.sweeps = (uint32_t)solver->sweeps;
+
+        unsigned char padded[RETRO_TABLE_HEADER_BYTES];
+        memset(padded, 0, sizeof(padded));
+        memcpy(padded, &header, sizeof(header));
+        static const uint32_t k_zero = 0;
+        fp = fopen(path, "wb");
+        bool ok = fp != NULL && fwrite(padded, 1, sizeof(padded), fp) == sizeof(padded) &&
+                  fwrite(displacements, sizeof(uint32_t), (size_t)buckets, fp) == buckets &&
+                  ((buckets & 1) == 0 || fwrite(&k_zero, sizeof(k_zero), 1, fp) == 1) &&
+                  fwrite(entries, sizeof(RetroEntry), (size_t)slots, fp) == slots;
+        ok = (fp == NULL || fclose(fp) == 0) && ok;
+        status = ok ? 0 : -1;
+    }
+
+    free(keys);
+    free(values);
+    free(key_slots);
+    free(displacements);
+    free(entries);
+    return status;
+}
+
+#if defined(_WIN32)
+
+int retro_table_open(RetroTable *table, const char *path) {
+    (void)path;
+    if (table != NULL) {
+        memset(table, 0, sizeof(*table));
+    }
+    return -1;
+}
+
+void retro_table_close(RetroTable *table) {
+    (void)table;
+}
+
+#else
+
+// Map a table read-only and check that its header and section sizes agree with the file.
+int retro_table_open(RetroTable *table, const char *path) {
+    if (table == NULL || path == NULL) {
+        return -1;
+    }
+    memset(table, 0, sizeof(*table));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < RETRO_TABLE_HEADER_BYTES) {
+        close(fd);
+        return -1;
+    }
+    void *mapped = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return -1;
+    }
+
+    table->base = mapped;
+    table->length = (size_t)info.st_size;
+    table->header = mapped;
+    const RetroTableHeader *header = table->header;
+    uint64_t displacement_bytes = (header->bucket_count + (header->bucket_count & 1)) * sizeof(uint32_t);
+    if (header->magic != RETRO_TABLE_MAGIC || header->version != RETRO_TABLE_VERSION || header->bucket_count == 0 ||
+        header->slot_count == 0 || header->bucket_count > table->length || header->slot_count > table->length ||
+        RETRO_TABLE_HEADER_BYTES + displacement_bytes + header->slot_count * sizeof(RetroEntry) != table->length) {
+        retro_table_close(table);
+        return -1;
+    }
+    table->displacements = (const uint32_t *)(table->base + RETRO_TABLE_HEADER_BYTES);
+    table->entries = (const RetroEntry *)(table->base + RETRO_TABLE_HEADER_BYTES + displacement_bytes);
+    return 0;
+}
+
+void retro_table_close(RetroTable *table) {
+    if (table == NULL || table->base == NULL) {
+        return;
+    }
+    munmap((void *)table->base, table->length);
+    memset(table, 0, sizeof(*table));
+}
+
+#endif
+
+// Two hashes and one entry read; a state that was never stored fails its fingerprint check
+// (up to a 2^-32 chance of a false match).
+bool retro_table_lookup(const RetroTable *table, uint64_t field, unsigned bag, float *value) {
+    if (table == NULL || table->header == NULL || bag == 0 || bag > RETRO_FULL_BAG) {
+        return false;
+    }
+    const RetroTableHeader *header = table->header;
+    uint64_t key = retro_state_key(field, bag);
+    uint32_t displacement = table->displacements[key_bucket(key, header->seed, header->bucket_count)];
+    const RetroEntry *entry = &table->entries[key_slot(key, header->seed, displacement, header->slot_count)];
+    if (entry->check != key_check(key, header->seed)) {
+        return false;
+    }
+    if (value != NULL) {
+        *value = entry->value;
+    }
+    return true;
+}
@@ -1,10 +1,41 @@
 #include "score.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
-// Score bookkeeping and persistence helpers.
-static const int line_values[] = {0, 100, 300, 500, 800};
+#include "metrics.h"
+
+// Score bookkeeping and persistence helpers. Lock scoring is table-driven and allocation
+// free so search code can score every candidate placement.
+
+#define SCORE_COMBO_POINTS 50
+#define SCORE_B2B_TETRIS_PERFECT_CLEAR 3200
+
+// Points before the level multiplier, by spin kind and lines cleared (0-4).
+static const int64_t k_clear_points[SCORE_SPIN_COUNT][5] = {
+    [SCORE_SPIN_NONE] = {0, 100, 300, 500, 800},
+    [SCORE_SPIN_MINI] = {100, 200, 400, 400, 400},
+    [SCORE_SPIN_FULL] = {400, 800, 1200, 1600, 1600},
+};
+
+static const int64_t k_perfect_clear_points[5] = {0, 800, 1200, 1800, 2000};
+
+// T centre within the 4x4 pattern for each rotation, and which of its diagonal corners
+// (bit 0 top-left, 1 top-right, 2 bottom-left, 3 bottom-right) are on the side it points at.
+static const struct {
+    int row;
+    int col;
+    uint8_t front;
+} k_t_corners[4] = {
+    {2, 1, 0x3}, // points up
+    {1, 2, 0x5}, // points left
+    {1, 1, 0xC}, // points down
+    {1, 1, 0xA}, // points right
+};
+
+static const int k_corner_offsets[4][2] = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+static const uint8_t k_bit_count[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
 
 // Load the saved high score (when available) and prepare bookkeeping.
 int score_state_init(ScoreState *state, const char *path) {
@@ -14,6 +45,7 @@ int score_state_init(ScoreState *state, const char *path) {
 
     state->current = 0;
     state->high = 0;
+    score_chain_reset(&state->chain);
     const char *resolved = (path == NULL) ? SCORE_DEFAULT_FILE : path;
     strncpy(state->storage_path, resolved, SCORE_PATH_CAPACITY - 1);
     state->storage_path[SCORE_PATH_CAPACITY - 1] = '\0';
@@ -23,8 +55,8 @@ int score_state_init(ScoreState *state, const char *path) {
         return 0;
     }
 
-    int file_value = 0;
-    if (fscanf(fp, "%d", &file_value) == 1 && file_value >= 0) {
+    int64_t file_value = 0;
+    if (fscanf(fp, "%" SCNd64, &file_value) == 1 && file_value >= 0) {
         state->high = file_value;
     }
 
@@ -43,33 +75,98 @@ int score_state_save(const ScoreState *state) {
         return -1;
     }
 
-    fprintf(fp, "%d\n", state->high);
+    fprintf(fp, "%" PRId64 "\n", state->high);
     fclose(fp);
+    metrics_inc(METRIC_SCORE_SAVES);
     return 0;
 }
 
-// Clear the in-progress session score.
+// Clear the in-progress session score and any running chain.
 void score_reset_current(ScoreState *state) {
     if (state == NULL) {
         return;
     }
     state->current = 0;
+    score_chain_reset(&state->chain);
 }
 
-// Award points for a batch of cleared lines (classic scoring table).
-void score_add_lines(ScoreState *state, int cleared_lines) {
-    if (state == NULL || cleared_lines <= 0) {
+void score_chain_reset(ScoreChain *chain) {
+    if (chain == NULL) {
         return;
     }
+    chain->combo = -1;
+    chain->back_to_back = false;
+}
 
-    int award = 0;
-    if (cleared_lines >= 0 && cleared_lines < (int)(sizeof(line_values) / sizeof(line_values[0]))) {
-        award = line_values[cleared_lines];
+// Three-corner rule at the lock position: a T whose last move was a rotation, with at
+// least three diagonal corners blocked (walls and floor count), is a T-spin when both
+// corners it points at are blocked and a mini otherwise. Call before clearing lines.
+ScoreSpin score_detect_tspin(const Board *board, const ActivePiece *piece, bool rotated_last) {
+    if (board == NULL || piece == NULL || !rotated_last || piece->type != SCORE_T_PIECE || piece->rotation < 0 ||
+        piece->rotation >= 4) {
+        return SCORE_SPIN_NONE;
+    }
+
+    int center_row = piece->row + k_t_corners[piece->rotation].row;
+    int center_col = piece->col + k_t_corners[piece->rotation].col;
+    uint8_t blocked = 0;
+    for (int i = 0; i < 4; ++i) {
+        int row = center_row + k_corner_offsets[i][0];
+        int col = center_col + k_corner_offsets[i][1];
+        if (row >= BOARD_HEIGHT || col < 0 || col >= BOARD_WIDTH || (row >= 0 && board->cells[row][col] != 0)) {
+            blocked |= (uint8_t)(1U << i);
+        }
+    }
+
+    if (k_bit_count[blocked] < 3) {
+        return SCORE_SPIN_NONE;
+    }
+    uint8_t front = k_t_corners[piece->rotation].front;
+    return ((blocked & front) == front) ? SCORE_SPIN_FULL : SCORE_SPIN_MINI;
+}
+
+// Points for one lock, advancing the combo/back-to-back chain. Difficult clears (tetrises
+// and spin clears) following another get 1.5x; every consecutive clearing lock adds a
+// combo bonus; a lock that clears nothing ends the combo but keeps back-to-back.
+int64_t score_lock_points(ScoreChain *chain, const ScoreLock *lock) {
+    if (chain == NULL || lock == NULL || lock->lines < 0 || lock->spin < 0 || lock->spin >= SCORE_SPIN_COUNT) {
+        return 0;
+    }
+
+    int column = (lock->lines > 4) ? 4 : lock->lines;
+    int64_t points = k_clear_points[lock->spin][column];
+    if (lock->spin == SCORE_SPIN_NONE && lock->lines > 4) {
+        points += (int64_t)(lock->lines - 4) * 100;
+    }
+
+    if (lock->lines == 0) {
+        chain->combo = -1;
     } else {
-        award = line_values[4] + (cleared_lines - 4) * 100;
+        bool difficult = lock->lines >= 4 || lock->spin != SCORE_SPIN_NONE;
+        bool chained = difficult && chain->back_to_back;
+        if (chained) {
+            points += points / 2;
+        }
+        chain->back_to_back = difficult;
+        chain->combo += 1;
+        points += (int64_t)SCORE_COMBO_POINTS * chain->combo;
+        if (lock->perfect_clear) {
+            points += (chained && column == 4) ? SCORE_B2B_TETRIS_PERFECT_CLEAR : k_perfect_clear_points[column];
+        }
+    }
+
+    return points * (lock->level > 1 ? lock->level : 1);
+}
+
+// Award a lock to the running score; returns the points added.
+int64_t score_add_lock(ScoreState *state, const ScoreLock *lock) {
+    if (state == NULL) {
+        return 0;
     }
 
-    state->current += award;
+    int64_t points = score_lock_points(&state->chain, lock);
+    state->current += points;
+    return points;
 }
 
 // Increment score based on the distance of a hard drop.
@@ -0,0 +1,619 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "spectate.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "versus.h"
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// Spectator ring: one encoder per tick, any number of readers. Socket viewers are fed
+// straight from the ring bytes, so an extra viewer costs one send() per frame and no
+// encoding or drawing.
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define CELL_COUNT (BOARD_HEIGHT * BOARD_WIDTH)
+
+static int8_t clamp_i8(int value) {
+    return (int8_t)(value < INT8_MIN ? INT8_MIN : (value > INT8_MAX ? INT8_MAX : value));
+}
+
+void spectate_state_from_engine(const Engine *engine, SpectateState *state) {
+    memset(state, 0, sizeof(*state));
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            state->cells[row][col] = (uint8_t)engine->board.cells[row][col];
+        }
+    }
+    state->type = clamp_i8(engine->active.type);
+    state->rotation = clamp_i8(engine->active.rotation);
+    state->row = clamp_i8(engine->active.row);
+    state->col = clamp_i8(engine->active.col);
+    state->active = engine->active.active ? 1U : 0U;
+    state->next_type = clamp_i8(engine->next_piece_type);
+    state->phase = (uint8_t)engine->phase;
+    state->level = (uint8_t)(engine->level > 255 ? 255 : engine->level);
+    state->lines = (uint16_t)(engine->total_lines_cleared > 65535 ? 65535 : engine->total_lines_cleared);
+    state->score = (uint32_t)(engine->score.current > UINT32_MAX ? UINT32_MAX : engine->score.current);
+    state->high = (uint32_t)(engine->score.high > UINT32_MAX ? UINT32_MAX : engine->score.high);
+}
+
+// Mirror a spectated state into an engine so the normal renderer can draw it.
+void spectate_state_to_engine(const SpectateState *state, Engine *engine) {
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            engine->board.cells[row][col] = state->cells[row][col];
+        }
+    }
+    engine->active.type = state->type;
+    engine->active.rotation = state->rotation;
+    engine->active.row = state->row;
+    engine->active.col = state->col;
+    engine->active.active = state->active != 0 && piece_shape_get((size_t)state->type) != NULL;
+    engine->next_piece_type = state->next_type;
+    engine->phase = (state->phase <= ENGINE_PHASE_GAME_OVER) ? (EnginePhase)state->phase : ENGINE_PHASE_IDLE;
+    engine->level = state->level;
+    engine_gravity_for_level(state->level, &engine->gravity_interval_ms, &engine->gravity_rows);
+    engine->total_lines_cleared = state->lines;
+    engine->score.current = state->score;
+    engine->score.high = state->high;
+}
+
+static unsigned char *put_fields(unsigned char *p, const SpectateState *state) {
+    *p++ = (unsigned char)state->type;
+    *p++ = (unsigned char)state->rotation;
+    *p++ = (unsigned char)state->row;
+    *p++ = (unsigned char)state->col;
+    *p++ = state->active;
+    *p++ = (unsigned char)state->next_type;
+    *p++ = state->phase;
+    *p++ = state->level;
+    *p++ = (unsigned char)(state->lines & 0xFF);
+    *p++ = (unsigned char)(state->lines >> 8);
+    for (int i = 0; i < 4; ++i) {
+        *p++ = (unsigned char)(state->score >> (8 * i));
+    }
+    for (int i = 0; i < 4; ++i) {
+        *p++ = (unsigned char)(state->high >> (8 * i));
+    }
+    return p;
+}
+
+static void get_fields(const unsigned char *p, SpectateState *state) {
+    state->type = (int8_t)p[0];
+    state->rotation = (int8_t)p[1];
+    state->row = (int8_t)p[2];
+    state->col = (int8_t)p[3];
+    state->active = p[4];
+    state->next_type = (int8_t)p[5];
+    state->phase = p[6];
+    state->level = p[7];
+    state->lines = (uint16_t)(p[8] | (p[9] << 8));
+    state->score = 0;
+    for (int i = 0; i < 4; ++i) {
+        state->score |= (uint32_t)p[10 + i] << (8 * i);
+    }
+    state->high = 0;
+    for (int i = 0; i < 4; ++i) {
+        state->high |= (uint32_t)p[14 + i] << (8 * i);
+    }
+}
+
+// Encode `current` relative to `previous` (NULL for a keyframe); returns the record size.
+static size_t encode_record(const SpectateState *previous, const SpectateState *current, uint32_t tick,
+                            unsigned char *out) {
+    unsigned char *p = out + SPECTATE_RECORD_HEADER;
+    SpectateRecordKind kind = SPECTATE_RECORD_KEYFRAME;
+
+    if (previous != NULL) {
+        kind = SPECTATE_RECORD_DELTA;
+        unsigned char *count = p++;
+        int changed = 0;
+        const uint8_t *before = &previous->cells[0][0];
+        const uint8_t *after = &current->cells[0][0];
+        for (int i = 0; i < CELL_COUNT; ++i) {
+            if (before[i] != after[i]) {
+                *p++ = (unsigned char)i;
+                *p++ = after[i];
+                ++changed;
+            }
+        }
+        *count = (unsigned char)changed;
+    } else {
+        memcpy(p, current->cells, CELL_COUNT);
+        p += CELL_COUNT;
+    }
+    p = put_fields(p, current);
+
+    size_t payload = (size_t)(p - out) - SPECTATE_RECORD_HEADER;
+    out[0] = (unsigned char)kind;
+    out[1] = 0;
+    out[2] = (unsigned char)(payload & 0xFF);
+    out[3] = (unsigned char)(payload >> 8);
+    for (int i = 0; i < 4; ++i) {
+        out[4 + i] = (unsigned char)(tick >> (8 * i));
+    }
+    return (size_t)(p - out);
+}
+
+// Apply one record to `state`. Returns 1 when applied, 0 when more bytes are needed, and
+// -1 for a malformed record.
+int spectate_apply_record(const unsigned char *buffer, size_t length, SpectateState *state, size_t *consumed) {
+    if (buffer == NULL || state == NULL || consumed == NULL) {
+        return -1;
+    }
+    if (length < SPECTATE_RECORD_HEADER) {
+        return 0;
+    }
+
+    size_t payload = (size_t)buffer[2] | ((size_t)buffer[3] << 8);
+    if (SPECTATE_RECORD_HEADER + payload > SPECTATE_MAX_RECORD) {
+        return -1;
+    }
+    if (length < SPECTATE_RECORD_HEADER + payload) {
+        return 0;
+    }
+
+    const unsigned char *p = buffer + SPECTATE_RECORD_HEADER;
+    if (buffer[0] == SPECTATE_RECORD_KEYFRAME) {
+        if (payload != CELL_COUNT + SPECTATE_FIELDS_SIZE) {
+            return -1;
+        }
+        memcpy(state->cells, p, CELL_COUNT);
+        p += CELL_COUNT;
+    } else if (buffer[0] == SPECTATE_RECORD_DELTA) {
+        size_t changed = p[0];
+        if (payload != 1 + changed * 2 + SPECTATE_FIELDS_SIZE) {
+            return -1;
+        }
+        ++p;
+        uint8_t *cells = &state->cells[0][0];
+        for (size_t i = 0; i < changed; ++i, p += 2) {
+            if (p[0] >= CELL_COUNT) {
+                return -1;
+            }
+            cells[p[0]] = p[1];
+        }
+    } else {
+        return -1;
+    }
+
+    get_fields(p, state);
+    state->tick = 0;
+    for (int i = 0; i < 4; ++i) {
+        state->tick |= (uint32_t)buffer[4 + i] << (8 * i);
+    }
+    *consumed = SPECTATE_RECORD_HEADER + payload;
+    return 1;
+}
+
+// --- Ring ------------------------------------------------------------------------------------
+
+// How far behind write_pos a reader may start a copy: the writer may already be filling
+// the next record (up to SPECTATE_MAX_RECORD bytes past write_pos) over older bytes.
+#define READER_WINDOW (SPECTATE_RING_BYTES - SPECTATE_MAX_RECORD)
+
+static void ring_copy_out(const SpectateRing *ring, uint64_t pos, unsigned char *out, size_t length) {
+    size_t offset = (size_t)(pos % SPECTATE_RING_BYTES);
+    size_t first = SPECTATE_RING_BYTES - offset;
+    if (first > length) {
+        first = length;
+    }
+    memcpy(out, ring->data + offset, first);
+    memcpy(out + first, ring->data, length - first);
+}
+
+// Copy the record in, then publish it by moving write_pos (and keyframe_pos) with
+// release stores so readers never see a position ahead of its bytes.
+static void ring_append(SpectateRing *ring, const unsigned char *record, size_t length, bool keyframe) {
+    uint64_t pos = atomic_load_explicit(&ring->write_pos, memory_order_relaxed);
+    size_t offset = (size_t)(pos % SPECTATE_RING_BYTES);
+    size_t first = SPECTATE_RING_BYTES - offset;
+    if (first > length) {
+        first = length;
+    }
+    memcpy(ring->data + offset, record, first);
+    memcpy(ring->data, record + first, length - first);
+
+    atomic_store_explicit(&ring->write_pos, pos + length, memory_order_release);
+    if (keyframe) {
+        atomic_store_explicit(&ring->keyframe_pos, pos, memory_order_release);
+    }
+}
+
+void spectate_reader_init(SpectateReader *reader, const SpectateRing *ring) {
+    reader->ring = ring;
+    reader->pos = 0;
+    reader->synced = false;
+}
+
+// Apply the next record to `state`. Returns 1 when the state changed, 0 when caught up.
+// A reader that falls within one record of being lapped (so the writer may be overwriting
+// the bytes it copies) restarts from the newest keyframe.
+int spectate_reader_next(SpectateReader *reader, SpectateState *state) {
+    if (reader == NULL || reader->ring == NULL || state == NULL) {
+        return -1;
+    }
+
+    const SpectateRing *ring = reader->ring;
+    for (;;) {
+        uint64_t write_pos = atomic_load_explicit(&ring->write_pos, memory_order_acquire);
+        if (!reader->synced || write_pos - reader->pos > READER_WINDOW) {
+            reader->pos = atomic_load_explicit(&ring->keyframe_pos, memory_order_acquire);
+            reader->synced = true;
+        }
+        if (reader->pos == write_pos) {
+            return 0;
+        }
+
+        unsigned char record[SPECTATE_MAX_RECORD];
+        size_t available = (size_t)(write_pos - reader->pos);
+        size_t length = available < sizeof(record) ? available : sizeof(record);
+        ring_copy_out(ring, reader->pos, record, length);
+
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t after = atomic_load_explicit(&ring->write_pos, memory_order_relaxed);
+        if (after - reader->pos > READER_WINDOW) {
+            reader->synced = false;
+            continue;
+        }
+
+        SpectateState next = *state;
+        size_t consumed = 0;
+        if (spectate_apply_record(record, length, &next, &consumed) != 1) {
+            reader->synced = false;
+            continue;
+        }
+        *state = next;
+        reader->pos += consumed;
+        return 1;
+    }
+}
+
+// --- Hub (publisher) ---------------------------------------------------------------------------
+
+#if defined(_WIN32)
+
+static SpectateRing *map_shared_ring(const char *name, bool create) {
+    (void)name;
+    (void)create;
+    return NULL;
+}
+
+static void unmap_shared_ring(SpectateRing *ring) {
+    (void)ring;
+}
+
+static void unlink_shared_ring(const char *name) {
+    (void)name;
+}
+
+static long socket_send(int fd, const unsigned char *data, size_t length) {
+    (void)fd;
+    (void)data;
+    (void)length;
+    return -1;
+}
+
+static long socket_recv(int fd, unsigned char *data, size_t length) {
+    (void)fd;
+    (void)data;
+    (void)length;
+    return -1;
+}
+
+static bool socket_would_block(void) {
+    return false;
+}
+
+static void socket_close(int fd) {
+    (void)fd;
+}
+
+#else
+
+// Map the ring from POSIX shared memory: read-write for the publisher, read-only for viewers.
+static SpectateRing *map_shared_ring(const char *name, bool create) {
+    int fd = shm_open(name, create ? (O_CREAT | O_RDWR) : O_RDONLY, 0600);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (create && ftruncate(fd, (off_t)sizeof(SpectateRing)) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void *mapped = mmap(NULL, sizeof(SpectateRing), create ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    return (mapped == MAP_FAILED) ? NULL : mapped;
+}
+
+static void unmap_shared_ring(SpectateRing *ring) {
+    munmap(ring, sizeof(SpectateRing));
+}
+
+static void unlink_shared_ring(const char *name) {
+    shm_unlink(name);
+}
+
+static long socket_send(int fd, const unsigned char *data, size_t length) {
+    return (long)send(fd, data, length, MSG_NOSIGNAL);
+}
+
+static long socket_recv(int fd, unsigned char *data, size_t length) {
+    return (long)recv(fd, data, length, 0);
+}
+
+static bool socket_would_block(void) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+
+static void socket_close(int fd) {
+    close(fd);
+}
+
+#endif
+
+// shm names must start with a slash; accept "shm:name" and "shm:/name".
+static int shm_path(const char *name, char *out, size_t capacity) {
+    if (name == NULL || name[0] == '\0') {
+        return -1;
+    }
+    int written = snprintf(out, capacity, "%s%s", name[0] == '/' ? "" : "/", name);
+    return (written < 0 || (size_t)written >= capacity) ? -1 : 0;
+}
+
+// Open a hub publishing to a socket endpoint, a shared-memory ring, or both (either may
+// be NULL; with neither the ring is private, which is what the tests and benchmarks use).
+int spectate_hub_open(SpectateHub *hub, const char *socket_address, const char *shm_name) {
+    if (hub == NULL) {
+        return -1;
+    }
+
+    memset(hub, 0, sizeof(*hub));
+    hub->listen_fd = -1;
+    if (shm_name != NULL) {
+        if (shm_path(shm_name, hub->shm_name, sizeof(hub->shm_name)) != 0) {
+            return -1;
+        }
+        hub->ring = map_shared_ring(hub->shm_name, true);
+    } else {
+        hub->ring = calloc(1, sizeof(SpectateRing));
+    }
+    if (hub->ring == NULL) {
+        hub->shm_name[0] = '\0';
+        return -1;
+    }
+
+    hub->ring->magic = SPECTATE_RING_MAGIC;
+    hub->ring->capacity = SPECTATE_RING_BYTES;
+    atomic_store_explicit(&hub->ring->write_pos, 0, memory_order_relaxed);
+    atomic_store_explicit(&hub->ring->keyframe_pos, 0, memory_order_relaxed);
+    atomic_store_explicit(&hub->ring->closed, false, memory_order_relaxed);
+
+    if (socket_address != NULL) {
+        hub->listen_fd = versus_listen(socket_address);
+        if (hub->listen_fd < 0) {
+            spectate_hub_close(hub);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Encode this tick's changes once. Nothing is written for an unchanged tick; a keyframe
+// replaces the delta when one is due, when it would be smaller, or before the previous
+// keyframe could be overwritten. Returns true when a record was written.
+bool spectate_hub_publish(SpectateHub *hub, const Engine *engine) {
+    if (hub == NULL || hub->ring == NULL || engine == NULL) {
+        return false;
+    }
+
+    ++hub->tick;
+    SpectateState current;
+    spectate_state_from_engine(engine, &current);
+    if (hub->have_last && memcmp(&current, &hub->last, sizeof(current)) == 0) {
+        return false;
+    }
+
+    unsigned char record[SPECTATE_MAX_RECORD];
+    size_t length = 0;
+    bool keyframe = !hub->have_last || hub->tick - hub->keyframe_tick >= SPECTATE_KEYFRAME_TICKS;
+    if (!keyframe) {
+        length = encode_record(&hub->last, &current, hub->tick, record);
+        uint64_t since = atomic_load_explicit(&hub->ring->write_pos, memory_order_relaxed) -
+                         atomic_load_explicit(&hub->ring->keyframe_pos, memory_order_relaxed);
+        keyframe = length > SPECTATE_RECORD_HEADER + CELL_COUNT + SPECTATE_FIELDS_SIZE ||
+                   since + length > SPECTATE_RING_BYTES / 2;
+    }
+    if (keyframe) {
+        length = encode_record(NULL, &current, hub->tick, record);
+        hub->keyframe_tick = hub->tick;
+    }
+
+    ring_append(hub->ring, record, length, keyframe);
+    hub->last = current;
+    hub->have_last = true;
+    return true;
+}
+
+static void drop_viewer(SpectateHub *hub, int index) {
+    socket_close(hub->viewers[index].fd);
+    hub->viewers[index] = hub->viewers[--hub->viewer_count];
+}
+
+// Accept new viewers (they start at the newest keyframe) and send each whatever it has
+// not seen yet, straight from the ring. A viewer that falls a full ring behind skips to
+// the newest keyframe if it stopped on a record boundary, and is dropped otherwise.
+void spectate_hub_pump(SpectateHub *hub) {
+    if (hub == NULL || hub->ring == NULL) {
+        return;
+    }
+
+    uint64_t write_pos = atomic_load_explicit(&hub->ring->write_pos, memory_order_relaxed);
+    uint64_t keyframe_pos = atomic_load_explicit(&hub->ring->keyframe_pos, memory_order_relaxed);
+
+    if (hub->listen_fd >= 0) {
+        int fd;
+        while ((fd = versus_accept(hub->listen_fd)) >= 0) {
+            if (hub->viewer_count == SPECTATE_MAX_VIEWERS) {
+                socket_close(fd);
+                continue;
+            }
+            SpectateViewer *viewer = &hub->viewers[hub->viewer_count++];
+            viewer->fd = fd;
+            viewer->pos = keyframe_pos;
+            viewer->at_record = true;
+        }
+    }
+
+    for (int i = 0; i < hub->viewer_count; ++i) {
+        SpectateViewer *viewer = &hub->viewers[i];
+        if (write_pos - viewer->pos > SPECTATE_RING_BYTES) {
+            if (!viewer->at_record) {
+                drop_viewer(hub, i--);
+                continue;
+            }
+            viewer->pos = keyframe_pos;
+        }
+
+        bool dead = false;
+        while (viewer->pos < write_pos) {
+            size_t offset = (size_t)(viewer->pos % SPECTATE_RING_BYTES);
+            size_t length = (size_t)(write_pos - viewer->pos);
+            if (length > SPECTATE_RING_BYTES - offset) {
+                length = SPECTATE_RING_BYTES - offset;
+            }
+            long sent = socket_send(viewer->fd, hub->ring->data + offset, length);
+            if (sent <= 0) {
+                dead = !(sent < 0 && socket_would_block());
+                break;
+            }
+            viewer->pos += (uint64_t)sent;
+        }
+        if (dead) {
+            drop_viewer(hub, i--);
+            continue;
+        }
+        viewer->at_record = viewer->pos == write_pos;
+    }
+}
+
+void spectate_hub_close(SpectateHub *hub) {
+    if (hub == NULL) {
+        return;
+    }
+
+    while (hub->viewer_count > 0) {
+        drop_viewer(hub, hub->viewer_count - 1);
+    }
+    if (hub->listen_fd >= 0) {
+        socket_close(hub->listen_fd);
+        hub->listen_fd = -1;
+    }
+    if (hub->ring != NULL) {
+        if (hub->shm_name[0] != '\0') {
+            atomic_store_explicit(&hub->ring->closed, true, memory_order_release);
+            unmap_shared_ring(hub->ring);
+            unlink_shared_ring(hub->shm_name);
+        } else {
+            free(hub->ring);
+        }
+        hub->ring = NULL;
+    }
+}
+
+// --- Feed (viewer) -----------------------------------------------------------------------------
+
+int spectate_feed_open(SpectateFeed *feed, const char *address) {
+    if (feed == NULL || address == NULL) {
+        return -1;
+    }
+
+    memset(feed, 0, sizeof(*feed));
+    feed->fd = -1;
+    if (strncmp(address, "shm:", 4) == 0) {
+        char name[64];
+        if (shm_path(address + 4, name, sizeof(name)) != 0) {
+            return -1;
+        }
+        feed->mapped = map_shared_ring(name, false);
+        if (feed->mapped == NULL || feed->mapped->magic != SPECTATE_RING_MAGIC ||
+            feed->mapped->capacity != SPECTATE_RING_BYTES) {
+            spectate_feed_close(feed);
+            return -1;
+        }
+        spectate_reader_init(&feed->reader, feed->mapped);
+        return 0;
+    }
+
+    feed->fd = versus_connect(address);
+    return (feed->fd < 0) ? -1 : 0;
+}
+
+// Bring `state` up to date with everything available. Returns 1 when it changed, 0 when
+// nothing new arrived, and -1 once the publisher has gone away.
+int spectate_feed_poll(SpectateFeed *feed, SpectateState *state) {
+    if (feed == NULL || state == NULL) {
+        return -1;
+    }
+
+    int changed = 0;
+    if (feed->mapped != NULL) {
+        while (spectate_reader_next(&feed->reader, state) > 0) {
+            changed = 1;
+        }
+        if (!changed && atomic_load_explicit(&feed->mapped->closed, memory_order_acquire)) {
+            return -1;
+        }
+        return changed;
+    }
+
+    for (;;) {
+        size_t consumed = 0;
+        int status;
+        while ((status = spectate_apply_record(feed->in, feed->in_len, state, &consumed)) > 0) {
+            memmove(feed->in, feed->in + consumed, feed->in_len - consumed);
+            feed->in_len -= consumed;
+            changed = 1;
+        }
+        if (status < 0) {
+            return -1;
+        }
+
+        long n = socket_recv(feed->fd, feed->in + feed->in_len, sizeof(feed->in) - feed->in_len);
+        if (n < 0 && socket_would_block()) {
+            return changed;
+        }
+        if (n <= 0) {
+            return changed ? changed : -1;
+        }
+        feed->in_len += (size_t)n;
+    }
+}
+
+void spectate_feed_close(SpectateFeed *feed) {
+    if (feed == NULL) {
+        return;
+    }
+    if (feed->mapped != NULL) {
+        unmap_shared_ring(feed->mapped);
+        feed->mapped = NULL;
+    }
+    if (feed->fd >= 0) {
+        socket_close(feed->fd);
+        feed->fd = -1;
+    }
+}
@@ -0,0 +1,337 @@
+#define _POSIX_C_SOURCE 200809L
+
+#if defined(_WIN32)
+#include <curses.h>
+#else
+#include <ncurses.h>
+#endif
+
+#include "term.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "vt100.h"
+
+// Thin drawing/input layer over either ncurses or the raw VT100 backend. The game only
+// talks to this module, so both backends render the same frame.
+
+#define TERM_INPUT_BUFFER 64
+#define TERM_NULL_ROWS 40
+#define TERM_NULL_COLS 120
+
+static TermBackend g_backend = TERM_BACKEND_NCURSES;
+static bool g_active = false;
+static bool g_colors = false;
+static Vt100Screen g_screen;
+static unsigned char g_input[TERM_INPUT_BUFFER];
+static size_t g_input_len = 0;
+
+// Per-tetromino colors, indexed by piece type (I, O, T, L, J, S, Z).
+static const TermColor k_piece_colors[] = {
+    TERM_COLOR_CYAN,
+    TERM_COLOR_YELLOW,
+    TERM_COLOR_MAGENTA,
+    TERM_COLOR_WHITE,
+    TERM_COLOR_BLUE,
+    TERM_COLOR_GREEN,
+    TERM_COLOR_RED
+};
+
+static const char *const k_backend_names[] = {
+    [TERM_BACKEND_NCURSES] = "ncurses",
+    [TERM_BACKEND_VT100] = "vt100",
+    [TERM_BACKEND_NULL] = "null"
+};
+
+const char *term_backend_name(TermBackend backend) {
+    if ((unsigned)backend > TERM_BACKEND_NULL) {
+        return "unknown";
+    }
+    return k_backend_names[backend];
+}
+
+int term_backend_parse(const char *name, TermBackend *backend_out) {
+    if (name == NULL || backend_out == NULL) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < sizeof(k_backend_names) / sizeof(k_backend_names[0]); ++i) {
+        if (strcmp(name, k_backend_names[i]) == 0) {
+            *backend_out = (TermBackend)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Shared by every view that draws pieces; unknown types (e.g. garbage) are white.
+TermColor term_piece_color(int piece_type) {
+    int count = (int)(sizeof(k_piece_colors) / sizeof(k_piece_colors[0]));
+    return (piece_type >= 0 && piece_type < count) ? k_piece_colors[piece_type] : TERM_COLOR_WHITE;
+}
+
+// --- ncurses backend ------------------------------------------------------------------------
+
+static int ncurses_init(void) {
+    if (initscr() == NULL) {
+        return -1;
+    }
+
+    cbreak();
+    noecho();
+    keypad(stdscr, TRUE);
+    nodelay(stdscr, TRUE);
+    curs_set(0);
+
+    g_colors = false;
+    if (has_colors()) {
+        start_color();
+        use_default_colors();
+        init_pair(TERM_COLOR_CYAN, COLOR_CYAN, -1);
+        init_pair(TERM_COLOR_YELLOW, COLOR_YELLOW, -1);
+        init_pair(TERM_COLOR_BLUE, COLOR_BLUE, -1);
+        init_pair(TERM_COLOR_WHITE, COLOR_WHITE, -1);
+        init_pair(TERM_COLOR_MAGENTA, COLOR_MAGENTA, -1);
+        init_pair(TERM_COLOR_GREEN, COLOR_GREEN, -1);
+        init_pair(TERM_COLOR_RED, COLOR_RED, -1);
+        g_colors = true;
+    }
+    return 0;
+}
+
+static attr_t ncurses_attr(TermAttr attr) {
+    attr_t result = A_NORMAL;
+    if (attr & TERM_ATTR_BOLD) {
+        result |= A_BOLD;
+    }
+    if (attr & TERM_ATTR_DIM) {
+        result |= A_DIM;
+    }
+    if (attr & TERM_ATTR_REVERSE) {
+        result |= A_REVERSE;
+    }
+    TermColor color = TERM_ATTR_COLOR(attr);
+    if (g_colors && color != TERM_COLOR_DEFAULT && (unsigned)color < TERM_COLOR_COUNT) {
+        result |= COLOR_PAIR(color);
+    }
+    return result;
+}
+
+static int ncurses_key(int ch) {
+    switch (ch) {
+        case ERR:
+            return TERM_KEY_NONE;
+        case KEY_UP:
+            return TERM_KEY_UP;
+        case KEY_DOWN:
+            return TERM_KEY_DOWN;
+        case KEY_LEFT:
+            return TERM_KEY_LEFT;
+        case KEY_RIGHT:
+            return TERM_KEY_RIGHT;
+        case KEY_ENTER:
+            return TERM_KEY_ENTER;
+        default:
+            return ch;
+    }
+}
+
+// --- VT100 backend --------------------------------------------------------------------------
+
+static int vt100_init(void) {
+    int rows = 0;
+    int cols = 0;
+    if (vt100_tty_size(&rows, &cols) != 0 || vt100_screen_init(&g_screen, rows, cols) != 0) {
+        return -1;
+    }
+    if (vt100_tty_open() != 0) {
+        vt100_screen_destroy(&g_screen);
+        return -1;
+    }
+
+    g_colors = true;
+    g_input_len = 0;
+    return 0;
+}
+
+// Input that ends inside an escape sequence stays buffered and is completed by the next
+// read; a buffer full of one unfinished sequence cannot be a key and is dropped.
+static int vt100_key(void) {
+    for (;;) {
+        size_t consumed = 0;
+        int key = vt100_parse_key(g_input, g_input_len, &consumed);
+        if (consumed == 0) {
+            if (g_input_len == sizeof(g_input)) {
+                g_input_len = 0;
+            }
+            int n = vt100_tty_read(g_input + g_input_len, sizeof(g_input) - g_input_len);
+            if (n <= 0) {
+                return TERM_KEY_NONE;
+            }
+            g_input_len += (size_t)n;
+            continue;
+        }
+
+        memmove(g_input, g_input + consumed, g_input_len - consumed);
+        g_input_len -= consumed;
+        if (key != TERM_KEY_NONE) {
+            return key;
+        }
+    }
+}
+
+// --- Public API -----------------------------------------------------------------------------
+
+// Start the requested backend, falling back to ncurses if VT100 cannot take the terminal.
+int term_init(TermBackend requested) {
+    if (requested == TERM_BACKEND_NULL) {
+        if (vt100_screen_init(&g_screen, TERM_NULL_ROWS, TERM_NULL_COLS) != 0) {
+            return -1;
+        }
+        g_backend = TERM_BACKEND_NULL;
+        g_colors = true;
+        g_active = true;
+        return 0;
+    }
+    if (requested == TERM_BACKEND_VT100 && vt100_init() == 0) {
+        g_backend = TERM_BACKEND_VT100;
+        g_active = true;
+        return 0;
+    }
+
+    if (ncurses_init() != 0) {
+        return -1;
+    }
+    g_backend = TERM_BACKEND_NCURSES;
+    g_active = true;
+    return 0;
+}
+
+void term_shutdown(void) {
+    if (!g_active) {
+        return;
+    }
+
+    if (g_backend == TERM_BACKEND_VT100) {
+        vt100_tty_close();
+        vt100_screen_destroy(&g_screen);
+    } else if (g_backend == TERM_BACKEND_NULL) {
+        vt100_screen_destroy(&g_screen);
+    } else {
+        endwin();
+    }
+    g_active = false;
+}
+
+TermBackend term_backend(void) {
+    return g_backend;
+}
+
+bool term_has_colors(void) {
+    return g_colors;
+}
+
+int term_rows(void) {
+    return (g_backend != TERM_BACKEND_NCURSES) ? g_screen.rows : LINES;
+}
+
+int term_cols(void) {
+    return (g_backend != TERM_BACKEND_NCURSES) ? g_screen.cols : COLS;
+}
+
+int term_read_key(void) {
+    if (g_backend == TERM_BACKEND_NULL) {
+        return TERM_KEY_NONE;
+    }
+    return (g_backend == TERM_BACKEND_VT100) ? vt100_key() : ncurses_key(getch());
+}
+
+void term_nap(int ms) {
+#if defined(_WIN32)
+    napms(ms);
+#else
+    struct timespec delay = {ms / 1000, (long)(ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+#endif
+}
+
+// Start a new frame; the VT100 backend also picks up terminal resizes here.
+void term_clear(void) {
+    if (g_backend == TERM_BACKEND_NULL) {
+        vt100_clear(&g_screen);
+        return;
+    }
+    if (g_backend != TERM_BACKEND_VT100) {
+        erase();
+        return;
+    }
+
+    int rows = 0;
+    int cols = 0;
+    if (vt100_tty_resized() && vt100_tty_size(&rows, &cols) == 0) {
+        vt100_screen_resize(&g_screen, rows, cols);
+    }
+    vt100_clear(&g_screen);
+}
+
+void term_box(void) {
+    if (g_backend != TERM_BACKEND_NCURSES) {
+        vt100_box(&g_screen);
+    } else {
+        box(stdscr, 0, 0);
+    }
+}
+
+// Attribute used by every following put until changed.
+void term_set_attr(TermAttr attr) {
+    if (g_backend != TERM_BACKEND_NCURSES) {
+        g_screen.attr = attr & (TermAttr)~VT100_ATTR_LINE;
+    } else {
+        attrset(ncurses_attr(attr));
+    }
+}
+
+void term_put(int y, int x, const char *text) {
+    if (text == NULL) {
+        return;
+    }
+    if (g_backend != TERM_BACKEND_NCURSES) {
+        vt100_put(&g_screen, y, x, text, strlen(text));
+    } else {
+        mvaddstr(y, x, text);
+    }
+}
+
+void term_putc(int y, int x, char ch) {
+    if (g_backend != TERM_BACKEND_NCURSES) {
+        vt100_put(&g_screen, y, x, &ch, 1);
+    } else {
+        mvaddch(y, x, (chtype)(unsigned char)ch);
+    }
+}
+
+void term_printf(int y, int x, const char *format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    term_put(y, x, text);
+}
+
+// Push the composed frame to the terminal: one write() for VT100, refresh() for ncurses.
+// The null backend still composes the frame's escape sequences, then drops them.
+void term_flush(void) {
+    if (g_backend == TERM_BACKEND_NCURSES) {
+        refresh();
+        return;
+    }
+
+    size_t len = vt100_compose(&g_screen);
+    if (len > 0 && g_backend == TERM_BACKEND_VT100) {
+        vt100_tty_write(g_screen.out.data, len);
+    }
+}
@@ -0,0 +1,370 @@
+#include "tetris_env.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bag.h"
+#include "engine.h"
+
+// Batched environment behind the libtetris ABI: one Engine per slot, stepped in lockstep
+// by the caller plus an optional pool of worker threads, writing observations straight
+// into the caller's buffers.
+
+_Static_assert(TETRIS_ENV_ROWS == BOARD_HEIGHT, "ABI row count must match the board");
+_Static_assert(TETRIS_ENV_COLS == BOARD_WIDTH && BOARD_WIDTH <= 16, "ABI rows are 16-bit masks");
+
+typedef struct {
+    Engine engine;
+    uint64_t seed;
+    int32_t pieces;
+} EnvSlot;
+
+typedef struct {
+    TetrisEnv *env;
+    pthread_t thread;
+    int begin;
+    int end;
+    uint64_t seen_generation;
+} EnvWorker;
+
+struct TetrisEnv {
+    int count;
+    EnvSlot *slots;
+    TetrisEnvBuffers buffers;
+    bool bound;
+    const int32_t *actions;
+
+    EnvWorker *workers;
+    int worker_count;
+    int caller_end;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    uint64_t generation;
+    int pending;
+    bool stopping;
+};
+
+// Episodes after the first are seeded from the previous one so a batch is reproducible
+// from its creation seeds alone.
+static uint64_t next_episode_seed(uint64_t seed) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static void start_episode(EnvSlot *slot) {
+    engine_init(&slot->engine, slot->seed);
+    engine_start(&slot->engine);
+    engine_take_events(&slot->engine, NULL);
+    slot->pieces = 0;
+}
+
+static void write_observation(TetrisEnv *env, int index) {
+    const Engine *engine = &env->slots[index].engine;
+    size_t plane_stride = (size_t)TETRIS_ENV_PLANE_COUNT * TETRIS_ENV_ROWS;
+    uint16_t *locked = env->buffers.planes + (size_t)index * plane_stride;
+    uint16_t *active = locked + TETRIS_ENV_ROWS;
+
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        uint16_t mask = 0;
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            if (engine->board.cells[row][col] != 0) {
+                mask |= (uint16_t)(1U << col);
+            }
+        }
+        locked[row] = mask;
+        active[row] = 0;
+    }
+
+    const PieceShape *shape = engine_active_shape(engine);
+    if (engine->active.active && shape != NULL) {
+        const char *pattern = shape->rotations[engine->active.rotation];
+        for (int r = 0; r < shape->size; ++r) {
+            for (int c = 0; c < shape->size; ++c) {
+                int row = engine->active.row + r;
+                int col = engine->active.col + c;
+                if (pattern[r * shape->size + c] == '1' && row >= 0 && row < BOARD_HEIGHT && col >= 0 &&
+                    col < BOARD_WIDTH) {
+                    active[row] |= (uint16_t)(1U << col);
+                }
+            }
+        }
+    }
+
+    int8_t *queue = env->buffers.queue + (size_t)index * TETRIS_ENV_QUEUE_LEN;
+    int preview[TETRIS_ENV_QUEUE_LEN - 2];
+    piece_bag_peek(&engine->bag, preview, TETRIS_ENV_QUEUE_LEN - 2);
+    queue[0] = (int8_t)(engine->active.active ? engine->active.type : -1);
+    queue[1] = (int8_t)engine->next_piece_type;
+    for (int i = 0; i < TETRIS_ENV_QUEUE_LEN - 2; ++i) {
+        queue[2 + i] = (int8_t)preview[i];
+    }
+
+    int32_t *stats = env->buffers.stats + (size_t)index * TETRIS_ENV_STAT_COUNT;
+    stats[TETRIS_ENV_STAT_SCORE] = (int32_t)(engine->score.current > INT32_MAX ? INT32_MAX : engine->score.current);
+    stats[TETRIS_ENV_STAT_LINES] = engine->total_lines_cleared;
+    stats[TETRIS_ENV_STAT_LEVEL] = engine->level;
+    stats[TETRIS_ENV_STAT_PIECES] = env->slots[index].pieces;
+    stats[TETRIS_ENV_STAT_ACTIVE_ROW] = engine->active.row;
+    stats[TETRIS_ENV_STAT_ACTIVE_COL] = engine->active.col;
+    stats[TETRIS_ENV_STAT_ACTIVE_ROTATION] = engine->active.rotation;
+}
+
+static void step_one(TetrisEnv *env, int index) {
+    EnvSlot *slot = &env->slots[index];
+    Engine *engine = &slot->engine;
+    int64_t score_before = engine->score.current;
+
+    switch (env->actions[index]) {
+        case TETRIS_ACTION_LEFT:
+            engine_shift(engine, -1);
+            break;
+        case TETRIS_ACTION_RIGHT:
+            engine_shift(engine, 1);
+            break;
+        case TETRIS_ACTION_ROTATE_CW:
+            engine_rotate(engine, 1);
+            break;
+        case TETRIS_ACTION_ROTATE_CCW:
+            engine_rotate(engine, -1);
+            break;
+        case TETRIS_ACTION_SOFT_DROP:
+            engine_soft_drop(engine);
+            break;
+        case TETRIS_ACTION_HARD_DROP:
+            engine_hard_drop(engine);
+            break;
+        default:
+            break;
+    }
+    engine_tick(engine, TETRIS_ENV_FRAME_MS);
+
+    uint32_t flags = engine_take_events(engine, NULL);
+    if (flags & ENGINE_EVENT_LOCKED) {
+        ++slot->pieces;
+    }
+
+    float reward = (float)(engine->score.current - score_before);
+    bool done = engine->phase == ENGINE_PHASE_GAME_OVER;
+    if (done) {
+        slot->seed = next_episode_seed(slot->seed);
+        start_episode(slot);
+    }
+
+    env->buffers.rewards[index] = reward;
+    env->buffers.dones[index] = done ? 1U : 0U;
+    write_observation(env, index);
+}
+
+static void step_range(TetrisEnv *env, int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+        step_one(env, i);
+    }
+}
+
+static void *worker_main(void *arg) {
+    EnvWorker *worker = arg;
+    TetrisEnv *env = worker->env;
+    uint64_t seen = worker->seen_generation;
+
+    pthread_mutex_lock(&env->lock);
+    for (;;) {
+        while (!env->stopping && env->generation == seen) {
+            pthread_cond_wait(&env->start, &env->lock);
+        }
+        if (env->stopping) {
+            break;
+        }
+        seen = env->generation;
+        pthread_mutex_unlock(&env->lock);
+
+        step_range(env, worker->begin, worker->end);
+
+        pthread_mutex_lock(&env->lock);
+        if (--env->pending == 0) {
+            pthread_cond_signal(&env->done);
+        }
+    }
+    pthread_mutex_unlock(&env->lock);
+    return NULL;
+}
+
+static void stop_workers(TetrisEnv *env) {
+    if (env->worker_count == 0) {
+        free(env->workers);
+        env->workers = NULL;
+        env->caller_end = env->count;
+        return;
+    }
+
+    pthread_mutex_lock(&env->lock);
+    env->stopping = true;
+    pthread_cond_broadcast(&env->start);
+    pthread_mutex_unlock(&env->lock);
+
+    for (int i = 0; i < env->worker_count; ++i) {
+        pthread_join(env->workers[i].thread, NULL);
+    }
+    free(env->workers);
+    env->workers = NULL;
+    env->worker_count = 0;
+    env->caller_end = env->count;
+    env->stopping = false;
+}
+
+int env_abi_version(void) {
+    return TETRIS_ENV_ABI_VERSION;
+}
+
+// Create count games, seeded from seeds[i] (or from i when seeds is NULL), all playing.
+TetrisEnv *env_create(int count, const uint64_t *seeds) {
+    if (count <= 0) {
+        return NULL;
+    }
+
+    TetrisEnv *env = calloc(1, sizeof(*env));
+    if (env == NULL) {
+        return NULL;
+    }
+    env->slots = calloc((size_t)count, sizeof(EnvSlot));
+    if (env->slots == NULL) {
+        free(env);
+        return NULL;
+    }
+
+    env->count = count;
+    env->caller_end = count;
+    pthread_mutex_init(&env->lock, NULL);
+    pthread_cond_init(&env->start, NULL);
+    pthread_cond_init(&env->done, NULL);
+
+    for (int i = 0; i < count; ++i) {
+        env->slots[i].seed = (seeds != NULL) ? seeds[i] : (uint64_t)i;
+        start_episode(&env->slots[i]);
+    }
+    return env;
+}
+
+void env_destroy(TetrisEnv *env) {
+    if (env == NULL) {
+        return;
+    }
+
+    stop_workers(env);
+    pthread_cond_destroy(&env->done);
+    pthread_cond_destroy(&env->start);
+    pthread_mutex_destroy(&env->lock);
+    free(env->slots);
+    free(env);
+}
+
+int env_count(const TetrisEnv *env) {
+    return (env == NULL) ? 0 : env->count;
+}
+
+// Point the environment at the caller's observation buffers (see the layout in
+// tetris_env.h) and fill them with the current state. Buffers must stay valid until
+// rebound or the environment is destroyed.
+int env_bind_buffers(TetrisEnv *env, const TetrisEnvBuffers *buffers) {
+    if (env == NULL || buffers == NULL || buffers->planes == NULL || buffers->queue == NULL ||
+        buffers->stats == NULL || buffers->rewards == NULL || buffers->dones == NULL) {
+        return -1;
+    }
+
+    env->buffers = *buffers;
+    env->bound = true;
+    for (int i = 0; i < env->count; ++i) {
+        env->buffers.rewards[i] = 0.0f;
+        env->buffers.dones[i] = 0U;
+        write_observation(env, i);
+    }
+    return 0;
+}
+
+// Step with `threads` threads in total (the caller plus threads - 1 workers). Each thread
+// owns a fixed contiguous range of games, so results do not depend on the thread count.
+int env_set_threads(TetrisEnv *env, int threads) {
+    if (env == NULL) {
+        return -1;
+    }
+
+    stop_workers(env);
+    if (threads > env->count) {
+        threads = env->count;
+    }
+    if (threads <= 1) {
+        return 0;
+    }
+
+    env->workers = calloc((size_t)threads - 1, sizeof(EnvWorker));
+    if (env->workers == NULL) {
+        return -1;
+    }
+
+    env->caller_end = env->count / threads;
+    for (int t = 1; t < threads; ++t) {
+        EnvWorker *worker = &env->workers[t - 1];
+        worker->env = env;
+        worker->begin = (int)((int64_t)env->count * t / threads);
+        worker->end = (int)((int64_t)env->count * (t + 1) / threads);
+        worker->seen_generation = env->generation;
+        if (pthread_create(&worker->thread, NULL, worker_main, worker) != 0) {
+            stop_workers(env);
+            return -1;
+        }
+        ++env->worker_count;
+    }
+    return 0;
+}
+
+// Start new episodes everywhere, from seeds when given or continuing each slot's chain.
+int env_reset(TetrisEnv *env, const uint64_t *seeds) {
+    if (env == NULL) {
+        return -1;
+    }
+
+    for (int i = 0; i < env->count; ++i) {
+        EnvSlot *slot = &env->slots[i];
+        slot->seed = (seeds != NULL) ? seeds[i] : next_episode_seed(slot->seed);
+        start_episode(slot);
+        if (env->bound) {
+            env->buffers.rewards[i] = 0.0f;
+            env->buffers.dones[i] = 0U;
+            write_observation(env, i);
+        }
+    }
+    return 0;
+}
+
+// Apply actions[i] to game i, advance each by one frame, and write reward, done, and the
+// next observation. Finished games restart immediately and report their first frame.
+int env_step(TetrisEnv *env, const int32_t *actions) {
+    if (env == NULL || actions == NULL || !env->bound) {
+        return -1;
+    }
+
+    env->actions = actions;
+    if (env->worker_count == 0) {
+        step_range(env, 0, env->count);
+        return 0;
+    }
+
+    pthread_mutex_lock(&env->lock);
+    env->pending = env->worker_count;
+    ++env->generation;
+    pthread_cond_broadcast(&env->start);
+    pthread_mutex_unlock(&env->lock);
+
+    step_range(env, 0, env->caller_end);
+
+    pthread_mutex_lock(&env->lock);
+    while (env->pending > 0) {
+        pthread_cond_wait(&env->done, &env->lock);
+    }
+    pthread_mutex_unlock(&env->lock);
+    return 0;
+}
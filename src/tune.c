@@ -0,0 +1,443 @@
+#include "tune.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "bag.h"
+#include "cow_board.h"
+#include "perft.h"
+
+// Genetic search over hint evaluation weights, scored by headless greedy games played on
+// every core with shared seeds, and checkpointed so a long run can resume.
+
+#define TUNE_TOURNAMENT 3
+#define TUNE_MUTATION_RATE 0.25
+#define TUNE_MUTATION_SIGMA 0.2
+#define TUNE_CHECKPOINT_MAX_BYTES \
+    (8 * 4 + 8 * 4 + 8 * HINT_FEATURE_COUNT * (TUNE_MAX_POPULATION + 1))
+
+static uint64_t splitmix(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t tune_random(TuneState *state) {
+    uint64_t x = state->rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    state->rng_state = x;
+    return x * 2685821657736338717ULL;
+}
+
+// Uniform in [0, 1).
+static double tune_uniform(TuneState *state) {
+    return (double)(tune_random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Standard normal by Box-Muller; 1 - u keeps the logarithm finite.
+static double tune_gaussian(TuneState *state) {
+    double u = 1.0 - tune_uniform(state);
+    double v = tune_uniform(state);
+    return sqrt(-2.0 * log(u)) * cos(6.283185307179586 * v);
+}
+
+// The greedy policy only compares placements, so a weight vector and any positive multiple
+// play identically; keep candidates on the unit sphere.
+static void normalize(HintWeights *weights) {
+    double norm = 0.0;
+    for (int i = 0; i < HINT_FEATURE_COUNT; ++i) {
+        norm += weights->weights[i] * weights->weights[i];
+    }
+    if (norm == 0.0) {
+        *weights = hint_default_weights;
+        normalize(weights);
+        return;
+    }
+    norm = sqrt(norm);
+    for (int i = 0; i < HINT_FEATURE_COUNT; ++i) {
+        weights->weights[i] /= norm;
+    }
+}
+
+// Candidate 0 starts from the hand-set weights, the rest at random.
+void tune_state_init(TuneState *state, int population, uint64_t seed) {
+    if (state == NULL) {
+        return;
+    }
+    if (population < 2) {
+        population = 2;
+    } else if (population > TUNE_MAX_POPULATION) {
+        population = TUNE_MAX_POPULATION;
+    }
+
+    memset(state, 0, sizeof(*state));
+    state->population = (uint32_t)population;
+    state->seed = seed;
+    state->rng_state = splitmix(seed ^ 0x5475E3ULL) | 1ULL;
+    state->candidates[0] = hint_default_weights;
+    normalize(&state->candidates[0]);
+    for (int c = 1; c < population; ++c) {
+        for (int i = 0; i < HINT_FEATURE_COUNT; ++i) {
+            state->candidates[c].weights[i] = 2.0 * tune_uniform(state) - 1.0;
+        }
+        normalize(&state->candidates[c]);
+    }
+    state->best = state->candidates[0];
+    state->best_fitness = -1.0;
+}
+
+// Seed of game `game` in the current generation: the same for every candidate.
+uint64_t tune_game_seed(const TuneState *state, int game) {
+    return splitmix(state->seed ^ splitmix(((uint64_t)state->generation << 32) | (uint32_t)game));
+}
+
+// Play one seven-bag game, placing each piece where the weights like it best (no preview),
+// and return the lines cleared before topping out or reaching max_pieces. Candidates are
+// copy-on-write clones in the thread arena, so each copies only the rows its piece touches.
+int tune_play_game(const HintWeights *weights, uint64_t seed, int max_pieces) {
+    Arena *arena = arena_thread_local();
+    ArenaMark mark = arena_mark(arena);
+    CowRowPool rows;
+    cow_pool_init(&rows, arena);
+    CowBoard board;
+    cow_board_init(&rows, &board);
+    PieceBag bag;
+    piece_bag_seed(&bag, piece_shape_count(), seed);
+    ActivePiece placements[PERFT_MAX_PLACEMENTS];
+
+    int lines = 0;
+    for (int piece_index = 0; piece_index < max_pieces; ++piece_index) {
+        int piece = piece_bag_next(&bag);
+        int count = perft_generate_cow(&board, piece, placements, PERFT_MAX_PLACEMENTS);
+        const PieceShape *shape = piece_shape_get((size_t)piece);
+
+        CowBoard best_board;
+        int best_lines = 0;
+        double best = 0.0;
+        bool found = false;
+        for (int i = 0; i < count; ++i) {
+            if (hint_locks_above_board(&placements[i])) {
+                continue;
+            }
+            CowBoard child;
+            cow_board_clone(&child, &board);
+            if (cow_board_lock_shape(&rows, &child, shape, placements[i].rotation, placements[i].row,
+                                     placements[i].col, piece + 1) != 0) {
+                cow_board_release(&rows, &child);
+                continue;
+            }
+            int cleared = cow_board_clear_completed_lines(&rows, &child, NULL, 0);
+            double value = hint_evaluate_cow_weights(&child, cleared, weights);
+            if (!found || value > best) {
+                if (found) {
+                    cow_board_release(&rows, &best_board);
+                }
+                found = true;
+                best = value;
+                best_board = child;
+                best_lines = cleared;
+            } else {
+                cow_board_release(&rows, &child);
+            }
+        }
+        if (!found) {
+            break;
+        }
+        cow_board_release(&rows, &board);
+        board = best_board;
+        lines += best_lines;
+    }
+
+    cow_board_release(&rows, &board);
+    cow_pool_destroy(&rows);
+    arena_reset_to(arena, mark);
+    return lines;
+}
+
+// --- Parallel evaluation -------------------------------------------------------------------
+
+typedef struct {
+    const TuneState *state;
+    int games;
+    int max_pieces;
+    uint64_t seeds[TUNE_MAX_GAMES];
+    int *lines; // [candidate * games + game]
+    _Atomic int next_job;
+} TuneJobs;
+
+// Threads take (candidate, game) jobs off a shared counter until none are left.
+static void *evaluate_jobs(void *arg) {
+    TuneJobs *jobs = arg;
+    int total = (int)jobs->state->population * jobs->games;
+    for (;;) {
+        int job = atomic_fetch_add_explicit(&jobs->next_job, 1, memory_order_relaxed);
+        if (job >= total) {
+            break;
+        }
+        const HintWeights *weights = &jobs->state->candidates[job / jobs->games];
+        jobs->lines[job] = tune_play_game(weights, jobs->seeds[job % jobs->games], jobs->max_pieces);
+    }
+    return NULL;
+}
+
+// Score every candidate as its mean lines over config->games shared-seed games, and keep
+// the best candidate seen in any generation. The calling thread works alongside the
+// helpers, so a helper that fails to start only costs speed. The per-game results live in
+// the calling thread's arena, so generations after the first do not touch the heap.
+int tune_evaluate(TuneState *state, const TuneConfig *config) {
+    if (state == NULL || config == NULL || config->games < 1 || config->games > TUNE_MAX_GAMES ||
+        config->max_pieces < 1) {
+        return -1;
+    }
+
+    TuneJobs jobs;
+    jobs.state = state;
+    jobs.games = config->games;
+    jobs.max_pieces = config->max_pieces;
+    for (int game = 0; game < config->games; ++game) {
+        jobs.seeds[game] = tune_game_seed(state, game);
+    }
+    Arena *arena = arena_thread_local();
+    ArenaMark mark = arena_mark(arena);
+    jobs.lines = arena_alloc(arena, sizeof(int) * state->population * (size_t)config->games, ARENA_DEFAULT_ALIGN);
+    if (jobs.lines == NULL) {
+        return -1;
+    }
+    atomic_init(&jobs.next_job, 0);
+
+    int helpers = (config->threads < 1) ? 0 : config->threads - 1;
+    if (helpers > TUNE_MAX_THREADS - 1) {
+        helpers = TUNE_MAX_THREADS - 1;
+    }
+    pthread_t threads[TUNE_MAX_THREADS];
+    int started = 0;
+    while (started < helpers && pthread_create(&threads[started], NULL, evaluate_jobs, &jobs) == 0) {
+        ++started;
+    }
+    evaluate_jobs(&jobs);
+    for (int t = 0; t < started; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    for (uint32_t c = 0; c < state->population; ++c) {
+        long total = 0;
+        for (int game = 0; game < config->games; ++game) {
+            total += jobs.lines[c * (uint32_t)config->games + (uint32_t)game];
+        }
+        state->fitness[c] = (double)total / config->games;
+        if (state->fitness[c] > state->best_fitness) {
+            state->best_fitness = state->fitness[c];
+            state->best = state->candidates[c];
+            state->best_generation = state->generation;
+        }
+    }
+    arena_reset_to(arena, mark);
+    return 0;
+}
+
+// --- Breeding ------------------------------------------------------------------------------
+
+static int tournament(TuneState *state) {
+    int winner = (int)(tune_random(state) % state->population);
+    for (int i = 1; i < TUNE_TOURNAMENT; ++i) {
+        int rival = (int)(tune_random(state) % state->population);
+        if (state->fitness[rival] > state->fitness[winner]) {
+            winner = rival;
+        }
+    }
+    return winner;
+}
+
+// Replace the evaluated population: the top eighth carries over unchanged, the rest are
+// tournament-selected blends of two parents with occasional Gaussian mutation.
+void tune_next_generation(TuneState *state) {
+    if (state == NULL) {
+        return;
+    }
+
+    int order[TUNE_MAX_POPULATION];
+    for (uint32_t c = 0; c < state->population; ++c) {
+        int i = (int)c;
+        while (i > 0 && state->fitness[order[i - 1]] < state->fitness[c]) {
+            order[i] = order[i - 1];
+            --i;
+        }
+        order[i] = (int)c;
+    }
+
+    HintWeights next[TUNE_MAX_POPULATION];
+    int elites = (int)state->population / 8;
+    if (elites < 1) {
+        elites = 1;
+    }
+    for (int c = 0; c < elites; ++c) {
+        next[c] = state->candidates[order[c]];
+    }
+    for (int c = elites; c < (int)state->population; ++c) {
+        const HintWeights *a = &state->candidates[tournament(state)];
+        const HintWeights *b = &state->candidates[tournament(state)];
+        for (int i = 0; i < HINT_FEATURE_COUNT; ++i) {
+            double t = tune_uniform(state);
+            next[c].weights[i] = t * a->weights[i] + (1.0 - t) * b->weights[i];
+            if (tune_uniform(state) < TUNE_MUTATION_RATE) {
+                next[c].weights[i] += TUNE_MUTATION_SIGMA * tune_gaussian(state);
+            }
+        }
+        normalize(&next[c]);
+    }
+
+    memcpy(state->candidates, next, sizeof(HintWeights) * state->population);
+    memset(state->fitness, 0, sizeof(state->fitness));
+    ++state->generation;
+}
+
+// --- Checkpoint ----------------------------------------------------------------------------
+
+typedef struct {
+    unsigned char *data;
+    size_t length;
+    size_t capacity;
+    bool failed;
+} TuneCursor;
+
+static void put_u64(TuneCursor *cursor, uint64_t value) {
+    if (cursor->length + 8 > cursor->capacity) {
+        cursor->failed = true;
+        return;
+    }
+    for (int i = 0; i < 8; ++i) {
+        cursor->data[cursor->length++] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static uint64_t get_u64(TuneCursor *cursor) {
+    if (cursor->length + 8 > cursor->capacity) {
+        cursor->failed = true;
+        return 0;
+    }
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= (uint64_t)cursor->data[cursor->length++] << (8 * i);
+    }
+    return value;
+}
+
+static void put_double(TuneCursor *cursor, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put_u64(cursor, bits);
+}
+
+static double get_double(TuneCursor *cursor) {
+    uint64_t bits = get_u64(cursor);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void put_weights(TuneCursor *cursor, const HintWeights *weights) {
+    for (int i = 0; i < HINT_FEATURE_COUNT; ++i) {
+        put_double(cursor, weights->weights[i]);
+    }
+}
+
+static void get_weights(TuneCursor *cursor, HintWeights *weights) {
+    for (int i = 0; i < HINT_FEATURE_COUNT; ++i) {
+        weights->weights[i] = get_double(cursor);
+    }
+}
+
+// Saves the population waiting to be evaluated, via write-then-rename so a crash mid-save
+// keeps the previous generation. Fitness is not saved; a resumed run re-plays it.
+int tune_checkpoint_save(const TuneState *state, const char *path) {
+    if (state == NULL || path == NULL) {
+        return -1;
+    }
+
+    unsigned char buffer[TUNE_CHECKPOINT_MAX_BYTES];
+    TuneCursor cursor = {buffer, 0, sizeof(buffer), false};
+    put_u64(&cursor, ((uint64_t)TUNE_CHECKPOINT_VERSION << 32) | TUNE_CHECKPOINT_MAGIC);
+    put_u64(&cursor, HINT_FEATURE_COUNT);
+    put_u64(&cursor, ((uint64_t)state->population << 32) | state->generation);
+    put_u64(&cursor, state->best_generation);
+    put_u64(&cursor, state->seed);
+    put_u64(&cursor, state->rng_state);
+    put_double(&cursor, state->best_fitness);
+    put_weights(&cursor, &state->best);
+    for (uint32_t c = 0; c < state->population; ++c) {
+        put_weights(&cursor, &state->candidates[c]);
+    }
+    if (cursor.failed) {
+        return -1;
+    }
+
+    char temp_path[512];
+    int written = snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    if (written < 0 || (size_t)written >= sizeof(temp_path)) {
+        return -1;
+    }
+    FILE *fp = fopen(temp_path, "wb");
+    if (fp == NULL) {
+        return -1;
+    }
+    bool ok = fwrite(buffer, 1, cursor.length, fp) == cursor.length;
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return -1;
+    }
+    return 0;
+}
+
+// Returns -1 when the file is missing, truncated, or from another version or feature set.
+int tune_checkpoint_load(TuneState *state, const char *path) {
+    if (state == NULL || path == NULL) {
+        return -1;
+    }
+
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return -1;
+    }
+    unsigned char buffer[TUNE_CHECKPOINT_MAX_BYTES + 1];
+    size_t length = fread(buffer, 1, sizeof(buffer), fp);
+    fclose(fp);
+
+    // Decode into a heap copy so a bad file leaves *state untouched.
+    TuneState *decoded = calloc(1, sizeof(*decoded));
+    if (decoded == NULL) {
+        return -1;
+    }
+    TuneCursor cursor = {buffer, 0, length, false};
+    uint64_t magic = get_u64(&cursor);
+    uint64_t features = get_u64(&cursor);
+    uint64_t sizes = get_u64(&cursor);
+    decoded->population = (uint32_t)(sizes >> 32);
+    decoded->generation = (uint32_t)sizes;
+    decoded->best_generation = (uint32_t)get_u64(&cursor);
+    decoded->seed = get_u64(&cursor);
+    decoded->rng_state = get_u64(&cursor);
+    decoded->best_fitness = get_double(&cursor);
+    get_weights(&cursor, &decoded->best);
+    bool ok = !cursor.failed && magic == (((uint64_t)TUNE_CHECKPOINT_VERSION << 32) | TUNE_CHECKPOINT_MAGIC) &&
+              features == HINT_FEATURE_COUNT && decoded->population >= 2 &&
+              decoded->population <= TUNE_MAX_POPULATION && decoded->rng_state != 0;
+    for (uint32_t c = 0; ok && c < decoded->population; ++c) {
+        get_weights(&cursor, &decoded->candidates[c]);
+    }
+    ok = ok && !cursor.failed && cursor.length == length;
+
+    if (ok) {
+        *state = *decoded;
+    }
+    free(decoded);
+    return ok ? 0 : -1;
+}
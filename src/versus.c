@@ -0,0 +1,418 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "versus.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Versus wire format plus the socket plumbing shared by game clients and the match server.
+// Addresses are "unix:PATH" for a Unix domain socket or "tcp:PORT" for loopback TCP.
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Payload size per message type; every payload starts with the player byte.
+static size_t payload_size(int type) {
+    switch (type) {
+        case VERSUS_MSG_HELLO:
+        case VERSUS_MSG_ATTACK:
+        case VERSUS_MSG_GARBAGE:
+            return 2;
+        case VERSUS_MSG_MATCH:
+            return 10;
+        case VERSUS_MSG_BOARD:
+            return 1 + BOARD_HEIGHT * 2 + 4;
+        case VERSUS_MSG_TOPPED_OUT:
+        case VERSUS_MSG_RESULT:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+size_t versus_encode(const VersusMessage *message, unsigned char *buffer, size_t capacity) {
+    if (message == NULL || buffer == NULL) {
+        return 0;
+    }
+
+    size_t payload = payload_size(message->type);
+    if (payload == 0 || VERSUS_HEADER_SIZE + payload > capacity) {
+        return 0;
+    }
+
+    unsigned char *p = buffer;
+    *p++ = (unsigned char)message->type;
+    *p++ = (unsigned char)(payload & 0xFF);
+    *p++ = (unsigned char)(payload >> 8);
+    *p++ = message->player;
+
+    switch (message->type) {
+        case VERSUS_MSG_HELLO:
+            *p++ = message->version;
+            break;
+        case VERSUS_MSG_MATCH:
+            *p++ = message->player_count;
+            for (int i = 0; i < 8; ++i) {
+                *p++ = (unsigned char)(message->seed >> (8 * i));
+            }
+            break;
+        case VERSUS_MSG_ATTACK:
+        case VERSUS_MSG_GARBAGE:
+            *p++ = message->lines;
+            break;
+        case VERSUS_MSG_BOARD:
+            for (int row = 0; row < BOARD_HEIGHT; ++row) {
+                *p++ = (unsigned char)(message->rows[row] & 0xFF);
+                *p++ = (unsigned char)(message->rows[row] >> 8);
+            }
+            for (int i = 0; i < 4; ++i) {
+                *p++ = (unsigned char)(message->score >> (8 * i));
+            }
+            break;
+        default:
+            break;
+    }
+    return (size_t)(p - buffer);
+}
+
+// Returns 1 with one message decoded, 0 when more bytes are needed, -1 on a malformed stream.
+int versus_decode(const unsigned char *buffer, size_t length, VersusMessage *message, size_t *consumed) {
+    if (buffer == NULL || message == NULL || consumed == NULL) {
+        return -1;
+    }
+    if (length < VERSUS_HEADER_SIZE) {
+        return 0;
+    }
+
+    size_t payload = payload_size(buffer[0]);
+    size_t declared = (size_t)buffer[1] | ((size_t)buffer[2] << 8);
+    if (payload == 0 || declared != payload) {
+        return -1;
+    }
+    if (length < VERSUS_HEADER_SIZE + payload) {
+        return 0;
+    }
+
+    const unsigned char *p = buffer + VERSUS_HEADER_SIZE;
+    memset(message, 0, sizeof(*message));
+    message->type = (VersusMessageType)buffer[0];
+    message->player = *p++;
+
+    switch (message->type) {
+        case VERSUS_MSG_HELLO:
+            message->version = *p++;
+            break;
+        case VERSUS_MSG_MATCH:
+            message->player_count = *p++;
+            for (int i = 0; i < 8; ++i) {
+                message->seed |= (uint64_t)*p++ << (8 * i);
+            }
+            break;
+        case VERSUS_MSG_ATTACK:
+        case VERSUS_MSG_GARBAGE:
+            message->lines = *p++;
+            break;
+        case VERSUS_MSG_BOARD:
+            for (int row = 0; row < BOARD_HEIGHT; ++row) {
+                message->rows[row] = (uint16_t)(p[0] | (p[1] << 8));
+                p += 2;
+            }
+            for (int i = 0; i < 4; ++i) {
+                message->score |= (uint32_t)*p++ << (8 * i);
+            }
+            break;
+        default:
+            break;
+    }
+
+    *consumed = VERSUS_HEADER_SIZE + payload;
+    return 1;
+}
+
+#if defined(_WIN32)
+
+int versus_listen(const char *address) {
+    (void)address;
+    return -1;
+}
+
+int versus_accept(int listen_fd) {
+    (void)listen_fd;
+    return -1;
+}
+
+int versus_connect(const char *address) {
+    (void)address;
+    return -1;
+}
+
+static long socket_read(int fd, unsigned char *buffer, size_t length) {
+    (void)fd;
+    (void)buffer;
+    (void)length;
+    return -1;
+}
+
+static long socket_write(int fd, const unsigned char *buffer, size_t length) {
+    (void)fd;
+    (void)buffer;
+    (void)length;
+    return -1;
+}
+
+static bool socket_would_block(void) {
+    return false;
+}
+
+static void socket_close(int fd) {
+    (void)fd;
+}
+
+#else
+
+typedef struct {
+    struct sockaddr_storage storage;
+    socklen_t length;
+    bool is_unix;
+} VersusAddress;
+
+static int parse_address(const char *address, VersusAddress *out) {
+    if (address == NULL) {
+        return -1;
+    }
+
+    memset(out, 0, sizeof(*out));
+    if (strncmp(address, "unix:", 5) == 0) {
+        struct sockaddr_un *un = (struct sockaddr_un *)&out->storage;
+        const char *path = address + 5;
+        if (path[0] == '\0' || strlen(path) >= sizeof(un->sun_path)) {
+            return -1;
+        }
+        un->sun_family = AF_UNIX;
+        strcpy(un->sun_path, path);
+        out->length = (socklen_t)sizeof(*un);
+        out->is_unix = true;
+        return 0;
+    }
+
+    if (strncmp(address, "tcp:", 4) == 0) {
+        char *end = NULL;
+        long port = strtol(address + 4, &end, 10);
+        if (end == address + 4 || *end != '\0' || port <= 0 || port > 65535) {
+            return -1;
+        }
+        struct sockaddr_in *in = (struct sockaddr_in *)&out->storage;
+        in->sin_family = AF_INET;
+        in->sin_port = htons((uint16_t)port);
+        in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        out->length = (socklen_t)sizeof(*in);
+        return 0;
+    }
+    return -1;
+}
+
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) ? -1 : 0;
+}
+
+// Small messages must not wait for Nagle; harmless no-op failure on Unix sockets.
+static void set_nodelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+// Listening socket for the match server (non-blocking; a stale Unix socket file is replaced).
+int versus_listen(const char *address) {
+    VersusAddress parsed;
+    if (parse_address(address, &parsed) != 0) {
+        return -1;
+    }
+
+    int fd = socket(parsed.storage.ss_family, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (parsed.is_unix) {
+        unlink(((struct sockaddr_un *)&parsed.storage)->sun_path);
+    } else {
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+
+    if (bind(fd, (struct sockaddr *)&parsed.storage, parsed.length) != 0 || listen(fd, 16) != 0 ||
+        set_nonblocking(fd) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Next pending connection, already non-blocking, or -1 when none is waiting.
+int versus_accept(int listen_fd) {
+    int fd = accept(listen_fd, NULL, NULL);
+    if (fd < 0) {
+        return -1;
+    }
+    if (set_nonblocking(fd) != 0) {
+        close(fd);
+        return -1;
+    }
+    set_nodelay(fd);
+    return fd;
+}
+
+// Connect (blocking) and switch the socket to non-blocking for the game loop.
+int versus_connect(const char *address) {
+    VersusAddress parsed;
+    if (parse_address(address, &parsed) != 0) {
+        return -1;
+    }
+
+    int fd = socket(parsed.storage.ss_family, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, (struct sockaddr *)&parsed.storage, parsed.length) != 0 || set_nonblocking(fd) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (!parsed.is_unix) {
+        set_nodelay(fd);
+    }
+    return fd;
+}
+
+static long socket_read(int fd, unsigned char *buffer, size_t length) {
+    return (long)recv(fd, buffer, length, 0);
+}
+
+static long socket_write(int fd, const unsigned char *buffer, size_t length) {
+    return (long)send(fd, buffer, length, MSG_NOSIGNAL);
+}
+
+static bool socket_would_block(void) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+
+static void socket_close(int fd) {
+    close(fd);
+}
+
+#endif
+
+void versus_conn_init(VersusConn *conn, int fd) {
+    if (conn == NULL) {
+        return;
+    }
+    conn->fd = fd;
+    conn->closed = fd < 0;
+    conn->in_len = 0;
+    conn->out_len = 0;
+}
+
+// Write as much queued output as the socket accepts without blocking.
+int versus_conn_flush(VersusConn *conn) {
+    if (conn == NULL || conn->closed) {
+        return -1;
+    }
+
+    size_t sent = 0;
+    while (sent < conn->out_len) {
+        long n = socket_write(conn->fd, conn->out + sent, conn->out_len - sent);
+        if (n < 0 && socket_would_block()) {
+            break;
+        }
+        if (n <= 0) {
+            conn->closed = true;
+            return -1;
+        }
+        sent += (size_t)n;
+    }
+    memmove(conn->out, conn->out + sent, conn->out_len - sent);
+    conn->out_len -= sent;
+    return 0;
+}
+
+// Queue one message and try to send it now; fails if the peer has stopped reading.
+int versus_conn_send(VersusConn *conn, const VersusMessage *message) {
+    if (conn == NULL || conn->closed) {
+        return -1;
+    }
+
+    unsigned char encoded[VERSUS_MAX_MESSAGE];
+    size_t length = versus_encode(message, encoded, sizeof(encoded));
+    if (length == 0) {
+        return -1;
+    }
+    if (conn->out_len + length > sizeof(conn->out) && versus_conn_flush(conn) != 0) {
+        return -1;
+    }
+    if (conn->out_len + length > sizeof(conn->out)) {
+        return -1;
+    }
+
+    memcpy(conn->out + conn->out_len, encoded, length);
+    conn->out_len += length;
+    return versus_conn_flush(conn);
+}
+
+// Returns 1 with the next buffered message, 0 if none is complete yet, -1 once the peer
+// has gone away (or sent garbage) and nothing decodable is left.
+int versus_conn_receive(VersusConn *conn, VersusMessage *message) {
+    if (conn == NULL || message == NULL) {
+        return -1;
+    }
+
+    for (;;) {
+        size_t consumed = 0;
+        int status = versus_decode(conn->in, conn->in_len, message, &consumed);
+        if (status < 0) {
+            conn->closed = true;
+            return -1;
+        }
+        if (status > 0) {
+            memmove(conn->in, conn->in + consumed, conn->in_len - consumed);
+            conn->in_len -= consumed;
+            return 1;
+        }
+        if (conn->closed) {
+            return -1;
+        }
+
+        long n = socket_read(conn->fd, conn->in + conn->in_len, sizeof(conn->in) - conn->in_len);
+        if (n < 0 && socket_would_block()) {
+            return 0;
+        }
+        if (n <= 0) {
+            conn->closed = true;
+            return -1;
+        }
+        conn->in_len += (size_t)n;
+    }
+}
+
+void versus_conn_close(VersusConn *conn) {
+    if (conn == NULL) {
+        return;
+    }
+    if (conn->fd >= 0) {
+        socket_close(conn->fd);
+    }
+    conn->fd = -1;
+    conn->closed = true;
+    conn->in_len = 0;
+    conn->out_len = 0;
+}
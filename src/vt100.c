@@ -0,0 +1,483 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "vt100.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "metrics.h"
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// Raw VT100/ANSI backend: frames are composed in memory and flushed with one write().
+
+static const char *const k_color_codes[TERM_COLOR_COUNT] = {
+    [TERM_COLOR_DEFAULT] = NULL,
+    [TERM_COLOR_CYAN] = "36",
+    [TERM_COLOR_YELLOW] = "33",
+    [TERM_COLOR_BLUE] = "34",
+    [TERM_COLOR_WHITE] = "37",
+    [TERM_COLOR_MAGENTA] = "35",
+    [TERM_COLOR_GREEN] = "32",
+    [TERM_COLOR_RED] = "31"
+};
+
+static const Vt100Cell k_blank_cell = {' ', TERM_ATTR_NORMAL};
+
+// --- Output buffer --------------------------------------------------------------------------
+
+static int buffer_reserve(Vt100Buffer *buffer, size_t extra) {
+    if (buffer->len + extra <= buffer->capacity) {
+        return 0;
+    }
+
+    size_t capacity = (buffer->capacity == 0) ? 4096 : buffer->capacity;
+    while (capacity < buffer->len + extra) {
+        capacity *= 2;
+    }
+    char *data = realloc(buffer->data, capacity);
+    if (data == NULL) {
+        return -1;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+static void buffer_append(Vt100Buffer *buffer, const char *data, size_t len) {
+    if (buffer_reserve(buffer, len) != 0) {
+        return;
+    }
+    memcpy(buffer->data + buffer->len, data, len);
+    buffer->len += len;
+}
+
+static void buffer_append_str(Vt100Buffer *buffer, const char *text) {
+    buffer_append(buffer, text, strlen(text));
+}
+
+static void buffer_append_uint(Vt100Buffer *buffer, unsigned value) {
+    char digits[12];
+    size_t count = 0;
+    do {
+        digits[sizeof(digits) - 1 - count] = (char)('0' + value % 10U);
+        value /= 10U;
+        ++count;
+    } while (value != 0U);
+    buffer_append(buffer, digits + sizeof(digits) - count, count);
+}
+
+// CUP is 1-based.
+static void buffer_append_move(Vt100Buffer *buffer, int y, int x) {
+    buffer_append(buffer, "\x1b[", 2);
+    buffer_append_uint(buffer, (unsigned)y + 1U);
+    buffer_append(buffer, ";", 1);
+    buffer_append_uint(buffer, (unsigned)x + 1U);
+    buffer_append(buffer, "H", 1);
+}
+
+// Emit only what differs between two attributes: the charset switch and/or one SGR.
+static void buffer_append_attr_change(Vt100Buffer *buffer, TermAttr from, TermAttr to) {
+    if ((from & VT100_ATTR_LINE) != (to & VT100_ATTR_LINE)) {
+        buffer_append_str(buffer, (to & VT100_ATTR_LINE) ? "\x1b(0" : "\x1b(B");
+    }
+
+    if ((from & (TermAttr)~VT100_ATTR_LINE) == (to & (TermAttr)~VT100_ATTR_LINE)) {
+        return;
+    }
+
+    buffer_append(buffer, "\x1b[0", 3);
+    if (to & TERM_ATTR_BOLD) {
+        buffer_append(buffer, ";1", 2);
+    }
+    if (to & TERM_ATTR_DIM) {
+        buffer_append(buffer, ";2", 2);
+    }
+    if (to & TERM_ATTR_REVERSE) {
+        buffer_append(buffer, ";7", 2);
+    }
+    TermColor color = TERM_ATTR_COLOR(to);
+    if ((unsigned)color < TERM_COLOR_COUNT && k_color_codes[color] != NULL) {
+        buffer_append(buffer, ";", 1);
+        buffer_append_str(buffer, k_color_codes[color]);
+    }
+    buffer_append(buffer, "m", 1);
+}
+
+// --- Screen model ---------------------------------------------------------------------------
+
+static void fill_blank(Vt100Cell *cells, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        cells[i] = k_blank_cell;
+    }
+}
+
+int vt100_screen_init(Vt100Screen *screen, int rows, int cols) {
+    if (screen == NULL) {
+        return -1;
+    }
+
+    memset(screen, 0, sizeof(*screen));
+    return vt100_screen_resize(screen, rows, cols);
+}
+
+// Reallocate both grids; the next compose repaints the whole screen. Both new grids are
+// allocated before either old one is replaced, so on failure the screen keeps its old size.
+int vt100_screen_resize(Vt100Screen *screen, int rows, int cols) {
+    if (screen == NULL || rows <= 0 || cols <= 0) {
+        return -1;
+    }
+
+    size_t count = (size_t)rows * (size_t)cols;
+    if (count > SIZE_MAX / sizeof(Vt100Cell)) {
+        return -1;
+    }
+    Vt100Cell *back = malloc(sizeof(Vt100Cell) * count);
+    Vt100Cell *front = malloc(sizeof(Vt100Cell) * count);
+    if (back == NULL || front == NULL) {
+        free(back);
+        free(front);
+        return -1;
+    }
+    free(screen->back);
+    free(screen->front);
+    screen->back = back;
+    screen->front = front;
+
+    screen->rows = rows;
+    screen->cols = cols;
+    fill_blank(screen->back, count);
+    fill_blank(screen->front, count);
+    screen->full_redraw = true;
+    screen->attr = TERM_ATTR_NORMAL;
+    return 0;
+}
+
+void vt100_screen_destroy(Vt100Screen *screen) {
+    if (screen == NULL) {
+        return;
+    }
+
+    free(screen->back);
+    free(screen->front);
+    free(screen->out.data);
+    memset(screen, 0, sizeof(*screen));
+}
+
+void vt100_clear(Vt100Screen *screen) {
+    if (screen == NULL || screen->back == NULL) {
+        return;
+    }
+    fill_blank(screen->back, (size_t)screen->rows * (size_t)screen->cols);
+}
+
+// Write len bytes at (y, x) with the current attribute, clipped to the screen.
+void vt100_put(Vt100Screen *screen, int y, int x, const char *text, size_t len) {
+    if (screen == NULL || text == NULL || y < 0 || y >= screen->rows) {
+        return;
+    }
+
+    Vt100Cell *row = screen->back + (size_t)y * (size_t)screen->cols;
+    for (size_t i = 0; i < len; ++i) {
+        int col = x + (int)i;
+        if (col < 0) {
+            continue;
+        }
+        if (col >= screen->cols) {
+            break;
+        }
+        row[col].ch = text[i];
+        row[col].attr = screen->attr;
+    }
+}
+
+// Border around the whole screen using the DEC line-drawing set (same look as box()).
+void vt100_box(Vt100Screen *screen) {
+    if (screen == NULL || screen->rows < 2 || screen->cols < 2) {
+        return;
+    }
+
+    TermAttr saved = screen->attr;
+    screen->attr = VT100_ATTR_LINE;
+    int last_row = screen->rows - 1;
+    int last_col = screen->cols - 1;
+    for (int col = 1; col < last_col; ++col) {
+        vt100_put(screen, 0, col, "q", 1);
+        vt100_put(screen, last_row, col, "q", 1);
+    }
+    for (int row = 1; row < last_row; ++row) {
+        vt100_put(screen, row, 0, "x", 1);
+        vt100_put(screen, row, last_col, "x", 1);
+    }
+    vt100_put(screen, 0, 0, "l", 1);
+    vt100_put(screen, 0, last_col, "k", 1);
+    vt100_put(screen, last_row, 0, "m", 1);
+    vt100_put(screen, last_row, last_col, "j", 1);
+    screen->attr = saved;
+}
+
+static bool cells_equal(const Vt100Cell *a, const Vt100Cell *b) {
+    return a->ch == b->ch && a->attr == b->attr;
+}
+
+// Encode the changes since the last compose into screen->out and return its length.
+// Unchanged cells are skipped with a cursor move; runs of cells sharing an attribute
+// cost one SGR. The terminal is left in the default attribute afterwards.
+size_t vt100_compose(Vt100Screen *screen) {
+    if (screen == NULL || screen->back == NULL) {
+        return 0;
+    }
+
+    Vt100Buffer *out = &screen->out;
+    out->len = 0;
+
+    bool full = screen->full_redraw;
+    if (full) {
+        buffer_append_str(out, "\x1b[0m\x1b(B\x1b[H\x1b[2J");
+    }
+
+    TermAttr current = TERM_ATTR_NORMAL;
+    int cursor_y = -1;
+    int cursor_x = -1;
+
+    for (int y = 0; y < screen->rows; ++y) {
+        size_t base = (size_t)y * (size_t)screen->cols;
+        for (int x = 0; x < screen->cols; ++x) {
+            const Vt100Cell *cell = &screen->back[base + (size_t)x];
+            const Vt100Cell *shown = full ? &k_blank_cell : &screen->front[base + (size_t)x];
+            if (cells_equal(cell, shown)) {
+                continue;
+            }
+
+            if (cursor_y != y || cursor_x != x) {
+                buffer_append_move(out, y, x);
+            }
+            if (cell->attr != current) {
+                buffer_append_attr_change(out, current, cell->attr);
+                current = cell->attr;
+            }
+            buffer_append(out, &cell->ch, 1);
+            screen->front[base + (size_t)x] = *cell;
+
+            cursor_y = y;
+            cursor_x = (x + 1 < screen->cols) ? x + 1 : -1;
+        }
+    }
+
+    if (full) {
+        memcpy(screen->front, screen->back, sizeof(Vt100Cell) * (size_t)screen->rows * (size_t)screen->cols);
+        screen->full_redraw = false;
+    }
+    if (current != TERM_ATTR_NORMAL) {
+        buffer_append_attr_change(out, current, TERM_ATTR_NORMAL);
+    }
+    return out->len;
+}
+
+// --- Input ----------------------------------------------------------------------------------
+
+static int key_for_final_byte(unsigned char final) {
+    switch (final) {
+        case 'A':
+            return TERM_KEY_UP;
+        case 'B':
+            return TERM_KEY_DOWN;
+        case 'C':
+            return TERM_KEY_RIGHT;
+        case 'D':
+            return TERM_KEY_LEFT;
+        case 'M':
+            return TERM_KEY_ENTER;
+        default:
+            return TERM_KEY_NONE;
+    }
+}
+
+// Decode one key from raw input. Recognizes CSI/SS3 arrow sequences; other escape
+// sequences are consumed and reported as TERM_KEY_NONE, and plain bytes pass through.
+// A CSI/SS3 sequence cut off by the end of input is left unconsumed (*consumed is 0) so
+// the caller can keep it until the rest is read.
+int vt100_parse_key(const unsigned char *input, size_t len, size_t *consumed) {
+    size_t used = 0;
+    int key = TERM_KEY_NONE;
+
+    if (input != NULL && len > 0) {
+        if (input[0] != 0x1b || len == 1 || (input[1] != '[' && input[1] != 'O')) {
+            used = 1;
+            key = input[0];
+        } else {
+            size_t i = 2;
+            while (i < len && input[i] >= 0x20 && input[i] <= 0x3f) {
+                ++i;
+            }
+            if (i < len) {
+                key = key_for_final_byte(input[i]);
+                used = i + 1;
+            }
+        }
+    }
+
+    if (consumed != NULL) {
+        *consumed = used;
+    }
+    return key;
+}
+
+// --- Terminal I/O ---------------------------------------------------------------------------
+
+#if !defined(_WIN32)
+
+static const char k_enter_sequence[] = "\x1b[?1049h\x1b[?25l\x1b[?7l\x1b[2J";
+static const char k_leave_sequence[] = "\x1b[0m\x1b(B\x1b[?7h\x1b[?25h\x1b[?1049l";
+
+static struct termios g_saved_termios;
+static bool g_tty_open = false;
+static volatile sig_atomic_t g_resized = 0;
+static struct sigaction g_saved_int;
+static struct sigaction g_saved_term;
+static struct sigaction g_saved_winch;
+
+static void restore_terminal(void) {
+    ssize_t ignored = write(STDOUT_FILENO, k_leave_sequence, sizeof(k_leave_sequence) - 1);
+    (void)ignored;
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &g_saved_termios);
+}
+
+static void on_fatal_signal(int signo) {
+    restore_terminal();
+    signal(signo, SIG_DFL);
+    raise(signo);
+}
+
+static void on_resize(int signo) {
+    (void)signo;
+    g_resized = 1;
+}
+
+// Put the terminal in raw, non-blocking mode on the alternate screen. Fails (and leaves
+// the terminal untouched) when stdin/stdout is not a tty.
+int vt100_tty_open(void) {
+    if (g_tty_open) {
+        return 0;
+    }
+    if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO) || tcgetattr(STDIN_FILENO, &g_saved_termios) != 0) {
+        return -1;
+    }
+
+    struct termios raw = g_saved_termios;
+    raw.c_iflag &= ~(tcflag_t)(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+    raw.c_lflag &= ~(tcflag_t)(ECHO | ICANON | IEXTEN);
+    raw.c_cflag |= CS8;
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) {
+        return -1;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = on_fatal_signal;
+    sigaction(SIGINT, &action, &g_saved_int);
+    sigaction(SIGTERM, &action, &g_saved_term);
+    action.sa_handler = on_resize;
+    sigaction(SIGWINCH, &action, &g_saved_winch);
+
+    g_tty_open = true;
+    g_resized = 0;
+    return vt100_tty_write(k_enter_sequence, sizeof(k_enter_sequence) - 1);
+}
+
+void vt100_tty_close(void) {
+    if (!g_tty_open) {
+        return;
+    }
+
+    restore_terminal();
+    sigaction(SIGINT, &g_saved_int, NULL);
+    sigaction(SIGTERM, &g_saved_term, NULL);
+    sigaction(SIGWINCH, &g_saved_winch, NULL);
+    g_tty_open = false;
+}
+
+int vt100_tty_size(int *rows, int *cols) {
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_row == 0 || size.ws_col == 0) {
+        return -1;
+    }
+    *rows = size.ws_row;
+    *cols = size.ws_col;
+    return 0;
+}
+
+// True once per SIGWINCH.
+bool vt100_tty_resized(void) {
+    if (!g_resized) {
+        return false;
+    }
+    g_resized = 0;
+    return true;
+}
+
+int vt100_tty_write(const char *data, size_t len) {
+    size_t written = 0;
+    while (written < len) {
+        ssize_t n = write(STDOUT_FILENO, data + written, len - written);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        written += (size_t)n;
+    }
+    metrics_add(METRIC_TERMINAL_BYTES, written);
+    return 0;
+}
+
+// Non-blocking read of whatever input is pending; 0 when there is none.
+int vt100_tty_read(unsigned char *buffer, size_t capacity) {
+    ssize_t n = read(STDIN_FILENO, buffer, capacity);
+    return (n > 0) ? (int)n : 0;
+}
+
+#else
+
+int vt100_tty_open(void) {
+    return -1;
+}
+
+void vt100_tty_close(void) {
+}
+
+int vt100_tty_size(int *rows, int *cols) {
+    (void)rows;
+    (void)cols;
+    return -1;
+}
+
+bool vt100_tty_resized(void) {
+    return false;
+}
+
+int vt100_tty_write(const char *data, size_t len) {
+    (void)data;
+    (void)len;
+    return -1;
+}
+
+int vt100_tty_read(unsigned char *buffer, size_t capacity) {
+    (void)buffer;
+    (void)capacity;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,165 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "arena.h"
+#include "board.h"
+#include "cow_board.h"
+#include "piece.h"
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static void test_arena_alignment_and_growth(void) {
+    Arena arena;
+    arena_init(&arena, 256);
+
+    char *a = arena_alloc(&arena, 3, 1);
+    uint64_t *b = arena_alloc(&arena, sizeof(uint64_t), 8);
+    assert(a != NULL && b != NULL);
+    assert(((uintptr_t)b % 8) == 0);
+
+    void *large = arena_alloc(&arena, 1000, 16);
+    assert(large != NULL);
+    assert(((uintptr_t)large % 16) == 0);
+    memset(large, 0xAB, 1000);
+    assert(arena_bytes_reserved(&arena) >= 1256);
+
+    arena_destroy(&arena);
+}
+
+static void test_arena_scoped_reset_reuses_memory(void) {
+    Arena arena;
+    arena_init(&arena, 1024);
+    (void)arena_alloc(&arena, 64, 16);
+
+    ArenaMark mark = arena_mark(&arena);
+    void *first = arena_alloc(&arena, sizeof(Board), 16);
+    for (int i = 0; i < 20; ++i) {
+        assert(arena_alloc(&arena, sizeof(Board), 16) != NULL);
+    }
+    arena_reset_to(&arena, mark);
+    void *again = arena_alloc(&arena, sizeof(Board), 16);
+    assert(first == again);
+
+    arena_destroy(&arena);
+}
+
+// After one warm-up decision, repeating the same work must not touch the heap.
+static void test_arena_steady_state_has_no_heap_allocations(void) {
+    Arena arena;
+    arena_init(&arena, 4096);
+    uint64_t before = 0;
+
+    for (int decision = 0; decision < 50; ++decision) {
+        if (decision == 1) {
+            before = arena_heap_allocations();
+        }
+        ArenaMark mark = arena_mark(&arena);
+        for (int node = 0; node < 100; ++node) {
+            Board *board = arena_alloc(&arena, sizeof(Board), 16);
+            assert(board != NULL);
+            board_reset(board);
+        }
+        arena_reset_to(&arena, mark);
+    }
+
+    assert(arena_heap_allocations() == before);
+    arena_destroy(&arena);
+}
+
+static void test_pool_recycles_objects(void) {
+    Arena arena;
+    arena_init(&arena, 4096);
+    Pool pool;
+    pool_init(&pool, &arena, sizeof(ActivePiece));
+
+    ActivePiece *a = pool_alloc(&pool);
+    ActivePiece *b = pool_alloc(&pool);
+    assert(a != NULL && b != NULL && a != b);
+    assert(pool.live == 2);
+
+    pool_free(&pool, a);
+    assert(pool.live == 1);
+    assert(pool_alloc(&pool) == a);
+
+    arena_destroy(&arena);
+}
+
+static void test_cow_rows_steady_state(void) {
+    CowRowPool rows;
+    cow_pool_init(&rows, NULL);
+    CowBoard root;
+    cow_board_init(&rows, &root);
+    const PieceShape *shape = piece_shape_get(2);
+    assert(cow_board_lock_shape(&rows, &root, shape, 0, BOARD_HEIGHT - 2, 3, 3) == 0);
+
+    uint64_t before = 0;
+    for (int decision = 0; decision < 20; ++decision) {
+        if (decision == 1) {
+            before = arena_heap_allocations();
+        }
+        for (int col = 0; col < 7; ++col) {
+            CowBoard child;
+            cow_board_clone(&child, &root);
+            assert(cow_board_lock_shape(&rows, &child, shape, 0, BOARD_HEIGHT - 4, col, 3) == 0);
+            cow_board_release(&rows, &child);
+        }
+    }
+    assert(arena_heap_allocations() == before);
+
+    cow_board_release(&rows, &root);
+    cow_pool_destroy(&rows);
+}
+
+static void *thread_arena_worker(void *arg) {
+    Arena **out = arg;
+    *out = arena_thread_local();
+    assert(arena_alloc(*out, 128, 16) != NULL);
+    arena_thread_local_release();
+    return NULL;
+}
+
+static void test_thread_local_arenas_are_distinct(void) {
+    Arena *main_arena = arena_thread_local();
+    Arena *worker_arena = NULL;
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, thread_arena_worker, &worker_arena) == 0);
+    pthread_join(thread, NULL);
+    assert(worker_arena != NULL);
+    assert(worker_arena != main_arena);
+}
+
+static void *exiting_arena_worker(void *arg) {
+    (void)arg;
+    Arena *arena = arena_thread_local();
+    assert(arena_alloc(arena, ARENA_DEFAULT_BLOCK_SIZE * 2, 16) != NULL);
+    return NULL;
+}
+
+static void test_thread_arena_freed_on_exit(void) {
+    uint64_t allocated = arena_heap_allocations();
+    uint64_t freed = arena_heap_frees();
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, exiting_arena_worker, NULL) == 0);
+    pthread_join(thread, NULL);
+    uint64_t worker_blocks = arena_heap_allocations() - allocated;
+    assert(worker_blocks >= 1);
+    assert(arena_heap_frees() - freed == worker_blocks);
+}
+
+int main(void) {
+    run_test("arena_alignment_and_growth", test_arena_alignment_and_growth);
+    run_test("arena_scoped_reset_reuses_memory", test_arena_scoped_reset_reuses_memory);
+    run_test("arena_steady_state_has_no_heap_allocations", test_arena_steady_state_has_no_heap_allocations);
+    run_test("pool_recycles_objects", test_pool_recycles_objects);
+    run_test("cow_rows_steady_state", test_cow_rows_steady_state);
+    run_test("thread_local_arenas_are_distinct", test_thread_local_arenas_are_distinct);
+    run_test("thread_arena_freed_on_exit", test_thread_arena_freed_on_exit);
+    return 0;
+}
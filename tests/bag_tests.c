@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -70,10 +71,159 @@ static void test_bag_handles_zero_pieces(void) {
     assert(piece_bag_next(&bag) == -1);
 }
 
+static void test_bag_peek_matches_draws(void) {
+    PieceBag bag;
+    piece_bag_seed(&bag, 7, 42);
+    piece_bag_next(&bag);
+    piece_bag_next(&bag);
+
+    int preview[10];
+    assert(piece_bag_peek(&bag, preview, 10) == 10);
+    for (int i = 0; i < 10; ++i) {
+        assert(piece_bag_next(&bag) == preview[i]);
+    }
+}
+
+static void test_generate_matches_next(void) {
+    for (int kind = 0; kind < PIECE_RANDOMIZER_COUNT; ++kind) {
+        PieceBag drawn;
+        PieceBag bulk;
+        piece_bag_seed_kind(&drawn, (PieceRandomizer)kind, 7, 99);
+        piece_bag_seed_kind(&bulk, (PieceRandomizer)kind, 7, 99);
+
+        // Uneven chunk sizes so bag runs start and end mid-bag.
+        int pieces[200];
+        size_t done = 0;
+        for (size_t chunk = 1; done + chunk <= 200; done += chunk, chunk += 3) {
+            assert(piece_bag_generate(&bulk, pieces + done, chunk) == chunk);
+        }
+        for (size_t i = 0; i < done; ++i) {
+            assert(piece_bag_next(&drawn) == pieces[i]);
+        }
+        assert(piece_bag_next(&drawn) == piece_bag_next(&bulk));
+    }
+}
+
+static void test_seed_kind_is_deterministic(void) {
+    for (int kind = 0; kind < PIECE_RANDOMIZER_COUNT; ++kind) {
+        PieceBag a;
+        PieceBag b;
+        PieceBag other;
+        piece_bag_seed_kind(&a, (PieceRandomizer)kind, 7, 5);
+        piece_bag_seed_kind(&b, (PieceRandomizer)kind, 7, 5);
+        piece_bag_seed_kind(&other, (PieceRandomizer)kind, 7, 6);
+
+        bool differs = false;
+        for (int i = 0; i < 100; ++i) {
+            int piece = piece_bag_next(&a);
+            assert(piece >= 0 && piece < 7);
+            assert(piece == piece_bag_next(&b));
+            differs = differs || piece != piece_bag_next(&other);
+        }
+        assert(differs);
+    }
+}
+
+static void test_bag14_holds_each_piece_twice(void) {
+    PieceBag bag;
+    piece_bag_seed_kind(&bag, PIECE_RANDOMIZER_BAG14, 7, 11);
+
+    for (int round = 0; round < 20; ++round) {
+        int counts[7];
+        memset(counts, 0, sizeof(counts));
+        int pieces[14];
+        piece_bag_generate(&bag, pieces, 14);
+        for (int i = 0; i < 14; ++i) {
+            ++counts[pieces[i]];
+        }
+        for (int i = 0; i < 7; ++i) {
+            assert(counts[i] == 2);
+        }
+    }
+}
+
+static void test_bag_valid_checks_each_kind(void) {
+    for (int kind = 0; kind < PIECE_RANDOMIZER_COUNT; ++kind) {
+        PieceBag bag;
+        piece_bag_seed_kind(&bag, (PieceRandomizer)kind, 7, 3);
+        assert(piece_bag_valid(&bag));
+        int drawn[20];
+        piece_bag_generate(&bag, drawn, 20);
+        assert(piece_bag_valid(&bag));
+    }
+
+    PieceBag bag;
+    piece_bag_seed_kind(&bag, PIECE_RANDOMIZER_BAG14, 7, 3);
+    bag.cursor = 15;
+    assert(!piece_bag_valid(&bag));
+    piece_bag_seed_kind(&bag, PIECE_RANDOMIZER_BAG7, 7, 3);
+    bag.values[6] = 7;
+    assert(!piece_bag_valid(&bag));
+    piece_bag_seed_kind(&bag, PIECE_RANDOMIZER_TGM, 7, 3);
+    bag.values[3] = -2;
+    assert(!piece_bag_valid(&bag));
+    piece_bag_seed_kind(&bag, PIECE_RANDOMIZER_UNIFORM, 7, 3);
+    bag.piece_count = PIECE_BAG_MAX + 1;
+    assert(!piece_bag_valid(&bag));
+}
+
+// A piece among the previous four needs six failed rolls in TGM (about 3% of draws) and
+// an immediate repeat needs two in NES (about 4%); uniform draws repeat far more often.
+static void test_history_randomizers_avoid_repeats(void) {
+    enum { DRAWS = 70000 };
+    static int pieces[DRAWS];
+    PieceBag bag;
+
+    piece_bag_seed_kind(&bag, PIECE_RANDOMIZER_TGM, 7, 3);
+    piece_bag_generate(&bag, pieces, DRAWS);
+    int recent = 0;
+    for (int i = 4; i < DRAWS; ++i) {
+        recent += pieces[i] == pieces[i - 1] || pieces[i] == pieces[i - 2] || pieces[i] == pieces[i - 3] ||
+                  pieces[i] == pieces[i - 4];
+    }
+    assert(recent < DRAWS / 20);
+
+    piece_bag_seed_kind(&bag, PIECE_RANDOMIZER_NES, 7, 3);
+    piece_bag_generate(&bag, pieces, DRAWS);
+    int repeats = 0;
+    for (int i = 1; i < DRAWS; ++i) {
+        repeats += pieces[i] == pieces[i - 1];
+    }
+    assert(repeats > DRAWS / 50 && repeats < DRAWS / 15);
+}
+
+// Every kind deals each piece a seventh of the time; 7000 draws per piece leaves a
+// standard deviation of about 80, so 600 is far outside chance.
+static void test_randomizers_are_balanced(void) {
+    enum { DRAWS = 49000 };
+    static int pieces[DRAWS];
+    for (int kind = 0; kind < PIECE_RANDOMIZER_COUNT; ++kind) {
+        PieceBag bag;
+        piece_bag_seed_kind(&bag, (PieceRandomizer)kind, 7, 17);
+        piece_bag_generate(&bag, pieces, DRAWS);
+
+        int counts[7];
+        memset(counts, 0, sizeof(counts));
+        for (int i = 0; i < DRAWS; ++i) {
+            ++counts[pieces[i]];
+        }
+        for (int i = 0; i < 7; ++i) {
+            assert(counts[i] > DRAWS / 7 - 600 && counts[i] < DRAWS / 7 + 600);
+        }
+    }
+}
+
 int main(void) {
     run_test("bag_cycle_contains_all", test_bag_cycle_contains_all);
     run_test("bag_multiple_cycles", test_bag_multiple_cycles);
     run_test("bag_many_cycles_distribution", test_bag_many_cycles_distribution);
     run_test("bag_handles_zero_pieces", test_bag_handles_zero_pieces);
+    run_test("bag_peek_matches_draws", test_bag_peek_matches_draws);
+    run_test("generate_matches_next", test_generate_matches_next);
+    run_test("seed_kind_is_deterministic", test_seed_kind_is_deterministic);
+    run_test("bag14_holds_each_piece_twice", test_bag14_holds_each_piece_twice);
+    run_test("history_randomizers_avoid_repeats", test_history_randomizers_avoid_repeats);
+    run_test("randomizers_are_balanced", test_randomizers_are_balanced);
+    run_test("bag_valid_checks_each_kind", test_bag_valid_checks_each_kind);
     return 0;
 }
@@ -0,0 +1,121 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bitboard.h"
+
+#define I_PIECE 0
+#define O_PIECE 1
+#define T_PIECE 2
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+// Row and column masks must describe exactly the occupied cells.
+static void assert_masks_match(const BitBoard *board) {
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            bool filled = board->board.cells[row][col] != 0;
+            assert(((board->rows[row] >> col) & 1U) == filled);
+            assert(((board->columns[col] >> row) & 1U) == filled);
+        }
+    }
+}
+
+static void fill_row(Board *board, int row, int hole) {
+    for (int col = 0; col < BOARD_WIDTH; ++col) {
+        board->cells[row][col] = (col == hole) ? 0 : 8;
+    }
+}
+
+static void test_placement_matches_board(void) {
+    Board reference;
+    board_reset(&reference);
+    fill_row(&reference, BOARD_HEIGHT - 1, 4);
+    reference.cells[BOARD_HEIGHT - 4][7] = 3;
+    BitBoard bits;
+    bitboard_from_board(&bits, &reference);
+    assert_masks_match(&bits);
+
+    for (size_t type = 0; type < piece_shape_count(); ++type) {
+        const PieceShape *shape = piece_shape_get(type);
+        for (int rotation = 0; rotation < shape->rotation_count; ++rotation) {
+            for (int row = -5; row <= BOARD_HEIGHT + 1; ++row) {
+                for (int col = -4; col <= BOARD_WIDTH + 1; ++col) {
+                    assert(bitboard_can_place(&bits, shape, rotation, row, col) ==
+                           board_can_place(&reference, shape, rotation, row, col));
+                    assert(bitboard_drop_distance(&bits, shape, rotation, row, col) ==
+                           board_drop_distance(&reference, shape, rotation, row, col));
+                }
+            }
+        }
+    }
+    assert(!bitboard_can_place(&bits, piece_shape_get(T_PIECE), 4, 0, 0));
+    assert(!bitboard_can_place(NULL, piece_shape_get(T_PIECE), 0, 0, 0));
+}
+
+static void test_lock_and_clear_match_board(void) {
+    Board reference;
+    board_reset(&reference);
+    fill_row(&reference, BOARD_HEIGHT - 1, 0);
+    fill_row(&reference, BOARD_HEIGHT - 2, 0);
+    fill_row(&reference, BOARD_HEIGHT - 3, 0);
+    reference.cells[BOARD_HEIGHT - 3][5] = 0;
+    fill_row(&reference, BOARD_HEIGHT - 4, 0);
+    BitBoard bits;
+    bitboard_from_board(&bits, &reference);
+
+    // A vertical I in column 0 completes rows 19, 18 and 16; row 17 keeps a second hole.
+    const PieceShape *i_piece = piece_shape_get(I_PIECE);
+    int row = -2 + board_drop_distance(&reference, i_piece, 1, -2, -2);
+    assert(row == -2 + bitboard_drop_distance(&bits, i_piece, 1, -2, -2));
+    board_lock_shape(&reference, i_piece, 1, row, -2, I_PIECE + 1);
+    bitboard_lock_shape(&bits, i_piece, 1, row, -2, I_PIECE + 1);
+    assert(memcmp(&reference, &bits.board, sizeof(Board)) == 0);
+    assert_masks_match(&bits);
+
+    int expected_rows[BOARD_HEIGHT];
+    int actual_rows[BOARD_HEIGHT];
+    int expected = board_clear_completed_lines(&reference, expected_rows, BOARD_HEIGHT);
+    int actual = bitboard_clear_completed_lines(&bits, actual_rows, BOARD_HEIGHT);
+    assert(expected == 3 && actual == 3);
+    assert(memcmp(expected_rows, actual_rows, sizeof(int) * 3) == 0);
+    assert(memcmp(&reference, &bits.board, sizeof(Board)) == 0);
+    assert_masks_match(&bits);
+
+    // Locking zero erases, including cells of an O hanging off the right wall.
+    board_lock_shape(&reference, piece_shape_get(O_PIECE), 0, BOARD_HEIGHT - 2, BOARD_WIDTH - 2, 0);
+    bitboard_lock_shape(&bits, piece_shape_get(O_PIECE), 0, BOARD_HEIGHT - 2, BOARD_WIDTH - 2, 0);
+    assert(memcmp(&reference, &bits.board, sizeof(Board)) == 0);
+    assert_masks_match(&bits);
+}
+
+static void test_garbage_matches_board(void) {
+    Board reference;
+    board_reset(&reference);
+    BitBoard bits;
+    bitboard_reset(&bits);
+    assert(bitboard_is_empty(&bits));
+
+    static const int k_garbage[][3] = {{2, 3, 8}, {0, 1, 8}, {1, -1, 8}, {4, BOARD_WIDTH, 5},
+                                       {3, 9, 0}, {BOARD_HEIGHT - 6, 2, 8}, {BOARD_HEIGHT + 3, 4, 8}};
+    for (size_t i = 0; i < sizeof(k_garbage) / sizeof(k_garbage[0]); ++i) {
+        bool expected = board_insert_garbage(&reference, k_garbage[i][0], k_garbage[i][1], k_garbage[i][2]);
+        bool actual = bitboard_insert_garbage(&bits, k_garbage[i][0], k_garbage[i][1], k_garbage[i][2]);
+        assert(expected == actual);
+        assert(memcmp(&reference, &bits.board, sizeof(Board)) == 0);
+        assert(bitboard_is_empty(&bits) == board_is_empty(&reference));
+        assert_masks_match(&bits);
+    }
+    assert(!bitboard_is_empty(&bits));
+}
+
+int main(void) {
+    run_test("placement_matches_board", test_placement_matches_board);
+    run_test("lock_and_clear_match_board", test_lock_and_clear_match_board);
+    run_test("garbage_matches_board", test_garbage_matches_board);
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bitboard.h"
+#include "board_diff.h"
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static void temp_path(char *out, size_t capacity, const char *tag) {
+    snprintf(out, capacity, "/tmp/tetris_board_diff_%s_%ld.bin", tag, (long)getpid());
+}
+
+// The reference with a planted bug: locks never fill the rightmost column.
+static void buggy_lock_shape(void *state, const PieceShape *shape, int rotation, int row, int col, int value) {
+    Board *board = state;
+    int saved[BOARD_HEIGHT];
+    for (int r = 0; r < BOARD_HEIGHT; ++r) {
+        saved[r] = board->cells[r][BOARD_WIDTH - 1];
+    }
+    board_lock_shape(board, shape, rotation, row, col, value);
+    for (int r = 0; r < BOARD_HEIGHT; ++r) {
+        board->cells[r][BOARD_WIDTH - 1] = saved[r];
+    }
+}
+
+static BoardBackend buggy_backend(void) {
+    BoardBackend backend = *board_backend_reference();
+    backend.name = "buggy";
+    backend.lock_shape = buggy_lock_shape;
+    return backend;
+}
+
+static void test_random_streams_agree(void) {
+    BoardOpStream stream;
+    board_op_stream_init(&stream);
+    int kinds[BOARD_OP_KIND_COUNT] = {0};
+    int lines = 0;
+    for (uint64_t seed = 1; seed <= 4; ++seed) {
+        assert(board_diff_random_stream(&stream, seed, 20000) == 0);
+        assert(stream.count == 20000);
+        assert(board_diff_check(board_backend_bitboard(), &stream, stream.count) == BOARD_DIFF_NO_DIVERGENCE);
+
+        Board board;
+        board_reset(&board);
+        for (size_t i = 0; i < stream.count; ++i) {
+            BoardOpResult result;
+            board_diff_apply(board_backend_reference(), &board, &stream, &stream.ops[i], &result);
+            ++kinds[stream.ops[i].kind];
+            lines += (stream.ops[i].kind == BOARD_OP_CLEAR) ? result.value : 0;
+        }
+    }
+    // Every kind of operation shows up, and the steered drops actually clear lines.
+    for (int kind = 0; kind < BOARD_OP_KIND_COUNT; ++kind) {
+        assert(kinds[kind] > 0);
+    }
+    assert(lines > 100);
+    board_op_stream_free(&stream);
+}
+
+static void test_replay_stream_agrees(void) {
+    char path[64];
+    temp_path(path, sizeof(path), "replay");
+    static DatasetWriter writer;
+    assert(dataset_writer_open(&writer, path) == 0);
+    for (uint64_t i = 0; i < 500; ++i) {
+        DatasetRecord record;
+        memset(&record, 0, sizeof(record));
+        for (int row = 8; row < BOARD_HEIGHT; ++row) {
+            record.board[row] = (uint16_t)(((i * 2654435761u) >> (row % 13)) & 0x3FF);
+        }
+        record.board[BOARD_HEIGHT - 1] = 0x3FF;
+        record.piece = (int8_t)(i % 7);
+        record.rotation = (int8_t)(i % (uint64_t)piece_shape_get(i % 7)->rotation_count);
+        record.row = (int8_t)(i % 12);
+        record.col = (int8_t)(i % 10) - 1;
+        assert(dataset_writer_append(&writer, &record) == 0);
+    }
+    assert(dataset_writer_close(&writer) == 0);
+
+    DatasetView view;
+    assert(dataset_view_open(&view, path) == 0);
+    BoardOpStream stream;
+    board_op_stream_init(&stream);
+    assert(board_diff_replay_stream(&stream, &view, 100, 50) == 0);
+    assert(stream.count == 50 * 7 && stream.board_count == 50);
+    assert(board_diff_check(board_backend_bitboard(), &stream, stream.count) == BOARD_DIFF_NO_DIVERGENCE);
+    board_op_stream_free(&stream);
+
+    BoardDiffConfig config = {.records_per_stream = 64, .replay = &view, .streams = 100, .threads = 2};
+    BoardDiffReport report;
+    assert(board_diff_run(board_backend_bitboard(), &config, &report) == 0);
+    assert(report.failing_stream == -1 && report.streams == 8 && report.ops == 500 * 7);
+    dataset_view_close(&view);
+    unlink(path);
+}
+
+static void test_divergence_is_minimized(void) {
+    BoardBackend buggy = buggy_backend();
+    BoardOpStream stream;
+    board_op_stream_init(&stream);
+    assert(board_diff_random_stream(&stream, 7, 5000) == 0);
+    size_t divergence = board_diff_check(&buggy, &stream, stream.count);
+    assert(divergence != BOARD_DIFF_NO_DIVERGENCE);
+    assert(board_diff_check(&buggy, &stream, divergence) == BOARD_DIFF_NO_DIVERGENCE);
+
+    BoardOpStream reproducer;
+    assert(board_diff_minimize(&buggy, &stream, divergence, &reproducer) == 0);
+    assert(reproducer.count >= 1 && reproducer.count <= 2);
+    assert(reproducer.ops[reproducer.count - 1].kind == BOARD_OP_LOCK);
+    assert(board_diff_check(&buggy, &reproducer, reproducer.count) == reproducer.count - 1);
+    assert(board_diff_check(board_backend_bitboard(), &reproducer, reproducer.count) == BOARD_DIFF_NO_DIVERGENCE);
+    board_op_stream_free(&reproducer);
+    board_op_stream_free(&stream);
+}
+
+static void test_run_reports_lowest_failing_stream(void) {
+    BoardBackend buggy = buggy_backend();
+    BoardDiffConfig config = {.seed = 11, .streams = 24, .ops_per_stream = 3000, .threads = 4};
+    BoardDiffReport clean;
+    assert(board_diff_run(board_backend_bitboard(), &config, &clean) == 0);
+    assert(clean.failing_stream == -1 && clean.streams == 24 && clean.ops == 24 * 3000);
+    assert(clean.reproducer.count == 0);
+
+    BoardDiffReport threaded;
+    BoardDiffReport serial;
+    assert(board_diff_run(&buggy, &config, &threaded) == 0);
+    config.threads = 1;
+    assert(board_diff_run(&buggy, &config, &serial) == 0);
+    assert(serial.failing_stream == 0);
+    assert(threaded.failing_stream == serial.failing_stream && threaded.failing_op == serial.failing_op);
+    assert(threaded.reproducer.count == serial.reproducer.count && threaded.reproducer.count > 0);
+    board_op_stream_free(&threaded.reproducer);
+    board_op_stream_free(&serial.reproducer);
+}
+
+static void test_format_op(void) {
+    BoardOpStream stream;
+    board_op_stream_init(&stream);
+    uint16_t rows[BOARD_HEIGHT] = {0};
+    rows[BOARD_HEIGHT - 1] = 0x3FE;
+    BoardOp load = {.kind = BOARD_OP_LOAD, .value = 8};
+    assert(board_op_stream_add_board(&stream, rows, &load.load) == 0 && load.load == 0);
+
+    char line[256];
+    BoardOp lock = {.kind = BOARD_OP_LOCK, .type = 2, .rotation = 1, .row = 17, .col = -1, .value = 3};
+    board_diff_format_op(&lock, &stream, line, sizeof(line));
+    assert(strcmp(line, "lock T rot 1 row 17 col -1 value 3") == 0);
+    BoardOp garbage = {.kind = BOARD_OP_GARBAGE, .lines = 2, .col = 4, .value = 8};
+    board_diff_format_op(&garbage, &stream, line, sizeof(line));
+    assert(strcmp(line, "garbage lines 2 hole 4 value 8") == 0);
+    board_diff_format_op(&load, &stream, line, sizeof(line));
+    assert(strncmp(line, "load value 8 rows 000 000", 25) == 0);
+    assert(strcmp(line + strlen(line) - 4, " 3fe") == 0);
+    board_op_stream_free(&stream);
+}
+
+int main(void) {
+    run_test("random_streams_agree", test_random_streams_agree);
+    run_test("replay_stream_agrees", test_replay_stream_agrees);
+    run_test("divergence_is_minimized", test_divergence_is_minimized);
+    run_test("run_reports_lowest_failing_stream", test_run_reports_lowest_failing_stream);
+    run_test("format_op", test_format_op);
+    return 0;
+}
@@ -68,6 +68,20 @@ static void test_board_can_place_above_board(void) {
     assert(board_can_place(&board, shape, 0, -3, 3));
 }
 
+// Flat-side-down T (rotation 2) at row -2: its three-wide row sits just above the board and
+// its stem in row 0, so only the hidden row reaches past a wall.
+static void test_board_can_place_walls_above_board(void) {
+    Board board;
+    board_reset(&board);
+    const PieceShape *shape = piece_shape_get(2);
+    assert(shape != NULL);
+
+    assert(board_can_place(&board, shape, 2, -2, 0));
+    assert(board_can_place(&board, shape, 2, -2, BOARD_WIDTH - 3));
+    assert(!board_can_place(&board, shape, 2, -2, -1));
+    assert(!board_can_place(&board, shape, 2, -2, BOARD_WIDTH - 2));
+}
+
 static void test_board_lock_ignores_out_of_bounds_cells(void) {
     Board board;
     board_reset(&board);
@@ -103,6 +117,40 @@ static void test_board_clear_multiple_lines(void) {
     }
 }
 
+// The one-query drop distance agrees with stepping board_can_place row by row, on ragged
+// stacks with overhangs and from spawn rows above the board.
+static void test_board_drop_distance_matches_stepping(void) {
+    unsigned int state = 12345U;
+    for (int trial = 0; trial < 200; ++trial) {
+        Board board;
+        board_reset(&board);
+        for (int row = 6; row < BOARD_HEIGHT; ++row) {
+            for (int col = 0; col < BOARD_WIDTH; ++col) {
+                state = state * 1103515245U + 12345U;
+                board.cells[row][col] = ((state >> 16) % 3 == 0) ? 1 : 0;
+            }
+        }
+
+        for (size_t type = 0; type < piece_shape_count(); ++type) {
+            const PieceShape *shape = piece_shape_get(type);
+            for (int rotation = 0; rotation < shape->rotation_count; ++rotation) {
+                for (int col = -2; col < BOARD_WIDTH; ++col) {
+                    for (int row = -2; row < BOARD_HEIGHT; ++row) {
+                        if (!board_can_place(&board, shape, rotation, row, col)) {
+                            continue;
+                        }
+                        int expected = 0;
+                        while (board_can_place(&board, shape, rotation, row + expected + 1, col)) {
+                            ++expected;
+                        }
+                        assert(board_drop_distance(&board, shape, rotation, row, col) == expected);
+                    }
+                }
+            }
+        }
+    }
+}
+
 static void run_test(const char *name, void (*fn)(void)) {
     printf("[RUN] %s\n", name);
     fn();
@@ -115,7 +163,9 @@ int main(void) {
     run_test("board_lock_and_clear", test_board_lock_and_clear);
     run_test("board_can_place_left_boundary", test_board_can_place_left_boundary);
     run_test("board_can_place_above_board", test_board_can_place_above_board);
+    run_test("board_can_place_walls_above_board", test_board_can_place_walls_above_board);
     run_test("board_lock_ignores_out_of_bounds_cells", test_board_lock_ignores_out_of_bounds_cells);
     run_test("board_clear_multiple_lines", test_board_clear_multiple_lines);
+    run_test("board_drop_distance_matches_stepping", test_board_drop_distance_matches_stepping);
     return 0;
 }
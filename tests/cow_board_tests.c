@@ -0,0 +1,108 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "board.h"
+#include "cow_board.h"
+#include "piece.h"
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static void test_clone_shares_rows(void) {
+    CowRowPool pool;
+    cow_pool_init(&pool, NULL);
+
+    CowBoard parent;
+    cow_board_init(&pool, &parent);
+    const PieceShape *shape = piece_shape_get(1);
+    assert(cow_board_lock_shape(&pool, &parent, shape, 0, BOARD_HEIGHT - 2, 4, 2) == 0);
+    assert(cow_pool_live_rows(&pool) == 2);
+
+    CowBoard child;
+    cow_board_clone(&child, &parent);
+    assert(cow_pool_live_rows(&pool) == 2);
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        assert(child.rows[row] == parent.rows[row]);
+    }
+
+    assert(cow_board_lock_shape(&pool, &child, piece_shape_get(0), 0, BOARD_HEIGHT - 3, 0, 1) == 0);
+    assert(cow_pool_live_rows(&pool) == 3);
+    assert(child.rows[BOARD_HEIGHT - 1] == parent.rows[BOARD_HEIGHT - 1]);
+    assert(child.rows[BOARD_HEIGHT - 2] != parent.rows[BOARD_HEIGHT - 2]);
+    assert(parent.rows[BOARD_HEIGHT - 2]->cells[0] == 0);
+
+    cow_board_release(&pool, &child);
+    cow_board_release(&pool, &parent);
+    assert(cow_pool_live_rows(&pool) == 0);
+    cow_pool_destroy(&pool);
+}
+
+// Apply the same operations to a flat Board and a CowBoard and compare every step.
+static void test_matches_flat_board(void) {
+    CowRowPool pool;
+    cow_pool_init(&pool, NULL);
+    CowBoard cow;
+    cow_board_init(&pool, &cow);
+    Board flat;
+    board_reset(&flat);
+
+    unsigned seed = 12345U;
+    for (int step = 0; step < 400; ++step) {
+        seed = seed * 1103515245U + 12345U;
+        int type = (int)((seed >> 16) % piece_shape_count());
+        const PieceShape *shape = piece_shape_get((size_t)type);
+        int rotation = (int)((seed >> 8) % (unsigned)shape->rotation_count);
+        int col = (int)((seed >> 4) % 10U) - 1;
+
+        if (!board_can_place(&flat, shape, rotation, -2, col)) {
+            assert(!cow_board_can_place(&cow, shape, rotation, -2, col));
+            continue;
+        }
+        int row = -2;
+        while (board_can_place(&flat, shape, rotation, row + 1, col)) {
+            assert(cow_board_can_place(&cow, shape, rotation, row + 1, col));
+            ++row;
+        }
+        assert(!cow_board_can_place(&cow, shape, rotation, row + 1, col));
+
+        board_lock_shape(&flat, shape, rotation, row, col, type + 1);
+        assert(cow_board_lock_shape(&pool, &cow, shape, rotation, row, col, type + 1) == 0);
+
+        int flat_rows[BOARD_HEIGHT];
+        int cow_rows[BOARD_HEIGHT];
+        int flat_cleared = board_clear_completed_lines(&flat, flat_rows, BOARD_HEIGHT);
+        int cow_cleared = cow_board_clear_completed_lines(&pool, &cow, cow_rows, BOARD_HEIGHT);
+        assert(flat_cleared == cow_cleared);
+        assert(memcmp(flat_rows, cow_rows, sizeof(int) * (size_t)flat_cleared) == 0);
+
+        Board materialized;
+        cow_board_to_board(&cow, &materialized);
+        assert(memcmp(&materialized, &flat, sizeof(Board)) == 0);
+
+        if (flat.cells[2][4] != 0) {
+            board_reset(&flat);
+            cow_board_release(&pool, &cow);
+        }
+    }
+
+    CowBoard imported;
+    assert(cow_board_from_board(&pool, &imported, &flat) == 0);
+    Board roundtrip;
+    cow_board_to_board(&imported, &roundtrip);
+    assert(memcmp(&roundtrip, &flat, sizeof(Board)) == 0);
+
+    cow_board_release(&pool, &imported);
+    cow_board_release(&pool, &cow);
+    assert(cow_pool_live_rows(&pool) == 0);
+    cow_pool_destroy(&pool);
+}
+
+int main(void) {
+    run_test("clone_shares_rows", test_clone_shares_rows);
+    run_test("matches_flat_board", test_matches_flat_board);
+    return 0;
+}
@@ -0,0 +1,160 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "dataset.h"
+#include "engine.h"
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static void temp_path(char *out, size_t capacity, const char *tag) {
+    snprintf(out, capacity, "/tmp/tetris_dataset_%s_%ld.bin", tag, (long)getpid());
+}
+
+static void make_record(uint64_t index, DatasetRecord *record) {
+    memset(record, 0, sizeof(*record));
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        record->board[row] = (uint16_t)((index * 31 + (uint64_t)row) & 0x3FF);
+    }
+    record->piece = (int8_t)(index % 7);
+    record->next = (int8_t)((index + 3) % 7);
+    record->rotation = (int8_t)(index % 4);
+    record->row = (int8_t)(index % 23) - 3;
+    record->col = (int8_t)(index % 12) - 2;
+    record->lines = (uint8_t)(index % 5);
+    record->done = (index % 997) == 0;
+    record->score_delta = (int32_t)(index * 7);
+    record->game = (uint32_t)(index / 997);
+}
+
+static void test_header_layout(void) {
+    DatasetHeader header;
+    dataset_header_init(&header);
+    assert(header.column_count == DATASET_COLUMN_COUNT);
+    assert(strcmp(header.columns[DATASET_COL_BOARD].name, "board") == 0);
+    assert(header.columns[DATASET_COL_BOARD].element_bytes == BOARD_HEIGHT * 2);
+    assert(header.columns[DATASET_COL_SCORE_DELTA].element_bytes == 4);
+
+    uint64_t end = 0;
+    for (int c = 0; c < DATASET_COLUMN_COUNT; ++c) {
+        assert(header.columns[c].offset % DATASET_COLUMN_ALIGN == 0);
+        assert(header.columns[c].offset >= end);
+        end = header.columns[c].offset + (uint64_t)header.columns[c].element_bytes * DATASET_RECORDS_PER_BLOCK;
+    }
+    assert(end <= header.block_bytes && header.block_bytes % DATASET_COLUMN_ALIGN == 0);
+}
+
+static void test_round_trip_across_blocks(void) {
+    char path[64];
+    temp_path(path, sizeof(path), "round_trip");
+    const uint64_t count = DATASET_RECORDS_PER_BLOCK * 2 + 123;
+
+    static DatasetWriter writer;
+    assert(dataset_writer_open(&writer, path) == 0);
+    for (uint64_t i = 0; i < count; ++i) {
+        DatasetRecord record;
+        make_record(i, &record);
+        assert(dataset_writer_append(&writer, &record) == 0);
+    }
+    assert(dataset_writer_close(&writer) == 0);
+
+    DatasetView view;
+    assert(dataset_view_open(&view, path) == 0);
+    assert(view.header->record_count == count && view.header->block_count == 3);
+    assert(view.length == DATASET_HEADER_BYTES + 3 * view.header->block_bytes);
+    for (uint64_t i = 0; i < count; ++i) {
+        DatasetRecord expected;
+        DatasetRecord actual;
+        make_record(i, &expected);
+        assert(dataset_view_record(&view, i, &actual) == 0);
+        assert(memcmp(&expected, &actual, sizeof(expected)) == 0);
+    }
+    DatasetRecord past_end;
+    assert(dataset_view_record(&view, count, &past_end) == -1);
+
+    // Columns are plain arrays: a loader indexes them directly.
+    const int32_t *deltas = dataset_view_column(&view, 1, DATASET_COL_SCORE_DELTA);
+    assert(deltas[5] == (int32_t)((DATASET_RECORDS_PER_BLOCK + 5) * 7));
+    const uint8_t *lines = dataset_view_column(&view, 2, DATASET_COL_LINES);
+    assert(lines[DATASET_RECORDS_PER_BLOCK - 1] == 0);
+    assert(dataset_view_column(&view, 3, DATASET_COL_LINES) == NULL);
+
+    dataset_view_close(&view);
+    remove(path);
+}
+
+static void test_record_from_engine(void) {
+    Engine engine;
+    engine_init(&engine, 11);
+    engine_start(&engine);
+    engine.board.cells[BOARD_HEIGHT - 1][0] = 1;
+    engine.board.cells[BOARD_HEIGHT - 1][9] = ENGINE_GARBAGE_CELL;
+    engine.board.cells[10][4] = 3;
+
+    DatasetRecord record;
+    dataset_record_from_engine(&record, &engine);
+    assert(record.board[BOARD_HEIGHT - 1] == ((1U << 0) | (1U << 9)));
+    assert(record.board[10] == (1U << 4));
+    assert(record.board[0] == 0);
+    assert(record.piece == engine.active.type && record.next == engine.next_piece_type);
+}
+
+static void test_rejects_bad_files(void) {
+    char path[64];
+    temp_path(path, sizeof(path), "bad");
+
+    static DatasetWriter writer;
+    assert(dataset_writer_open(&writer, path) == 0);
+    DatasetRecord record;
+    make_record(1, &record);
+    assert(dataset_writer_append(&writer, &record) == 0);
+    assert(dataset_writer_close(&writer) == 0);
+
+    DatasetView view;
+    assert(dataset_view_open(&view, path) == 0);
+    size_t length = view.length;
+    dataset_view_close(&view);
+
+    // A block count whose byte size wraps around to fit the file must not pass.
+    FILE *patch = fopen(path, "r+b");
+    assert(patch != NULL);
+    DatasetHeader header;
+    assert(fread(&header, sizeof(header), 1, patch) == 1);
+    uint64_t block_count = header.block_count;
+    header.block_count = UINT64_MAX / header.block_bytes + 1;
+    assert(DATASET_HEADER_BYTES + header.block_count * header.block_bytes <= length);
+    assert(fseek(patch, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, patch) == 1);
+    assert(fflush(patch) == 0);
+    assert(dataset_view_open(&view, path) == -1);
+    header.block_count = block_count;
+    assert(fseek(patch, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, patch) == 1);
+    fclose(patch);
+    assert(dataset_view_open(&view, path) == 0);
+    dataset_view_close(&view);
+
+    assert(truncate(path, (off_t)(length - 1)) == 0);
+    assert(dataset_view_open(&view, path) == -1);
+
+    FILE *fp = fopen(path, "wb");
+    assert(fp != NULL);
+    fputs("not a dataset", fp);
+    fclose(fp);
+    assert(dataset_view_open(&view, path) == -1);
+    assert(dataset_writer_open(&writer, "/nonexistent-dir/out.bin") == -1);
+    remove(path);
+}
+
+int main(void) {
+    run_test("header_layout", test_header_layout);
+    run_test("round_trip_across_blocks", test_round_trip_across_blocks);
+    run_test("record_from_engine", test_record_from_engine);
+    run_test("rejects_bad_files", test_rejects_bad_files);
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "effects.h"
+
+#define I_PIECE 0
+#define T_PIECE 2
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static void test_piece_overlay_clips_to_board(void) {
+    uint16_t rows[BOARD_HEIGHT];
+    memset(rows, 0, sizeof(rows));
+    ActivePiece flat_i = {I_PIECE, 0, -1, 3, true}; // pattern row 1 lands on board row 0
+    overlay_add_piece(rows, &flat_i);
+    assert(rows[0] == 0x78);
+
+    // Vertical I in pattern column 2, pushed to the left wall, half above the board.
+    ActivePiece upright_i = {I_PIECE, 1, -2, -2, true};
+    overlay_add_piece(rows, &upright_i);
+    assert(rows[0] == (0x78 | 0x1) && rows[1] == 0x1 && rows[2] == 0);
+
+    memset(rows, 0, sizeof(rows));
+    ActivePiece t_right = {T_PIECE, 0, BOARD_HEIGHT - 3, BOARD_WIDTH - 3, true};
+    overlay_add_piece(rows, &t_right);
+    assert(rows[BOARD_HEIGHT - 1] == (0x7 << (BOARD_WIDTH - 3)));
+    assert(rows[BOARD_HEIGHT - 2] == (0x2 << (BOARD_WIDTH - 3)));
+}
+
+// The trail equals the union of the piece's cells at every row it fell through.
+static void test_drop_trail_matches_every_step(void) {
+    Effects effects;
+    for (int type = 0; type < (int)piece_shape_count(); ++type) {
+        const PieceShape *shape = piece_shape_get((size_t)type);
+        for (int rotation = 0; rotation < shape->rotation_count; ++rotation) {
+            for (int col = -2; col < BOARD_WIDTH; ++col) {
+                for (int distance = 1; distance <= BOARD_HEIGHT; distance += 3) {
+                    ActivePiece landed = {type, rotation, BOARD_HEIGHT - 4, col, true};
+                    uint16_t expected[BOARD_HEIGHT];
+                    memset(expected, 0, sizeof(expected));
+                    for (int step = 0; step <= distance; ++step) {
+                        ActivePiece pose = landed;
+                        pose.row -= step;
+                        overlay_add_piece(expected, &pose);
+                    }
+
+                    effects_reset(&effects);
+                    effects_drop_trail(&effects, &landed, distance, 100);
+                    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+                        assert(effects_row_mask(&effects, EFFECT_DROP_TRAIL, row) == expected[row]);
+                    }
+                }
+            }
+        }
+    }
+
+    ActivePiece piece = {T_PIECE, 0, 10, 3, true};
+    effects_drop_trail(&effects, &piece, 0, 100);
+    assert(effects.effects[EFFECT_DROP_TRAIL].timer_ms == 0);
+    assert(effects_row_mask(&effects, EFFECT_DROP_TRAIL, 11) == 0);
+}
+
+static void test_effects_expire_independently(void) {
+    Effects effects;
+    effects_reset(&effects);
+    int cleared[] = {BOARD_HEIGHT - 1, BOARD_HEIGHT - 3, BOARD_HEIGHT};
+    effects_flash_rows(&effects, cleared, 3, 200);
+    ActivePiece piece = {I_PIECE, 1, 4, 0, true};
+    effects_drop_trail(&effects, &piece, 5, 100);
+
+    assert(effects_row_mask(&effects, EFFECT_LINE_FLASH, BOARD_HEIGHT - 1) == OVERLAY_COLUMNS_MASK);
+    assert(effects_row_mask(&effects, EFFECT_LINE_FLASH, BOARD_HEIGHT - 2) == 0);
+    assert(effects_row_mask(&effects, EFFECT_LINE_FLASH, BOARD_HEIGHT - 3) == OVERLAY_COLUMNS_MASK);
+    assert(effects_row_mask(&effects, EFFECT_DROP_TRAIL, 4) == 0x4);
+
+    effects_tick(&effects, 100);
+    assert(effects_row_mask(&effects, EFFECT_DROP_TRAIL, 4) == 0);
+    assert(effects_row_mask(&effects, EFFECT_LINE_FLASH, BOARD_HEIGHT - 1) == OVERLAY_COLUMNS_MASK);
+    effects_tick(&effects, 150);
+    assert(effects_row_mask(&effects, EFFECT_LINE_FLASH, BOARD_HEIGHT - 1) == 0);
+    assert(effects.effects[EFFECT_LINE_FLASH].timer_ms == 0);
+
+    assert(effects_row_mask(&effects, EFFECT_COUNT, 0) == 0);
+    assert(effects_row_mask(&effects, EFFECT_LINE_FLASH, BOARD_HEIGHT) == 0);
+}
+
+int main(void) {
+    run_test("piece_overlay_clips_to_board", test_piece_overlay_clips_to_board);
+    run_test("drop_trail_matches_every_step", test_drop_trail_matches_every_step);
+    run_test("effects_expire_independently", test_effects_expire_independently);
+    return 0;
+}
@@ -0,0 +1,381 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "engine.h"
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+// Deterministic input script: shift, rotate, and hard drop in a repeating pattern.
+static void play_pieces(Engine *engine, int pieces) {
+    for (int i = 0; i < pieces && engine->phase == ENGINE_PHASE_PLAYING; ++i) {
+        for (int r = 0; r < i % 4; ++r) {
+            engine_rotate(engine, 1);
+        }
+        int shift = (i % 9) - 4;
+        while (shift != 0 && engine_shift(engine, shift > 0 ? 1 : -1)) {
+            shift += (shift > 0) ? -1 : 1;
+        }
+        engine_tick(engine, 16);
+        engine_hard_drop(engine);
+        engine_take_events(engine, NULL);
+    }
+}
+
+static void test_engine_same_seed_same_game(void) {
+    Engine a;
+    Engine b;
+    engine_init(&a, 42);
+    engine_init(&b, 42);
+    engine_start(&a);
+    engine_start(&b);
+    play_pieces(&a, 60);
+    play_pieces(&b, 60);
+    assert(memcmp(&a.board, &b.board, sizeof(Board)) == 0);
+    assert(a.score.current == b.score.current);
+    assert(a.next_piece_type == b.next_piece_type);
+}
+
+static void test_engine_gravity_and_lock_delay(void) {
+    Engine engine;
+    engine_init(&engine, 7);
+    engine_start(&engine);
+    int start_row = engine.active.row;
+
+    engine_tick(&engine, ENGINE_GRAVITY_INTERVAL_MS);
+    assert(engine.active.row == start_row + 1);
+
+    int landing = engine_ghost_row(&engine);
+    while (engine.active.row < landing) {
+        engine_soft_drop(&engine);
+    }
+    engine_soft_drop(&engine);
+    assert(engine.lock_pending);
+    engine_tick(&engine, ENGINE_LOCK_DELAY_MS - 1);
+    assert((engine_take_events(&engine, NULL) & ENGINE_EVENT_LOCKED) == 0);
+    engine_tick(&engine, 1);
+    EngineEvents events;
+    assert(engine_take_events(&engine, &events) & ENGINE_EVENT_LOCKED);
+    assert(events.locked_piece.row == landing);
+}
+
+static void test_gravity_curve_extends_past_level_13(void) {
+    uint64_t interval = 0;
+    int rows = 0;
+    engine_gravity_for_level(1, &interval, &rows);
+    assert(interval == ENGINE_GRAVITY_INTERVAL_MS && rows == 1);
+    engine_gravity_for_level(13, &interval, &rows);
+    assert(interval == ENGINE_MIN_GRAVITY_INTERVAL_MS && rows == 1);
+
+    // Rows per millisecond strictly increase until 20G, then stay there.
+    double previous = 1.0 / (double)interval;
+    Engine engine;
+    engine_init(&engine, 3);
+    for (int level = 14; level <= 30; ++level) {
+        engine_gravity_for_level(level, &interval, &rows);
+        double speed = rows / (double)interval;
+        engine.gravity_interval_ms = interval;
+        engine.gravity_rows = rows;
+        if (level < 22) {
+            assert(speed > previous && !engine_gravity_is_instant(&engine));
+        } else {
+            assert(speed == previous || level == 22);
+            assert(engine_gravity_is_instant(&engine));
+        }
+        previous = speed;
+    }
+}
+
+// At 5G a 100 ms stall is 30 rows of gravity: the piece lands in one tick and the lock
+// delay starts, just as stepping a row at a time would have done.
+static void test_engine_multi_row_gravity(void) {
+    Engine engine;
+    engine_init(&engine, 8);
+    engine_start(&engine);
+    engine_set_level(&engine, 21);
+    int landing = engine_ghost_row(&engine);
+    int start_row = engine.active.row;
+
+    engine_tick(&engine, 10);
+    assert(engine.active.row == start_row + 3 && !engine.lock_pending);
+    engine_tick(&engine, 100);
+    assert(engine.active.row == landing && engine.lock_pending);
+
+    // 1G: three rows every 50 ms, with the remainder carried between ticks.
+    engine_start(&engine);
+    engine_set_level(&engine, 19);
+    start_row = engine.active.row;
+    engine_tick(&engine, 30);
+    assert(engine.active.row == start_row + 1);
+    engine_tick(&engine, 20);
+    assert(engine.active.row == start_row + 3);
+}
+
+static void test_engine_20g_drops_instantly(void) {
+    Engine engine;
+    engine_init(&engine, 9);
+    engine_start(&engine);
+    engine_set_level(&engine, 22);
+    assert(engine.active.row == engine_ghost_row(&engine));
+
+    // Sliding off a ledge falls straight down again.
+    engine.board.cells[BOARD_HEIGHT - 1][0] = 1;
+    engine.board.cells[BOARD_HEIGHT - 2][0] = 1;
+    while (engine_shift(&engine, -1)) {
+        assert(engine.active.row == engine_ghost_row(&engine));
+    }
+    while (engine_shift(&engine, 1)) {
+        assert(engine.active.row == engine_ghost_row(&engine));
+    }
+
+    // The next piece spawns onto the stack, and clearing lines never lowers the level.
+    engine_hard_drop(&engine);
+    engine_take_events(&engine, NULL);
+    assert(engine.active.active && engine.active.row == engine_ghost_row(&engine));
+    assert(engine.level == 22);
+}
+
+static void test_snapshot_restore_replays_identically(void) {
+    Engine engine;
+    engine_init(&engine, 1234);
+    engine_start(&engine);
+    play_pieces(&engine, 25);
+    engine_receive_garbage(&engine, 3); // pending garbage and its hole RNG are state too
+
+    EngineSnapshot snapshot;
+    engine_snapshot(&engine, &snapshot);
+    Engine reference = engine;
+    play_pieces(&reference, 30);
+
+    play_pieces(&engine, 11);
+    engine_receive_garbage(&engine, 2);
+    engine_restore(&engine, &snapshot);
+    play_pieces(&engine, 30);
+
+    assert(memcmp(&engine.board, &reference.board, sizeof(Board)) == 0);
+    assert(memcmp(&engine.active, &reference.active, sizeof(ActivePiece)) == 0);
+    assert(engine.score.current == reference.score.current);
+    assert(engine.total_lines_cleared == reference.total_lines_cleared);
+    assert(engine.garbage_pending == reference.garbage_pending && engine.garbage_rng == reference.garbage_rng);
+    assert(memcmp(&engine.stats, &reference.stats, sizeof(EngineStats)) == 0);
+}
+
+static void test_snapshot_serialization_roundtrip(void) {
+    const char *path = "build/tests/engine_session.bin";
+    remove(path);
+
+    Engine engine;
+    engine_init(&engine, 99);
+    piece_bag_seed_kind(&engine.bag, PIECE_RANDOMIZER_NES, piece_shape_count(), 99);
+    engine_start(&engine);
+    play_pieces(&engine, 17);
+    engine_tick(&engine, 250);
+
+    EngineSnapshot snapshot;
+    engine_snapshot(&engine, &snapshot);
+    unsigned char buffer[ENGINE_SNAPSHOT_ENCODED_SIZE];
+    assert(engine_snapshot_encode(&snapshot, buffer, sizeof(buffer)) == ENGINE_SNAPSHOT_ENCODED_SIZE);
+    assert(engine_snapshot_encode(&snapshot, buffer, sizeof(buffer) - 1) == 0);
+
+    assert(engine_snapshot_save(&snapshot, path) == 0);
+    EngineSnapshot loaded;
+    assert(engine_snapshot_load(&loaded, path) == 0);
+    assert(memcmp(&loaded, &snapshot, sizeof(snapshot)) == 0);
+
+    buffer[100] ^= 0x01;
+    assert(engine_snapshot_decode(&loaded, buffer, sizeof(buffer)) != 0);
+    remove(path);
+}
+
+static void snapshot_of_game(EngineSnapshot *snapshot) {
+    Engine engine;
+    engine_init(&engine, 21);
+    engine_start(&engine);
+    play_pieces(&engine, 5);
+    engine_snapshot(&engine, snapshot);
+}
+
+// Re-encode with a fresh checksum so only the tampered field can cause the rejection.
+static bool snapshot_decodes(const EngineSnapshot *snapshot) {
+    unsigned char buffer[ENGINE_SNAPSHOT_ENCODED_SIZE];
+    assert(engine_snapshot_encode(snapshot, buffer, sizeof(buffer)) == ENGINE_SNAPSHOT_ENCODED_SIZE);
+    EngineSnapshot decoded;
+    return engine_snapshot_decode(&decoded, buffer, sizeof(buffer)) == 0;
+}
+
+static void test_decode_rejects_bad_next_piece(void) {
+    EngineSnapshot snapshot;
+    snapshot_of_game(&snapshot);
+    assert(snapshot_decodes(&snapshot));
+    snapshot.next_piece_type = (int)piece_shape_count();
+    assert(!snapshot_decodes(&snapshot));
+    snapshot.next_piece_type = -2;
+    assert(!snapshot_decodes(&snapshot));
+}
+
+static void test_decode_rejects_bag_cursor_past_end(void) {
+    EngineSnapshot snapshot;
+    snapshot_of_game(&snapshot);
+    snapshot.bag.cursor = snapshot.bag.piece_count + 1;
+    assert(!snapshot_decodes(&snapshot));
+}
+
+static void test_decode_rejects_bad_bag_value(void) {
+    EngineSnapshot snapshot;
+    snapshot_of_game(&snapshot);
+    snapshot.bag.values[snapshot.bag.piece_count - 1] = (int)snapshot.bag.piece_count;
+    assert(!snapshot_decodes(&snapshot));
+    snapshot_of_game(&snapshot);
+    snapshot.bag.values[0] = -1;
+    assert(!snapshot_decodes(&snapshot));
+}
+
+static void test_decode_rejects_bad_board_cell(void) {
+    EngineSnapshot snapshot;
+    snapshot_of_game(&snapshot);
+    snapshot.board.cells[BOARD_HEIGHT - 1][0] = ENGINE_GARBAGE_CELL + 1;
+    assert(!snapshot_decodes(&snapshot));
+    snapshot.board.cells[BOARD_HEIGHT - 1][0] = -1;
+    assert(!snapshot_decodes(&snapshot));
+}
+
+// Drop a T into a T-spin double slot and rotate it in place: the lock reports the spin and
+// is scored as one.
+// A caller-chosen randomizer stays in use through new games and reseeds.
+static void test_randomizer_kind_survives_restart(void) {
+    Engine engine;
+    engine_init(&engine, 5);
+    piece_bag_seed_kind(&engine.bag, PIECE_RANDOMIZER_TGM, piece_shape_count(), 77);
+    PieceBag expected = engine.bag;
+    piece_bag_seed_kind(&expected, PIECE_RANDOMIZER_TGM, piece_shape_count(), expected.rng_state);
+
+    engine_start(&engine);
+    assert(engine.bag.kind == PIECE_RANDOMIZER_TGM);
+    int first[4];
+    int drawn[4];
+    piece_bag_generate(&expected, first, 4);
+    drawn[0] = engine.active.type;
+    drawn[1] = engine.next_piece_type;
+    piece_bag_peek(&engine.bag, &drawn[2], 2);
+    assert(memcmp(first, drawn, sizeof(first)) == 0);
+
+    engine_reseed(&engine, 8);
+    engine_start(&engine);
+    assert(engine.bag.kind == PIECE_RANDOMIZER_TGM);
+}
+
+static void test_engine_reports_tspin(void) {
+    Engine engine;
+    engine_init(&engine, 5);
+    engine_start(&engine);
+    engine_take_events(&engine, NULL);
+    const int bottom = BOARD_HEIGHT - 1;
+    for (int col = 0; col < BOARD_WIDTH; ++col) {
+        engine.board.cells[bottom][col] = (col != 4) ? 1 : 0;
+        engine.board.cells[bottom - 1][col] = (col < 3 || col > 5) ? 1 : 0;
+    }
+    engine.board.cells[bottom - 2][3] = 1;
+
+    engine.active = (ActivePiece){.type = SCORE_T_PIECE, .rotation = 3, .row = BOARD_HEIGHT - 3, .col = 3, .active = true};
+    assert(engine_rotate(&engine, -1));
+    assert(engine.active.rotation == 2);
+    int64_t before = engine.score.current;
+    engine_hard_drop(&engine);
+
+    EngineEvents events;
+    assert(engine_take_events(&engine, &events) & ENGINE_EVENT_LOCKED);
+    assert(events.spin == SCORE_SPIN_FULL && events.cleared_count == 2);
+    assert(engine.level == 1 && events.lock_points == 1200);
+    assert(engine.score.current == before + events.lock_points);
+}
+
+// A vertical I into a four-deep well: one tetris, and the row left above it covers a hole.
+static void test_engine_stats_track_locks(void) {
+    Engine engine;
+    engine_init(&engine, 9);
+    engine_start(&engine);
+    engine_take_events(&engine, NULL);
+    const int bottom = BOARD_HEIGHT - 1;
+    for (int row = bottom - 4; row <= bottom; ++row) {
+        for (int col = 1; col < BOARD_WIDTH; ++col) {
+            engine.board.cells[row][col] = 1;
+        }
+    }
+    engine.board.cells[bottom - 4][5] = 0;
+    engine.board.cells[bottom - 5][5] = 1; // covers one hole
+
+    engine_count_key(&engine);
+    engine_tick(&engine, 500);
+    engine.active = (ActivePiece){.type = 0, .rotation = 1, .row = 0, .col = -2, .active = true};
+    engine_hard_drop(&engine);
+    engine_take_events(&engine, NULL);
+    assert(engine.stats.pieces == 1 && engine.stats.clears[ENGINE_CLEAR_TETRIS] == 1);
+    assert(engine.stats.attack == 4 && engine.stats.max_combo == 0);
+
+    const EngineStats *stats = &engine.stats;
+    assert(stats->keys == 1 && stats->play_ms >= 500);
+    assert(stats->stack_height_sum == 2 && stats->holes_sum == 1);
+    assert(engine_stats_kpp(stats) == 1.0);
+    assert(engine_stats_mean_holes(stats) == 1.0);
+
+    EngineStats fixed = {.play_ms = 30000, .pieces = 60, .keys = 180, .attack = 15};
+    assert(engine_stats_pps(&fixed) == 2.0);
+    assert(engine_stats_kpp(&fixed) == 3.0);
+    assert(engine_stats_apm(&fixed) == 30.0);
+    EngineStats empty = {0};
+    assert(engine_stats_pps(&empty) == 0.0 && engine_stats_kpp(&empty) == 0.0);
+
+    engine.phase = ENGINE_PHASE_IDLE;
+    engine_count_key(&engine);
+    engine_tick(&engine, 1000);
+    assert(stats->keys == 1 && stats->play_ms < 1500);
+
+    engine_start(&engine);
+    assert(engine.stats.pieces == 0 && engine.stats.keys == 0 && engine.stats.play_ms == 0);
+}
+
+static void test_engine_stats_format(void) {
+    EngineStats stats = {.play_ms = 60000, .pieces = 120, .keys = 400, .attack = 30, .max_combo = 3};
+    stats.clears[ENGINE_CLEAR_TETRIS] = 2;
+    stats.clears[ENGINE_CLEAR_TSPIN_DOUBLE] = 1;
+    char line[512];
+    int length = engine_stats_format(&stats, line, sizeof(line));
+    assert(length > 0 && (size_t)length == strlen(line));
+    assert(line[0] == '{' && line[length - 1] == '}');
+    assert(strstr(line, "\"pps\":2.000") != NULL);
+    assert(strstr(line, "\"apm\":30.00") != NULL);
+    assert(strstr(line, "\"max_combo\":3") != NULL);
+    assert(strstr(line, "\"tetris\":2") != NULL);
+    assert(strstr(line, "\"tspin_double\":1") != NULL);
+    assert(strstr(line, "\"perfect_clear\":0}}") != NULL);
+
+    char small[16];
+    assert(engine_stats_format(&stats, small, sizeof(small)) >= (int)sizeof(small));
+    assert(strlen(small) == sizeof(small) - 1);
+    assert(engine_stats_format(NULL, line, sizeof(line)) == -1);
+    assert(strcmp(engine_clear_kind_name(ENGINE_CLEAR_KIND_COUNT), "unknown") == 0);
+}
+
+int main(void) {
+    run_test("engine_same_seed_same_game", test_engine_same_seed_same_game);
+    run_test("engine_gravity_and_lock_delay", test_engine_gravity_and_lock_delay);
+    run_test("engine_reports_tspin", test_engine_reports_tspin);
+    run_test("gravity_curve_extends_past_level_13", test_gravity_curve_extends_past_level_13);
+    run_test("engine_multi_row_gravity", test_engine_multi_row_gravity);
+    run_test("engine_20g_drops_instantly", test_engine_20g_drops_instantly);
+    run_test("snapshot_restore_replays_identically", test_snapshot_restore_replays_identically);
+    run_test("snapshot_serialization_roundtrip", test_snapshot_serialization_roundtrip);
+    run_test("decode_rejects_bad_next_piece", test_decode_rejects_bad_next_piece);
+    run_test("decode_rejects_bag_cursor_past_end", test_decode_rejects_bag_cursor_past_end);
+    run_test("decode_rejects_bad_bag_value", test_decode_rejects_bad_bag_value);
+    run_test("decode_rejects_bad_board_cell", test_decode_rejects_bad_board_cell);
+    run_test("randomizer_kind_survives_restart", test_randomizer_kind_survives_restart);
+    run_test("engine_stats_track_locks", test_engine_stats_track_locks);
+    run_test("engine_stats_format", test_engine_stats_format);
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "engine.h"
+#include "finesse.h"
+
+#define I_PIECE 0
+#define O_PIECE 1
+#define T_PIECE 2
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+// Play a path through the engine from a fresh spawn; returns the pose it ends in.
+static ActivePiece play_path(Engine *engine, const FinessePath *path) {
+    for (int i = 0; i < path->length; ++i) {
+        if (path->inputs[i] == FINESSE_INPUT_ROTATE) {
+            assert(engine_rotate(engine, 1));
+        } else {
+            assert(engine_shift(engine, path->inputs[i] == FINESSE_INPUT_LEFT ? -1 : 1));
+        }
+    }
+    return engine->active;
+}
+
+static void test_spawn_pose_costs_nothing(void) {
+    for (int type = 0; type < (int)piece_shape_count(); ++type) {
+        ActivePiece spawn;
+        engine_spawn_pose(type, &spawn);
+        assert(finesse_optimal_inputs(type, spawn.rotation, spawn.col) == 0);
+    }
+    assert(finesse_optimal_inputs(O_PIECE, 0, 4) == 1);
+    assert(finesse_optimal_inputs(T_PIECE, 3, 3) == 3); // clockwise only
+    assert(finesse_optimal_inputs(O_PIECE, 1, 3) == -1);
+    assert(finesse_optimal_inputs(I_PIECE, 0, BOARD_WIDTH) == -1);
+    assert(finesse_path(-1, 0, 0) == NULL);
+}
+
+// Every table path replays through the engine to exactly the pose it is filed under, and
+// each pose reachable from spawn has an entry.
+static void test_paths_replay_through_engine(void) {
+    for (int type = 0; type < (int)piece_shape_count(); ++type) {
+        const PieceShape *shape = piece_shape_get((size_t)type);
+        for (int rotation = 0; rotation < shape->rotation_count; ++rotation) {
+            for (int col = FINESSE_COL_MIN; col < BOARD_WIDTH; ++col) {
+                const FinessePath *path = finesse_path(type, rotation, col);
+                Board empty;
+                board_reset(&empty);
+                bool fits = board_can_place(&empty, shape, rotation, -2, col);
+                assert((path != NULL) == fits);
+                if (path == NULL) {
+                    continue;
+                }
+
+                Engine engine;
+                engine_init(&engine, 1);
+                engine_start(&engine);
+                engine_spawn_pose(type, &engine.active);
+                ActivePiece end = play_path(&engine, path);
+                assert(end.rotation == rotation && end.col == col);
+            }
+        }
+    }
+}
+
+// With a one-column well beside a four-row stack, the best I placement is the tetris.
+static void test_best_path_takes_the_tetris(void) {
+    Engine engine;
+    engine_init(&engine, 1);
+    engine_start(&engine);
+    for (int row = BOARD_HEIGHT - 4; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH - 1; ++col) {
+            engine.board.cells[row][col] = 8;
+        }
+    }
+    engine_spawn_pose(I_PIECE, &engine.active);
+    const FinessePath *path = finesse_best_path(&engine.board, I_PIECE);
+    assert(path != NULL);
+    play_path(&engine, path);
+    engine_hard_drop(&engine);
+    assert(engine.total_lines_cleared == 4);
+
+    assert(finesse_best_path(NULL, I_PIECE) == NULL);
+    assert(finesse_best_path(&engine.board, -1) == NULL);
+}
+
+static void test_tracker_counts_faults(void) {
+    FinesseTracker tracker;
+    finesse_tracker_reset(&tracker);
+    ActivePiece placement = {O_PIECE, 0, 18, 4, true};
+
+    finesse_tracker_input(&tracker, FINESSE_INPUT_RIGHT);
+    assert(finesse_tracker_lock(&tracker, &placement) == 0);
+
+    // Right, left, right: two presses wasted on the same one-column move.
+    finesse_tracker_input(&tracker, FINESSE_INPUT_RIGHT);
+    finesse_tracker_input(&tracker, FINESSE_INPUT_LEFT);
+    finesse_tracker_input(&tracker, FINESSE_INPUT_RIGHT);
+    assert(finesse_tracker_lock(&tracker, &placement) == 2);
+
+    // A soft-dropped piece is not judged.
+    finesse_tracker_input(&tracker, FINESSE_INPUT_SOFT_DROP);
+    finesse_tracker_input(&tracker, FINESSE_INPUT_LEFT);
+    assert(finesse_tracker_lock(&tracker, &placement) == -1);
+
+    assert(tracker.pieces == 3 && tracker.judged == 2);
+    assert(tracker.faults == 1 && tracker.extra_inputs == 2);
+    assert(tracker.last_extra == -1 && tracker.inputs == 0 && !tracker.soft_dropped);
+}
+
+static void test_bulk_matches_streaming(void) {
+    static const int8_t types[] = {O_PIECE, O_PIECE, T_PIECE, I_PIECE, O_PIECE};
+    static const int8_t rotations[] = {0, 0, 3, 1, 2};
+    static const int8_t cols[] = {4, 4, 3, -2, 4};
+    static const int8_t inputs[] = {1, 3, 3, -1, 1};
+    FinesseSummary summary;
+    memset(&summary, 0, sizeof(summary));
+    finesse_analyze(types, rotations, cols, inputs, 5, &summary);
+
+    assert(summary.pieces == 5 && summary.unreachable == 1);
+    assert(summary.judged == 3 && summary.faults == 1 && summary.extra_inputs == 2);
+    int i_cost = finesse_optimal_inputs(I_PIECE, 1, -2);
+    assert(summary.optimal_inputs == (uint64_t)(1 + 1 + 3 + i_cost));
+    assert(summary.optimal_histogram[1] == 2 && summary.optimal_histogram[3] >= 1);
+
+    finesse_analyze(types, rotations, cols, NULL, 5, &summary);
+    assert(summary.pieces == 10 && summary.judged == 3);
+}
+
+int main(void) {
+    run_test("spawn_pose_costs_nothing", test_spawn_pose_costs_nothing);
+    run_test("paths_replay_through_engine", test_paths_replay_through_engine);
+    run_test("best_path_takes_the_tetris", test_best_path_takes_the_tetris);
+    run_test("tracker_counts_faults", test_tracker_counts_faults);
+    run_test("bulk_matches_streaming", test_bulk_matches_streaming);
+    return 0;
+}
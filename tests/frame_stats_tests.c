@@ -0,0 +1,89 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "frame_stats.h"
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static void test_percentiles_empty_window(void) {
+    FrameStats stats;
+    frame_stats_reset(&stats);
+
+    uint64_t p50 = 1;
+    uint64_t p99 = 1;
+    frame_stats_percentiles(&stats, FRAME_PHASE_DRAW, &p50, &p99);
+    assert(p50 == 0);
+    assert(p99 == 0);
+}
+
+static void test_percentiles_nearest_rank(void) {
+    FrameStats stats;
+    frame_stats_reset(&stats);
+
+    for (uint64_t value = 100; value >= 1; --value) {
+        frame_stats_record(&stats, FRAME_PHASE_UPDATE, value);
+    }
+
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    frame_stats_percentiles(&stats, FRAME_PHASE_UPDATE, &p50, &p99);
+    assert(p50 == 50);
+    assert(p99 == 99);
+    assert(frame_stats_sample_count(&stats, FRAME_PHASE_INPUT) == 0);
+}
+
+static void test_window_keeps_latest_samples(void) {
+    FrameStats stats;
+    frame_stats_reset(&stats);
+
+    for (int i = 0; i < FRAME_STATS_WINDOW; ++i) {
+        frame_stats_record(&stats, FRAME_PHASE_LATENCY, 5000);
+    }
+    for (int i = 0; i < FRAME_STATS_WINDOW; ++i) {
+        frame_stats_record(&stats, FRAME_PHASE_LATENCY, 7);
+    }
+
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    frame_stats_percentiles(&stats, FRAME_PHASE_LATENCY, &p50, &p99);
+    assert(frame_stats_sample_count(&stats, FRAME_PHASE_LATENCY) == FRAME_STATS_WINDOW);
+    assert(p50 == 7);
+    assert(p99 == 7);
+}
+
+static void test_trace_writer_emits_json(void) {
+    const char *path = "build/tests/frame_trace.json";
+    remove(path);
+
+    TraceWriter writer;
+    assert(trace_writer_open(&writer, path, 1000) == 0);
+    trace_writer_span(&writer, "frame", 1500, 40);
+    trace_writer_span(&writer, "draw_frame", 1510, 12);
+    trace_writer_close(&writer);
+
+    FILE *fp = fopen(path, "r");
+    assert(fp != NULL);
+    char buffer[512];
+    size_t length = fread(buffer, 1, sizeof(buffer) - 1, fp);
+    buffer[length] = '\0';
+    fclose(fp);
+
+    assert(strncmp(buffer, "{\"traceEvents\":[", 16) == 0);
+    assert(strstr(buffer, "\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":500,\"dur\":40") != NULL);
+    assert(strstr(buffer, "\"ts\":510,\"dur\":12}") != NULL);
+    assert(strstr(buffer, "]") != NULL);
+    remove(path);
+}
+
+int main(void) {
+    run_test("percentiles_empty_window", test_percentiles_empty_window);
+    run_test("percentiles_nearest_rank", test_percentiles_nearest_rank);
+    run_test("window_keeps_latest_samples", test_window_keeps_latest_samples);
+    run_test("trace_writer_emits_json", test_trace_writer_emits_json);
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "grid_view.h"
+#include "term.h"
+
+#define TEAR_PUBLISHES 200000
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+// An engine with no falling piece whose every cell and score are the same value.
+static void fill_engine(Engine *engine, int value) {
+    engine_init(engine, 1);
+    engine_start(engine);
+    engine->active.active = false;
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            engine->board.cells[row][col] = value;
+        }
+    }
+    engine->score.current = (uint64_t)value;
+}
+
+static void test_slot_publish_and_read(void) {
+    static GridSlot slot;
+    grid_slot_init(&slot);
+    assert(grid_slot_wanted(&slot));
+
+    Engine engine;
+    engine_init(&engine, 7);
+    engine_start(&engine);
+    engine.active.row = BOARD_HEIGHT / 2; // spawn rows can lie above the board
+    uint32_t generation = 0;
+    GridBoard board;
+    assert(grid_slot_read(&slot, &generation, &board) == 0);
+
+    grid_slot_publish(&slot, &engine);
+    assert(!grid_slot_wanted(&slot));
+    assert(grid_slot_read(&slot, &generation, &board) == 1 && generation == 1);
+    assert(grid_slot_read(&slot, &generation, &board) == 0);
+
+    // The falling piece is drawn into the cells; the board itself is still empty.
+    int filled = 0;
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            assert(board.cells[row][col] == 0 || board.cells[row][col] == engine.active.type + 1);
+            filled += board.cells[row][col] != 0;
+        }
+    }
+    assert(filled == 4 && board.phase == ENGINE_PHASE_PLAYING);
+
+    // Two more publishes land in alternate buffers; a read sees only the newest.
+    engine.score.current = 50;
+    grid_slot_publish(&slot, &engine);
+    engine.score.current = 60;
+    grid_slot_publish(&slot, &engine);
+    assert(grid_slot_read(&slot, &generation, &board) == 1 && generation == 3 && board.score == 60);
+}
+
+typedef struct {
+    GridSlot *slot;
+    Engine engines[2];
+} Publisher;
+
+static void *publish_flat_out(void *arg) {
+    Publisher *publisher = arg;
+    for (int i = 0; i < TEAR_PUBLISHES; ++i) {
+        grid_slot_publish(publisher->slot, &publisher->engines[i & 1]);
+    }
+    return NULL;
+}
+
+// A writer that ignores requests and reuses each buffer as fast as it can: every read the
+// slot accepts is one whole snapshot, and overlapping reads are reported, never returned.
+static void test_reads_never_tear(void) {
+    static GridSlot slot;
+    static Publisher publisher;
+    grid_slot_init(&slot);
+    publisher.slot = &slot;
+    fill_engine(&publisher.engines[0], 1);
+    fill_engine(&publisher.engines[1], 2);
+
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, publish_flat_out, &publisher) == 0);
+    uint32_t generation = 0;
+    int reads = 0;
+    while (generation < TEAR_PUBLISHES) {
+        GridBoard board;
+        uint32_t previous = generation;
+        int read = grid_slot_read(&slot, &generation, &board);
+        if (read <= 0) {
+            assert(generation == previous);
+            continue;
+        }
+        assert(generation > previous && (board.score == 1 || board.score == 2));
+        for (int row = 0; row < BOARD_HEIGHT; ++row) {
+            for (int col = 0; col < BOARD_WIDTH; ++col) {
+                assert(board.cells[row][col] == board.score);
+            }
+        }
+        ++reads;
+    }
+    pthread_join(thread, NULL);
+    assert(reads > 0);
+}
+
+static void test_image_is_half_height(void) {
+    GridBoard board;
+    memset(&board, 0, sizeof(board));
+    board.cells[0][0] = 1; // top only
+    board.cells[1][1] = 3; // bottom only
+    board.cells[2][2] = 2; // both, top color wins
+    board.cells[3][2] = 5;
+    board.cells[BOARD_HEIGHT - 1][9] = 8; // garbage in the last row
+
+    GridImage image;
+    grid_image_from_board(&board, &image);
+    assert(image.glyphs[0][0] == '\'' && image.colors[0][0] == 1);
+    assert(image.glyphs[0][1] == '.' && image.colors[0][1] == 3);
+    assert(image.glyphs[1][2] == ':' && image.colors[1][2] == 2);
+    assert(image.glyphs[GRID_TILE_ROWS - 1][9] == '.' && image.colors[GRID_TILE_ROWS - 1][9] == 8);
+    assert(image.glyphs[0][2] == ' ' && image.colors[0][2] == 0);
+}
+
+// Tiles draw in full once, then only when due and changed, and only their changed rows.
+static void test_view_redraws_changed_tiles(void) {
+    static GridSlot slots[GRID_MIN_BOARDS];
+    static GridView view;
+    assert(term_init(TERM_BACKEND_NULL) == 0);
+    assert(grid_view_init(&view, slots, GRID_MIN_BOARDS - 1, 100) == -1);
+    assert(grid_view_init(&view, slots, GRID_MAX_BOARDS + 1, 100) == -1);
+    assert(grid_view_init(&view, slots, GRID_MIN_BOARDS, 100) == 0);
+
+    Engine engine;
+    fill_engine(&engine, 0);
+    for (int i = 0; i < GRID_MIN_BOARDS; ++i) {
+        grid_slot_init(&slots[i]);
+        grid_slot_publish(&slots[i], &engine);
+    }
+    assert(grid_view_draw(&view, 0) == GRID_MIN_BOARDS);
+    assert(view.shown == GRID_MIN_BOARDS && view.rows_written == GRID_MIN_BOARDS * GRID_TILE_ROWS);
+
+    // Nothing new: due tiles ask their games for a snapshot instead of drawing.
+    assert(grid_view_draw(&view, 100000) == 0);
+    for (int i = 0; i < GRID_MIN_BOARDS; ++i) {
+        assert(grid_slot_wanted(&slots[i]));
+    }
+
+    // A republished but identical board sends nothing; one changed cell sends one row.
+    grid_slot_publish(&slots[0], &engine);
+    engine.board.cells[BOARD_HEIGHT - 1][4] = 1;
+    grid_slot_publish(&slots[2], &engine);
+    assert(grid_view_draw(&view, 100000) == 1);
+    assert(view.rows_written == GRID_MIN_BOARDS * GRID_TILE_ROWS + 1 && view.tile_redraws == GRID_MIN_BOARDS + 1);
+
+    // Throttled: the tile waits out its interval before showing the next change.
+    engine.board.cells[0][0] = 2;
+    grid_slot_publish(&slots[2], &engine);
+    assert(grid_view_draw(&view, 150000) == 0);
+    assert(grid_view_draw(&view, 200000) == 1);
+    assert(view.torn_reads == 0);
+    term_shutdown();
+}
+
+int main(void) {
+    run_test("slot_publish_and_read", test_slot_publish_and_read);
+    run_test("reads_never_tear", test_reads_never_tear);
+    run_test("image_is_half_height", test_image_is_half_height);
+    run_test("view_redraws_changed_tiles", test_view_redraws_changed_tiles);
+    return 0;
+}
@@ -0,0 +1,194 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "frame_stats.h"
+#include "hint.h"
+
+#define I_PIECE 0
+#define O_PIECE 1
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+// Four full rows except for a well in the rightmost column.
+static void make_well_request(HintRequest *request, uint64_t id) {
+    memset(request, 0, sizeof(*request));
+    for (int row = BOARD_HEIGHT - 4; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH - 1; ++col) {
+            request->board.cells[row][col] = 1;
+        }
+    }
+    request->piece = I_PIECE;
+    request->next = O_PIECE;
+    request->id = id;
+}
+
+// Poll until the worker answers `id`, sleeping between polls; fails after ~10 s.
+static bool wait_for_result(HintWorker *worker, uint64_t id, HintResult *result) {
+    const struct timespec pause = {0, 1000000L};
+    for (int i = 0; i < 10000; ++i) {
+        if (hint_worker_poll(worker, id, result)) {
+            return true;
+        }
+        nanosleep(&pause, NULL);
+    }
+    return false;
+}
+
+static bool clears_four(const HintRequest *request, const ActivePiece *placement) {
+    Board board = request->board;
+    board_lock_shape(&board, piece_shape_get((size_t)placement->type), placement->rotation, placement->row,
+                     placement->col, 1);
+    return board_clear_completed_lines(&board, NULL, 0) == 4;
+}
+
+// Column heights 2,0,3 then empty: one hole under column 0's top, a two-deep well at
+// column 1, and four filled/empty changes along each of the three stack rows.
+static void test_features_count_stack_shape(void) {
+    Board board;
+    memset(&board, 0, sizeof(board));
+    board.cells[BOARD_HEIGHT - 2][0] = 1;
+    for (int row = BOARD_HEIGHT - 3; row < BOARD_HEIGHT; ++row) {
+        board.cells[row][2] = 1;
+    }
+
+    double features[HINT_FEATURE_COUNT];
+    hint_features(&board, 1, features);
+    assert(features[HINT_FEATURE_HEIGHT] == 5);
+    assert(features[HINT_FEATURE_LINES] == 1);
+    assert(features[HINT_FEATURE_HOLES] == 1);
+    assert(features[HINT_FEATURE_BUMPINESS] == 2 + 3 + 3);
+    assert(features[HINT_FEATURE_MAX_HEIGHT] == 3);
+    assert(features[HINT_FEATURE_WELLS] == 2);
+    assert(features[HINT_FEATURE_ROW_TRANSITIONS] == 3 * 4);
+
+    double expected = 0.0;
+    for (int i = 0; i < HINT_FEATURE_COUNT; ++i) {
+        expected += hint_default_weights.weights[i] * features[i];
+    }
+    assert(hint_evaluate(&board, 1) == expected);
+
+    CowRowPool pool;
+    cow_pool_init(&pool, NULL);
+    CowBoard cow;
+    assert(cow_board_from_board(&pool, &cow, &board) == 0);
+    assert(hint_evaluate_cow(&cow, 1) == expected);
+    cow_board_release(&pool, &cow);
+    cow_pool_destroy(&pool);
+}
+
+static void test_search_finds_tetris(void) {
+    HintRequest request;
+    make_well_request(&request, 7);
+    for (int depth = 1; depth <= 2; ++depth) {
+        HintResult result;
+        assert(hint_search(&request, depth, NULL, &result));
+        assert(result.found && result.id == 7);
+        assert(result.placement.type == I_PIECE);
+        assert(clears_four(&request, &result.placement));
+    }
+}
+
+static void test_search_stops_for_newer_request(void) {
+    HintRequest request;
+    make_well_request(&request, 3);
+    _Atomic uint64_t latest = 4;
+    HintResult result;
+    assert(!hint_search(&request, 3, &latest, &result));
+}
+
+static void test_worker_answers_request(void) {
+    static HintWorker worker;
+    assert(hint_worker_start(&worker, 2) == 0);
+    HintResult result;
+    assert(!hint_worker_poll(&worker, 1, &result));
+
+    HintRequest request;
+    make_well_request(&request, 1);
+    hint_worker_post(&worker, &request);
+    assert(wait_for_result(&worker, 1, &result));
+    assert(result.id == 1 && clears_four(&request, &result.placement));
+    hint_worker_stop(&worker);
+}
+
+// With the queue attached, the well plus an I is a known perfect clear and is flagged so.
+static void test_worker_reports_perfect_clear(void) {
+    static HintWorker worker;
+    assert(hint_worker_start(&worker, 1) == 0);
+
+    HintRequest request;
+    make_well_request(&request, 1);
+    request.queue[0] = I_PIECE;
+    request.queue_length = 1;
+    hint_worker_post(&worker, &request);
+    HintResult result;
+    assert(wait_for_result(&worker, 1, &result));
+    assert(result.perfect_clear && clears_four(&request, &result.placement));
+
+    make_well_request(&request, 2);
+    hint_worker_post(&worker, &request);
+    assert(wait_for_result(&worker, 2, &result));
+    assert(!result.perfect_clear);
+    hint_worker_stop(&worker);
+}
+
+// Requests for pieces that have since locked are superseded; only the newest id answers.
+static void test_worker_drops_stale_results(void) {
+    static HintWorker worker;
+    assert(hint_worker_start(&worker, HINT_DEFAULT_DEPTH) == 0);
+
+    HintRequest request;
+    for (uint64_t id = 1; id <= 20; ++id) {
+        make_well_request(&request, id);
+        request.piece = (id == 20) ? I_PIECE : O_PIECE;
+        hint_worker_post(&worker, &request);
+    }
+
+    HintResult result;
+    assert(wait_for_result(&worker, 20, &result));
+    assert(result.placement.type == I_PIECE);
+    for (uint64_t id = 1; id < 20; ++id) {
+        assert(!hint_worker_poll(&worker, id, NULL));
+    }
+    hint_worker_stop(&worker);
+}
+
+// Posting and polling are a copy and an atomic exchange, however deep the search is.
+static void test_post_and_poll_never_wait(void) {
+    static HintWorker worker;
+    assert(hint_worker_start(&worker, HINT_MAX_DEPTH) == 0);
+
+    HintRequest request;
+    make_well_request(&request, 0);
+    uint64_t slowest = 0;
+    for (uint64_t id = 1; id <= 2000; ++id) {
+        request.id = id;
+        uint64_t start = frame_stats_now_us();
+        hint_worker_post(&worker, &request);
+        (void)hint_worker_poll(&worker, id, NULL);
+        uint64_t elapsed = frame_stats_now_us() - start;
+        if (elapsed > slowest) {
+            slowest = elapsed;
+        }
+    }
+    assert(slowest < 5000);
+    hint_worker_stop(&worker);
+}
+
+int main(void) {
+    run_test("features_count_stack_shape", test_features_count_stack_shape);
+    run_test("search_finds_tetris", test_search_finds_tetris);
+    run_test("search_stops_for_newer_request", test_search_stops_for_newer_request);
+    run_test("worker_answers_request", test_worker_answers_request);
+    run_test("worker_reports_perfect_clear", test_worker_reports_perfect_clear);
+    run_test("worker_drops_stale_results", test_worker_drops_stale_results);
+    run_test("post_and_poll_never_wait", test_post_and_poll_never_wait);
+    return 0;
+}
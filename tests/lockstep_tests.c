@@ -0,0 +1,171 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "lockstep.h"
+#include "replay_corpus.h"
+
+#define MAX_SESSION_FRAMES 20000
+
+static LockstepBatch g_batch;
+static Engine g_reference[LOCKSTEP_MAX_LANES];
+static uint8_t g_scripts[LOCKSTEP_MAX_LANES][MAX_SESSION_FRAMES];
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static uint64_t next_random(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// The lane's game must be byte for byte the reference engine's, analytics included.
+static void assert_lane_matches(LockstepBatch *batch, int lane, const Engine *reference) {
+    const Engine *engine = lockstep_engine(batch, lane);
+    EngineSnapshot snapshot;
+    unsigned char actual[ENGINE_SNAPSHOT_ENCODED_SIZE];
+    unsigned char expected[ENGINE_SNAPSHOT_ENCODED_SIZE];
+    engine_snapshot(engine, &snapshot);
+    assert(engine_snapshot_encode(&snapshot, actual, sizeof(actual)) == sizeof(actual));
+    engine_snapshot(reference, &snapshot);
+    assert(engine_snapshot_encode(&snapshot, expected, sizeof(expected)) == sizeof(expected));
+    assert(memcmp(actual, expected, sizeof(actual)) == 0);
+}
+
+static int kernel_count(LockstepKernel kernels[2]) {
+    kernels[0] = LOCKSTEP_KERNEL_SCALAR;
+    kernels[1] = LOCKSTEP_KERNEL_AVX2;
+    return lockstep_avx2_supported() ? 2 : 1;
+}
+
+// Every corpus session in its own lane, stopped when its script ends, plays exactly as
+// recorded on both kernels.
+static void test_corpus_matches_recording(void) {
+    int lanes = replay_corpus_count;
+    assert(lanes <= LOCKSTEP_MAX_LANES);
+    int lengths[LOCKSTEP_MAX_LANES];
+    int longest = 0;
+    for (int lane = 0; lane < lanes; ++lane) {
+        lengths[lane] = perf_script_decode(replay_corpus[lane].script, g_scripts[lane], MAX_SESSION_FRAMES);
+        assert(lengths[lane] > 0);
+        longest = (lengths[lane] > longest) ? lengths[lane] : longest;
+    }
+
+    LockstepKernel kernels[2];
+    for (int k = 0; k < kernel_count(kernels); ++k) {
+        assert(lockstep_init(&g_batch, lanes, kernels[k]) == 0);
+        assert(g_batch.kernel == kernels[k]);
+        for (int lane = 0; lane < lanes; ++lane) {
+            lockstep_start(&g_batch, lane, replay_corpus[lane].seed);
+        }
+        uint8_t keys[LOCKSTEP_MAX_LANES];
+        for (int frame = 0; frame < longest; ++frame) {
+            for (int lane = 0; lane < lanes; ++lane) {
+                if (frame == lengths[lane]) {
+                    lockstep_stop(&g_batch, lane);
+                }
+                keys[lane] = (frame < lengths[lane]) ? g_scripts[lane][frame] : PERF_KEY_IDLE;
+            }
+            lockstep_step(&g_batch, keys, PERF_FRAME_MS);
+        }
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            const ReplaySession *session = &replay_corpus[lane];
+            PerfSessionResult result;
+            lockstep_result(&g_batch, lane, &result);
+            assert(result.frames == session->frames && result.pieces == session->pieces);
+            assert(result.lines == session->lines && result.score == session->score);
+            assert(result.topped_out == session->topped_out);
+        }
+    }
+}
+
+// Random keys on 32 and 13 lanes (a partial vector), at levels up to 20G and at frame
+// times from 1 ms to past the lock delay, checked against separate engines every frame.
+static void test_random_keys_match_engines(void) {
+    static const int k_lanes[] = {LOCKSTEP_MAX_LANES, 13};
+    static const uint64_t k_frame_ms[] = {16, 1, 45, 600};
+    LockstepKernel kernels[2];
+    for (int k = 0; k < kernel_count(kernels); ++k) {
+        for (size_t l = 0; l < sizeof(k_lanes) / sizeof(k_lanes[0]); ++l) {
+            for (size_t f = 0; f < sizeof(k_frame_ms) / sizeof(k_frame_ms[0]); ++f) {
+                int lanes = k_lanes[l];
+                assert(lockstep_init(&g_batch, lanes, kernels[k]) == 0);
+                for (int lane = 0; lane < lanes; ++lane) {
+                    uint64_t seed = 1000 + (uint64_t)lane * 7919;
+                    int level = 1 + (lane * 3) % 24;
+                    lockstep_start(&g_batch, lane, seed);
+                    lockstep_set_level(&g_batch, lane, level);
+                    perf_engine_start(&g_reference[lane], seed);
+                    engine_set_level(&g_reference[lane], level);
+                }
+
+                uint64_t rng = 0x5DEECE66DULL + f;
+                uint8_t keys[LOCKSTEP_MAX_LANES];
+                int playing = lanes;
+                for (int frame = 0; frame < 1500 && playing > 0; ++frame) {
+                    for (int lane = 0; lane < lanes; ++lane) {
+                        // Mostly idle and moves, a hard drop now and then.
+                        uint64_t roll = next_random(&rng) % 64;
+                        keys[lane] = (roll < 30) ? PERF_KEY_IDLE : (roll == 63) ? PERF_KEY_HARD_DROP
+                                                                                : (uint8_t)(1 + roll % 4);
+                        if (g_reference[lane].phase == ENGINE_PHASE_PLAYING) {
+                            perf_engine_step(&g_reference[lane], (PerfKey)keys[lane], k_frame_ms[f]);
+                        }
+                    }
+                    playing = lockstep_step(&g_batch, keys, k_frame_ms[f]);
+                    int expected = 0;
+                    for (int lane = 0; lane < lanes; ++lane) {
+                        expected += g_reference[lane].phase == ENGINE_PHASE_PLAYING;
+                        if (frame % 97 == 0 || g_reference[lane].phase != ENGINE_PHASE_PLAYING) {
+                            assert_lane_matches(&g_batch, lane, &g_reference[lane]);
+                        }
+                    }
+                    assert(playing == expected);
+                }
+                for (int lane = 0; lane < lanes; ++lane) {
+                    assert_lane_matches(&g_batch, lane, &g_reference[lane]);
+                }
+            }
+        }
+    }
+}
+
+static void test_stop_masks_lane(void) {
+    assert(lockstep_init(&g_batch, 0, LOCKSTEP_KERNEL_SCALAR) == -1);
+    assert(lockstep_init(&g_batch, LOCKSTEP_MAX_LANES + 1, LOCKSTEP_KERNEL_SCALAR) == -1);
+    assert(lockstep_init(&g_batch, 3, LOCKSTEP_KERNEL_AUTO) == 0);
+    assert(g_batch.kernel == (lockstep_avx2_supported() ? LOCKSTEP_KERNEL_AVX2 : LOCKSTEP_KERNEL_SCALAR));
+
+    uint8_t keys[3] = {PERF_KEY_IDLE, PERF_KEY_IDLE, PERF_KEY_IDLE};
+    assert(lockstep_step(&g_batch, keys, PERF_FRAME_MS) == 0);
+    assert(lockstep_step(&g_batch, NULL, PERF_FRAME_MS) == -1);
+    for (int lane = 0; lane < 3; ++lane) {
+        lockstep_start(&g_batch, lane, 5);
+    }
+    assert(lockstep_step(&g_batch, keys, PERF_FRAME_MS) == 3);
+    lockstep_stop(&g_batch, 1);
+    for (int frame = 0; frame < 9; ++frame) {
+        assert(lockstep_step(&g_batch, keys, PERF_FRAME_MS) == 2);
+    }
+    assert(g_batch.frames[0] == 10 && g_batch.frames[1] == 1);
+    assert(lockstep_engine(&g_batch, 1)->stats.play_ms == PERF_FRAME_MS);
+    assert(lockstep_engine(&g_batch, 0)->stats.play_ms == 10 * PERF_FRAME_MS);
+
+    lockstep_start(&g_batch, 1, 5);
+    assert(lockstep_step(&g_batch, keys, PERF_FRAME_MS) == 3);
+    assert(g_batch.frames[1] == 1);
+    assert(lockstep_engine(&g_batch, 3) == NULL);
+}
+
+int main(void) {
+    run_test("corpus_matches_recording", test_corpus_matches_recording);
+    run_test("random_keys_match_engines", test_random_keys_match_engines);
+    run_test("stop_masks_lane", test_stop_masks_lane);
+    return 0;
+}
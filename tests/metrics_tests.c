@@ -0,0 +1,139 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "board.h"
+#include "metrics.h"
+#include "piece.h"
+
+#define WORKER_COUNT 4
+#define WORKER_INCREMENTS 100000
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static void *increment_worker(void *arg) {
+    (void)arg;
+    for (int i = 0; i < WORKER_INCREMENTS; ++i) {
+        metrics_inc(METRIC_FRAMES_RENDERED);
+    }
+    return NULL;
+}
+
+static void test_blocks_are_cache_line_padded(void) {
+    assert(sizeof(MetricsBlock) % METRICS_CACHE_LINE == 0);
+    MetricsBlock *block = metrics_claim_block();
+    assert(block == metrics_claim_block());
+    assert(((uintptr_t)block % METRICS_CACHE_LINE) == 0);
+}
+
+static void test_threads_aggregate(void) {
+    uint64_t before[METRIC_COUNT];
+    metrics_snapshot(before);
+
+    pthread_t threads[WORKER_COUNT];
+    for (int i = 0; i < WORKER_COUNT; ++i) {
+        assert(pthread_create(&threads[i], NULL, increment_worker, NULL) == 0);
+    }
+    for (int i = 0; i < WORKER_COUNT; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    uint64_t after[METRIC_COUNT];
+    metrics_snapshot(after);
+    assert(after[METRIC_FRAMES_RENDERED] - before[METRIC_FRAMES_RENDERED] ==
+           (uint64_t)WORKER_COUNT * WORKER_INCREMENTS);
+}
+
+static void *claim_worker(void *arg) {
+    bool *shared = arg;
+    metrics_inc(METRIC_SCORE_SAVES);
+    *shared = metrics_claim_block()->shared;
+    return NULL;
+}
+
+// Far more short-lived threads than blocks: each exited thread's block goes to the next,
+// so none falls back to the shared overflow block and no count is lost.
+static void test_exited_threads_return_blocks(void) {
+    uint64_t before[METRIC_COUNT];
+    metrics_snapshot(before);
+
+    for (int i = 0; i < METRICS_MAX_BLOCKS * 4; ++i) {
+        pthread_t thread;
+        bool shared = true;
+        assert(pthread_create(&thread, NULL, claim_worker, &shared) == 0);
+        pthread_join(thread, NULL);
+        assert(!shared);
+    }
+
+    uint64_t after[METRIC_COUNT];
+    metrics_snapshot(after);
+    assert(after[METRIC_SCORE_SAVES] - before[METRIC_SCORE_SAVES] == (uint64_t)METRICS_MAX_BLOCKS * 4);
+}
+
+static void test_board_counts_collision_checks(void) {
+    uint64_t before[METRIC_COUNT];
+    metrics_snapshot(before);
+
+    Board board;
+    board_reset(&board);
+    const PieceShape *shape = piece_shape_get(0);
+    assert(board_can_place(&board, shape, 0, 0, 3));
+    assert(!board_can_place(&board, shape, 0, 0, -1));
+
+    uint64_t after[METRIC_COUNT];
+    metrics_snapshot(after);
+    assert(after[METRIC_COLLISION_CHECKS] - before[METRIC_COLLISION_CHECKS] == 2);
+}
+
+static void test_clear_buckets(void) {
+    uint64_t before[METRIC_COUNT];
+    metrics_snapshot(before);
+
+    metrics_record_clear(1);
+    metrics_record_clear(4);
+    metrics_record_clear(4);
+    metrics_record_clear(0);
+
+    uint64_t after[METRIC_COUNT];
+    metrics_snapshot(after);
+    assert(after[METRIC_CLEARS_SINGLE] - before[METRIC_CLEARS_SINGLE] == 1);
+    assert(after[METRIC_CLEARS_DOUBLE] - before[METRIC_CLEARS_DOUBLE] == 0);
+    assert(after[METRIC_CLEARS_TETRIS] - before[METRIC_CLEARS_TETRIS] == 2);
+}
+
+static void test_stats_file_prometheus_format(void) {
+    const char *path = "build/tests/metrics.prom";
+    remove(path);
+
+    metrics_inc(METRIC_PIECES_LOCKED);
+    assert(metrics_write_stats_file(path) == 0);
+
+    FILE *fp = fopen(path, "r");
+    assert(fp != NULL);
+    char buffer[4096];
+    size_t length = fread(buffer, 1, sizeof(buffer) - 1, fp);
+    buffer[length] = '\0';
+    fclose(fp);
+
+    assert(strstr(buffer, "# TYPE tetris_pieces_locked_total counter\n") != NULL);
+    assert(strstr(buffer, "\ntetris_line_clears_total{lines=\"4\"} ") != NULL);
+    char *first_type = strstr(buffer, "# TYPE tetris_line_clears_total");
+    assert(first_type != NULL);
+    assert(strstr(first_type + 1, "# TYPE tetris_line_clears_total") == NULL);
+    remove(path);
+}
+
+int main(void) {
+    run_test("blocks_are_cache_line_padded", test_blocks_are_cache_line_padded);
+    run_test("threads_aggregate", test_threads_aggregate);
+    run_test("exited_threads_return_blocks", test_exited_threads_return_blocks);
+    run_test("board_counts_collision_checks", test_board_counts_collision_checks);
+    run_test("clear_buckets", test_clear_buckets);
+    run_test("stats_file_prometheus_format", test_stats_file_prometheus_format);
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "perf_suite.h"
+#include "replay_corpus.h"
+
+#define MAX_SESSION_FRAMES 20000
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static void temp_path(char *out, size_t capacity, const char *tag) {
+    snprintf(out, capacity, "/tmp/tetris_perf_suite_%s_%ld.txt", tag, (long)getpid());
+}
+
+static void test_script_round_trip(void) {
+    uint8_t keys[64];
+    assert(perf_script_decode("LLR3.UH12DH", keys, sizeof(keys)) == 21);
+    static const uint8_t k_expected[] = {PERF_KEY_LEFT, PERF_KEY_LEFT, PERF_KEY_RIGHT, PERF_KEY_IDLE, PERF_KEY_IDLE,
+                                         PERF_KEY_IDLE, PERF_KEY_ROTATE, PERF_KEY_HARD_DROP};
+    assert(memcmp(keys, k_expected, sizeof(k_expected)) == 0);
+    assert(keys[8] == PERF_KEY_SOFT_DROP && keys[19] == PERF_KEY_SOFT_DROP && keys[20] == PERF_KEY_HARD_DROP);
+
+    char script[64];
+    assert(perf_script_encode(keys, 21, script, sizeof(script)) == 11);
+    assert(strcmp(script, "LLR3.UH12DH") == 0);
+    assert(perf_script_encode(keys, 21, script, 11) == -1);
+
+    assert(perf_script_decode("", keys, sizeof(keys)) == 0);
+    assert(perf_script_decode("LX", keys, sizeof(keys)) == -1);
+    assert(perf_script_decode("0L", keys, sizeof(keys)) == -1);
+    assert(perf_script_decode("12", keys, sizeof(keys)) == -1);
+    assert(perf_script_decode("65.", keys, sizeof(keys)) == -1);
+    assert(perf_key_term_code(PERF_KEY_IDLE) == -1);
+}
+
+// Every checked-in session decodes and plays on a bare engine exactly as recorded, and
+// replaying it twice gives the same game.
+static void test_corpus_replays_as_recorded(void) {
+    static uint8_t keys[MAX_SESSION_FRAMES];
+    int bots = 0;
+    int top_outs = 0;
+    for (int s = 0; s < replay_corpus_count; ++s) {
+        const ReplaySession *session = &replay_corpus[s];
+        int count = perf_script_decode(session->script, keys, sizeof(keys));
+        assert(count > 0);
+        PerfSessionResult first;
+        PerfSessionResult second;
+        assert(perf_replay_engine(session->seed, keys, (size_t)count, PERF_FRAME_MS, &first) == 0);
+        assert(perf_replay_engine(session->seed, keys, (size_t)count, PERF_FRAME_MS, &second) == 0);
+        assert(first.frames == second.frames && first.score == second.score);
+        assert(first.frames == session->frames && first.pieces == session->pieces);
+        assert(first.lines == session->lines && first.score == session->score);
+        assert(first.topped_out == session->topped_out);
+        bots += strncmp(session->name, "bot_", 4) == 0 && session->lines > 0;
+        top_outs += session->topped_out;
+    }
+    assert(bots >= 1 && top_outs >= 1);
+}
+
+static void test_sample_statistics(void) {
+    const double values[] = {10.0, 12.0, 14.0, 16.0, 18.0};
+    PerfSample sample;
+    perf_sample_from_runs(values, 5, &sample);
+    assert(sample.count == 5 && sample.mean == 14.0);
+    assert(fabs(sample.stddev - sqrt(10.0)) < 1e-12);
+    assert(fabs(perf_sample_interval(&sample) - 2.776 * sqrt(10.0) / sqrt(5.0)) < 1e-9);
+
+    perf_sample_from_runs(values, 1, &sample);
+    assert(sample.stddev == 0.0 && perf_sample_interval(&sample) == 0.0);
+    assert(perf_t_critical(1.0) > 12.0 && perf_t_critical(30.0) < 2.05);
+    assert(perf_t_critical(1000.0) > 1.96 && perf_t_critical(1000.0) < 1.97);
+}
+
+static void test_compare_needs_significance(void) {
+    PerfSample baseline = {5, 1000.0, 10.0};
+    PerfVerdict verdict;
+
+    // A 10% drop with tight runs is a regression.
+    PerfSample slower = {5, 900.0, 10.0};
+    perf_compare(PERF_METRIC_PIECES_PER_SEC, &baseline, &slower, 0.03, &verdict);
+    assert(verdict.regressed && fabs(verdict.change + 0.10) < 1e-12);
+
+    // The same drop inside very noisy runs is not.
+    PerfSample noisy = {5, 900.0, 200.0};
+    perf_compare(PERF_METRIC_PIECES_PER_SEC, &baseline, &noisy, 0.03, &verdict);
+    assert(!verdict.regressed && verdict.noise > 0.10);
+
+    // A significant drop smaller than the tolerance is not either.
+    PerfSample slightly = {5, 980.0, 1.0};
+    PerfSample tight = {5, 1000.0, 1.0};
+    perf_compare(PERF_METRIC_FRAMES_PER_SEC, &tight, &slightly, 0.03, &verdict);
+    assert(!verdict.regressed);
+    perf_compare(PERF_METRIC_FRAMES_PER_SEC, &tight, &slightly, 0.01, &verdict);
+    assert(verdict.regressed);
+
+    // Faster is never a regression; for allocations, more is worse.
+    perf_compare(PERF_METRIC_PIECES_PER_SEC, &slower, &baseline, 0.03, &verdict);
+    assert(!verdict.regressed && verdict.change > 0.0);
+    PerfSample none = {5, 0.0, 0.0};
+    PerfSample some = {5, 2.0, 0.0};
+    perf_compare(PERF_METRIC_ALLOCS_PER_GAME, &none, &some, 0.03, &verdict);
+    assert(verdict.regressed);
+    perf_compare(PERF_METRIC_ALLOCS_PER_GAME, &some, &none, 0.03, &verdict);
+    assert(!verdict.regressed);
+}
+
+static void test_baseline_round_trip(void) {
+    char path[64];
+    temp_path(path, sizeof(path), "baseline");
+    PerfBaseline saved = {{12, 61234, 5017}, {{5, 5890.25, 35.5}, {5, 61921.125, 370.75}, {5, 0.0, 0.0}}};
+    assert(perf_baseline_save(&saved, path) == 0);
+    PerfBaseline loaded;
+    assert(perf_baseline_load(&loaded, path) == 0);
+    assert(perf_corpus_equal(&loaded.corpus, &saved.corpus));
+    PerfCorpus other = saved.corpus;
+    other.pieces++;
+    assert(!perf_corpus_equal(&loaded.corpus, &other));
+    for (int m = 0; m < PERF_METRIC_COUNT; ++m) {
+        assert(loaded.metrics[m].count == saved.metrics[m].count);
+        assert(loaded.metrics[m].mean == saved.metrics[m].mean);
+        assert(loaded.metrics[m].stddev == saved.metrics[m].stddev);
+    }
+
+    FILE *fp = fopen(path, "w");
+    assert(fp != NULL);
+    fprintf(fp, "%s %d\ncorpus 12 61234 5017\npieces_per_sec 5 1 0\n", PERF_BASELINE_MAGIC, PERF_BASELINE_VERSION);
+    fclose(fp);
+    assert(perf_baseline_load(&loaded, path) == -1);
+
+    // A baseline that does not say which corpus it was measured on is not usable.
+    fp = fopen(path, "w");
+    assert(fp != NULL);
+    fprintf(fp, "%s %d\n", PERF_BASELINE_MAGIC, PERF_BASELINE_VERSION);
+    for (int m = 0; m < PERF_METRIC_COUNT; ++m) {
+        fprintf(fp, "%s 5 1 0\n", perf_metric_name((PerfMetric)m));
+    }
+    fclose(fp);
+    assert(perf_baseline_load(&loaded, path) == -1);
+    unlink(path);
+    assert(perf_baseline_load(&loaded, path) == -1);
+}
+
+int main(void) {
+    run_test("script_round_trip", test_script_round_trip);
+    run_test("corpus_replays_as_recorded", test_corpus_replays_as_recorded);
+    run_test("sample_statistics", test_sample_statistics);
+    run_test("compare_needs_significance", test_compare_needs_significance);
+    run_test("baseline_round_trip", test_baseline_round_trip);
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bag.h"
+#include "board.h"
+#include "engine.h"
+#include "perfect_clear.h"
+#include "perft.h"
+
+#define I_PIECE 0
+#define O_PIECE 1
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+// The first ten pieces of a seeded seven-bag, as a fresh game would deal them.
+static void seeded_queue(uint64_t seed, int *queue) {
+    PieceBag bag;
+    piece_bag_seed(&bag, piece_shape_count(), seed);
+    piece_bag_generate(&bag, queue, PC_MAX_PIECES);
+}
+
+// Play the solution through the board code: every placement must be one perft_generate
+// reaches, and the last one must leave the board empty.
+static bool replays_to_empty(const Board *start, const int *queue, const PcSolution *solution) {
+    Board board = *start;
+    for (int i = 0; i < solution->pieces; ++i) {
+        const ActivePiece *placement = &solution->placements[i];
+        if (placement->type != queue[i]) {
+            return false;
+        }
+        ActivePiece reachable[PERFT_MAX_PLACEMENTS];
+        int count = perft_generate(&board, queue[i], reachable, PERFT_MAX_PLACEMENTS);
+        bool found = false;
+        for (int j = 0; j < count && !found; ++j) {
+            found = reachable[j].rotation == placement->rotation && reachable[j].row == placement->row &&
+                    reachable[j].col == placement->col;
+        }
+        if (!found) {
+            return false;
+        }
+        board_lock_shape(&board, piece_shape_get((size_t)queue[i]), placement->rotation, placement->row,
+                         placement->col, queue[i] + 1);
+        board_clear_completed_lines(&board, NULL, 0);
+    }
+    return board_is_empty(&board);
+}
+
+static void test_single_piece_fills_well(void) {
+    Board board;
+    board_reset(&board);
+    for (int row = BOARD_HEIGHT - 4; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH - 1; ++col) {
+            board.cells[row][col] = 1;
+        }
+    }
+    PcSolver solver;
+    assert(pc_solver_init(&solver, 1, 0) == 0);
+
+    int queue[] = {I_PIECE};
+    PcSolution solution;
+    assert(pc_solve(&solver, &board, queue, 1, &solution));
+    assert(solution.pieces == 1);
+    assert(replays_to_empty(&board, queue, &solution));
+
+    queue[0] = O_PIECE;
+    assert(!pc_solve(&solver, &board, queue, 1, &solution));
+    pc_solver_free(&solver);
+}
+
+static void test_solves_seeded_openings(void) {
+    PcSolver solver;
+    assert(pc_solver_init(&solver, 1, 0) == 0);
+    Board board;
+    board_reset(&board);
+    static const uint64_t seeds[] = {1, 2};
+    for (size_t s = 0; s < sizeof(seeds) / sizeof(seeds[0]); ++s) {
+        int queue[PC_MAX_PIECES];
+        seeded_queue(seeds[s], queue);
+        PcSolution solution;
+        assert(pc_solve(&solver, &board, queue, PC_MAX_PIECES, &solution));
+        assert(solution.pieces == 5 || solution.pieces == PC_MAX_PIECES);
+        assert(replays_to_empty(&board, queue, &solution));
+        assert(solver.nodes > 0);
+    }
+    pc_solver_free(&solver);
+}
+
+static void test_rejects_unreachable_positions(void) {
+    PcSolver solver;
+    assert(pc_solver_init(&solver, 1, 0) == 0);
+    int queue[PC_MAX_PIECES];
+    seeded_queue(1, queue);
+    PcSolution solution;
+
+    // A cell above the bottom four rows can never be cleared within the field.
+    Board board;
+    board_reset(&board);
+    board.cells[BOARD_HEIGHT - 1 - PC_MAX_HEIGHT][0] = 1;
+    assert(!pc_solve(&solver, &board, queue, PC_MAX_PIECES, &solution));
+
+    // An empty board needs at least five pieces.
+    board_reset(&board);
+    assert(!pc_solve(&solver, &board, queue, 4, &solution));
+    assert(!pc_solve(&solver, &board, queue, 0, &solution));
+    pc_solver_free(&solver);
+}
+
+// Threads race for the roots, but the lowest solved root always wins.
+static void test_threads_agree_with_serial(void) {
+    int queue[PC_MAX_PIECES];
+    seeded_queue(2, queue);
+    Board board;
+    board_reset(&board);
+
+    PcSolver serial;
+    PcSolver parallel;
+    assert(pc_solver_init(&serial, 1, 0) == 0);
+    assert(pc_solver_init(&parallel, 4, 0) == 0);
+    PcSolution expected;
+    PcSolution solution;
+    assert(pc_solve(&serial, &board, queue, PC_MAX_PIECES, &expected));
+    for (int run = 0; run < 3; ++run) {
+        assert(pc_solve(&parallel, &board, queue, PC_MAX_PIECES, &solution));
+        assert(memcmp(&solution, &expected, sizeof(solution)) == 0);
+    }
+    pc_solver_free(&serial);
+    pc_solver_free(&parallel);
+}
+
+static void test_node_budget_gives_up(void) {
+    int queue[PC_MAX_PIECES];
+    seeded_queue(2, queue);
+    Board board;
+    board_reset(&board);
+
+    PcSolver solver;
+    assert(pc_solver_init(&solver, 1, 10) == 0);
+    PcSolution solution;
+    assert(!pc_solve(&solver, &board, queue, PC_MAX_PIECES, &solution));
+    assert(solver.nodes < 1000);
+    pc_solver_free(&solver);
+}
+
+// A solve whose request has been replaced stops at the next node batch, like the budget.
+static void test_stale_request_gives_up(void) {
+    int queue[PC_MAX_PIECES];
+    seeded_queue(2, queue);
+    Board board;
+    board_reset(&board);
+
+    PcSolver solver;
+    assert(pc_solver_init(&solver, 1, 0) == 0);
+    _Atomic uint64_t latest_id = 7;
+    solver.latest_id = &latest_id;
+    solver.id = 6;
+    PcSolution solution;
+    assert(!pc_solve(&solver, &board, queue, PC_MAX_PIECES, &solution));
+    assert(solver.nodes < 1000);
+
+    solver.id = 7;
+    assert(pc_solve(&solver, &board, queue, PC_MAX_PIECES, &solution));
+    pc_solver_free(&solver);
+}
+
+static void test_queue_from_engine(void) {
+    Engine engine;
+    engine_init(&engine, 5);
+    engine_start(&engine);
+
+    int queue[PC_MAX_PIECES];
+    assert(pc_queue_from_engine(&engine, queue, PC_MAX_PIECES) == PC_MAX_PIECES);
+    assert(queue[0] == engine.active.type && queue[1] == engine.next_piece_type);
+    int upcoming[PC_MAX_PIECES - 2];
+    piece_bag_peek(&engine.bag, upcoming, PC_MAX_PIECES - 2);
+    assert(memcmp(queue + 2, upcoming, sizeof(upcoming)) == 0);
+
+    engine.active.active = false;
+    assert(pc_queue_from_engine(&engine, queue, PC_MAX_PIECES) == 0);
+}
+
+int main(void) {
+    run_test("single_piece_fills_well", test_single_piece_fills_well);
+    run_test("solves_seeded_openings", test_solves_seeded_openings);
+    run_test("rejects_unreachable_positions", test_rejects_unreachable_positions);
+    run_test("threads_agree_with_serial", test_threads_agree_with_serial);
+    run_test("node_budget_gives_up", test_node_budget_gives_up);
+    run_test("stale_request_gives_up", test_stale_request_gives_up);
+    run_test("queue_from_engine", test_queue_from_engine);
+    return 0;
+}
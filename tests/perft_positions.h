@@ -0,0 +1,58 @@
+#ifndef PERFT_POSITIONS_H
+#define PERFT_POSITIONS_H
+
+#include <stdint.h>
+
+#include "board.h"
+
+// Reference positions for perft: the bottom rows of the board ('#' filled, '.' empty),
+// a piece sequence (I=0 O=1 T=2 L=3 J=4 S=5 Z=6), and expected node counts per depth
+// without and with transposition merging. Shared by tests/perft_tests.c and the
+// perft_bench tool. Depth-1 counts on the empty board are the columns each rotation fits
+// (34 for T, 9 for O); the rest were recorded from perft_generate and pin its output.
+
+#define PERFT_POSITION_MAX_ROWS 8
+#define PERFT_POSITION_MAX_DEPTH 4
+
+typedef struct {
+    const char *name;
+    const char *rows[PERFT_POSITION_MAX_ROWS];
+    int pieces[PERFT_POSITION_MAX_DEPTH];
+    int depth;
+    uint64_t expected[PERFT_POSITION_MAX_DEPTH];
+    uint64_t expected_dedupe[PERFT_POSITION_MAX_DEPTH];
+} PerftPosition;
+
+static const PerftPosition perft_positions[] = {
+    {"empty_TIOL", {NULL}, {2, 0, 1, 3}, 3, {34, 596, 5542, 0}, {34, 596, 5542, 0}},
+    {"empty_OOO", {NULL}, {1, 1, 1}, 3, {9, 81, 741, 0}, {9, 53, 260, 0}},
+    {"stairs_TIO",
+     {"......####", "#.....####", "##...#####", "###.######", NULL},
+     {2, 0, 1}, 3, {34, 595, 5646, 0}, {34, 595, 5646, 0}},
+    {"well_III",
+     {"#########.", "#########.", "#########.", "#########.", NULL},
+     {0, 0, 0}, 3, {17, 289, 5043, 0}, {17, 196, 1988, 0}},
+    {"overhang_ZST",
+     {"###.......", "#.........", "#.######.#", NULL},
+     {6, 5, 2}, 3, {17, 308, 11289, 0}, {17, 308, 11289, 0}}
+};
+
+static const int perft_position_count = (int)(sizeof(perft_positions) / sizeof(perft_positions[0]));
+
+static inline void perft_position_board(const PerftPosition *position, Board *board) {
+    board_reset(board);
+
+    int count = 0;
+    while (count < PERFT_POSITION_MAX_ROWS && position->rows[count] != NULL) {
+        ++count;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        int row = BOARD_HEIGHT - count + i;
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            board->cells[row][col] = (position->rows[i][col] == '#') ? 8 : 0;
+        }
+    }
+}
+
+#endif /* PERFT_POSITIONS_H */
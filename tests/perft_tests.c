@@ -0,0 +1,145 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "board.h"
+#include "engine.h"
+#include "perft.h"
+#include "perft_positions.h"
+#include "piece.h"
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static void test_empty_board_single_piece_counts(void) {
+    // I, O, T, L, J, S, Z: one lock position per rotation/column on an empty board.
+    static const int expected[] = {17, 9, 34, 34, 34, 17, 17};
+    Board board;
+    board_reset(&board);
+
+    for (int type = 0; type < (int)piece_shape_count(); ++type) {
+        assert(perft(&board, &type, 1, false) == (uint64_t)expected[type]);
+    }
+}
+
+static void test_generated_placements_are_resting(void) {
+    Board board;
+    perft_position_board(&perft_positions[2], &board);
+
+    for (int type = 0; type < (int)piece_shape_count(); ++type) {
+        ActivePiece placements[PERFT_MAX_PLACEMENTS];
+        int count = perft_generate(&board, type, placements, PERFT_MAX_PLACEMENTS);
+        assert(count > 0);
+
+        const PieceShape *shape = piece_shape_get((size_t)type);
+        for (int i = 0; i < count; ++i) {
+            const ActivePiece *p = &placements[i];
+            assert(board_can_place(&board, shape, p->rotation, p->row, p->col));
+            assert(!board_can_place(&board, shape, p->rotation, p->row + 1, p->col));
+            for (int j = 0; j < i; ++j) {
+                assert(placements[j].rotation != p->rotation || placements[j].row != p->row ||
+                       placements[j].col != p->col);
+            }
+        }
+    }
+}
+
+static void test_tuck_reaches_under_overhang(void) {
+    // A flat I can only reach the slot under the left overhang by sliding sideways at the
+    // bottom, which a hard-drop-only generator would miss.
+    Board board;
+    perft_position_board(&perft_positions[4], &board);
+    ActivePiece placements[PERFT_MAX_PLACEMENTS];
+    int count = perft_generate(&board, 0, placements, PERFT_MAX_PLACEMENTS);
+
+    bool tucked = false;
+    const PieceShape *shape = piece_shape_get(0);
+    for (int i = 0; i < count; ++i) {
+        if (!board_can_place(&board, shape, placements[i].rotation, -2, placements[i].col)) {
+            continue;
+        }
+        int drop_row = -2;
+        while (board_can_place(&board, shape, placements[i].rotation, drop_row + 1, placements[i].col)) {
+            ++drop_row;
+        }
+        if (drop_row != placements[i].row) {
+            tucked = true;
+        }
+    }
+    assert(tucked);
+}
+
+static void test_piece_above_board_stays_inside_walls(void) {
+    // Regression: cells above row 0 used to skip the side-wall test, letting a freshly
+    // spawned piece slide off the board.
+    Board board;
+    board_reset(&board);
+    for (int type = 0; type < (int)piece_shape_count(); ++type) {
+        const PieceShape *shape = piece_shape_get((size_t)type);
+        ActivePiece piece;
+        engine_spawn_pose(type, &piece);
+        piece.row = -shape->size;
+        while (board_try_move_piece(&board, &piece, 0, -1)) {
+        }
+        for (int rotation = 0; rotation < shape->rotation_count; ++rotation) {
+            assert(!board_can_place(&board, shape, rotation, -shape->size, -shape->size));
+            assert(!board_can_place(&board, shape, rotation, -shape->size, BOARD_WIDTH));
+        }
+        assert(board_can_place(&board, shape, piece.rotation, piece.row + shape->size, piece.col));
+    }
+}
+
+static void test_reference_positions(void) {
+    for (int i = 0; i < perft_position_count; ++i) {
+        const PerftPosition *position = &perft_positions[i];
+        Board board;
+        perft_position_board(position, &board);
+
+        for (int depth = 1; depth <= position->depth; ++depth) {
+            uint64_t nodes = perft(&board, position->pieces, depth, false);
+            uint64_t unique = perft(&board, position->pieces, depth, true);
+            if (nodes != position->expected[depth - 1] || unique != position->expected_dedupe[depth - 1]) {
+                printf("  %s depth %d: got %llu/%llu\n", position->name, depth,
+                       (unsigned long long)nodes, (unsigned long long)unique);
+            }
+            assert(nodes == position->expected[depth - 1]);
+            assert(unique == position->expected_dedupe[depth - 1]);
+            assert(unique <= nodes);
+        }
+    }
+}
+
+// The copy-on-write generator the searches use yields the same poses in the same order.
+static void test_cow_generator_matches_flat(void) {
+    CowRowPool pool;
+    cow_pool_init(&pool, NULL);
+    for (int i = 0; i < perft_position_count; ++i) {
+        Board board;
+        perft_position_board(&perft_positions[i], &board);
+        CowBoard cow;
+        assert(cow_board_from_board(&pool, &cow, &board) == 0);
+        for (int type = 0; type < (int)piece_shape_count(); ++type) {
+            static ActivePiece flat[PERFT_MAX_PLACEMENTS];
+            static ActivePiece shared[PERFT_MAX_PLACEMENTS];
+            int count = perft_generate(&board, type, flat, PERFT_MAX_PLACEMENTS);
+            assert(perft_generate_cow(&cow, type, shared, PERFT_MAX_PLACEMENTS) == count);
+            assert(memcmp(flat, shared, sizeof(flat[0]) * (size_t)count) == 0);
+        }
+        cow_board_release(&pool, &cow);
+    }
+    assert(cow_pool_live_rows(&pool) == 0);
+    cow_pool_destroy(&pool);
+}
+
+int main(void) {
+    run_test("empty_board_single_piece_counts", test_empty_board_single_piece_counts);
+    run_test("generated_placements_are_resting", test_generated_placements_are_resting);
+    run_test("tuck_reaches_under_overhang", test_tuck_reaches_under_overhang);
+    run_test("piece_above_board_stays_inside_walls", test_piece_above_board_stays_inside_walls);
+    run_test("reference_positions", test_reference_positions);
+    run_test("cow_generator_matches_flat", test_cow_generator_matches_flat);
+    return 0;
+}
@@ -0,0 +1,138 @@
+#ifndef REPLAY_CORPUS_H
+#define REPLAY_CORPUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Recorded sessions for the end-to-end throughput suite (see include/perf_suite.h): a
+// game seed, the key script played one key per frame at PERF_FRAME_MS, and what the game
+// must show at the end. "bot" sessions hard drop each piece where the hint evaluation
+// likes it best, with the fewest presses; "soft_bot" ones soft drop and wait out the
+// lock delay; "random" ones press random keys until they top out. Shared by
+// tests/perf_suite_tests.c and the replay_bench tool, which regenerates this file with
+// --record; a change to the game rules that alters the expected results needs a new
+// corpus and a new baseline.
+
+typedef struct {
+    const char *name;
+    uint64_t seed;
+    const char *script;
+    uint32_t frames;
+    uint32_t pieces;
+    uint32_t lines;
+    int64_t score;
+    bool topped_out;
+} ReplaySession;
+
+static const ReplaySession replay_corpus[] = {
+    {"bot_11", 11ULL,
+     "3LH.5LH.H.4RH.LH.4RH3.ULLHRHH..UURH.4RHU4LH3ULLHULH..3U4LH..LLH4RHUU4RH3.U5LHURH3RH.URRH"
+     "..3UH3.LLH3LH3.RRH.3U5RH3.U4LHUURHURRHUH.3LH3.UU4RH..UH3.3RH3.U4RH3U3LH..LH3.URH5LH3.UUL"
+     "H.U3RH3.U3RHUHLLH..U4RH..U4LH5LHULHRRH3.5LH.U4RH.ULLHURH..4RH..UH.LH..UURRH3RH.ULLH3.ULH"
+     "..UURRH3.U4LH3ULLH..LLH..ULLH3.U4LH.RRH3RH3.U5LH3RH.LH..UU4RH3.URRH..3U3LH..U5LH..H3.U4R"
+     "H.LLH3.ULLH.URRH3.3U3LH3.UHU4RH.3RH.RRH3.4RHLLH.LH3LH3.URH3.3LHULH..4RH..5LH3.UU4RH3.URH"
+     ".4RHRRH.3ULHU4RH..UULLH.4LH..U5LHUUHURRH.UURH3.U4RH3.ULH3.U4RH3.URH3.4LH..UULH.URRHU5LH."
+     ".4RH3.LH.U3LHULH3.U3RH..URHU4RH3.UU3LH..RRH..LLH3U4RH3.3RH3.URH..4LH.LH4RH..UU3LH..U4LHU"
+     "LH3.3RH.U3LH..UHLLH3.U4RH3U3LH..UURRH3U5RH..U4LH..UURRH..3LH3.ULHLLH3.U3LH..U5LH3.U4LH3."
+     "URH..4RH.3RHLLH3.3LH.U4RH3.UU3RH3.4LH3.3URH3.4RH.ULH..RRHURRHU5LH3.3ULH3RH3.URH.U3LH3.3L"
+     "H3.ULH3.LH.UU4RH3.3U5RH..RRH..URH.U4RH3.H3LH.URRHU4LH3.3RH..3ULLH3ULHUH..URRHU5LH.3U5RH3"
+     ".U3RH..3RH.UULLH..5LH.URH3UH.URH..LH.U3RHUULLH.3RH4LHUU3RH.H3.U4RHHU5LH.UUH.3LHUULH..3RH"
+     "..5LHU4RH..RHU4RH.ULLH..U4LH3.U5LH3.3U3RH3.4LH..4LHULH3URRH..H3.3U4RH.UURH.ULLH.4LHU4RHU"
+     "H3.URRHLH..URH.UULH.U4LH..U4RH3.UURRH.UU3RH..U4RH3.3RH3.3RH3.URH..RH3.LH3.U4LH..UH..U3LH"
+     "..U5LHRHULLH.U4RH..UUHRRH..U4RH..U3LHULLH.3U4LH..LLHRRH..5LHUH..U3RHLH.H3.U4RH3.UU3RHULH"
+     "..U4RH3.3LH.4LH.ULLH3.URH..U3RH3U3RH3.U4LHUUH..U3RH..RH..U4RHU3LH.3ULH5LH.U4RH3.URH.3UH."
+     ".URRH3.U4LH.ULLH.3RH..UH3UH..3LH..RHU4LH.LH..U5LH3.4RH3URRHUU4RH..LLH..LH..URRH.H..3U3LH"
+     "..U4RHLLH..RHLLH3U5RH3.RRH..UUH.3RH4RH.U4LH3U4LHULLH3.4LH.RH..RH3ULH4LH.3U3RHHU4RHUU3RHU"
+     "5LH3.4LH..URH..U3RH3.U4RH3.ULH3.3RH3.UHU5LH..4RH.4LH3.H..LLH..LH..RH.3U5RH3.URH3.U4LHLH."
+     ".URRH3.U3RH..URHUULLH..U4LH.ULH..U4RH..3U3RH.5LH3.U4RH3.ULLH.RHUH.U3RH3.3RH.UU4RH3.URH3."
+     "URH.3RH.LLH3.U4RH3.UU3LH.U4LH3.4LHULH..3LH3.UH..LH.UU3RH3.UU3LH..UU3LH3.UH.U3RH3.URRH3UL"
+     "H..UULH3.5LHUH3U5RHURRHURH.U4RH.3LH3U3LH..3LH..U4LHRH.UURH3.UU4RH..3LHU3RH.3LH..U4RH..3U"
+     "RRHULHU3RH..4LH..RRH.3ULH3.",
+     2383, 400, 156, 180062, false},
+    {"bot_23", 23ULL,
+     "5LH3.LH..3LH..RRH..RRH.U3RH..UUH.3LH3.3RH3.5LH3.H3ULH3.3U5RH..U3LH3.RH3.RHU4RHU4RH3URH.U"
+     "5LH3.ULH.3U3LH3.ULH3.RRH..3U4RH..URH.3U3RH.3LH5LH3.U4RH3.3RH..LLHU5LH3.UH3.UULLHLLH3URRH"
+     "3.U4RH.U3RH..3URH..3RH..3LH3.LH3.U4LHLLH..3U5RH3RH3.U4RH..U4LHLH3.3URRH..LH3.3U3RH3.LH3."
+     "U5LHURH.3U3LH..U5LH..3U5RH..U3LHLLH.UU3RH3.LLH3.U5LH..4RH4LH.URRHUH3.ULH..U4RH..3URRH3UR"
+     "H3.U4LH4RH.U3RH.3ULLH3.LLH..ULLHU4RH..UURRHUH3.3RHUUH.RH4LH3.UU3RH3.LLHU3LH.U5LH3.3U5RH3"
+     ".RH3.3RH3.UH3.U4LH3.URRH.ULLHUU4RH.UURRH..3LH.3RHUHLH..3U3RH.U5LH..U3LH.URH3.UH.U4RH.ULH"
+     ".U3LH.5LH.URRH3U5RH..UH..3RH.5LH.ULLH.U4RH3.U3RH3URH..5LH..URRH.ULLH.UU3LH.U4RH.ULH..3LH"
+     "..URRH.U4RH3.3URHRHUULLH..UU3LH..ULH..3U5RH3.UURH3.3LH.U3RHLLH3.H3.5LHU4RH3.LH..UU3RHUU3"
+     "LH3.ULH.4RHUHURRH..LLH3.LLHU4LH5LH.3U4RH..ULH3LH3URRH..U4RH.RH.U3RH3.UURRH3.ULHU4RH..3LH"
+     "..U3RH.3LH.URHRH.LH..ULLH3U4LH..RH.3ULLH..RH..U4RH3.UU4RH.RRH3U4LH..U5LH.U3LH..3ULH..3RH"
+     "3.4LHUUH3.URRH.3U5RH3.3U3RH3.3LH.U3RHH..H.U4RH3.UURRH..U4RH..LLH.LLH..RH.U4LH.UH.3ULLHU5"
+     "LH..ULH3.RRH.URRH..3RH3U3LH3.UH..ULLH3.ULH.URRH..UURRH.RH..5LHU4RH3.3LH.3LH.U4RHUULH3.RH"
+     ".U3RH3.ULLH3.URH4LH.UH.UU3LH.U4RH3.3RH3.LHU3RH.U4LH3.H3.LLH.3U5RH..RH3.U3LH..URRHUULLH3."
+     "UU3RHLLHLH..U5LH.U4LH3.3U5RH..3U3RH3.ULLH.UURHU4LH.U4RH3U4LHLLH.3RH3.U4RH3.4RH.UHULLH3.U"
+     "RRH..3UH3.4LH3.UU4RH.UU3LHH.ULLH3LH..3UH3.4RH.4RH3.LLH..H..UU4RH.UU3LH3.ULLHRH..4RH5LH.."
+     "U4RHH.U3RHURH.LLH..3RH3.UUH..H3.3LH.3LH..5LH.4RH3.UULH5LHUU4RH..U3LH..RH.U4RH3.U3RHURHUL"
+     "H.LH3.UH..3RH3.3U5RH..URH3.5LH.5LHUU4RH..LHURH.U3RHUULLHU4LH3.3LH3.3UH3.URRH.URRH..3U5RH"
+     "UHU4LH..U4RH.RRH..U4LH.ULLH3.U3LH3.3RH3.ULH.LH3.RRH3.UURRH.U5LH3U5RHUHRRH.URH3.3LHULLH.."
+     "U3LH4RH.LH3.U4LH3.3RH.UH..URH..UULH..3RHURRH3.U4LH.3RH..LH3.URH.UU3LH.4RH.H3.ULLH..URH.U"
+     "H3.3LHRHU4RH3U4RH..U4LH3.UULH3.UUH.4LHU5LH3URRH3.RH.4RH.UURH.RRH..ULLH..U3LH.U4RH.U4LH4R"
+     "H.UU3LH.H..5LH3.ULLH..RRH.URH.4RH3ULLH3.4LH3.URRH3.UH.U4RH3.H3.URH.U3RH..3RH3.U4LH3ULH.3"
+     "URRHU3RH..U4RH..UULH5LHU5LH.H.UULLH3.RRH.ULH3RH..",
+     2418, 400, 153, 167854, false},
+    {"bot_37", 37ULL,
+     "3LHUU3LHLLH.RRH..3LH3.U5LH..RRH..3RH.H.U4RH.U3LH3.ULLH.RH.U3RH..U4RH..UURH.RHUULLH4RHH3."
+     "5LH3.5LHUU4RH..U3LH..3LHRRHH.4RH..U5LH.U3LH3.LH3.UUH.3URRH3.4RH..URRH..U4RH.H..U3RH.3UH3"
+     ".3LH3.U3LH3.RRH.3U4LH3U5RH..UH3RH.URRH3.3UH3.4LH3.3U4LH3.U4RH3.ULHRRH..U4RH3.LH3.4LHUURR"
+     "H..ULH.U3RH3.U5LH3.H.U4RH.LLHUU3RH3LH3.3RH3.U4LH.UH3.LH.3RH3.LLH3.RH..3U5RH..URRH4RH3.5L"
+     "H3.UH.URHLH.RRH.LLH.UHU4LH.3U5RH3.LH..3LHHUUH.U5LH3.URRH3.4LH..3LH.U4RH..U3RH5LH3U5RH..H"
+     "LH.RH5LH3.UU3RH..UU4RH3.RRH3.UULHLHLH3.3U5RH3.RRH3LH.3LH.HLLH3.RRH4RH3U4RH3.H.LLH3.RH.U4"
+     "RH3.U4LH3.LH3.U4LH3RH..5LH.U4RH..ULLH3.5LH..H..URRH3.3ULLH.UHU4RH..ULLH..UU3RH.UH3.RHU4L"
+     "H.U4RH..LH.U4RH..URH..U3RH3.LLH3.UU3LHRRH3LH3.UH3.3RHLLH..3U4LH..3U3RH.U4LHU4RH3.RH3.3UL"
+     "H.RH3.3ULLH..5LH3.U3RH..URRHUH..ULLH.UUH3.URRH..3U5RH.U4RH5LH..LH.RH5LHU3RH3U3RH.UULH.U4"
+     "RHURHURHLH..LH.U4RHU4RH3.3ULH3.3LH.U4LH.URRH..3ULLH.LH3.UUH..3RH3U3LH.URH..4RH3.UULH..U5"
+     "LH3.3LH3.LLH.UULLH3URRH.U3RH3.RH3.RH3.U4RH3.U5LH..4LH3.ULH.3RHRRH..3LH3.3U5RH..LH.RRH3.U"
+     "URRH3RH3.3LH..UUH3LH..LH3RH..UURH..3U5RH..5LH.ULH..U3LH3.URRH..3ULH3RHUH..5LH..U4RH.LLH3"
+     "U4LH..3U3RH..HLLH..UH3.4RH..U4RH..3LH.UUH..3RH3URRH.3U4LHURRHUULH.U4RH3.U4LH.U4LH..3LHU4"
+     "RH..RH.U5LH.LH..UURRH.LH.3URRH3.U4LH..ULLH3.4RH3.3U4RHU4LH.HUULH..U4RH3.ULLH..3ULLH..3RH"
+     "..U5LH3.UURH.UH..U4RH..RH3.ULHU3LH.RRH.LH3.U4RH3.U5LH..RRHRRH..4LHH3.U4RH.3UHLLHRRH3LH3."
+     "U4LH3.U4RH.URRH.RHU4RH3.HRRH3RH.UULLH.3LH.URH3.5LH.3U3RH.UHULLH3.U4RHH.5LH..UU3LH..3RH.."
+     "H.3U5RH..RH.RHULLH..3U3LHULLH..U5LH..UH..4RH.U4RH..UURRH..URRH3.U3RH..4LH3.3URH..ULLH.5L"
+     "H3URRHUHULLH3.U4RH..U3RH..RH.U4LH.3ULH.U4LHULLH.U4LH.5LH.UH.ULLH5LHULLHUU3RH3.U4RH.RH.UR"
+     "RH..3U5RHURHUH.3RH..UH4RH..5LH3.UU4RHURHULLH3.U4RH.RH5LHUULH..4RH.UURRH.UULH3.5LH.UUH..U"
+     "4RH..ULLH..3RH3LH.UURH.U3RH..U4RH3.5LH.4RH3.RH.H..U3LH3.3LH3ULH3.U3RH3.UURH.LLH..RRHUUH3"
+     ".URRH3.3U5RH.U5LH3.4RH3ULLH.LLH3U3LH.URH.U4RHUULLH..RH.U3RH.LLH.U5LH3.3U3RH3.U3LH.UUH..4"
+     "RH3.U4RH3.",
+     2375, 400, 158, 181758, false},
+    {"soft_bot_41", 41ULL,
+     "3L20D52.5L18D67.R19D65.R18D70.4R18D66.UU4R18D63.UL18D67.U3L17D67.UU3R18D63.UL18D68.5L19D"
+     "65.L17D71.UURR18D65.3U5R17D60.RR18D70.R17D68.3U3L17D64.3ULL17D65.4R18D65.3UL16D71.R17D68"
+     ".UUR15D70.4R16D65.U5L16D66.3U5R18D62.LL19D67.R19D60.5L19D60.UU3R18D57.L19D62.5L18D56.UUL"
+     "17D61.UU4R18D57.UR18D65.3L18D60.4R19D56.U17D65.UL18D61.3R19D59.LL19D61.RR19D60.U4L18D58."
+     "U4R17D58.URR18D59.3U4R18D58.3L19D59.3U4L18D55.R19D62.UUL18D61.UU4R18D57.R19D62.3L18D60.3"
+     "U3L18D57.UR18D56.3L17D54.4R17D53.U17D56.URR17D58.UL16D56.4L17D55.",
+     4984, 60, 21, 4100, false},
+    {"random_53", 53ULL,
+     "..U..DL3.D.DL.R3.D5.RR..DRLL.DRD.RUR.U.DLDL.D.R3.R3.LU4.L.LD.L3.D..H.DLRU3.U.RHRLRUD.HL."
+     ".U4.RL.U..DRR.U..RLU.DL.UU3.RR3.DHDH.DH.DRDRDL4.DUR.DLRDD.DR5.U.R..R3.D..H..HUD3.R..DD.."
+     "L.UR.U.D.RR.R5.R.ULUU.U..R..U6.D.R.U..D4.D4.RD.ULUU.LH.DL.U.U5.DLL..R5.LLR6.DU.L.RUU5.L."
+     ".DUL.DL.DUDU3.LD.RRDR3.LR.D..UU.L.HRDD..L.LDLR.D.UL.U..ULL.H.R..H4.U3.DLL3.D..LLU3.L..DL"
+     "..RU3.LURD.RDDRR..H6.L4.HR3.R7.R..RUL..U..D.R..LRU.DL3.DR..RLLUULU..D.DHL.RUD3.U.U.U.UUD"
+     "R4.HRU..DR.LR..L..UDL3.D3.L.L5.L..DRH.UR.RD5.RHU.LD3.H..R.UR5.DUDRUUHD.L5.UURD.UD.D..R.."
+     "R7.L.RLH..DUR4.LUL.U.L6.U..DR3.H.RUU4.U..U3.R.R..LRUUD.R.LRDRUU.L..DL.DL.U..D.R.UL.ULD.."
+     "U..LD.DDLU.D5.U..UR..RDDRL.D..DRR.D3.D.DLL.DURDU3.R6.RU..D3.L4.UU..U.H3.UR.R..L..RH.L..D"
+     "RD.UR..R.D7.LL.DUDR.R3L.RR.D3.URR.LH3.RDL.DDRHL.H",
+     874, 27, 0, 228, true},
+    {"random_67", 67ULL,
+     ".RRD..UUR..R.HR..DH3.RL3.R.HU.U..R.D.LR.RD.U4.U.U.DUU.LL7.U..DH.LU3.R5.R.RU..U..U..L3.DR"
+     ".UH..RL.UUHR3.3L4.LR..RDU..RR.L..DUD..L..D.RUUD5.L..URUDL..R.R..L..H..URU.UHD..L10.UR3.R"
+     "DLHUR.H..U..HL..LRLL6.RLD5.D3.L.R..RDRL.L.DUD.L.RR.DU.LRLLD.ULDL..RDUL.L..R.RU.L.DDUHR.."
+     "DD.UD.RDRH.LDHUHDRD.DRULUH.HU..U.L3.U.H",
+     341, 18, 0, 266, true},
+    {"random_79", 79ULL,
+     ".UD.ULR..UR..LR.RL..UDR..LURL..U3.R.DH4.L3.DUDUU.D3.RD.D.HR.RDDRRDDLU..RLDL.RLDD..UR.RD."
+     "L.UL3.RH.UUL3.D.UL..U.U..LU.L3.L3.R..DL.L..L.H.UD7.U..UH.UUD..D.U3.HLUU..DLU.HU.R.L5.U3."
+     "URL..D.D..LUL4.HRDDL..L.L.UUH.U..LR..R..UL.R.DLRL4.DL.DRD3.UUD..R..LL3.D.R..LU.LUDRLUU.."
+     "L6.R.UU..DR7.D..D.LU6.U.U.D3.UU.RDLL..L4.D..LL..RRLRUR..L.L.D.R.L.UD..L6.L..U4.U.UUR.RR."
+     "DLHD3.UL..LLHULLRR.R4.H..L..H.U.DH..U4.D..R.D..R..RLD.HU3D..R.L.LD5.ULULRUU..HDURR..R4.L"
+     "U.LLHRH..L3.L3.DDRUDDRU..H.RR3.UDD.HDL5.D5.LUD..RRLHL.UD6.RHDU4.DU.R..DU.R4.DL..HUULUU.R"
+     "UH5.D.RDL.UHU.R..L.LH",
+     627, 27, 0, 310, true},
+};
+
+static const int replay_corpus_count = (int)(sizeof(replay_corpus) / sizeof(replay_corpus[0]));
+
+#endif /* REPLAY_CORPUS_H */
@@ -0,0 +1,164 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "retro.h"
+
+#define I_PIECE 0
+#define O_PIECE 1
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static void temp_path(char *out, size_t capacity, const char *tag) {
+    snprintf(out, capacity, "/tmp/tetris_retro_%s_%ld.bin", tag, (long)getpid());
+}
+
+static void solve(RetroSolver *solver, int width, int height, double gamma, int threads) {
+    assert(retro_solver_init(solver, width, height) == 0);
+    assert(retro_solver_explore(solver) == 0);
+    RetroConfig config = {.gamma = gamma, .tolerance = 1e-9, .max_sweeps = 2000, .threads = threads};
+    assert(retro_solver_iterate(solver, &config) == 0);
+}
+
+static void test_geometry_limits(void) {
+    static RetroGeometry geometry;
+    assert(retro_geometry_init(&geometry, 3, 6) != 0);
+    assert(retro_geometry_init(&geometry, 10, 3) != 0); // 70 bits with the buffer rows
+    assert(retro_geometry_init(&geometry, 4, RETRO_MAX_HEIGHT + 1) != 0);
+    assert(retro_geometry_init(&geometry, 10, 2) == 0);
+    assert(retro_geometry_init(&geometry, 4, RETRO_MAX_HEIGHT) == 0);
+    assert(retro_geometry_init(&geometry, 6, 6) == 0);
+    assert(geometry.row_mask == 0x3F && geometry.field_mask == (1ULL << 36) - 1);
+
+    const uint16_t rows[6] = {0, 0, 0, 0, 0x20, 0x01};
+    assert(retro_field_from_rows(&geometry, rows) == ((1ULL << (6 + 5)) | 1ULL));
+}
+
+static void test_placements_on_empty_field(void) {
+    static RetroGeometry geometry;
+    assert(retro_geometry_init(&geometry, 4, 2) == 0);
+    RetroPlacement placements[RETRO_MAX_PLACEMENTS];
+
+    // Flat I clears the bottom row; every upright I sticks out of a 2-row field.
+    int count = retro_place(&geometry, 0, I_PIECE, placements, RETRO_MAX_PLACEMENTS);
+    assert(count == 5);
+    int clears = 0;
+    for (int i = 0; i < count; ++i) {
+        if (!placements[i].topout) {
+            assert(placements[i].lines == 1 && placements[i].field == 0);
+            ++clears;
+        }
+    }
+    assert(clears == 1);
+
+    count = retro_place(&geometry, 0, O_PIECE, placements, RETRO_MAX_PLACEMENTS);
+    assert(count == 3);
+    uint64_t columns = 0;
+    for (int i = 0; i < count; ++i) {
+        assert(!placements[i].topout && placements[i].lines == 0);
+        int x = __builtin_ctzll(placements[i].field);
+        assert(placements[i].field == (0x33ULL << x));
+        columns |= 1ULL << x;
+    }
+    assert(columns == 0x7);
+
+    // Too little room for every lock is an error, not a silent truncation.
+    assert(retro_place(&geometry, 0xE, I_PIECE, placements, 2) == -1);
+}
+
+// Converged values are a fixed point of the Bellman backup, and threads change nothing.
+static void test_values_satisfy_bellman(void) {
+    static RetroSolver one;
+    static RetroSolver four;
+    solve(&one, 4, 3, 0.9, 1);
+    solve(&four, 4, 3, 0.9, 4);
+    assert(one.state_count > 0 && one.state_count == four.state_count);
+    assert(one.residual <= 1e-9 && one.sweeps == four.sweeps);
+    assert(memcmp(one.values, four.values, one.board_count * RETRO_BAGS * sizeof(double)) == 0);
+    assert(retro_solver_value(&one, 0, RETRO_FULL_BAG) > 0.0);
+    assert(retro_solver_value(&one, 0, 0) < 0.0);
+    assert(retro_solver_value(&one, one.geometry.row_mask, RETRO_FULL_BAG) < 0.0); // a full row never stays
+
+    RetroPlacement placements[RETRO_MAX_PLACEMENTS];
+    for (size_t board = 0; board < one.board_count; ++board) {
+        for (unsigned bag = 1; bag <= RETRO_FULL_BAG; ++bag) {
+            double value = retro_solver_value(&one, one.boards[board], bag);
+            if (value < 0.0) {
+                continue;
+            }
+            double expected = 0.0;
+            int pieces = 0;
+            for (int type = 0; type < RETRO_PIECE_TYPES; ++type) {
+                if ((bag & (1U << type)) == 0) {
+                    continue;
+                }
+                unsigned next_bag = (bag & ~(1U << type)) ? (bag & ~(1U << type)) : RETRO_FULL_BAG;
+                int count = retro_place(&one.geometry, one.boards[board], type, placements, RETRO_MAX_PLACEMENTS);
+                double best = 0.0;
+                for (int i = 0; i < count; ++i) {
+                    double q = placements[i].lines;
+                    if (!placements[i].topout) {
+                        q += 0.9 * retro_solver_value(&one, placements[i].field, next_bag);
+                    }
+                    best = (q > best) ? q : best;
+                }
+                expected += best;
+                ++pieces;
+            }
+            assert(fabs(value - expected / pieces) < 1e-6);
+        }
+    }
+    retro_solver_free(&one);
+    retro_solver_free(&four);
+}
+
+static void test_table_roundtrip(void) {
+    static RetroSolver solver;
+    solve(&solver, 4, 3, 0.95, 2);
+    char path[64];
+    temp_path(path, sizeof(path), "table");
+    assert(retro_table_write(&solver, path, 7) == 0);
+
+    RetroTable table;
+    assert(retro_table_open(&table, path) == 0);
+    assert(table.header->state_count == solver.state_count);
+    assert(table.header->width == 4 && table.header->height == 3);
+    size_t found = 0;
+    for (size_t board = 0; board < solver.board_count; ++board) {
+        for (unsigned bag = 1; bag <= RETRO_FULL_BAG; ++bag) {
+            double value = retro_solver_value(&solver, solver.boards[board], bag);
+            float stored = -1.0f;
+            bool hit = retro_table_lookup(&table, solver.boards[board], bag, &stored);
+            if (value >= 0.0) {
+                assert(hit && stored == (float)value);
+                ++found;
+            }
+        }
+    }
+    assert(found == solver.state_count);
+    assert(!retro_table_lookup(&table, solver.geometry.row_mask, RETRO_FULL_BAG, NULL));
+    assert(!retro_table_lookup(&table, 0, 0, NULL));
+    retro_table_close(&table);
+
+    FILE *fp = fopen(path, "r+b");
+    assert(fp != NULL);
+    assert(fputc('X', fp) != EOF);
+    fclose(fp);
+    assert(retro_table_open(&table, path) != 0);
+    remove(path);
+    retro_solver_free(&solver);
+}
+
+int main(void) {
+    run_test("geometry_limits", test_geometry_limits);
+    run_test("placements_on_empty_field", test_placements_on_empty_field);
+    run_test("values_satisfy_bellman", test_values_satisfy_bellman);
+    run_test("table_roundtrip", test_table_roundtrip);
+    return 0;
+}
@@ -19,6 +19,11 @@ static void test_score_init_without_file(void) {
     assert(state.high == 0);
 }
 
+static ScoreLock lock_of(int lines, ScoreSpin spin, int level) {
+    ScoreLock lock = {.lines = lines, .spin = spin, .perfect_clear = false, .level = level};
+    return lock;
+}
+
 static void test_score_line_awards(void) {
     const char *path = "build/tests/score_line.dat";
     cleanup_file(path);
@@ -26,27 +31,122 @@ static void test_score_line_awards(void) {
     ScoreState state;
     assert(score_state_init(&state, path) == 0);
 
-    score_add_lines(&state, 2);
+    ScoreLock lock = lock_of(2, SCORE_SPIN_NONE, 1);
+    assert(score_add_lock(&state, &lock) == 300);
     assert(state.current == 300);
 
-    score_add_lines(&state, 4);
-    assert(state.current == 1100);
+    // Second clearing lock in a row: tetris plus one combo step.
+    lock = lock_of(4, SCORE_SPIN_NONE, 1);
+    assert(score_add_lock(&state, &lock) == 850);
+    assert(state.current == 1150);
 
     cleanup_file(path);
 }
 
 static void test_score_line_overflow_award(void) {
-    const char *path = "build/tests/score_line_overflow.dat";
-    cleanup_file(path);
+    ScoreChain chain;
+    score_chain_reset(&chain);
+    ScoreLock lock = lock_of(6, SCORE_SPIN_NONE, 1);
+    assert(score_lock_points(&chain, &lock) == 800 + 200);
+}
 
-    ScoreState state;
-    assert(score_state_init(&state, path) == 0);
+static void test_score_level_multiplier(void) {
+    ScoreChain chain;
+    score_chain_reset(&chain);
+    ScoreLock lock = lock_of(1, SCORE_SPIN_NONE, 5);
+    assert(score_lock_points(&chain, &lock) == 500);
 
-    score_add_lines(&state, 6);
-    assert(state.current > 0);
-    assert(state.current >= 800 + 200);
+    score_chain_reset(&chain);
+    lock = lock_of(1, SCORE_SPIN_NONE, 0);
+    assert(score_lock_points(&chain, &lock) == 100);
+}
 
-    cleanup_file(path);
+static void test_score_back_to_back(void) {
+    ScoreChain chain;
+    score_chain_reset(&chain);
+    ScoreLock tetris = lock_of(4, SCORE_SPIN_NONE, 1);
+    ScoreLock tsd = lock_of(2, SCORE_SPIN_FULL, 1);
+    ScoreLock empty = lock_of(0, SCORE_SPIN_NONE, 1);
+    ScoreLock single = lock_of(1, SCORE_SPIN_NONE, 1);
+
+    assert(score_lock_points(&chain, &tetris) == 800);
+    assert(chain.back_to_back && chain.combo == 0);
+
+    // A placement between clears ends the combo but keeps back-to-back alive.
+    assert(score_lock_points(&chain, &empty) == 0);
+    assert(chain.back_to_back && chain.combo == -1);
+    assert(score_lock_points(&chain, &tsd) == 1800);
+
+    // A plain single breaks the chain; the next tetris is not a back-to-back.
+    assert(score_lock_points(&chain, &single) == 100 + 50);
+    assert(!chain.back_to_back);
+    assert(score_lock_points(&chain, &tetris) == 800 + 100);
+}
+
+static void test_score_combo_reset(void) {
+    ScoreChain chain;
+    score_chain_reset(&chain);
+    ScoreLock single = lock_of(1, SCORE_SPIN_NONE, 1);
+    ScoreLock empty = lock_of(0, SCORE_SPIN_NONE, 1);
+
+    assert(score_lock_points(&chain, &single) == 100);
+    assert(score_lock_points(&chain, &single) == 150);
+    assert(score_lock_points(&chain, &single) == 200);
+    assert(chain.combo == 2);
+    assert(score_lock_points(&chain, &empty) == 0);
+    assert(score_lock_points(&chain, &single) == 100);
+
+    // Spins that clear nothing still score but end the combo.
+    ScoreLock spin = lock_of(0, SCORE_SPIN_FULL, 1);
+    assert(score_lock_points(&chain, &spin) == 400);
+    assert(chain.combo == -1);
+}
+
+static void test_score_perfect_clear(void) {
+    ScoreChain chain;
+    score_chain_reset(&chain);
+    ScoreLock lock = lock_of(2, SCORE_SPIN_NONE, 1);
+    lock.perfect_clear = true;
+    assert(score_lock_points(&chain, &lock) == 300 + 1200);
+
+    score_chain_reset(&chain);
+    chain.back_to_back = true;
+    lock = lock_of(4, SCORE_SPIN_NONE, 2);
+    lock.perfect_clear = true;
+    assert(score_lock_points(&chain, &lock) == (1200 + 3200) * 2);
+}
+
+// Rotation 2 points down; rotation 0 points up (see piece.c).
+static void test_score_detect_tspin(void) {
+    Board board;
+    board_reset(&board);
+    const int bottom = BOARD_HEIGHT - 1;
+    for (int col = 0; col < BOARD_WIDTH; ++col) {
+        if (col != 4) {
+            board.cells[bottom][col] = 1;
+        }
+        if (col < 3 || col > 5) {
+            board.cells[bottom - 1][col] = 1;
+        }
+    }
+    board.cells[bottom - 2][3] = 1;
+
+    ActivePiece piece = {.type = SCORE_T_PIECE, .rotation = 2, .row = BOARD_HEIGHT - 3, .col = 3};
+    assert(score_detect_tspin(&board, &piece, true) == SCORE_SPIN_FULL);
+    assert(score_detect_tspin(&board, &piece, false) == SCORE_SPIN_NONE);
+
+    ActivePiece other = piece;
+    other.type = 3;
+    assert(score_detect_tspin(&board, &other, true) == SCORE_SPIN_NONE);
+
+    // Pointing up at the floor: both back corners are the floor, one front corner is
+    // blocked, so only a mini.
+    board_reset(&board);
+    board.cells[bottom - 1][0] = 1;
+    ActivePiece mini = {.type = SCORE_T_PIECE, .rotation = 0, .row = BOARD_HEIGHT - 3, .col = 0};
+    assert(score_detect_tspin(&board, &mini, true) == SCORE_SPIN_MINI);
+    board.cells[bottom - 1][0] = 0;
+    assert(score_detect_tspin(&board, &mini, true) == SCORE_SPIN_NONE);
 }
 
 static void test_score_persistence(void) {
@@ -55,13 +155,13 @@ static void test_score_persistence(void) {
 
     ScoreState state;
     assert(score_state_init(&state, path) == 0);
-    state.current = 500;
+    state.current = 5000000000LL;
     assert(score_commit_highscore(&state));
     assert(score_state_save(&state) == 0);
 
     ScoreState reread;
     assert(score_state_init(&reread, path) == 0);
-    assert(reread.high == 500);
+    assert(reread.high == 5000000000LL);
     cleanup_file(path);
 }
 
@@ -104,6 +204,11 @@ int main(void) {
     run_test("score_init_without_file", test_score_init_without_file);
     run_test("score_line_awards", test_score_line_awards);
     run_test("score_line_overflow_award", test_score_line_overflow_award);
+    run_test("score_level_multiplier", test_score_level_multiplier);
+    run_test("score_back_to_back", test_score_back_to_back);
+    run_test("score_combo_reset", test_score_combo_reset);
+    run_test("score_perfect_clear", test_score_perfect_clear);
+    run_test("score_detect_tspin", test_score_detect_tspin);
     run_test("score_persistence", test_score_persistence);
     run_test("score_drop_award_and_reset", test_score_drop_award_and_reset);
     run_test("score_highscore_only_increases", test_score_highscore_only_increases);
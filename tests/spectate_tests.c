@@ -0,0 +1,285 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "engine.h"
+#include "spectate.h"
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static Engine *started_engine(uint64_t seed) {
+    static Engine engine;
+    engine_init(&engine, seed);
+    engine_start(&engine);
+    engine_take_events(&engine, NULL);
+    return &engine;
+}
+
+// One frame of scripted play that changes something most ticks.
+static void play_frame(Engine *engine, int frame) {
+    switch (frame % 5) {
+        case 0:
+            engine_shift(engine, (frame / 5) % 2 ? 1 : -1);
+            break;
+        case 1:
+            engine_rotate(engine, 1);
+            break;
+        case 4:
+            engine_hard_drop(engine);
+            break;
+        default:
+            break;
+    }
+    engine_tick(engine, 16);
+    engine_take_events(engine, NULL);
+    if (engine->phase == ENGINE_PHASE_GAME_OVER) {
+        engine_start(engine);
+        engine_take_events(engine, NULL);
+    }
+}
+
+static void assert_matches_engine(const SpectateState *state, const Engine *engine) {
+    SpectateState expected;
+    spectate_state_from_engine(engine, &expected);
+    expected.tick = state->tick;
+    assert(memcmp(state, &expected, sizeof(expected)) == 0);
+}
+
+static void test_reader_follows_deltas(void) {
+    static SpectateHub hub;
+    assert(spectate_hub_open(&hub, NULL, NULL) == 0);
+    Engine *engine = started_engine(3);
+
+    SpectateReader reader;
+    SpectateState state;
+    memset(&state, 0, sizeof(state));
+    spectate_reader_init(&reader, hub.ring);
+
+    for (int frame = 0; frame < 400; ++frame) {
+        play_frame(engine, frame);
+        spectate_hub_publish(&hub, engine);
+        while (spectate_reader_next(&reader, &state) > 0) {
+        }
+        assert_matches_engine(&state, engine);
+    }
+
+    Engine mirror;
+    engine_init(&mirror, 0);
+    spectate_state_to_engine(&state, &mirror);
+    assert(memcmp(&mirror.board, &engine->board, sizeof(mirror.board)) == 0);
+    assert(mirror.score.current == engine->score.current && mirror.level == engine->level);
+    spectate_hub_close(&hub);
+}
+
+static void test_unchanged_tick_writes_nothing(void) {
+    static SpectateHub hub;
+    assert(spectate_hub_open(&hub, NULL, NULL) == 0);
+    Engine *engine = started_engine(4);
+
+    assert(spectate_hub_publish(&hub, engine));
+    uint64_t keyframe_end = atomic_load(&hub.ring->write_pos);
+    assert(keyframe_end == SPECTATE_RECORD_HEADER + BOARD_HEIGHT * BOARD_WIDTH + SPECTATE_FIELDS_SIZE);
+    assert(!spectate_hub_publish(&hub, engine));
+    assert(atomic_load(&hub.ring->write_pos) == keyframe_end);
+
+    // Moving the piece one column is a cell-free delta: header, count byte, fields tail.
+    engine_shift(engine, 1);
+    assert(spectate_hub_publish(&hub, engine));
+    assert(atomic_load(&hub.ring->write_pos) - keyframe_end == SPECTATE_RECORD_HEADER + 1 + SPECTATE_FIELDS_SIZE);
+    spectate_hub_close(&hub);
+}
+
+static void test_late_and_lapped_readers_resync(void) {
+    static SpectateHub hub;
+    assert(spectate_hub_open(&hub, NULL, NULL) == 0);
+    Engine *engine = started_engine(5);
+
+    SpectateReader early;
+    SpectateState early_state;
+    memset(&early_state, 0, sizeof(early_state));
+    spectate_reader_init(&early, hub.ring);
+    spectate_hub_publish(&hub, engine);
+    assert(spectate_reader_next(&early, &early_state) == 1);
+
+    // Write several ring lengths while the early reader sleeps; it gets lapped.
+    int frame = 0;
+    while (atomic_load(&hub.ring->write_pos) < 4 * SPECTATE_RING_BYTES) {
+        play_frame(engine, frame++);
+        spectate_hub_publish(&hub, engine);
+    }
+    assert(atomic_load(&hub.ring->keyframe_pos) > 3 * SPECTATE_RING_BYTES);
+
+    SpectateReader late;
+    SpectateState late_state;
+    memset(&late_state, 0, sizeof(late_state));
+    spectate_reader_init(&late, hub.ring);
+    while (spectate_reader_next(&late, &late_state) > 0) {
+    }
+    while (spectate_reader_next(&early, &early_state) > 0) {
+    }
+    assert_matches_engine(&late_state, engine);
+    assert_matches_engine(&early_state, engine);
+    spectate_hub_close(&hub);
+}
+
+// A reader less than one record from being lapped could be copying bytes the writer is
+// overwriting with its next record, so it resyncs instead of reading them.
+static void test_nearly_lapped_reader_resyncs(void) {
+    static SpectateHub hub;
+    assert(spectate_hub_open(&hub, NULL, NULL) == 0);
+    Engine *engine = started_engine(6);
+
+    SpectateReader reader;
+    SpectateState state;
+    memset(&state, 0, sizeof(state));
+    spectate_reader_init(&reader, hub.ring);
+    spectate_hub_publish(&hub, engine);
+    assert(spectate_reader_next(&reader, &state) == 1);
+    uint64_t stopped = reader.pos;
+
+    int frame = 0;
+    while (atomic_load(&hub.ring->write_pos) - stopped <= SPECTATE_RING_BYTES - SPECTATE_MAX_RECORD) {
+        play_frame(engine, frame++);
+        spectate_hub_publish(&hub, engine);
+    }
+    assert(atomic_load(&hub.ring->write_pos) - stopped <= SPECTATE_RING_BYTES);
+
+    assert(spectate_reader_next(&reader, &state) == 1);
+    assert(reader.pos > atomic_load(&hub.ring->keyframe_pos));
+    assert(reader.pos > stopped + SPECTATE_RING_BYTES / 2);
+    while (spectate_reader_next(&reader, &state) > 0) {
+    }
+    assert_matches_engine(&state, engine);
+    spectate_hub_close(&hub);
+}
+
+// Pump the hub and poll `feed` until it reports nothing new (or a second passes).
+static void drain_feed(SpectateHub *hub, SpectateFeed *feed, SpectateState *state) {
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        spectate_hub_pump(hub);
+        int status = spectate_feed_poll(feed, state);
+        assert(status >= 0);
+        if (status == 0 && state->tick != 0) {
+            return;
+        }
+        nanosleep(&(struct timespec){.tv_sec = 0, .tv_nsec = 1000000}, NULL);
+    }
+}
+
+static void test_socket_viewers_share_one_stream(void) {
+    char address[64];
+    snprintf(address, sizeof(address), "unix:/tmp/tetris_spectate_test_%ld.sock", (long)getpid());
+
+    static SpectateHub hub;
+    assert(spectate_hub_open(&hub, address, NULL) == 0);
+    Engine *engine = started_engine(6);
+
+    enum { EARLY_VIEWERS = 3 };
+    static SpectateFeed feeds[EARLY_VIEWERS + 1];
+    SpectateState states[EARLY_VIEWERS + 1];
+    memset(states, 0, sizeof(states));
+    for (int i = 0; i < EARLY_VIEWERS; ++i) {
+        assert(spectate_feed_open(&feeds[i], address) == 0);
+    }
+
+    for (int frame = 0; frame < 300; ++frame) {
+        play_frame(engine, frame);
+        spectate_hub_publish(&hub, engine);
+        spectate_hub_pump(&hub);
+        if (frame == 200) {
+            assert(spectate_feed_open(&feeds[EARLY_VIEWERS], address) == 0);
+        }
+        for (int i = 0; i < EARLY_VIEWERS; ++i) {
+            assert(spectate_feed_poll(&feeds[i], &states[i]) >= 0);
+        }
+    }
+
+    for (int i = 0; i <= EARLY_VIEWERS; ++i) {
+        drain_feed(&hub, &feeds[i], &states[i]);
+        assert_matches_engine(&states[i], engine);
+    }
+    assert(hub.viewer_count == EARLY_VIEWERS + 1);
+
+    spectate_hub_close(&hub);
+    assert(spectate_feed_poll(&feeds[0], &states[0]) == -1);
+    for (int i = 0; i <= EARLY_VIEWERS; ++i) {
+        spectate_feed_close(&feeds[i]);
+    }
+    unlink(address + 5);
+}
+
+static void test_shared_memory_feed(void) {
+    char name[64];
+    snprintf(name, sizeof(name), "tetris_spectate_test_%ld", (long)getpid());
+    char address[80];
+    snprintf(address, sizeof(address), "shm:%s", name);
+
+    static SpectateHub hub;
+    assert(spectate_hub_open(&hub, NULL, name) == 0);
+    Engine *engine = started_engine(7);
+    for (int frame = 0; frame < 50; ++frame) {
+        play_frame(engine, frame);
+        spectate_hub_publish(&hub, engine);
+    }
+
+    static SpectateFeed feed;
+    SpectateState state;
+    memset(&state, 0, sizeof(state));
+    assert(spectate_feed_open(&feed, address) == 0);
+    assert(spectate_feed_poll(&feed, &state) == 1);
+    assert_matches_engine(&state, engine);
+
+    play_frame(engine, 4);
+    spectate_hub_publish(&hub, engine);
+    assert(spectate_feed_poll(&feed, &state) == 1);
+    assert_matches_engine(&state, engine);
+    assert(spectate_feed_poll(&feed, &state) == 0);
+
+    spectate_hub_close(&hub);
+    assert(spectate_feed_poll(&feed, &state) == -1);
+    spectate_feed_close(&feed);
+    assert(spectate_feed_open(&feed, address) == -1);
+}
+
+static void test_rejects_malformed_records(void) {
+    unsigned char record[SPECTATE_MAX_RECORD];
+    memset(record, 0, sizeof(record));
+    SpectateState state;
+    memset(&state, 0, sizeof(state));
+    size_t consumed = 0;
+
+    assert(spectate_apply_record(record, 4, &state, &consumed) == 0);
+    record[0] = 9;
+    assert(spectate_apply_record(record, sizeof(record), &state, &consumed) == -1);
+
+    record[0] = SPECTATE_RECORD_DELTA;
+    record[2] = 1 + 2 + SPECTATE_FIELDS_SIZE;
+    record[SPECTATE_RECORD_HEADER] = 1;
+    record[SPECTATE_RECORD_HEADER + 1] = BOARD_HEIGHT * BOARD_WIDTH;
+    assert(spectate_apply_record(record, sizeof(record), &state, &consumed) == -1);
+    record[SPECTATE_RECORD_HEADER + 1] = 7;
+    record[SPECTATE_RECORD_HEADER + 2] = 3;
+    assert(spectate_apply_record(record, sizeof(record), &state, &consumed) == 1);
+    assert(consumed == SPECTATE_RECORD_HEADER + 1 + 2 + SPECTATE_FIELDS_SIZE);
+    assert(state.cells[0][7] == 3);
+}
+
+int main(void) {
+    run_test("reader_follows_deltas", test_reader_follows_deltas);
+    run_test("unchanged_tick_writes_nothing", test_unchanged_tick_writes_nothing);
+    run_test("late_and_lapped_readers_resync", test_late_and_lapped_readers_resync);
+    run_test("nearly_lapped_reader_resyncs", test_nearly_lapped_reader_resyncs);
+    run_test("socket_viewers_share_one_stream", test_socket_viewers_share_one_stream);
+    run_test("shared_memory_feed", test_shared_memory_feed);
+    run_test("rejects_malformed_records", test_rejects_malformed_records);
+    return 0;
+}
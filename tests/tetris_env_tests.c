@@ -0,0 +1,178 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tetris_env.h"
+
+#define TEST_ENVS 7
+
+typedef struct {
+    uint16_t planes[TEST_ENVS][TETRIS_ENV_PLANE_COUNT][TETRIS_ENV_ROWS];
+    int8_t queue[TEST_ENVS][TETRIS_ENV_QUEUE_LEN];
+    int32_t stats[TEST_ENVS][TETRIS_ENV_STAT_COUNT];
+    float rewards[TEST_ENVS];
+    uint8_t dones[TEST_ENVS];
+} Observations;
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static TetrisEnv *create_bound(Observations *obs, const uint64_t *seeds) {
+    memset(obs, 0xCD, sizeof(*obs));
+    TetrisEnv *env = env_create(TEST_ENVS, seeds);
+    assert(env != NULL);
+    TetrisEnvBuffers buffers = {&obs->planes[0][0][0], &obs->queue[0][0], &obs->stats[0][0], obs->rewards,
+                                obs->dones};
+    assert(env_bind_buffers(env, &buffers) == 0);
+    return env;
+}
+
+static int popcount16(uint16_t value) {
+    int count = 0;
+    while (value != 0) {
+        value &= (uint16_t)(value - 1);
+        ++count;
+    }
+    return count;
+}
+
+static int plane_cells(const uint16_t plane[TETRIS_ENV_ROWS]) {
+    int total = 0;
+    for (int row = 0; row < TETRIS_ENV_ROWS; ++row) {
+        total += popcount16(plane[row]);
+    }
+    return total;
+}
+
+static void test_initial_observation(void) {
+    Observations obs;
+    TetrisEnv *env = create_bound(&obs, NULL);
+
+    assert(env_abi_version() == TETRIS_ENV_ABI_VERSION);
+    assert(env_count(env) == TEST_ENVS);
+    for (int i = 0; i < TEST_ENVS; ++i) {
+        assert(plane_cells(obs.planes[i][TETRIS_ENV_PLANE_LOCKED]) == 0);
+        for (int q = 0; q < TETRIS_ENV_QUEUE_LEN; ++q) {
+            assert(obs.queue[i][q] >= 0 && obs.queue[i][q] < 7);
+        }
+        assert(obs.stats[i][TETRIS_ENV_STAT_SCORE] == 0);
+        assert(obs.stats[i][TETRIS_ENV_STAT_PIECES] == 0);
+        assert(obs.rewards[i] == 0.0f && obs.dones[i] == 0);
+    }
+
+    env_destroy(env);
+}
+
+static void test_queue_advances_with_hard_drop(void) {
+    Observations obs;
+    TetrisEnv *env = create_bound(&obs, NULL);
+    int32_t actions[TEST_ENVS];
+    for (int i = 0; i < TEST_ENVS; ++i) {
+        actions[i] = TETRIS_ACTION_HARD_DROP;
+    }
+
+    int8_t before[TEST_ENVS][TETRIS_ENV_QUEUE_LEN];
+    memcpy(before, obs.queue, sizeof(before));
+    assert(env_step(env, actions) == 0);
+
+    for (int i = 0; i < TEST_ENVS; ++i) {
+        assert(memcmp(obs.queue[i], before[i] + 1, TETRIS_ENV_QUEUE_LEN - 1) == 0);
+        assert(obs.stats[i][TETRIS_ENV_STAT_PIECES] == 1);
+        assert(plane_cells(obs.planes[i][TETRIS_ENV_PLANE_LOCKED]) == 4);
+        assert(obs.rewards[i] > 0.0f);
+    }
+
+    env_destroy(env);
+}
+
+static void test_game_over_resets_in_place(void) {
+    Observations obs;
+    TetrisEnv *env = create_bound(&obs, NULL);
+    int32_t actions[TEST_ENVS];
+    for (int i = 0; i < TEST_ENVS; ++i) {
+        actions[i] = TETRIS_ACTION_HARD_DROP;
+    }
+
+    bool finished[TEST_ENVS] = {false};
+    int remaining = TEST_ENVS;
+    for (int step = 0; step < 200 && remaining > 0; ++step) {
+        assert(env_step(env, actions) == 0);
+        for (int i = 0; i < TEST_ENVS; ++i) {
+            if (obs.dones[i] && !finished[i]) {
+                finished[i] = true;
+                --remaining;
+                assert(obs.stats[i][TETRIS_ENV_STAT_PIECES] == 0);
+                assert(obs.stats[i][TETRIS_ENV_STAT_SCORE] == 0);
+                assert(plane_cells(obs.planes[i][TETRIS_ENV_PLANE_LOCKED]) == 0);
+                assert(obs.queue[i][0] >= 0);
+            }
+        }
+    }
+    assert(remaining == 0);
+
+    env_destroy(env);
+}
+
+static void step_random(TetrisEnv *env, uint64_t *rng, int steps) {
+    int32_t actions[TEST_ENVS];
+    for (int step = 0; step < steps; ++step) {
+        for (int i = 0; i < TEST_ENVS; ++i) {
+            *rng ^= *rng << 13;
+            *rng ^= *rng >> 7;
+            *rng ^= *rng << 17;
+            actions[i] = (int32_t)(*rng % TETRIS_ACTION_COUNT);
+        }
+        assert(env_step(env, actions) == 0);
+    }
+}
+
+static void test_threads_match_single_thread(void) {
+    const uint64_t seeds[TEST_ENVS] = {1, 2, 3, 4, 5, 6, 7};
+    Observations single;
+    Observations threaded;
+    TetrisEnv *a = create_bound(&single, seeds);
+    TetrisEnv *b = create_bound(&threaded, seeds);
+    assert(env_set_threads(b, 3) == 0);
+
+    uint64_t rng_a = 99;
+    uint64_t rng_b = 99;
+    step_random(a, &rng_a, 400);
+    step_random(b, &rng_b, 150);
+    assert(env_set_threads(b, 2) == 0);
+    step_random(b, &rng_b, 250);
+    assert(memcmp(&single, &threaded, sizeof(single)) == 0);
+
+    assert(env_reset(a, seeds) == 0);
+    assert(env_reset(b, seeds) == 0);
+    step_random(a, &rng_a, 50);
+    step_random(b, &rng_b, 50);
+    assert(memcmp(&single, &threaded, sizeof(single)) == 0);
+
+    env_destroy(a);
+    env_destroy(b);
+}
+
+static void test_rejects_invalid_use(void) {
+    assert(env_create(0, NULL) == NULL);
+
+    TetrisEnv *env = env_create(2, NULL);
+    int32_t actions[2] = {0, 0};
+    assert(env_step(env, actions) == -1);
+    assert(env_bind_buffers(env, NULL) == -1);
+    env_destroy(env);
+    env_destroy(NULL);
+}
+
+int main(void) {
+    run_test("initial_observation", test_initial_observation);
+    run_test("queue_advances_with_hard_drop", test_queue_advances_with_hard_drop);
+    run_test("game_over_resets_in_place", test_game_over_resets_in_place);
+    run_test("threads_match_single_thread", test_threads_match_single_thread);
+    run_test("rejects_invalid_use", test_rejects_invalid_use);
+    return 0;
+}
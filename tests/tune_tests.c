@@ -0,0 +1,98 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "arena.h"
+#include "tune.h"
+
+#define CHECKPOINT_PATH "build/tests/tune_checkpoint.tmp"
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static void test_game_is_seeded(void) {
+    int lines = tune_play_game(&hint_default_weights, 1, 100);
+    assert(lines > 0 && lines <= 40);
+    uint64_t before = arena_heap_allocations();
+    assert(tune_play_game(&hint_default_weights, 1, 100) == lines);
+    assert(arena_heap_allocations() == before);
+    assert(tune_play_game(&hint_default_weights, 1, 0) == 0);
+}
+
+// Equal weights see the same pieces, so they score identically however the games are
+// spread over threads.
+static void test_evaluate_uses_common_seeds(void) {
+    static TuneState state;
+    tune_state_init(&state, 4, 9);
+    state.candidates[2] = state.candidates[0];
+    assert(tune_game_seed(&state, 0) != tune_game_seed(&state, 1));
+
+    TuneConfig config = {3, 60, 1};
+    assert(tune_evaluate(&state, &config) == 0);
+    assert(state.fitness[2] == state.fitness[0]);
+    double serial[4];
+    memcpy(serial, state.fitness, sizeof(serial));
+
+    config.threads = 3;
+    assert(tune_evaluate(&state, &config) == 0);
+    assert(memcmp(serial, state.fitness, sizeof(serial)) == 0);
+    for (int c = 0; c < 4; ++c) {
+        assert(state.best_fitness >= state.fitness[c]);
+    }
+
+    config.games = 0;
+    assert(tune_evaluate(&state, &config) == -1);
+}
+
+static void test_next_generation_keeps_the_best(void) {
+    static TuneState state;
+    tune_state_init(&state, 16, 3);
+    for (int c = 0; c < 16; ++c) {
+        state.fitness[c] = c;
+    }
+    HintWeights top = state.candidates[15];
+    HintWeights runner_up = state.candidates[14];
+
+    tune_next_generation(&state);
+    assert(state.generation == 1);
+    assert(memcmp(&state.candidates[0], &top, sizeof(top)) == 0);
+    assert(memcmp(&state.candidates[1], &runner_up, sizeof(runner_up)) == 0);
+    for (int c = 0; c < 16; ++c) {
+        double norm = 0.0;
+        for (int i = 0; i < HINT_FEATURE_COUNT; ++i) {
+            norm += state.candidates[c].weights[i] * state.candidates[c].weights[i];
+        }
+        assert(norm > 0.999 && norm < 1.001);
+    }
+}
+
+static void test_checkpoint_round_trip(void) {
+    static TuneState state;
+    static TuneState loaded;
+    tune_state_init(&state, 5, 77);
+    state.generation = 12;
+    state.best_fitness = 41.5;
+    state.best_generation = 7;
+    assert(tune_checkpoint_save(&state, CHECKPOINT_PATH) == 0);
+    assert(tune_checkpoint_load(&loaded, CHECKPOINT_PATH) == 0);
+    assert(memcmp(&loaded, &state, sizeof(state)) == 0);
+
+    FILE *fp = fopen(CHECKPOINT_PATH, "r+b");
+    assert(fp != NULL);
+    fputc(0, fp);
+    fclose(fp);
+    assert(tune_checkpoint_load(&loaded, CHECKPOINT_PATH) == -1);
+    remove(CHECKPOINT_PATH);
+    assert(tune_checkpoint_load(&loaded, CHECKPOINT_PATH) == -1);
+}
+
+int main(void) {
+    run_test("game_is_seeded", test_game_is_seeded);
+    run_test("evaluate_uses_common_seeds", test_evaluate_uses_common_seeds);
+    run_test("next_generation_keeps_the_best", test_next_generation_keeps_the_best);
+    run_test("checkpoint_round_trip", test_checkpoint_round_trip);
+    return 0;
+}
@@ -0,0 +1,189 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "engine.h"
+#include "match_server.h"
+#include "versus.h"
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static void test_garbage_shifts_stack_up(void) {
+    Board board;
+    board_reset(&board);
+    board.cells[BOARD_HEIGHT - 1][4] = 3;
+    board.cells[5][0] = 1;
+
+    assert(!board_insert_garbage(&board, 2, 7, ENGINE_GARBAGE_CELL));
+    assert(board.cells[BOARD_HEIGHT - 3][4] == 3);
+    assert(board.cells[3][0] == 1);
+    for (int row = BOARD_HEIGHT - 2; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            assert(board.cells[row][col] == (col == 7 ? 0 : ENGINE_GARBAGE_CELL));
+        }
+    }
+
+    board.cells[1][2] = 5;
+    assert(board_insert_garbage(&board, 2, 0, ENGINE_GARBAGE_CELL));
+}
+
+// Drop an O piece into columns 0-1 over `rows` bottom rows filled everywhere else.
+static void drop_o_into_well(Engine *engine, int rows) {
+    for (int row = BOARD_HEIGHT - rows; row < BOARD_HEIGHT; ++row) {
+        for (int col = 2; col < BOARD_WIDTH; ++col) {
+            engine->board.cells[row][col] = 1;
+        }
+    }
+    engine_spawn_pose(1, &engine->active);
+    engine->active.col = -2;
+    engine_hard_drop(engine);
+}
+
+static void test_attack_cancels_incoming_garbage(void) {
+    Engine engine;
+    engine_init(&engine, 9);
+    engine_start(&engine);
+    engine_take_events(&engine, NULL);
+
+    assert(engine_attack_for_clear(1) == 0);
+    assert(engine_attack_for_clear(2) == 1);
+    assert(engine_attack_for_clear(4) == 4);
+
+    engine_receive_garbage(&engine, 3);
+    drop_o_into_well(&engine, 2);
+    EngineEvents events;
+    uint32_t flags = engine_take_events(&engine, &events);
+    assert(events.cleared_count == 2);
+    assert((flags & ENGINE_EVENT_ATTACK) == 0);
+    assert(engine.garbage_pending == 2);
+
+    board_reset(&engine.board);
+    engine_hard_drop(&engine);
+    flags = engine_take_events(&engine, &events);
+    assert((flags & ENGINE_EVENT_GARBAGE) && events.garbage_lines == 2);
+    assert(engine.garbage_pending == 0);
+    int holes = 0;
+    for (int col = 0; col < BOARD_WIDTH; ++col) {
+        holes += engine.board.cells[BOARD_HEIGHT - 1][col] == 0;
+    }
+    assert(holes == 1);
+
+    board_reset(&engine.board);
+    drop_o_into_well(&engine, 2);
+    flags = engine_take_events(&engine, &events);
+    assert((flags & ENGINE_EVENT_ATTACK) && events.attack_lines == 1);
+}
+
+static void test_protocol_round_trip(void) {
+    VersusMessage board;
+    memset(&board, 0, sizeof(board));
+    board.type = VERSUS_MSG_BOARD;
+    board.player = 5;
+    board.rows[0] = 0x3FF;
+    board.rows[BOARD_HEIGHT - 1] = 0x201;
+    board.score = 123456;
+
+    VersusMessage match;
+    memset(&match, 0, sizeof(match));
+    match.type = VERSUS_MSG_MATCH;
+    match.player = 2;
+    match.player_count = 8;
+    match.seed = 0x0123456789ABCDEFULL;
+
+    unsigned char stream[2 * VERSUS_MAX_MESSAGE];
+    size_t first = versus_encode(&board, stream, sizeof(stream));
+    assert(first == VERSUS_MAX_MESSAGE);
+    size_t total = first + versus_encode(&match, stream + first, sizeof(stream) - first);
+    assert(total == first + VERSUS_HEADER_SIZE + 10);
+
+    VersusMessage decoded;
+    size_t consumed = 0;
+    assert(versus_decode(stream, first - 1, &decoded, &consumed) == 0);
+    assert(versus_decode(stream, total, &decoded, &consumed) == 1 && consumed == first);
+    assert(memcmp(&decoded, &board, sizeof(board)) == 0);
+    assert(versus_decode(stream + first, total - first, &decoded, &consumed) == 1);
+    assert(memcmp(&decoded, &match, sizeof(match)) == 0);
+
+    stream[0] = 0x7F;
+    assert(versus_decode(stream, total, &decoded, &consumed) == -1);
+}
+
+// Pump the server until `conn` has a message (or give up after a second).
+static int receive_with_server(MatchServer *server, VersusConn *conn, VersusMessage *message) {
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        int status = versus_conn_receive(conn, message);
+        if (status != 0) {
+            return status;
+        }
+        match_server_poll(server, 10);
+    }
+    return 0;
+}
+
+static void test_server_pairs_and_routes(void) {
+    char address[64];
+    snprintf(address, sizeof(address), "unix:/tmp/tetris_versus_test_%ld.sock", (long)getpid());
+
+    static MatchServer server;
+    assert(match_server_open(&server, address, 2, 1) == 0);
+
+    VersusConn clients[2];
+    VersusMessage message;
+    memset(&message, 0, sizeof(message));
+    message.type = VERSUS_MSG_HELLO;
+    message.version = VERSUS_PROTOCOL_VERSION;
+    for (int i = 0; i < 2; ++i) {
+        versus_conn_init(&clients[i], versus_connect(address));
+        assert(!clients[i].closed);
+        assert(versus_conn_send(&clients[i], &message) == 0);
+        match_server_poll(&server, 10);
+    }
+
+    VersusMessage matched[2];
+    for (int i = 0; i < 2; ++i) {
+        assert(receive_with_server(&server, &clients[i], &matched[i]) == 1);
+        assert(matched[i].type == VERSUS_MSG_MATCH && matched[i].player_count == 2);
+    }
+    assert(matched[0].player != matched[1].player);
+    assert(matched[0].seed == matched[1].seed);
+
+    memset(&message, 0, sizeof(message));
+    message.type = VERSUS_MSG_ATTACK;
+    message.lines = 4;
+    assert(versus_conn_send(&clients[0], &message) == 0);
+    assert(receive_with_server(&server, &clients[1], &message) == 1);
+    assert(message.type == VERSUS_MSG_GARBAGE && message.lines == 4 && message.player == matched[0].player);
+
+    memset(&message, 0, sizeof(message));
+    message.type = VERSUS_MSG_BOARD;
+    message.rows[BOARD_HEIGHT - 1] = 0x1F;
+    assert(versus_conn_send(&clients[1], &message) == 0);
+    assert(receive_with_server(&server, &clients[0], &message) == 1);
+    assert(message.type == VERSUS_MSG_BOARD && message.player == matched[1].player);
+    assert(message.rows[BOARD_HEIGHT - 1] == 0x1F);
+
+    versus_conn_close(&clients[1]);
+    assert(receive_with_server(&server, &clients[0], &message) == 1);
+    assert(message.type == VERSUS_MSG_TOPPED_OUT && message.player == matched[1].player);
+    assert(receive_with_server(&server, &clients[0], &message) == 1);
+    assert(message.type == VERSUS_MSG_RESULT && message.player == matched[0].player);
+
+    versus_conn_close(&clients[0]);
+    match_server_close(&server);
+    unlink(address + 5);
+}
+
+int main(void) {
+    run_test("garbage_shifts_stack_up", test_garbage_shifts_stack_up);
+    run_test("attack_cancels_incoming_garbage", test_attack_cancels_incoming_garbage);
+    run_test("protocol_round_trip", test_protocol_round_trip);
+    run_test("server_pairs_and_routes", test_server_pairs_and_routes);
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "term.h"
+#include "vt100.h"
+
+static void run_test(const char *name, void (*fn)(void)) {
+    printf("[RUN] %s\n", name);
+    fn();
+    printf("[OK ] %s\n", name);
+}
+
+static size_t count_occurrences(const Vt100Screen *screen, const char *needle) {
+    size_t count = 0;
+    size_t needle_len = strlen(needle);
+    for (size_t i = 0; i + needle_len <= screen->out.len; ++i) {
+        if (memcmp(screen->out.data + i, needle, needle_len) == 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static bool output_equals(const Vt100Screen *screen, const char *expected) {
+    return screen->out.len == strlen(expected) && memcmp(screen->out.data, expected, screen->out.len) == 0;
+}
+
+static void test_first_frame_clears_and_draws(void) {
+    Vt100Screen screen;
+    assert(vt100_screen_init(&screen, 5, 10) == 0);
+
+    vt100_put(&screen, 1, 2, "hi", 2);
+    size_t len = vt100_compose(&screen);
+    assert(len == screen.out.len);
+    assert(output_equals(&screen, "\x1b[0m\x1b(B\x1b[H\x1b[2J\x1b[2;3Hhi"));
+
+    vt100_screen_destroy(&screen);
+}
+
+static void test_unchanged_frame_writes_nothing(void) {
+    Vt100Screen screen;
+    assert(vt100_screen_init(&screen, 5, 10) == 0);
+
+    vt100_put(&screen, 0, 0, "abc", 3);
+    vt100_compose(&screen);
+
+    vt100_clear(&screen);
+    vt100_put(&screen, 0, 0, "abc", 3);
+    assert(vt100_compose(&screen) == 0);
+
+    vt100_clear(&screen);
+    vt100_put(&screen, 0, 0, "abd", 3);
+    vt100_compose(&screen);
+    assert(output_equals(&screen, "\x1b[1;3Hd"));
+
+    vt100_screen_destroy(&screen);
+}
+
+static void test_attribute_runs_share_one_sgr(void) {
+    Vt100Screen screen;
+    assert(vt100_screen_init(&screen, 3, 20) == 0);
+    vt100_compose(&screen);
+
+    screen.attr = TERM_COLOR_CYAN;
+    vt100_put(&screen, 1, 0, "[][][]", 6);
+    screen.attr = TERM_ATTR_REVERSE | TERM_COLOR_YELLOW;
+    vt100_put(&screen, 1, 6, "  ", 2);
+    screen.attr = TERM_ATTR_NORMAL;
+    vt100_compose(&screen);
+
+    assert(output_equals(&screen, "\x1b[2;1H\x1b[0;36m[][][]\x1b[0;7;33m  \x1b[0m"));
+    assert(count_occurrences(&screen, "\x1b[0;36m") == 1);
+
+    vt100_screen_destroy(&screen);
+}
+
+static void test_box_uses_line_drawing_set(void) {
+    Vt100Screen screen;
+    assert(vt100_screen_init(&screen, 3, 4) == 0);
+
+    vt100_box(&screen);
+    vt100_compose(&screen);
+    assert(count_occurrences(&screen, "\x1b(0") == 1);
+    assert(count_occurrences(&screen, "lqqk") == 1);
+    assert(count_occurrences(&screen, "mqqj") == 1);
+    assert(screen.out.len >= 3 && memcmp(screen.out.data + screen.out.len - 3, "\x1b(B", 3) == 0);
+    assert(screen.attr == TERM_ATTR_NORMAL);
+
+    vt100_screen_destroy(&screen);
+}
+
+static void test_clipping_and_resize(void) {
+    Vt100Screen screen;
+    assert(vt100_screen_init(&screen, 2, 4) == 0);
+
+    vt100_put(&screen, 0, -1, "xabcdef", 7);
+    vt100_put(&screen, 5, 0, "zz", 2);
+    vt100_compose(&screen);
+    assert(count_occurrences(&screen, "abcd") == 1);
+    assert(count_occurrences(&screen, "x") == 0);
+
+    assert(vt100_screen_resize(&screen, 3, 6) == 0);
+    assert(screen.full_redraw);
+    vt100_put(&screen, 2, 0, "ok", 2);
+    vt100_compose(&screen);
+    assert(count_occurrences(&screen, "\x1b[2J") == 1);
+
+    // A resize whose grids cannot be allocated leaves the old ones in place.
+    assert(vt100_screen_resize(&screen, 1 << 20, 1 << 20) == -1);
+    assert(screen.rows == 3 && screen.cols == 6);
+    vt100_put(&screen, 2, 2, "still", 5);
+    vt100_compose(&screen);
+    assert(count_occurrences(&screen, "still") == 0 && count_occurrences(&screen, "stil") == 1);
+
+    vt100_screen_destroy(&screen);
+}
+
+static void test_parse_keys(void) {
+    size_t used = 0;
+    const unsigned char arrows[] = "\x1b[A\x1bOD\x1b[1;5Cq";
+    size_t offset = 0;
+
+    assert(vt100_parse_key(arrows + offset, sizeof(arrows) - 1 - offset, &used) == TERM_KEY_UP);
+    offset += used;
+    assert(vt100_parse_key(arrows + offset, sizeof(arrows) - 1 - offset, &used) == TERM_KEY_LEFT);
+    offset += used;
+    assert(vt100_parse_key(arrows + offset, sizeof(arrows) - 1 - offset, &used) == TERM_KEY_RIGHT);
+    offset += used;
+    assert(vt100_parse_key(arrows + offset, sizeof(arrows) - 1 - offset, &used) == 'q');
+    offset += used;
+    assert(offset == sizeof(arrows) - 1);
+
+    const unsigned char unknown[] = "\x1b[15~";
+    assert(vt100_parse_key(unknown, sizeof(unknown) - 1, &used) == TERM_KEY_NONE);
+    assert(used == sizeof(unknown) - 1);
+
+    // A sequence split across reads is left for the caller to complete.
+    const unsigned char split[] = "\x1b[1;5D";
+    assert(vt100_parse_key(split, 2, &used) == TERM_KEY_NONE && used == 0);
+    assert(vt100_parse_key(split, 5, &used) == TERM_KEY_NONE && used == 0);
+    assert(vt100_parse_key(split, sizeof(split) - 1, &used) == TERM_KEY_LEFT && used == sizeof(split) - 1);
+
+    const unsigned char lone_escape[] = "\x1b";
+    assert(vt100_parse_key(lone_escape, 1, &used) == 0x1b && used == 1);
+    assert(vt100_parse_key(NULL, 0, &used) == TERM_KEY_NONE && used == 0);
+}
+
+int main(void) {
+    run_test("first_frame_clears_and_draws", test_first_frame_clears_and_draws);
+    run_test("unchanged_frame_writes_nothing", test_unchanged_frame_writes_nothing);
+    run_test("attribute_runs_share_one_sgr", test_attribute_runs_share_one_sgr);
+    run_test("box_uses_line_drawing_set", test_box_uses_line_drawing_set);
+    run_test("clipping_and_resize", test_clipping_and_resize);
+    run_test("parse_keys", test_parse_keys);
+    return 0;
+}
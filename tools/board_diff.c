@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "board_diff.h"
+#include "frame_stats.h"
+
+// Differential run of the bitboard backend against board.c: checks every op of N random
+// streams (or of streams cut from an exported dataset with --replay) on all cores, times
+// each backend alone on one stream, and prints the minimized reproducer on divergence.
+// Usage: board_diff [streams] [ops_per_stream] [threads] [--replay FILE]
+
+// Single-backend throughput on one stream, in million ops per second.
+static double backend_mops(const BoardBackend *backend, const BoardOpStream *stream) {
+    void *state = malloc(backend->state_size);
+    if (state == NULL || stream->count == 0) {
+        free(state);
+        return 0.0;
+    }
+    backend->reset(state);
+    uint64_t start = frame_stats_now_us();
+    int sink = 0;
+    for (int pass = 0; pass < 20; ++pass) {
+        for (size_t i = 0; i < stream->count; ++i) {
+            BoardOpResult result;
+            board_diff_apply(backend, state, stream, &stream->ops[i], &result);
+            sink += result.value;
+        }
+    }
+    uint64_t elapsed = frame_stats_now_us() - start;
+    free(state);
+    return (sink == -1) ? 0.0 : (double)stream->count * 20 / (double)(elapsed ? elapsed : 1);
+}
+
+int main(int argc, char **argv) {
+    const char *replay_path = NULL;
+    long numbers[3] = {64, 100000, 0};
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (positional < 3) {
+            numbers[positional++] = atol(argv[i]);
+        }
+    }
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    BoardDiffConfig config;
+    memset(&config, 0, sizeof(config));
+    config.seed = 1;
+    config.streams = (int)numbers[0];
+    config.ops_per_stream = (size_t)numbers[1];
+    config.records_per_stream = (size_t)numbers[1];
+    config.threads = (numbers[2] > 0) ? (int)numbers[2] : (cores > 0 ? (int)cores : 1);
+    if (config.streams < 1 || numbers[1] < 1 || config.threads > BOARD_DIFF_MAX_THREADS) {
+        fprintf(stderr, "Usage: %s [streams] [ops_per_stream] [threads 1-%d] [--replay FILE]\n", argv[0],
+                BOARD_DIFF_MAX_THREADS);
+        return 1;
+    }
+
+    DatasetView view;
+    if (replay_path != NULL) {
+        if (dataset_view_open(&view, replay_path) != 0) {
+            fprintf(stderr, "cannot open dataset %s\n", replay_path);
+            return 1;
+        }
+        config.replay = &view;
+    }
+
+    const BoardBackend *candidate = board_backend_bitboard();
+    BoardDiffReport report;
+    uint64_t start = frame_stats_now_us();
+    int status = board_diff_run(candidate, &config, &report);
+    uint64_t elapsed = frame_stats_now_us() - start;
+    if (status != 0) {
+        fprintf(stderr, "differential run failed\n");
+        if (replay_path != NULL) {
+            dataset_view_close(&view);
+        }
+        return 1;
+    }
+    printf("candidate:   %s vs %s\n", candidate->name, board_backend_reference()->name);
+    printf("source:      %s\n", replay_path != NULL ? replay_path : "random streams");
+    printf("checked:     %llu ops in %d streams on %d threads, %.2f s (%.1f M ops/s)\n",
+           (unsigned long long)report.ops, report.streams, config.threads, (double)elapsed / 1e6,
+           (double)report.ops / (double)(elapsed ? elapsed : 1));
+
+    BoardOpStream sample;
+    board_op_stream_init(&sample);
+    int sampled = (replay_path != NULL) ? board_diff_replay_stream(&sample, &view, 0, config.records_per_stream)
+                                        : board_diff_random_stream(&sample, config.seed, config.ops_per_stream);
+    if (sampled == 0) {
+        printf("alone:       reference %.1f M ops/s, %s %.1f M ops/s\n",
+               backend_mops(board_backend_reference(), &sample), candidate->name, backend_mops(candidate, &sample));
+    }
+    board_op_stream_free(&sample);
+    if (replay_path != NULL) {
+        dataset_view_close(&view);
+    }
+
+    if (report.failing_stream < 0) {
+        printf("result:      no divergence\n");
+        return 0;
+    }
+    printf("result:      stream %d diverges at op %zu; minimized to %zu ops:\n", report.failing_stream,
+           report.failing_op, report.reproducer.count);
+    for (size_t i = 0; i < report.reproducer.count; ++i) {
+        char line[256];
+        board_diff_format_op(&report.reproducer.ops[i], &report.reproducer, line, sizeof(line));
+        printf("  %s\n", line);
+    }
+    board_op_stream_free(&report.reproducer);
+    return 1;
+}
@@ -0,0 +1,74 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "tetris_env.h"
+
+// Steps a batch of environments with pseudo-random actions through libtetris and
+// reports steps/sec. Usage: env_bench [envs] [threads] [steps]
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+    int count = (argc > 1) ? atoi(argv[1]) : 4096;
+    int threads = (argc > 2) ? atoi(argv[2]) : 1;
+    int steps = (argc > 3) ? atoi(argv[3]) : 500;
+    if (count <= 0 || steps <= 0) {
+        fprintf(stderr, "Usage: %s [envs] [threads] [steps]\n", argv[0]);
+        return 1;
+    }
+
+    TetrisEnv *env = env_create(count, NULL);
+    size_t n = (size_t)count;
+    uint16_t *planes = malloc(n * TETRIS_ENV_PLANE_COUNT * TETRIS_ENV_ROWS * sizeof(uint16_t));
+    int8_t *queue = malloc(n * TETRIS_ENV_QUEUE_LEN);
+    int32_t *stats = malloc(n * TETRIS_ENV_STAT_COUNT * sizeof(int32_t));
+    float *rewards = malloc(n * sizeof(float));
+    uint8_t *dones = malloc(n);
+    int32_t *actions = malloc(n * sizeof(int32_t));
+    if (env == NULL || planes == NULL || queue == NULL || stats == NULL || rewards == NULL || dones == NULL ||
+        actions == NULL) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    TetrisEnvBuffers buffers = {planes, queue, stats, rewards, dones};
+    env_bind_buffers(env, &buffers);
+    env_set_threads(env, threads);
+
+    uint64_t rng = 0x2545F4914F6CDD1DULL;
+    uint64_t episodes = 0;
+    uint64_t start = now_ns();
+    for (int step = 0; step < steps; ++step) {
+        for (size_t i = 0; i < n; ++i) {
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            actions[i] = (int32_t)(rng % TETRIS_ACTION_COUNT);
+        }
+        env_step(env, actions);
+        for (size_t i = 0; i < n; ++i) {
+            episodes += dones[i];
+        }
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    double total = (double)count * (double)steps;
+    printf("abi %d: %d envs x %d steps on %d thread(s): %.0f steps/s, %llu episodes finished\n",
+           env_abi_version(), count, steps, threads, total * 1e9 / (double)elapsed,
+           (unsigned long long)episodes);
+
+    env_destroy(env);
+    free(planes);
+    free(queue);
+    free(stats);
+    free(rewards);
+    free(dones);
+    free(actions);
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dataset.h"
+#include "engine.h"
+#include "frame_stats.h"
+#include "hint.h"
+#include "perft.h"
+
+// Plays headless games with a greedy placement policy (the hint evaluator's stack features,
+// plus some random moves for variety) and streams one record per placed piece into a
+// columnar dataset file. The same games are first played without exporting, so the
+// report shows what the exporter costs the simulation.
+// Usage: export_dataset FILE [games] [seed] [max_pieces_per_game]
+
+static uint64_t xorshift(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static bool choose_placement(const Engine *engine, uint64_t *rng, ActivePiece *out) {
+    ActivePiece placements[PERFT_MAX_PLACEMENTS];
+    int count = perft_generate(&engine->board, engine->active.type, placements, PERFT_MAX_PLACEMENTS);
+    if (count == 0) {
+        return false;
+    }
+    if (xorshift(rng) % 10 == 0) {
+        *out = placements[xorshift(rng) % (uint64_t)count];
+        return true;
+    }
+
+    const PieceShape *shape = piece_shape_get((size_t)engine->active.type);
+    double best = -1e300;
+    for (int i = 0; i < count; ++i) {
+        Board trial = engine->board;
+        board_lock_shape(&trial, shape, placements[i].rotation, placements[i].row, placements[i].col, 1);
+        int cleared = board_clear_completed_lines(&trial, NULL, 0);
+        double value = hint_evaluate(&trial, cleared);
+        if (value > best) {
+            best = value;
+            *out = placements[i];
+        }
+    }
+    return true;
+}
+
+// Play `games` games; with a writer, export every placement. Returns placements made.
+static uint64_t play(int games, uint64_t seed, int max_pieces, DatasetWriter *writer) {
+    Engine engine;
+    uint64_t rng = seed | 1;
+    uint64_t placed = 0;
+
+    for (int game = 0; game < games; ++game) {
+        engine_init(&engine, seed + (uint64_t)game);
+        engine_start(&engine);
+        engine_take_events(&engine, NULL);
+
+        for (int piece = 0; piece < max_pieces && engine.phase == ENGINE_PHASE_PLAYING; ++piece) {
+            DatasetRecord record;
+            ActivePiece placement;
+            dataset_record_from_engine(&record, &engine);
+            if (!choose_placement(&engine, &rng, &placement)) {
+                break;
+            }
+
+            int64_t score_before = engine.score.current;
+            engine.active = placement;
+            engine_hard_drop(&engine);
+            EngineEvents events;
+            engine_take_events(&engine, &events);
+            ++placed;
+
+            if (writer != NULL) {
+                record.rotation = (int8_t)placement.rotation;
+                record.row = (int8_t)placement.row;
+                record.col = (int8_t)placement.col;
+                record.lines = (uint8_t)events.cleared_count;
+                record.done = engine.phase == ENGINE_PHASE_GAME_OVER;
+                record.score_delta = (int32_t)(engine.score.current - score_before);
+                record.game = (uint32_t)game;
+                if (dataset_writer_append(writer, &record) != 0) {
+                    fprintf(stderr, "write failed\n");
+                    exit(1);
+                }
+            }
+        }
+    }
+    return placed;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s FILE [games] [seed] [max_pieces_per_game]\n", argv[0]);
+        return 1;
+    }
+    const char *path = argv[1];
+    int games = (argc > 2) ? atoi(argv[2]) : 20;
+    uint64_t seed = (argc > 3) ? strtoull(argv[3], NULL, 10) : 1;
+    int max_pieces = (argc > 4) ? atoi(argv[4]) : 5000;
+    if (games <= 0 || max_pieces <= 0) {
+        fprintf(stderr, "Usage: %s FILE [games] [seed] [max_pieces_per_game]\n", argv[0]);
+        return 1;
+    }
+
+    uint64_t start = frame_stats_now_us();
+    uint64_t simulated = play(games, seed, max_pieces, NULL);
+    uint64_t sim_us = frame_stats_now_us() - start;
+
+    static DatasetWriter writer;
+    if (dataset_writer_open(&writer, path) != 0) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+    start = frame_stats_now_us();
+    uint64_t exported = play(games, seed, max_pieces, &writer);
+    uint64_t stalls = writer.stalls;
+    if (dataset_writer_close(&writer) != 0) {
+        fprintf(stderr, "write failed\n");
+        return 1;
+    }
+    uint64_t export_us = frame_stats_now_us() - start;
+
+    DatasetView view;
+    if (dataset_view_open(&view, path) != 0 || view.header->record_count != exported) {
+        fprintf(stderr, "%s does not read back\n", path);
+        return 1;
+    }
+    uint64_t blocks = view.header->block_count;
+    dataset_view_close(&view);
+
+    double sim_rate = simulated * 1e6 / (double)(sim_us ? sim_us : 1);
+    double export_rate = exported * 1e6 / (double)(export_us ? export_us : 1);
+    printf("%llu records in %llu blocks -> %s\n", (unsigned long long)exported, (unsigned long long)blocks, path);
+    printf("simulation only: %.0f placements/s; with export: %.0f records/s (%.1f%% of simulation speed), "
+           "%llu writer stalls\n",
+           sim_rate, export_rate, 100.0 * export_rate / sim_rate, (unsigned long long)stalls);
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dataset.h"
+#include "finesse.h"
+#include "frame_stats.h"
+
+// Bulk finesse analysis over a placement corpus written by export_dataset: looks up the
+// fewest presses for every recorded placement straight from the mapped piece, rotation,
+// and column columns, and reports the distribution and pieces analyzed per minute. The
+// corpus is swept `passes` times so small files still give a stable rate.
+// Usage: finesse_stats FILE [passes]
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s FILE [passes]\n", argv[0]);
+        return 1;
+    }
+    int passes = (argc > 2) ? atoi(argv[2]) : 1;
+    if (passes < 1) {
+        passes = 1;
+    }
+
+    DatasetView view;
+    if (dataset_view_open(&view, argv[1]) != 0) {
+        fprintf(stderr, "cannot open dataset %s\n", argv[1]);
+        return 1;
+    }
+    const DatasetHeader *header = view.header;
+
+    FinesseSummary summary;
+    memset(&summary, 0, sizeof(summary));
+    uint64_t start = frame_stats_now_us();
+    for (int pass = 0; pass < passes; ++pass) {
+        uint64_t remaining = header->record_count;
+        for (uint64_t block = 0; block < header->block_count && remaining > 0; ++block) {
+            size_t count = (remaining < header->records_per_block) ? (size_t)remaining : header->records_per_block;
+            finesse_analyze(dataset_view_column(&view, block, DATASET_COL_PIECE),
+                            dataset_view_column(&view, block, DATASET_COL_ROTATION),
+                            dataset_view_column(&view, block, DATASET_COL_COL), NULL, count, &summary);
+            remaining -= count;
+        }
+    }
+    uint64_t elapsed = frame_stats_now_us() - start;
+    dataset_view_close(&view);
+
+    uint64_t placed = summary.pieces - summary.unreachable;
+    printf("pieces:      %llu over %d pass(es)\n", (unsigned long long)summary.pieces, passes);
+    printf("optimal:     %.3f presses per piece (%llu not reachable by shifts and rotations)\n",
+           placed ? (double)summary.optimal_inputs / (double)placed : 0.0, (unsigned long long)summary.unreachable);
+    for (int presses = 0; presses <= FINESSE_MAX_PATH; ++presses) {
+        if (summary.optimal_histogram[presses] > 0) {
+            printf("  %d presses: %6.2f%%\n", presses,
+                   100.0 * (double)summary.optimal_histogram[presses] / (double)(placed ? placed : 1));
+        }
+    }
+    printf("throughput:  %.1f M pieces/min\n", (double)summary.pieces * 60.0 / (double)(elapsed ? elapsed : 1));
+    return 0;
+}
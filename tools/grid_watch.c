@@ -0,0 +1,214 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "finesse.h"
+#include "frame_stats.h"
+#include "grid_view.h"
+#include "lockstep.h"
+#include "term.h"
+
+// Watches many simulated games at once. Simulation threads step lockstep batches as fast
+// as they can, every lane a bot that hard drops each piece where the hint evaluation likes
+// it best (restarted when it tops out), and publish into grid slots only when the viewer
+// asks; the main thread tiles the games and prints both sides' throughput on exit. With
+// "none" no viewer runs, which gives the simulation speed to compare against.
+// Usage: grid_watch [boards 4-64] [seconds, 0 until q] [ncurses|vt100|null|none]
+
+#define LANES_PER_THREAD 16
+#define MAX_THREADS (GRID_MAX_BOARDS / LANES_PER_THREAD)
+#define KEY_QUEUE (FINESSE_MAX_PATH + 8)
+#define VIEWER_NAP_MS 10
+
+typedef struct {
+    int first; // first board this thread plays
+    int lanes;
+    LockstepBatch batch;
+    uint8_t queue[LOCKSTEP_MAX_LANES][KEY_QUEUE];
+    int queued[LOCKSTEP_MAX_LANES];
+    int next[LOCKSTEP_MAX_LANES];
+    uint64_t rng;
+    uint64_t games;
+    uint64_t pieces; // from finished games
+    _Alignas(64) _Atomic uint64_t frames;
+    pthread_t thread;
+} Simulation;
+
+static GridSlot g_slots[GRID_MAX_BOARDS];
+static Simulation g_simulations[MAX_THREADS];
+static GridView g_view;
+static _Atomic bool g_stopping;
+
+static uint64_t next_random(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+// Queues the key presses for the lane's current piece: its finesse path to the best
+// placement, a hard drop, then up to three idle frames.
+static void plan_piece(Simulation *sim, int lane) {
+    static const uint8_t k_inputs[FINESSE_INPUT_COUNT] = {PERF_KEY_LEFT, PERF_KEY_RIGHT, PERF_KEY_ROTATE,
+                                                         PERF_KEY_SOFT_DROP};
+    const Engine *engine = lockstep_engine(&sim->batch, lane);
+    const FinessePath *path = finesse_best_path(&engine->board, engine->active.type);
+    int count = 0;
+    for (int i = 0; path != NULL && i < path->length; ++i) {
+        sim->queue[lane][count++] = k_inputs[path->inputs[i]];
+    }
+    sim->queue[lane][count++] = PERF_KEY_HARD_DROP;
+    for (uint64_t pause = next_random(&sim->rng) % 4; pause > 0; --pause) {
+        sim->queue[lane][count++] = PERF_KEY_IDLE;
+    }
+    sim->queued[lane] = count;
+    sim->next[lane] = 0;
+}
+
+static void *simulate(void *arg) {
+    Simulation *sim = arg;
+    uint8_t keys[LOCKSTEP_MAX_LANES];
+    uint64_t frames = 0;
+    while (!atomic_load_explicit(&g_stopping, memory_order_relaxed)) {
+        for (int lane = 0; lane < sim->lanes; ++lane) {
+            if (!sim->batch.live[lane]) {
+                sim->pieces += lockstep_engine(&sim->batch, lane)->stats.pieces;
+                lockstep_start(&sim->batch, lane, next_random(&sim->rng) | 1U);
+                sim->games++;
+                sim->queued[lane] = 0;
+            }
+            if (sim->next[lane] >= sim->queued[lane]) {
+                plan_piece(sim, lane);
+            }
+            keys[lane] = sim->queue[lane][sim->next[lane]++];
+        }
+        lockstep_step(&sim->batch, keys, PERF_FRAME_MS);
+        frames += (uint64_t)sim->lanes;
+        atomic_store_explicit(&sim->frames, frames, memory_order_relaxed);
+
+        for (int lane = 0; lane < sim->lanes; ++lane) {
+            GridSlot *slot = &g_slots[sim->first + lane];
+            if (grid_slot_wanted(slot)) {
+                grid_slot_publish(slot, lockstep_engine(&sim->batch, lane));
+            }
+        }
+    }
+    return NULL;
+}
+
+static uint64_t frames_so_far(int threads) {
+    uint64_t frames = 0;
+    for (int t = 0; t < threads; ++t) {
+        frames += atomic_load_explicit(&g_simulations[t].frames, memory_order_relaxed);
+    }
+    return frames;
+}
+
+// Draws until q or the time limit; the status line is refreshed once a second.
+static void watch(int boards, int threads, uint64_t limit_us) {
+    uint64_t start = frame_stats_now_us();
+    uint64_t status_due = 0;
+    uint64_t last_frames = 0;
+    uint64_t last_us = start;
+    for (;;) {
+        uint64_t now = frame_stats_now_us();
+        if ((limit_us > 0 && now - start >= limit_us) || term_read_key() == 'q') {
+            break;
+        }
+
+        bool dirty = grid_view_draw(&g_view, now) > 0;
+        if (now >= status_due) {
+            uint64_t frames = frames_so_far(threads);
+            double rate = (double)(frames - last_frames) / ((double)(now - last_us + 1) / 1e6);
+            term_set_attr(TERM_ATTR_BOLD);
+            term_printf(0, 0, "%d games (%d shown), %.1fM frames/s   q quits   ", boards, g_view.shown, rate / 1e6);
+            term_set_attr(TERM_ATTR_NORMAL);
+            last_frames = frames;
+            last_us = now;
+            status_due = now + 1000000U;
+            dirty = true;
+        }
+        if (dirty) {
+            term_flush();
+        }
+        term_nap(VIEWER_NAP_MS);
+    }
+}
+
+int main(int argc, char **argv) {
+    int boards = (argc > 1) ? atoi(argv[1]) : 16;
+    int seconds = (argc > 2) ? atoi(argv[2]) : 10;
+    const char *viewer = (argc > 3) ? argv[3] : "ncurses";
+    bool headless = strcmp(viewer, "none") == 0;
+    TermBackend backend = TERM_BACKEND_NCURSES;
+    if (boards < GRID_MIN_BOARDS || boards > GRID_MAX_BOARDS || seconds < 0 || (headless && seconds == 0) ||
+        (!headless && term_backend_parse(viewer, &backend) != 0)) {
+        fprintf(stderr, "Usage: %s [boards %d-%d] [seconds, 0 until q] [ncurses|vt100|null|none]\n", argv[0],
+                GRID_MIN_BOARDS, GRID_MAX_BOARDS);
+        return 1;
+    }
+
+    for (int i = 0; i < boards; ++i) {
+        grid_slot_init(&g_slots[i]);
+    }
+    if (!headless) {
+        if (term_init(backend) != 0) {
+            fprintf(stderr, "terminal setup failed\n");
+            return 1;
+        }
+        backend = term_backend();
+        grid_view_init(&g_view, g_slots, boards, GRID_DEFAULT_INTERVAL_MS);
+    }
+
+    int threads = (boards + LANES_PER_THREAD - 1) / LANES_PER_THREAD;
+    int started = 0;
+    uint64_t start = frame_stats_now_us();
+    for (int t = 0; t < threads; ++t) {
+        Simulation *sim = &g_simulations[t];
+        sim->first = boards * t / threads;
+        sim->lanes = boards * (t + 1) / threads - sim->first;
+        sim->rng = 0x9E3779B97F4A7C15ULL * (uint64_t)(t + 1);
+        lockstep_init(&sim->batch, sim->lanes, LOCKSTEP_KERNEL_AUTO);
+        if (pthread_create(&sim->thread, NULL, simulate, sim) != 0) {
+            atomic_store(&g_stopping, true);
+            break;
+        }
+        ++started;
+    }
+
+    if (!headless) {
+        watch(boards, started, (uint64_t)seconds * 1000000U);
+    } else {
+        term_nap(seconds * 1000);
+    }
+    atomic_store(&g_stopping, true);
+    uint64_t pieces = 0;
+    uint64_t games = 0;
+    for (int t = 0; t < started; ++t) {
+        Simulation *sim = &g_simulations[t];
+        pthread_join(sim->thread, NULL);
+        for (int lane = 0; lane < sim->lanes; ++lane) {
+            pieces += lockstep_engine(&sim->batch, lane)->stats.pieces;
+        }
+        pieces += sim->pieces;
+        games += sim->games;
+    }
+    double elapsed = (double)(frame_stats_now_us() - start) / 1e6;
+    if (!headless) {
+        term_shutdown();
+    }
+
+    printf("simulation:  %d games on %d threads (%s kernel), %.0f frames/s, %.0f pieces/s, %lu games started\n",
+           boards, started, lockstep_kernel_name(g_simulations[0].batch.kernel),
+           (double)frames_so_far(started) / elapsed, (double)pieces / elapsed, (unsigned long)games);
+    if (!headless) {
+        printf("viewer:      %s, %d tiles shown, %lu tile redraws, %lu rows written, %lu torn reads\n",
+               term_backend_name(backend), g_view.shown, (unsigned long)g_view.tile_redraws,
+               (unsigned long)g_view.rows_written, (unsigned long)g_view.torn_reads);
+    }
+    return started == threads ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "frame_stats.h"
+#include "lockstep.h"
+#include "replay_corpus.h"
+
+// Lockstep throughput against stepping the same games one at a time. Each lane replays a
+// corpus session (restarted when it ends) or presses random keys (restarted on topout);
+// the games are played once per engine, once per lockstep kernel, and must end identical.
+// Usage: lockstep_bench [lanes] [frames] [corpus|random]
+
+#define MAX_SESSION_FRAMES 20000
+
+// Keys for every lane and frame, generated before timing; a lane restarts when its game is
+// over or, for corpus keys, when its script starts over.
+typedef struct {
+    int lanes;
+    long frames;
+    bool corpus;
+    uint8_t *keys; // frames x lanes
+    int lengths[LOCKSTEP_MAX_LANES];
+} Workload;
+
+static Engine g_engines[LOCKSTEP_MAX_LANES];
+static LockstepBatch g_batch;
+
+static int workload_init(Workload *work, int lanes, long frames, bool corpus) {
+    static uint8_t script[MAX_SESSION_FRAMES];
+    work->lanes = lanes;
+    work->frames = frames;
+    work->corpus = corpus;
+    work->keys = malloc((size_t)lanes * (size_t)frames);
+    if (work->keys == NULL) {
+        return -1;
+    }
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    for (int lane = 0; lane < lanes; ++lane) {
+        const ReplaySession *session = &replay_corpus[lane % replay_corpus_count];
+        work->lengths[lane] = perf_script_decode(session->script, script, sizeof(script));
+        for (long frame = 0; frame < frames; ++frame) {
+            uint8_t key = script[frame % work->lengths[lane]];
+            if (!corpus) {
+                // Mostly idle frames and moves, with a hard drop about once a second.
+                rng ^= rng << 13;
+                rng ^= rng >> 7;
+                rng ^= rng << 17;
+                uint64_t roll = rng % 64;
+                key = (roll < 36) ? PERF_KEY_IDLE : (roll == 63) ? PERF_KEY_HARD_DROP : (uint8_t)(1 + roll % 4);
+            }
+            work->keys[(size_t)frame * (size_t)lanes + (size_t)lane] = key;
+        }
+    }
+    return 0;
+}
+
+// Seed for a new game on the lane at this frame, or 0 while the current one goes on.
+static uint64_t workload_restart(const Workload *work, int lane, long frame, bool playing) {
+    bool wrapped = work->corpus && frame % work->lengths[lane] == 0;
+    if (playing && !wrapped) {
+        return 0;
+    }
+    if (work->corpus) {
+        return replay_corpus[lane % replay_corpus_count].seed;
+    }
+    return ((uint64_t)frame << 8 | (uint64_t)lane) * 0x9E3779B97F4A7C15ULL | 1ULL;
+}
+
+static double run_engines(const Workload *work) {
+    uint64_t start = frame_stats_now_us();
+    for (int lane = 0; lane < work->lanes; ++lane) {
+        g_engines[lane].phase = ENGINE_PHASE_IDLE;
+        for (long frame = 0; frame < work->frames; ++frame) {
+            uint64_t seed = workload_restart(work, lane, frame, g_engines[lane].phase == ENGINE_PHASE_PLAYING);
+            if (seed != 0) {
+                perf_engine_start(&g_engines[lane], seed);
+            }
+            PerfKey key = (PerfKey)work->keys[(size_t)frame * (size_t)work->lanes + (size_t)lane];
+            perf_engine_step(&g_engines[lane], key, PERF_FRAME_MS);
+        }
+    }
+    uint64_t elapsed = frame_stats_now_us() - start;
+    return (double)work->lanes * (double)work->frames / ((double)(elapsed ? elapsed : 1) / 1e6);
+}
+
+static double run_lockstep(const Workload *work, LockstepKernel kernel) {
+    if (lockstep_init(&g_batch, work->lanes, kernel) != 0) {
+        return 0.0;
+    }
+
+    uint64_t start = frame_stats_now_us();
+    for (long frame = 0; frame < work->frames; ++frame) {
+        for (int lane = 0; lane < work->lanes; ++lane) {
+            uint64_t seed = workload_restart(work, lane, frame, g_batch.live[lane] != 0);
+            if (seed != 0) {
+                lockstep_start(&g_batch, lane, seed);
+            }
+        }
+        lockstep_step(&g_batch, work->keys + (size_t)frame * (size_t)work->lanes, PERF_FRAME_MS);
+    }
+    uint64_t elapsed = frame_stats_now_us() - start;
+    return (double)work->lanes * (double)work->frames / ((double)(elapsed ? elapsed : 1) / 1e6);
+}
+
+static bool lanes_match_engines(int lanes) {
+    for (int lane = 0; lane < lanes; ++lane) {
+        EngineSnapshot snapshot;
+        unsigned char expected[ENGINE_SNAPSHOT_ENCODED_SIZE];
+        unsigned char actual[ENGINE_SNAPSHOT_ENCODED_SIZE];
+        engine_snapshot(&g_engines[lane], &snapshot);
+        engine_snapshot_encode(&snapshot, expected, sizeof(expected));
+        const Engine *engine = lockstep_engine(&g_batch, lane);
+        engine_snapshot(engine, &snapshot);
+        engine_snapshot_encode(&snapshot, actual, sizeof(actual));
+        if (memcmp(expected, actual, sizeof(expected)) != 0 || engine->stats.pieces != g_engines[lane].stats.pieces ||
+            engine->stats.play_ms != g_engines[lane].stats.play_ms) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    int lanes = (argc > 1) ? atoi(argv[1]) : LOCKSTEP_MAX_LANES;
+    long frames = (argc > 2) ? atol(argv[2]) : 100000;
+    bool corpus = !(argc > 3 && strcmp(argv[3], "random") == 0);
+    if (lanes < 1 || lanes > LOCKSTEP_MAX_LANES || frames < 1 || (argc > 3 && corpus && strcmp(argv[3], "corpus") != 0)) {
+        fprintf(stderr, "Usage: %s [lanes 1-%d] [frames] [corpus|random]\n", argv[0], LOCKSTEP_MAX_LANES);
+        return 1;
+    }
+
+    Workload work;
+    if (workload_init(&work, lanes, frames, corpus) != 0) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    printf("workload:    %d lanes x %ld frames, %s keys\n", lanes, frames, corpus ? "corpus" : "random");
+    double engines = run_engines(&work);
+    printf("engines:     %10.0f frames/s, one game at a time\n", engines);
+
+    LockstepKernel kernels[] = {LOCKSTEP_KERNEL_SCALAR, LOCKSTEP_KERNEL_AVX2};
+    bool ok = true;
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); ++k) {
+        if (kernels[k] == LOCKSTEP_KERNEL_AVX2 && !lockstep_avx2_supported()) {
+            printf("%-12s not supported by this CPU\n", "avx2:");
+            continue;
+        }
+        double stepped = run_lockstep(&work, kernels[k]);
+        bool match = lanes_match_engines(lanes);
+        ok = ok && match;
+        printf("%s:%*s %10.0f frames/s, %.2fx, %s\n", lockstep_kernel_name(kernels[k]),
+               (int)(11 - strlen(lockstep_kernel_name(kernels[k]))), "", stepped, stepped / engines,
+               match ? "identical games" : "GAMES DIFFER");
+    }
+    free(work.keys);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bag.h"
+#include "frame_stats.h"
+#include "perfect_clear.h"
+
+// Batch perfect-clear analysis: deals the first ten pieces of a seeded seven-bag game for
+// each of N openings and asks the solver for a perfect clear from the empty board.
+// Reports the solve rate, solve times, and search throughput.
+// Usage: pc_bench [openings] [threads] [first_seed]
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+    int openings = (argc > 1) ? atoi(argv[1]) : 100;
+    int threads = (argc > 2) ? atoi(argv[2]) : 1;
+    uint64_t first_seed = (argc > 3) ? strtoull(argv[3], NULL, 10) : 0;
+    if (openings < 1 || threads < 1 || threads > PC_MAX_THREADS) {
+        fprintf(stderr, "Usage: %s [openings] [threads 1-%d] [first_seed]\n", argv[0], PC_MAX_THREADS);
+        return 1;
+    }
+
+    PcSolver solver;
+    uint64_t *times = malloc(sizeof(*times) * (size_t)openings);
+    if (times == NULL || pc_solver_init(&solver, threads, 0) != 0) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    Board board;
+    board_reset(&board);
+    int solved = 0;
+    int short_clears = 0;
+    uint64_t total_us = 0;
+    uint64_t total_nodes = 0;
+    for (int i = 0; i < openings; ++i) {
+        PieceBag bag;
+        piece_bag_seed(&bag, piece_shape_count(), first_seed + (uint64_t)i);
+        int queue[PC_MAX_PIECES];
+        piece_bag_generate(&bag, queue, PC_MAX_PIECES);
+
+        PcSolution solution;
+        uint64_t start = frame_stats_now_us();
+        bool found = pc_solve(&solver, &board, queue, PC_MAX_PIECES, &solution);
+        times[i] = frame_stats_now_us() - start;
+        total_us += times[i];
+        total_nodes += solver.nodes;
+        solved += found;
+        short_clears += found && solution.pieces < PC_MAX_PIECES;
+    }
+    qsort(times, (size_t)openings, sizeof(*times), compare_u64);
+
+    printf("openings:    %d (seeds %llu..%llu), %d thread(s)\n", openings, (unsigned long long)first_seed,
+           (unsigned long long)(first_seed + (uint64_t)openings - 1), threads);
+    printf("solved:      %d (%.1f%%), %d with two lines\n", solved, 100.0 * solved / openings, short_clears);
+    printf("time:        mean %.2f ms, p50 %.2f ms, max %.2f ms\n", total_us / 1000.0 / openings,
+           times[openings / 2] / 1000.0, times[openings - 1] / 1000.0);
+    printf("throughput:  %.2f M nodes/s\n", total_us ? (double)total_nodes / (double)total_us : 0.0);
+
+    pc_solver_free(&solver);
+    free(times);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "board.h"
+#include "frame_stats.h"
+#include "perft.h"
+#include "perft_positions.h"
+
+// Runs every reference position at full depth, checks the counts, and reports nodes/sec.
+// Usage: perft_bench [repeat]
+
+int main(int argc, char **argv) {
+    int repeat = (argc > 1) ? atoi(argv[1]) : 5;
+    if (repeat <= 0) {
+        repeat = 1;
+    }
+
+    uint64_t total_nodes = 0;
+    uint64_t total_us = 0;
+    int failures = 0;
+
+    printf("%-14s %5s %12s %12s %12s\n", "position", "depth", "nodes", "distinct", "nodes/s");
+    for (int i = 0; i < perft_position_count; ++i) {
+        const PerftPosition *position = &perft_positions[i];
+        Board board;
+        perft_position_board(position, &board);
+
+        uint64_t nodes = 0;
+        uint64_t start = frame_stats_now_us();
+        for (int r = 0; r < repeat; ++r) {
+            nodes = perft(&board, position->pieces, position->depth, false);
+        }
+        uint64_t elapsed = frame_stats_now_us() - start;
+        uint64_t distinct = perft(&board, position->pieces, position->depth, true);
+
+        bool ok = nodes == position->expected[position->depth - 1] &&
+                  distinct == position->expected_dedupe[position->depth - 1];
+        if (!ok) {
+            ++failures;
+        }
+
+        double rate = (elapsed > 0) ? (double)nodes * repeat * 1e6 / (double)elapsed : 0.0;
+        printf("%-14s %5d %12llu %12llu %12.0f%s\n", position->name, position->depth,
+               (unsigned long long)nodes, (unsigned long long)distinct, rate, ok ? "" : "  MISMATCH");
+        total_nodes += nodes * (uint64_t)repeat;
+        total_us += elapsed;
+    }
+
+    double overall = (total_us > 0) ? (double)total_nodes * 1e6 / (double)total_us : 0.0;
+    printf("total %llu nodes in %.3f s: %.0f nodes/s\n", (unsigned long long)total_nodes,
+           (double)total_us / 1e6, overall);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,323 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bag.h"
+#include "frame_stats.h"
+
+// Statistical validation of every piece randomizer. Each one deals `draws` pieces through
+// piece_bag_generate, split across worker threads with their own seeds, and the piece
+// frequencies and drought lengths (draws between two copies of the same piece) are checked
+// against their exact distributions with a chi-square test. Exits non-zero on any failure.
+// Usage: randomizer_stats [draws_per_randomizer] [threads] [seed]
+
+#define STATS_PIECES 7
+#define STATS_DROUGHT_BINS 128 /* droughts 1..126, then one bin for anything longer */
+#define STATS_CHUNK 4096
+#define STATS_MAX_THREADS 64
+#define STATS_MIN_EXPECTED 5.0
+#define STATS_Z 4.75 /* one false alarm in about a million runs for independent samples */
+
+typedef struct {
+    PieceRandomizer kind;
+    uint64_t seed;
+    uint64_t draws;
+    uint64_t counts[STATS_PIECES];
+    uint64_t droughts[STATS_DROUGHT_BINS];
+    uint64_t longest;
+} StatsShard;
+
+static void *deal_shard(void *arg) {
+    StatsShard *shard = arg;
+    PieceBag bag;
+    piece_bag_seed_kind(&bag, shard->kind, STATS_PIECES, shard->seed);
+
+    int pieces[STATS_CHUNK];
+    uint64_t last_seen[STATS_PIECES];
+    memset(last_seen, 0, sizeof(last_seen));
+    uint64_t position = 0;
+    while (position < shard->draws) {
+        uint64_t left = shard->draws - position;
+        size_t count = (left < STATS_CHUNK) ? (size_t)left : STATS_CHUNK;
+        piece_bag_generate(&bag, pieces, count);
+        for (size_t i = 0; i < count; ++i) {
+            int piece = pieces[i];
+            ++position;
+            ++shard->counts[piece];
+            // Positions start at 1, so 0 means the piece has not appeared yet.
+            if (last_seen[piece] != 0) {
+                uint64_t drought = position - last_seen[piece];
+                if (drought > shard->longest) {
+                    shard->longest = drought;
+                }
+                ++shard->droughts[(drought < STATS_DROUGHT_BINS - 1) ? drought : STATS_DROUGHT_BINS - 1];
+            }
+            last_seen[piece] = position;
+        }
+    }
+    return NULL;
+}
+
+// --- Expected drought distributions --------------------------------------------------------
+
+static void expect_uniform(double *p) {
+    for (int d = 1; d < STATS_DROUGHT_BINS; ++d) {
+        p[d] = pow(6.0 / 7.0, d - 1) / 7.0;
+    }
+}
+
+// Copies in consecutive bags sit at independent uniform slots i and j: drought 7 - i + j.
+static void expect_bag7(double *p) {
+    for (int d = 1; d <= 13; ++d) {
+        p[d] = (7 - abs(d - 7)) / 49.0;
+    }
+}
+
+// Half the droughts are between a bag's two copies (slots a < b, one of 91 pairs), half
+// from a bag's second copy to the next bag's first: 14 - b + a'.
+static void expect_bag14(double *p) {
+    for (int d = 1; d <= 13; ++d) {
+        p[d] += 0.5 * (14 - d) / 91.0;
+    }
+    for (int last = 1; last <= 13; ++last) {
+        for (int first = 0; first <= 12; ++first) {
+            p[14 - last + first] += 0.5 * (last / 91.0) * ((13 - first) / 91.0);
+        }
+    }
+}
+
+// A repeat takes the seventh roll or a repeat on the first roll, then a repeat on the
+// reroll: 2/56. Any other given piece comes up with probability 9/56.
+static void expect_nes(double *p) {
+    p[1] = 2.0 / 56.0;
+    for (int d = 2; d < STATS_DROUGHT_BINS; ++d) {
+        p[d] = (54.0 / 56.0) * pow(47.0 / 56.0, d - 2) * (9.0 / 56.0);
+    }
+}
+
+// TGM is a Markov chain over the four-piece history. Find its stationary distribution,
+// start from the histories that just dealt piece 0, and follow the probability of not
+// having dealt it again, step by step.
+#define TGM_STATES (STATS_PIECES * STATS_PIECES * STATS_PIECES * STATS_PIECES)
+
+static void tgm_transitions(int state, double *next_piece) {
+    int history[PIECE_TGM_HISTORY];
+    bool present[STATS_PIECES] = {false};
+    int distinct = 0;
+    for (int i = 0; i < PIECE_TGM_HISTORY; ++i) {
+        history[i] = state % STATS_PIECES;
+        state /= STATS_PIECES;
+        if (!present[history[i]]) {
+            present[history[i]] = true;
+            ++distinct;
+        }
+    }
+    double a = distinct / (double)STATS_PIECES;
+    for (int piece = 0; piece < STATS_PIECES; ++piece) {
+        next_piece[piece] = present[piece] ? pow(a, PIECE_TGM_ROLLS - 1) / STATS_PIECES
+                                           : (1.0 - pow(a, PIECE_TGM_ROLLS)) / (1.0 - a) / STATS_PIECES;
+    }
+}
+
+// The newest piece is the lowest base-7 digit.
+static int tgm_successor(int state, int piece) {
+    return (state * STATS_PIECES + piece) % TGM_STATES;
+}
+
+static void expect_tgm(double *p) {
+    static double odds[TGM_STATES][STATS_PIECES];
+    static double stationary[TGM_STATES];
+    static double scratch[TGM_STATES];
+    for (int s = 0; s < TGM_STATES; ++s) {
+        tgm_transitions(s, odds[s]);
+        stationary[s] = 1.0 / TGM_STATES;
+    }
+    for (int iteration = 0; iteration < 1000; ++iteration) {
+        memset(scratch, 0, sizeof(scratch));
+        for (int s = 0; s < TGM_STATES; ++s) {
+            for (int piece = 0; piece < STATS_PIECES; ++piece) {
+                scratch[tgm_successor(s, piece)] += stationary[s] * odds[s][piece];
+            }
+        }
+        memcpy(stationary, scratch, sizeof(stationary));
+    }
+
+    double total = 0.0;
+    for (int s = 0; s < TGM_STATES; ++s) {
+        if (s % STATS_PIECES != 0) {
+            stationary[s] = 0.0;
+        }
+        total += stationary[s];
+    }
+    for (int d = 1; d < STATS_DROUGHT_BINS - 1; ++d) {
+        memset(scratch, 0, sizeof(scratch));
+        for (int s = 0; s < TGM_STATES; ++s) {
+            double mass = stationary[s] / total;
+            if (mass == 0.0) {
+                continue;
+            }
+            p[d] += mass * odds[s][0];
+            for (int piece = 1; piece < STATS_PIECES; ++piece) {
+                scratch[tgm_successor(s, piece)] += stationary[s] * odds[s][piece];
+            }
+        }
+        memcpy(stationary, scratch, sizeof(stationary));
+    }
+}
+
+// --- Chi-square ----------------------------------------------------------------------------
+
+// Wilson-Hilferty approximation of the chi-square quantile at STATS_Z.
+static double chi_square_critical(int dof) {
+    double k = 2.0 / (9.0 * dof);
+    double root = 1.0 - k + STATS_Z * sqrt(k);
+    return dof * root * root * root;
+}
+
+// Pool neighbouring bins until each expects at least STATS_MIN_EXPECTED hits (a short
+// remainder joins the last pool); a hit where nothing is possible fails outright. Returns
+// the statistic and sets the degrees of freedom.
+static double chi_square(const uint64_t *observed, const double *probability, int bins, uint64_t total,
+                         int *dof, bool *impossible) {
+    double pool_expected[STATS_DROUGHT_BINS] = {0.0};
+    double pool_observed[STATS_DROUGHT_BINS] = {0.0};
+    int pools = 0;
+    *impossible = false;
+    for (int i = 0; i < bins; ++i) {
+        double expected = probability[i] * (double)total;
+        if (expected == 0.0 && observed[i] != 0) {
+            *impossible = true;
+        }
+        pool_expected[pools] += expected;
+        pool_observed[pools] += (double)observed[i];
+        if (pool_expected[pools] >= STATS_MIN_EXPECTED) {
+            ++pools;
+        }
+    }
+    if (pools == 0) {
+        pools = 1;
+    } else {
+        pool_expected[pools - 1] += pool_expected[pools];
+        pool_observed[pools - 1] += pool_observed[pools];
+    }
+
+    double statistic = 0.0;
+    for (int i = 0; i < pools; ++i) {
+        if (pool_expected[i] > 0.0) {
+            double diff = pool_observed[i] - pool_expected[i];
+            statistic += diff * diff / pool_expected[i];
+        }
+    }
+    *dof = (pools > 1) ? pools - 1 : 1;
+    return statistic;
+}
+
+static bool check_randomizer(PieceRandomizer kind, uint64_t draws, int threads, uint64_t seed) {
+    static StatsShard shards[STATS_MAX_THREADS];
+    pthread_t handles[STATS_MAX_THREADS];
+    memset(shards, 0, sizeof(shards));
+
+    uint64_t start = frame_stats_now_us();
+    for (int t = 0; t < threads; ++t) {
+        shards[t].kind = kind;
+        shards[t].seed = seed + (uint64_t)t * 0x9E3779B97F4A7C15ULL;
+        shards[t].draws = draws / (uint64_t)threads + ((uint64_t)t < draws % (uint64_t)threads ? 1 : 0);
+        if (pthread_create(&handles[t], NULL, deal_shard, &shards[t]) != 0) {
+            fprintf(stderr, "cannot start worker thread\n");
+            exit(1);
+        }
+    }
+
+    uint64_t counts[STATS_PIECES] = {0};
+    uint64_t droughts[STATS_DROUGHT_BINS] = {0};
+    uint64_t longest = 0;
+    for (int t = 0; t < threads; ++t) {
+        pthread_join(handles[t], NULL);
+        for (int i = 0; i < STATS_PIECES; ++i) {
+            counts[i] += shards[t].counts[i];
+        }
+        for (int i = 0; i < STATS_DROUGHT_BINS; ++i) {
+            droughts[i] += shards[t].droughts[i];
+        }
+        if (shards[t].longest > longest) {
+            longest = shards[t].longest;
+        }
+    }
+    uint64_t elapsed = frame_stats_now_us() - start;
+
+    double piece_odds[STATS_PIECES];
+    for (int i = 0; i < STATS_PIECES; ++i) {
+        piece_odds[i] = 1.0 / STATS_PIECES;
+    }
+    double drought_odds[STATS_DROUGHT_BINS] = {0.0};
+    switch (kind) {
+        case PIECE_RANDOMIZER_BAG7:
+            expect_bag7(drought_odds);
+            break;
+        case PIECE_RANDOMIZER_BAG14:
+            expect_bag14(drought_odds);
+            break;
+        case PIECE_RANDOMIZER_TGM:
+            expect_tgm(drought_odds);
+            break;
+        case PIECE_RANDOMIZER_NES:
+            expect_nes(drought_odds);
+            break;
+        default:
+            expect_uniform(drought_odds);
+            break;
+    }
+    double tail = 1.0;
+    for (int i = 1; i < STATS_DROUGHT_BINS - 1; ++i) {
+        tail -= drought_odds[i];
+    }
+    drought_odds[STATS_DROUGHT_BINS - 1] = (tail > 1e-12) ? tail : 0.0;
+
+    uint64_t drought_total = 0;
+    for (int i = 0; i < STATS_DROUGHT_BINS; ++i) {
+        drought_total += droughts[i];
+    }
+
+    int piece_dof = 0;
+    int drought_dof = 0;
+    bool piece_impossible = false;
+    bool drought_impossible = false;
+    double piece_chi = chi_square(counts, piece_odds, STATS_PIECES, draws, &piece_dof, &piece_impossible);
+    double drought_chi = chi_square(droughts + 1, drought_odds + 1, STATS_DROUGHT_BINS - 1, drought_total,
+                                    &drought_dof, &drought_impossible);
+    bool pieces_ok = !piece_impossible && piece_chi <= chi_square_critical(piece_dof);
+    bool droughts_ok = !drought_impossible && drought_chi <= chi_square_critical(drought_dof);
+
+    printf("%-8s %12llu %9.1f  %10.2f / %-3d %s  %10.2f / %-3d %s  %6llu\n", piece_randomizer_name(kind),
+           (unsigned long long)draws, draws / (double)(elapsed ? elapsed : 1), piece_chi, piece_dof,
+           pieces_ok ? "ok  " : "FAIL", drought_chi, drought_dof, droughts_ok ? "ok  " : "FAIL",
+           (unsigned long long)longest);
+    return pieces_ok && droughts_ok;
+}
+
+int main(int argc, char **argv) {
+    uint64_t draws = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000000ULL;
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = (argc > 2) ? atoi(argv[2]) : (int)(online > 0 ? online : 1);
+    uint64_t seed = (argc > 3) ? strtoull(argv[3], NULL, 10) : 1;
+    if (draws < 1000 || threads < 1 || threads > STATS_MAX_THREADS) {
+        fprintf(stderr, "Usage: %s [draws_per_randomizer >= 1000] [threads 1-%d] [seed]\n", argv[0],
+                STATS_MAX_THREADS);
+        return 1;
+    }
+
+    printf("%d thread(s); chi-square statistic / degrees of freedom, z = %.2f\n", threads, STATS_Z);
+    printf("%-8s %12s %9s  %17s  %17s  %6s\n", "kind", "draws", "Mpieces/s", "pieces", "droughts", "max");
+    bool ok = true;
+    for (int kind = 0; kind < PIECE_RANDOMIZER_COUNT; ++kind) {
+        ok = check_randomizer((PieceRandomizer)kind, draws, threads, seed) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,317 @@
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "finesse.h"
+#include "frame_stats.h"
+#include "game.h"
+#include "perf_suite.h"
+#include "replay_corpus.h"
+
+// End-to-end throughput regression run: replays the checked-in corpus (tests/replay_corpus.h)
+// through the whole game (input handling, engine, scoring, effects, frame composition) with
+// the null renderer, after checking every session still plays exactly as recorded. Repeats
+// the corpus --runs times and compares pieces/sec, frames/sec, and allocations per game with
+// the stored baseline; exits 1 on a regression, or when the baseline is missing, unreadable,
+// or was measured on a different corpus. Only --update makes the run the new baseline.
+// --record plays fresh bot and random sessions and prints a new corpus header.
+// Usage: replay_bench [--runs N] [--tolerance PCT] [--baseline FILE] [--update] [--record]
+
+#define RECORD_MAX_FRAMES 20000
+#define RECORD_MAX_SCRIPT 4000 /* keeps each script inside ISO C's minimum string length */
+
+// Every malloc, calloc, and realloc made by the linked objects lands here first: the link
+// rule passes -Wl,--wrap for each, so calls resolve to __wrap_* and the originals to __real_*.
+static _Atomic uint64_t g_allocations;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    atomic_fetch_add_explicit(&g_allocations, 1, memory_order_relaxed);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    atomic_fetch_add_explicit(&g_allocations, 1, memory_order_relaxed);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size) {
+    atomic_fetch_add_explicit(&g_allocations, 1, memory_order_relaxed);
+    return __real_realloc(pointer, size);
+}
+
+// --- Recording -----------------------------------------------------------------------------
+
+typedef enum {
+    RECORD_BOT,      // best hard-drop placement by the hint evaluation, fewest presses, short pauses
+    RECORD_SOFT_BOT, // same placements, soft dropped and left to lock on the lock delay
+    RECORD_RANDOM    // random presses and idle frames until it tops out
+} RecordStyle;
+
+typedef struct {
+    Engine engine;
+    uint8_t keys[RECORD_MAX_FRAMES];
+    size_t count;
+} Recorder;
+
+static bool record_key(Recorder *recorder, PerfKey key) {
+    if (recorder->count >= RECORD_MAX_FRAMES || recorder->engine.phase != ENGINE_PHASE_PLAYING) {
+        return false;
+    }
+    recorder->keys[recorder->count++] = (uint8_t)key;
+    perf_engine_step(&recorder->engine, key, PERF_FRAME_MS);
+    return true;
+}
+
+static uint64_t next_random(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+static void record_placement(Recorder *recorder, RecordStyle style, uint64_t *rng) {
+    Engine *engine = &recorder->engine;
+    const FinessePath *path = finesse_best_path(&engine->board, engine->active.type);
+    static const PerfKey k_inputs[FINESSE_INPUT_COUNT] = {PERF_KEY_LEFT, PERF_KEY_RIGHT, PERF_KEY_ROTATE,
+                                                         PERF_KEY_SOFT_DROP};
+    for (int i = 0; path != NULL && i < path->length; ++i) {
+        record_key(recorder, k_inputs[path->inputs[i]]);
+    }
+
+    uint32_t pieces = engine->stats.pieces;
+    if (style == RECORD_SOFT_BOT) {
+        while (engine->stats.pieces == pieces && engine->phase == ENGINE_PHASE_PLAYING) {
+            bool falling = engine->active.active && engine_ghost_row(engine) > engine->active.row;
+            if (!record_key(recorder, falling ? PERF_KEY_SOFT_DROP : PERF_KEY_IDLE)) {
+                return;
+            }
+        }
+    } else {
+        record_key(recorder, PERF_KEY_HARD_DROP);
+    }
+    for (uint64_t pause = next_random(rng) % 4; pause > 0; --pause) {
+        record_key(recorder, PERF_KEY_IDLE);
+    }
+}
+
+// Plays one session in the given style and trims it until its script fits.
+static int record_session(Recorder *recorder, RecordStyle style, uint64_t seed, uint32_t max_pieces, char *script) {
+    uint64_t rng = seed * 0x9E3779B97F4A7C15ULL + 1;
+    perf_engine_start(&recorder->engine, seed);
+    recorder->count = 0;
+    while (recorder->engine.phase == ENGINE_PHASE_PLAYING && recorder->engine.stats.pieces < max_pieces &&
+           recorder->count < RECORD_MAX_FRAMES) {
+        if (style != RECORD_RANDOM) {
+            record_placement(recorder, style, &rng);
+            continue;
+        }
+        uint64_t roll = next_random(&rng) % 100;
+        PerfKey key = (roll < 50) ? PERF_KEY_IDLE : (roll < 96) ? (PerfKey)(PERF_KEY_LEFT + roll % 4) : PERF_KEY_HARD_DROP;
+        record_key(recorder, key);
+    }
+    while (perf_script_encode(recorder->keys, recorder->count, script, RECORD_MAX_SCRIPT) < 0) {
+        recorder->count -= recorder->count / 10 + 1;
+    }
+    return 0;
+}
+
+static int record_corpus(void) {
+    static const struct {
+        RecordStyle style;
+        uint64_t seed;
+        uint32_t pieces;
+    } k_sessions[] = {
+        {RECORD_BOT, 11, 400},     {RECORD_BOT, 23, 400},     {RECORD_BOT, 37, 400},
+        {RECORD_SOFT_BOT, 41, 60}, {RECORD_RANDOM, 53, 1000}, {RECORD_RANDOM, 67, 1000},
+        {RECORD_RANDOM, 79, 1000},
+    };
+    static const char *const k_style_names[] = {"bot", "soft_bot", "random"};
+    static Recorder recorder;
+    static char script[RECORD_MAX_SCRIPT];
+
+    printf("#ifndef REPLAY_CORPUS_H\n#define REPLAY_CORPUS_H\n\n#include <stdbool.h>\n#include <stdint.h>\n\n");
+    printf("// Recorded sessions for the end-to-end throughput suite (see include/perf_suite.h): a\n"
+           "// game seed, the key script played one key per frame at PERF_FRAME_MS, and what the game\n"
+           "// must show at the end. \"bot\" sessions hard drop each piece where the hint evaluation\n"
+           "// likes it best, with the fewest presses; \"soft_bot\" ones soft drop and wait out the\n"
+           "// lock delay; \"random\" ones press random keys until they top out. Shared by\n"
+           "// tests/perf_suite_tests.c and the replay_bench tool, which regenerates this file with\n"
+           "// --record; a change to the game rules that alters the expected results needs a new\n"
+           "// corpus and a new baseline.\n\n");
+    printf("typedef struct {\n    const char *name;\n    uint64_t seed;\n    const char *script;\n"
+           "    uint32_t frames;\n    uint32_t pieces;\n    uint32_t lines;\n    int64_t score;\n"
+           "    bool topped_out;\n} ReplaySession;\n\n");
+    printf("static const ReplaySession replay_corpus[] = {\n");
+    for (size_t i = 0; i < sizeof(k_sessions) / sizeof(k_sessions[0]); ++i) {
+        record_session(&recorder, k_sessions[i].style, k_sessions[i].seed, k_sessions[i].pieces, script);
+        PerfSessionResult result;
+        perf_replay_engine(k_sessions[i].seed, recorder.keys, recorder.count, PERF_FRAME_MS, &result);
+        printf("    {\"%s_%llu\", %lluULL,\n", k_style_names[k_sessions[i].style],
+               (unsigned long long)k_sessions[i].seed, (unsigned long long)k_sessions[i].seed);
+        size_t length = strlen(script);
+        for (size_t at = 0; at < length; at += 88) {
+            printf("     \"%.*s\"%s\n", (int)(length - at < 88 ? length - at : 88), script + at,
+                   at + 88 >= length ? "," : "");
+        }
+        printf("     %u, %u, %u, %lld, %s},\n", result.frames, result.pieces, result.lines, (long long)result.score,
+               result.topped_out ? "true" : "false");
+    }
+    printf("};\n\nstatic const int replay_corpus_count = (int)(sizeof(replay_corpus) / sizeof(replay_corpus[0]));\n");
+    printf("\n#endif /* REPLAY_CORPUS_H */\n");
+    return 0;
+}
+
+// --- Benchmark -----------------------------------------------------------------------------
+
+typedef struct {
+    uint8_t *keys;
+    int count;
+} DecodedSession;
+
+static bool session_matches(const ReplaySession *session, const PerfSessionResult *result) {
+    return result->frames == session->frames && result->pieces == session->pieces &&
+           result->lines == session->lines && result->score == session->score &&
+           result->topped_out == session->topped_out;
+}
+
+int main(int argc, char **argv) {
+    int runs = 5;
+    double tolerance = 0.03;
+    const char *baseline_path = "tests/perf_baseline.txt";
+    bool update = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]) / 100.0;
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "--record") == 0) {
+            return record_corpus();
+        } else {
+            runs = 0;
+        }
+    }
+    if (runs < 2 || runs > PERF_MAX_RUNS || tolerance < 0.0) {
+        fprintf(stderr, "Usage: %s [--runs 2-%d] [--tolerance PCT] [--baseline FILE] [--update] [--record]\n",
+                argv[0], PERF_MAX_RUNS);
+        return 1;
+    }
+
+    DecodedSession sessions[sizeof(replay_corpus) / sizeof(replay_corpus[0])];
+    for (int s = 0; s < replay_corpus_count; ++s) {
+        size_t capacity = strlen(replay_corpus[s].script) * PERF_MAX_RUN_LENGTH;
+        capacity = (capacity > RECORD_MAX_FRAMES) ? RECORD_MAX_FRAMES : capacity;
+        sessions[s].keys = malloc(capacity);
+        sessions[s].count = (sessions[s].keys != NULL)
+                                ? perf_script_decode(replay_corpus[s].script, sessions[s].keys, capacity)
+                                : -1;
+        if (sessions[s].count < 0) {
+            fprintf(stderr, "cannot decode session %s\n", replay_corpus[s].name);
+            return 1;
+        }
+    }
+
+    GameOptions options;
+    game_options_default(&options);
+    options.backend = TERM_BACKEND_NULL;
+    options.highscore_path = "";
+    if (game_init(&options) != 0) {
+        fprintf(stderr, "cannot start the game headless\n");
+        return 1;
+    }
+
+    // The untimed first pass warms caches and proves the corpus still plays as recorded;
+    // otherwise the figures would not be comparable with the baseline.
+    uint64_t frames = 0;
+    uint64_t pieces = 0;
+    for (int s = 0; s < replay_corpus_count; ++s) {
+        PerfSessionResult result;
+        game_run_script(replay_corpus[s].seed, sessions[s].keys, (size_t)sessions[s].count, PERF_FRAME_MS, &result);
+        if (!session_matches(&replay_corpus[s], &result)) {
+            fprintf(stderr, "session %s no longer plays as recorded (%u frames, %u pieces, %u lines, score %lld); "
+                            "rerecord the corpus with --record\n",
+                    replay_corpus[s].name, result.frames, result.pieces, result.lines, (long long)result.score);
+            game_shutdown();
+            return 1;
+        }
+        frames += result.frames;
+        pieces += result.pieces;
+    }
+
+    double values[PERF_METRIC_COUNT][PERF_MAX_RUNS];
+    for (int run = 0; run < runs; ++run) {
+        uint64_t allocations = atomic_load_explicit(&g_allocations, memory_order_relaxed);
+        uint64_t start = frame_stats_now_us();
+        for (int s = 0; s < replay_corpus_count; ++s) {
+            PerfSessionResult result;
+            game_run_script(replay_corpus[s].seed, sessions[s].keys, (size_t)sessions[s].count, PERF_FRAME_MS,
+                            &result);
+        }
+        double seconds = (double)(frame_stats_now_us() - start) / 1e6;
+        seconds = (seconds > 0.0) ? seconds : 1e-6;
+        values[PERF_METRIC_PIECES_PER_SEC][run] = (double)pieces / seconds;
+        values[PERF_METRIC_FRAMES_PER_SEC][run] = (double)frames / seconds;
+        values[PERF_METRIC_ALLOCS_PER_GAME][run] =
+            (double)(atomic_load_explicit(&g_allocations, memory_order_relaxed) - allocations) / replay_corpus_count;
+    }
+    game_shutdown();
+    for (int s = 0; s < replay_corpus_count; ++s) {
+        free(sessions[s].keys);
+    }
+
+    PerfBaseline current;
+    current.corpus.sessions = replay_corpus_count;
+    current.corpus.frames = frames;
+    current.corpus.pieces = pieces;
+    printf("corpus:      %d sessions, %llu frames, %llu pieces per pass, all as recorded\n", replay_corpus_count,
+           (unsigned long long)frames, (unsigned long long)pieces);
+    for (int m = 0; m < PERF_METRIC_COUNT; ++m) {
+        perf_sample_from_runs(values[m], runs, &current.metrics[m]);
+        printf("%-16s %12.2f +/- %.2f (95%% CI, %d runs)\n", perf_metric_name((PerfMetric)m),
+               current.metrics[m].mean, perf_sample_interval(&current.metrics[m]), runs);
+    }
+
+    if (update) {
+        if (perf_baseline_save(&current, baseline_path) != 0) {
+            fprintf(stderr, "cannot write baseline %s\n", baseline_path);
+            return 1;
+        }
+        printf("baseline:    saved to %s\n", baseline_path);
+        return 0;
+    }
+
+    PerfBaseline baseline;
+    if (perf_baseline_load(&baseline, baseline_path) != 0) {
+        fprintf(stderr, "cannot read baseline %s; record one with --update\n", baseline_path);
+        return 1;
+    }
+    if (!perf_corpus_equal(&baseline.corpus, &current.corpus)) {
+        fprintf(stderr, "baseline %s was measured on another corpus (%d sessions, %llu frames, %llu pieces); "
+                        "record a new one with --update\n",
+                baseline_path, baseline.corpus.sessions, (unsigned long long)baseline.corpus.frames,
+                (unsigned long long)baseline.corpus.pieces);
+        return 1;
+    }
+
+    bool regressed = false;
+    printf("baseline:    %s (tolerance %.1f%%)\n", baseline_path, tolerance * 100.0);
+    for (int m = 0; m < PERF_METRIC_COUNT; ++m) {
+        PerfVerdict verdict;
+        perf_compare((PerfMetric)m, &baseline.metrics[m], &current.metrics[m], tolerance, &verdict);
+        printf("  %-16s %+7.2f%% (noise +/-%.2f%%) %s\n", perf_metric_name((PerfMetric)m), verdict.change * 100.0,
+               verdict.noise * 100.0, verdict.regressed ? "REGRESSED" : "ok");
+        regressed = regressed || verdict.regressed;
+    }
+    return regressed ? 1 : 0;
+}
@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "frame_stats.h"
+#include "retro.h"
+
+// Exhaustive small-board solve: explores every state reachable on a WIDTH x HEIGHT field
+// under the 7-bag, runs value iteration on all cores, writes the perfect-hashed table, and
+// maps it back to check and time lookups. gamma 1 values expected lines before topout;
+// boards that can be played forever need a gamma below 1 to converge.
+// Usage: retro_solve WIDTH HEIGHT TABLE [gamma] [threads] [max_sweeps]
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s WIDTH HEIGHT TABLE [gamma] [threads] [max_sweeps]\n", argv[0]);
+        return 1;
+    }
+    int width = atoi(argv[1]);
+    int height = atoi(argv[2]);
+    const char *path = argv[3];
+    RetroConfig config;
+    config.gamma = (argc > 4) ? atof(argv[4]) : 0.99;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    config.threads = (argc > 5) ? atoi(argv[5]) : (cores > 0 ? (int)cores : 1);
+    config.max_sweeps = (argc > 6) ? atoi(argv[6]) : 10000;
+    config.tolerance = 1e-7;
+
+    static RetroSolver solver;
+    if (retro_solver_init(&solver, width, height) != 0) {
+        fprintf(stderr, "unsupported board %dx%d (width %d-10, at most %d cells)\n", width, height, RETRO_MIN_WIDTH,
+                RETRO_MAX_CELLS);
+        return 1;
+    }
+
+    uint64_t start = frame_stats_now_us();
+    if (retro_solver_explore(&solver) != 0) {
+        fprintf(stderr, "out of memory exploring %dx%d\n", width, height);
+        retro_solver_free(&solver);
+        return 1;
+    }
+    uint64_t explored = frame_stats_now_us();
+    printf("board:       %dx%d, 7-bag\n", width, height);
+    printf("explore:     %zu fields, %zu states, %zu placements in %.2f s\n", solver.board_count, solver.state_count,
+           solver.edge_count, (double)(explored - start) / 1e6);
+
+    if (retro_solver_iterate(&solver, &config) != 0) {
+        fprintf(stderr, "value iteration failed\n");
+        retro_solver_free(&solver);
+        return 1;
+    }
+    uint64_t iterated = frame_stats_now_us();
+    double seconds = (double)(iterated - explored) / 1e6;
+    printf("iterate:     %d sweeps on %d threads in %.2f s (%.1f M backups/s), residual %.2g\n", solver.sweeps,
+           config.threads, seconds, (double)solver.state_count * solver.sweeps / (seconds > 0 ? seconds : 1e-9) / 1e6,
+           solver.residual);
+    printf("value:       %.4f lines from an empty field (gamma %.4g)\n", retro_solver_value(&solver, 0, RETRO_FULL_BAG),
+           config.gamma);
+
+    if (retro_table_write(&solver, path, 1) != 0) {
+        fprintf(stderr, "cannot write table %s\n", path);
+        retro_solver_free(&solver);
+        return 1;
+    }
+    RetroTable table;
+    if (retro_table_open(&table, path) != 0) {
+        fprintf(stderr, "cannot map table %s\n", path);
+        retro_solver_free(&solver);
+        return 1;
+    }
+    printf("table:       %s, %zu bytes (%.2f bytes/state)\n", path, table.length,
+           (double)table.length / (double)solver.state_count);
+
+    uint64_t lookups = 0;
+    uint64_t misses = 0;
+    uint64_t lookup_start = frame_stats_now_us();
+    for (size_t board = 0; board < solver.board_count; ++board) {
+        for (unsigned bag = 1; bag <= RETRO_FULL_BAG; ++bag) {
+            double value = retro_solver_value(&solver, solver.boards[board], bag);
+            if (value < 0.0) {
+                continue;
+            }
+            float stored;
+            misses += !retro_table_lookup(&table, solver.boards[board], bag, &stored) || stored != (float)value;
+            ++lookups;
+        }
+    }
+    uint64_t lookup_us = frame_stats_now_us() - lookup_start;
+    printf("lookups:     %llu checked, %llu wrong (%.1f M/s including the in-memory reference)\n",
+           (unsigned long long)lookups, (unsigned long long)misses,
+           (double)lookups / (double)(lookup_us ? lookup_us : 1));
+
+    retro_table_close(&table);
+    retro_solver_free(&solver);
+    return misses == 0 ? 0 : 1;
+}
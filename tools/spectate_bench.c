@@ -0,0 +1,108 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "engine.h"
+#include "frame_stats.h"
+#include "spectate.h"
+
+// Measures the publisher's cost per tick (encode once, then fan the same bytes out) with
+// 0, 1, 16, and 64 socket viewers attached. Viewers drain their sockets outside the timed
+// region, so the numbers are what the playing process pays per frame.
+// Usage: spectate_bench [ticks]
+
+static uint64_t xorshift(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static int run(int viewers, int ticks, const char *address) {
+    static SpectateHub hub;
+    static SpectateFeed feeds[SPECTATE_MAX_VIEWERS];
+    static SpectateState states[SPECTATE_MAX_VIEWERS];
+    if (spectate_hub_open(&hub, address, NULL) != 0) {
+        fprintf(stderr, "cannot listen on %s\n", address);
+        return 1;
+    }
+    for (int i = 0; i < viewers; ++i) {
+        if (spectate_feed_open(&feeds[i], address) != 0) {
+            fprintf(stderr, "viewer %d failed to connect\n", i);
+            return 1;
+        }
+        spectate_hub_pump(&hub); // accept as we go; the listen backlog is shorter than 64
+        memset(&states[i], 0, sizeof(states[i]));
+    }
+
+    Engine engine;
+    engine_init(&engine, 99);
+    engine_start(&engine);
+    engine_take_events(&engine, NULL);
+
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    uint64_t total_us = 0;
+    uint64_t worst_us = 0;
+    for (int tick = 0; tick < ticks; ++tick) {
+        uint64_t roll = xorshift(&rng) % 16;
+        if (roll < 2) {
+            engine_shift(&engine, roll == 0 ? -1 : 1);
+        } else if (roll == 2) {
+            engine_rotate(&engine, 1);
+        } else if (roll == 3) {
+            engine_hard_drop(&engine);
+        }
+        engine_tick(&engine, 16);
+        engine_take_events(&engine, NULL);
+        if (engine.phase == ENGINE_PHASE_GAME_OVER) {
+            engine_start(&engine);
+            engine_take_events(&engine, NULL);
+        }
+
+        uint64_t start = frame_stats_now_us();
+        spectate_hub_publish(&hub, &engine);
+        spectate_hub_pump(&hub);
+        uint64_t elapsed = frame_stats_now_us() - start;
+        total_us += elapsed;
+        if (elapsed > worst_us) {
+            worst_us = elapsed;
+        }
+
+        for (int i = 0; i < viewers; ++i) {
+            spectate_feed_poll(&feeds[i], &states[i]);
+        }
+    }
+
+    uint64_t bytes = (uint64_t)atomic_load(&hub.ring->write_pos);
+    int connected = hub.viewer_count;
+    spectate_hub_close(&hub);
+    for (int i = 0; i < viewers; ++i) {
+        spectate_feed_close(&feeds[i]);
+    }
+    unlink(address + 5);
+
+    printf("%2d viewers (%2d connected): mean %.2f us, worst %llu us per tick, %.1f stream bytes/tick\n",
+           viewers, connected, (double)total_us / ticks, (unsigned long long)worst_us, (double)bytes / ticks);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int ticks = (argc > 1) ? atoi(argv[1]) : 20000;
+    if (ticks <= 0) {
+        ticks = 1;
+    }
+
+    char address[64];
+    snprintf(address, sizeof(address), "unix:/tmp/tetris_spectate_bench_%ld.sock", (long)getpid());
+    static const int viewer_counts[] = {0, 1, 16, SPECTATE_MAX_VIEWERS};
+    for (size_t i = 0; i < sizeof(viewer_counts) / sizeof(viewer_counts[0]); ++i) {
+        if (run(viewer_counts[i], ticks, address) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
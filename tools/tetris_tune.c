@@ -0,0 +1,93 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "frame_stats.h"
+#include "tune.h"
+
+// Evolves hint evaluation weights with a genetic algorithm. Every candidate plays the same
+// seeded games each generation, spread over all cores, and the next population is
+// checkpointed to CHECKPOINT after each generation; rerunning with the same file resumes
+// where the last run stopped (the population and seed arguments then come from the file).
+// Usage: tetris_tune CHECKPOINT [generations] [population] [games] [max_pieces] [threads] [seed]
+
+static const char *const feature_names[HINT_FEATURE_COUNT] = {
+    "height", "lines", "holes", "bumpiness", "max_height", "wells", "row_transitions",
+};
+
+static void print_weights(const HintWeights *weights) {
+    for (int i = 0; i < HINT_FEATURE_COUNT; ++i) {
+        printf("  %-16s %+.4f\n", feature_names[i], weights->weights[i]);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s CHECKPOINT [generations] [population] [games] [max_pieces] [threads] [seed]\n",
+                argv[0]);
+        return 1;
+    }
+    const char *path = argv[1];
+    int generations = (argc > 2) ? atoi(argv[2]) : 20;
+    int population = (argc > 3) ? atoi(argv[3]) : 32;
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    TuneConfig config = {
+        .games = (argc > 4) ? atoi(argv[4]) : 32,
+        .max_pieces = (argc > 5) ? atoi(argv[5]) : 500,
+        .threads = (argc > 6) ? atoi(argv[6]) : (int)(online > 0 ? online : 1),
+    };
+    uint64_t seed = (argc > 7) ? strtoull(argv[7], NULL, 10) : 1;
+    if (generations < 1 || population < 2 || population > TUNE_MAX_POPULATION || config.games < 1 ||
+        config.games > TUNE_MAX_GAMES || config.max_pieces < 1 || config.threads < 1 ||
+        config.threads > TUNE_MAX_THREADS) {
+        fprintf(stderr, "Usage: %s CHECKPOINT [generations] [population 2-%d] [games 1-%d] [max_pieces] [threads] [seed]\n",
+                argv[0], TUNE_MAX_POPULATION, TUNE_MAX_GAMES);
+        return 1;
+    }
+
+    static TuneState state;
+    if (tune_checkpoint_load(&state, path) == 0) {
+        printf("resuming %s at generation %u (population %u)\n", path, state.generation, state.population);
+    } else {
+        tune_state_init(&state, population, seed);
+        printf("new run -> %s (population %u)\n", path, state.population);
+    }
+    printf("%d games of up to %d pieces per candidate, %d thread(s)\n", config.games, config.max_pieces,
+           config.threads);
+
+    uint32_t last = state.generation + (uint32_t)generations;
+    while (state.generation < last) {
+        uint64_t start = frame_stats_now_us();
+        if (tune_evaluate(&state, &config) != 0) {
+            fprintf(stderr, "evaluation failed\n");
+            return 1;
+        }
+        uint64_t elapsed = frame_stats_now_us() - start;
+
+        double best = state.fitness[0];
+        double total = 0.0;
+        for (uint32_t c = 0; c < state.population; ++c) {
+            total += state.fitness[c];
+            if (state.fitness[c] > best) {
+                best = state.fitness[c];
+            }
+        }
+        double games = (double)state.population * config.games;
+        printf("generation %4u: best %8.2f mean %8.2f lines/game  (%.0f games/s)\n", state.generation, best,
+               total / state.population, games * 1e6 / (double)(elapsed ? elapsed : 1));
+        fflush(stdout);
+
+        tune_next_generation(&state);
+        if (tune_checkpoint_save(&state, path) != 0) {
+            fprintf(stderr, "cannot write %s\n", path);
+            return 1;
+        }
+    }
+
+    printf("best %.2f lines/game (generation %u):\n", state.best_fitness, state.best_generation);
+    print_weights(&state.best);
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine.h"
+#include "frame_stats.h"
+#include "versus.h"
+#include "vt100.h"
+
+// Simulates one versus frame for 8 players in a single process: input, tick, attack and
+// garbage routing through the wire codec, board fan-out to every opponent, and composing
+// all 8 boards side by side on an off-screen VT100 screen. Reports the cost per frame
+// against the 60 Hz budget. Every lock also sends `pressure` garbage lines so the
+// insertion path stays hot even though random play rarely clears lines.
+// Usage: versus_bench [frames] [pressure]
+
+#define BENCH_PLAYERS 8
+#define FRAME_BUDGET_US 16667ULL
+
+static uint64_t xorshift(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void pack_rows(const Engine *engine, VersusMessage *message) {
+    memset(message, 0, sizeof(*message));
+    message->type = VERSUS_MSG_BOARD;
+    message->score = (uint32_t)engine->score.current;
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            if (engine->board.cells[row][col] != 0) {
+                message->rows[row] |= (uint16_t)(1U << col);
+            }
+        }
+    }
+}
+
+// Encode/decode round trip standing in for the socket hop through the match server.
+static void wire(const VersusMessage *in, VersusMessage *out) {
+    unsigned char buffer[VERSUS_MAX_MESSAGE];
+    size_t consumed = 0;
+    size_t length = versus_encode(in, buffer, sizeof(buffer));
+    if (versus_decode(buffer, length, out, &consumed) != 1) {
+        fprintf(stderr, "codec failure\n");
+        exit(1);
+    }
+}
+
+static void draw_board(Vt100Screen *screen, int x, const VersusMessage *board) {
+    char line[BOARD_WIDTH + 2];
+    line[0] = '|';
+    line[BOARD_WIDTH + 1] = '|';
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            line[1 + col] = (board->rows[row] & (1U << col)) ? '#' : ' ';
+        }
+        vt100_put(screen, 2 + row, x, line, sizeof(line));
+    }
+}
+
+int main(int argc, char **argv) {
+    int frames = (argc > 1) ? atoi(argv[1]) : 20000;
+    int pressure = (argc > 2) ? atoi(argv[2]) : 1;
+    if (frames <= 0) {
+        frames = 1;
+    }
+
+    Engine engines[BENCH_PLAYERS];
+    VersusMessage boards[BENCH_PLAYERS];
+    for (int p = 0; p < BENCH_PLAYERS; ++p) {
+        engine_init(&engines[p], 1234);
+        engine_start(&engines[p]);
+        engine_take_events(&engines[p], NULL);
+        pack_rows(&engines[p], &boards[p]);
+    }
+
+    Vt100Screen screen;
+    if (vt100_screen_init(&screen, BOARD_HEIGHT + 4, BENCH_PLAYERS * (BOARD_WIDTH + 3)) != 0) {
+        return 1;
+    }
+
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    uint64_t total_us = 0;
+    uint64_t worst_us = 0;
+    uint64_t garbage_lines = 0;
+    uint64_t bytes = 0;
+    int games = BENCH_PLAYERS;
+
+    for (int frame = 0; frame < frames; ++frame) {
+        uint64_t start = frame_stats_now_us();
+
+        for (int p = 0; p < BENCH_PLAYERS; ++p) {
+            Engine *engine = &engines[p];
+            uint64_t roll = xorshift(&rng) % 16;
+            if (roll < 2) {
+                engine_shift(engine, roll == 0 ? -1 : 1);
+            } else if (roll == 2) {
+                engine_rotate(engine, 1);
+            } else if (roll == 3) {
+                engine_hard_drop(engine);
+            }
+            engine_tick(engine, 16);
+
+            EngineEvents events;
+            uint32_t flags = engine_take_events(engine, &events);
+            garbage_lines += (uint64_t)events.garbage_lines;
+            int lines = events.attack_lines + ((flags & ENGINE_EVENT_LOCKED) ? pressure : 0);
+            if (lines > 0) {
+                VersusMessage attack = {.type = VERSUS_MSG_GARBAGE, .player = (uint8_t)p};
+                VersusMessage received;
+                attack.lines = (uint8_t)lines;
+                wire(&attack, &received);
+                engine_receive_garbage(&engines[(p + 1) % BENCH_PLAYERS], received.lines);
+            }
+            if (engine->phase == ENGINE_PHASE_GAME_OVER) {
+                engine_start(engine);
+                engine_take_events(engine, NULL);
+                ++games;
+            }
+
+            VersusMessage packed;
+            pack_rows(engine, &packed);
+            for (int viewer = 0; viewer < BENCH_PLAYERS - 1; ++viewer) {
+                wire(&packed, &boards[p]);
+            }
+        }
+
+        vt100_clear(&screen);
+        for (int p = 0; p < BENCH_PLAYERS; ++p) {
+            draw_board(&screen, p * (BOARD_WIDTH + 3), &boards[p]);
+        }
+        bytes += vt100_compose(&screen);
+
+        uint64_t elapsed = frame_stats_now_us() - start;
+        total_us += elapsed;
+        if (elapsed > worst_us) {
+            worst_us = elapsed;
+        }
+    }
+
+    vt100_screen_destroy(&screen);
+    double mean = (double)total_us / frames;
+    printf("%d players x %d frames: mean %.1f us, worst %llu us per frame (budget %llu us)\n", BENCH_PLAYERS,
+           frames, mean, (unsigned long long)worst_us, (unsigned long long)FRAME_BUDGET_US);
+    printf("%llu garbage lines inserted, %d games played, %.0f terminal bytes/frame\n",
+           (unsigned long long)garbage_lines, games, (double)bytes / frames);
+    return mean < (double)FRAME_BUDGET_US ? 0 : 1;
+}